@@ -1,3 +1,4 @@
 #pragma once
 
 void setMidiClientName(const char* name);
+void midiLatchInput(void);
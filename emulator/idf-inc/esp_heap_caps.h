@@ -99,4 +99,36 @@ void *heap_caps_realloc_dbg(void *ptr, size_t size, uint32_t caps, const char* f
 /** See above, but with function and line debugging */
 void heap_caps_free_dbg(void* ptr, const char* file, const char* func, int32_t line, const char* tag);
 
+/**
+ * @brief Current and peak heap usage in the emulator, in bytes
+ */
+typedef struct
+{
+    size_t usedInternal;        ///< Internal memory currently allocated
+    size_t usedSpiram;          ///< SPIRAM currently allocated
+    size_t peakInternal;        ///< The most internal memory ever allocated at once
+    size_t peakSpiram;          ///< The most SPIRAM ever allocated at once
+    size_t modePeakInternal;    ///< The most internal memory allocated at once since the current mode started
+    size_t modePeakSpiram;      ///< The most SPIRAM allocated at once since the current mode started
+    uint32_t liveAllocations;   ///< The number of allocations which haven't been freed
+    uint32_t callSites;         ///< The number of distinct call sites which have allocated memory
+    size_t freeInternal;        ///< Free internal memory. An estimate unless the heap is modeled
+    size_t freeSpiram;          ///< Free SPIRAM. An estimate unless the heap is modeled
+    size_t largestFreeInternal; ///< The largest allocatable block of internal memory
+    size_t largestFreeSpiram;   ///< The largest allocatable block of SPIRAM
+    size_t minimumFreeInternal; ///< The least free internal memory there has been
+    size_t minimumFreeSpiram;   ///< The least free SPIRAM there has been
+    uint32_t failures;          ///< Allocations which failed because the modeled heap had no room
+    uint32_t injectedFailures;  ///< Allocations which failed on purpose
+} heapCapsStats_t;
+
 void dumpAllocTable(void);
+void dumpAllocSites(void);
+void heapCapsGetStats(heapCapsStats_t* stats);
+void heapCapsModeExiting(const char* modeName);
+void heapCapsModeExited(void);
+
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief A saved copy of everything the Swadge had allocated, see emuHeapSaveSnapshot()
+typedef struct emuHeapSnapshot emuHeapSnapshot_t;
+
+void emuSetHeapModel(bool enable);
+bool emuGetHeapModel(void);
+void emuSetHeapFailRate(uint32_t oneIn);
+uint32_t emuGetHeapFailRate(void);
+
+void emuHeapBeginEmulatorAllocs(void);
+void emuHeapEndEmulatorAllocs(void);
+
+emuHeapSnapshot_t* emuHeapSaveSnapshot(void);
+bool emuHeapRestoreSnapshot(const emuHeapSnapshot_t* snap);
+void emuHeapFreeSnapshot(emuHeapSnapshot_t* snap);
+size_t emuHeapGetSnapshotSize(const emuHeapSnapshot_t* snap, uint32_t* numAllocs);
@@ -1,4 +1,21 @@
 #pragma once
 
+#include <stdint.h>
+
+/// @brief How many numbers esp_random()'s generator keeps
+#define EMU_RAND_DEGREE 31
+
+/**
+ * @brief The saved state of esp_random(), see emulatorSaveRandomState()
+ */
+typedef struct
+{
+    int32_t table[EMU_RAND_DEGREE];
+    uint8_t front;
+    uint8_t rear;
+} emuRandomState_t;
+
 void emulatorSetEspRandomSeed(unsigned int seed);
 unsigned int emulatorGetEspRandomSeed(void);
+void emulatorSaveRandomState(emuRandomState_t* state);
+void emulatorRestoreRandomState(const emuRandomState_t* state);
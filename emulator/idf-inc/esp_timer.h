@@ -66,6 +66,9 @@ extern "C"
             uint32_t event_id;
         };
         void* arg;
+        // The emulator keeps running timers in a min-heap ordered by alarm, then by seq
+        uint32_t heapIdx; //!< The timer's index in the emulator's timer heap, only meaningful while running
+        uint64_t seq;     //!< When the timer was started relative to other timers, so equal alarms fire in order
         // #if WITH_PROFILING
         //     const char* name;
         //     size_t times_triggered;
@@ -1,7 +1,33 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_timer.h"
+#include "linked_list.h"
+
+/**
+ * @brief The emulator's saved timer state, see emuTimerSaveState()
+ */
+typedef struct
+{
+    /// Every created timer
+    list_t list;
+    /// Running timers, in heap order
+    esp_timer_handle_t* heap;
+    uint32_t heapLen;
+    /// The time which timer alarms were measured against
+    uint64_t nowUs;
+    uint64_t seq;
+} emuTimerState_t;
+
 void emuSetUseRealTime(bool useRealTime);
+bool emuGetUseRealTime(void);
 void emuSetEspTimerTime(int64_t timeUs);
 void emuTimerPause(void);
 void emuTimerUnpause(void);
 bool emuTimerIsPaused(void);
+
+emuTimerState_t* emuTimerSaveState(void);
+void emuTimerRestoreState(const emuTimerState_t* state);
+void emuTimerFreeState(emuTimerState_t* state);
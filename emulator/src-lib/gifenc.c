@@ -102,6 +102,7 @@ ge_new_gif(
         goto no_gif;
     gif->w = width; gif->h = height;
     gif->bgindex = bgindex;
+    gif->transparent = -1;
     gif->frame = (uint8_t *) &gif[1];
     gif->back = &gif->frame[width*height];
 #ifdef _WIN32
@@ -218,6 +219,7 @@ put_image(ge_GIF *gif, uint16_t w, uint16_t h, uint16_t x, uint16_t y)
     int nkeys, key_size, i, j;
     Node *node, *child, *root;
     int degree = 1 << gif->depth;
+    int delta = gif->bgindex < 0 && gif->transparent >= 0 && gif->nframes > 0;
 
     write(gif->fd, ",", 1);
     write_num(gif->fd, x);
@@ -231,6 +233,10 @@ put_image(ge_GIF *gif, uint16_t w, uint16_t h, uint16_t x, uint16_t y)
     for (i = y; i < y+h; i++) {
         for (j = x; j < x+w; j++) {
             uint8_t pixel = gif->frame[i*gif->w+j] & (degree - 1);
+            /* In delta mode, unchanged pixels become transparent, which
+             * shows the previous frame and compresses into long runs. */
+            if (delta && pixel == (gif->back[i*gif->w+j] & (degree - 1)))
+                pixel = (uint8_t) gif->transparent;
             child = node->children[pixel];
             if (child) {
                 node = child;
@@ -290,9 +296,10 @@ static void
 add_graphics_control_extension(ge_GIF *gif, uint16_t d)
 {
     uint8_t flags = ((gif->bgindex >= 0 ? 2 : 1) << 2) + 1;
+    int tindex = gif->transparent >= 0 ? gif->transparent : gif->bgindex;
     write(gif->fd, (uint8_t []) {'!', 0xF9, 0x04, flags}, 4);
     write_num(gif->fd, d);
-    write(gif->fd, (uint8_t []) {(uint8_t) gif->bgindex, 0x00}, 2);
+    write(gif->fd, (uint8_t []) {(uint8_t) tindex, 0x00}, 2);
 }
 
 void
@@ -301,7 +308,7 @@ ge_add_frame(ge_GIF *gif, uint16_t delay)
     uint16_t w, h, x, y;
     uint8_t *tmp;
 
-    if (delay || (gif->bgindex >= 0))
+    if (delay || (gif->bgindex >= 0) || (gif->transparent >= 0))
         add_graphics_control_extension(gif, delay);
     if (gif->nframes == 0) {
         w = gif->w;
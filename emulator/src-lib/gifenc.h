@@ -11,6 +11,7 @@ typedef struct ge_GIF {
     uint16_t w, h;
     int depth;
     int bgindex;
+    int transparent;
     int fd;
     int offset;
     int nframes;
@@ -13,6 +13,7 @@
 #include "linked_list.h"
 #include "touchUtils.h"
 #include "esp_timer.h"
+#include "esp_heap_caps_emu.h"
 
 //==============================================================================
 // Variables
@@ -211,8 +212,11 @@ void emulatorInjectButton(buttonBit_t button, bool down)
     evt->state       = buttonState;
     evt->time        = esp_timer_get_time();
 
-    // Add the event to the list
+    // Add the event to the list. The list node is on the Swadge's heap, but the event isn't the Swadge's until it's
+    // taken from the queue
+    emuHeapBeginEmulatorAllocs();
     push(buttonQueue, evt);
+    emuHeapEndEmulatorAllocs();
 }
 
 void emulatorSetTouchJoystick(int32_t phi, int32_t radius, int32_t intensity)
@@ -252,3 +256,68 @@ buttonBit_t emulatorGetButtonState(void)
 {
     return buttonState;
 }
+
+/**
+ * @brief Save the buttons which are held, the events which haven't been handled yet, and the touchpad
+ *
+ * @return The saved input state, which must be freed with emulatorFreeButtonState()
+ */
+emuButtonState_t* emulatorSaveButtonState(void)
+{
+    emuButtonState_t* state = calloc(1, sizeof(emuButtonState_t));
+    state->buttonState      = buttonState;
+    state->touchPhi         = lastTouchPhi;
+    state->touchRadius      = lastTouchRadius;
+    state->touchIntensity   = lastTouchIntensity;
+
+    state->numEvents = buttonQueue->length;
+    state->events    = calloc(state->numEvents ? state->numEvents : 1, sizeof(buttonEvt_t));
+    int idx          = 0;
+    for (node_t* node = buttonQueue->first; NULL != node; node = node->next)
+    {
+        memcpy(&state->events[idx++], node->val, sizeof(buttonEvt_t));
+    }
+    return state;
+}
+
+/**
+ * @brief Put the buttons, unhandled events, and touchpad back the way they were when their state was saved
+ *
+ * @param state The saved input state, which is still valid afterwards
+ */
+void emulatorRestoreButtonState(const emuButtonState_t* state)
+{
+    void* val;
+    while (NULL != (val = shift(buttonQueue)))
+    {
+        free(val);
+    }
+
+    emuHeapBeginEmulatorAllocs();
+    for (int idx = 0; idx < state->numEvents; idx++)
+    {
+        buttonEvt_t* evt = malloc(sizeof(buttonEvt_t));
+        memcpy(evt, &state->events[idx], sizeof(buttonEvt_t));
+        push(buttonQueue, evt);
+    }
+    emuHeapEndEmulatorAllocs();
+
+    buttonState        = state->buttonState;
+    lastTouchPhi       = state->touchPhi;
+    lastTouchRadius    = state->touchRadius;
+    lastTouchIntensity = state->touchIntensity;
+}
+
+/**
+ * @brief Free saved input state
+ *
+ * @param state The saved input state, or NULL to do nothing
+ */
+void emulatorFreeButtonState(emuButtonState_t* state)
+{
+    if (state)
+    {
+        free(state->events);
+        free(state);
+    }
+}
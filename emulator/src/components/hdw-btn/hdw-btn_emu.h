@@ -5,7 +5,24 @@
 
 #include "hdw-btn.h"
 
+/**
+ * @brief The emulator's saved input state, see emulatorSaveButtonState()
+ */
+typedef struct
+{
+    buttonBit_t buttonState;
+    /// Events which hadn't been taken from the queue yet, oldest first
+    buttonEvt_t* events;
+    int numEvents;
+    int32_t touchPhi;
+    int32_t touchRadius;
+    int32_t touchIntensity;
+} emuButtonState_t;
+
 void emulatorInjectButton(buttonBit_t button, bool down);
 void emulatorSetTouchJoystick(int32_t phi, int32_t radius, int32_t intensity);
 void emulatorHandleKeys(int keycode, int bDown);
 buttonBit_t emulatorGetButtonState(void);
+emuButtonState_t* emulatorSaveButtonState(void);
+void emulatorRestoreButtonState(const emuButtonState_t* state);
+void emulatorFreeButtonState(emuButtonState_t* state);
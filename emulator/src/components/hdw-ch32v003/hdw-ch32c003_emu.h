@@ -1,4 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 // Only available on the emulator
 void ch32v003EmuDraw(int offX, int offY, int window_w, int window_h);
+void ch32v003EmuStep(int64_t elapsedUs);
@@ -5,7 +5,13 @@
  This is accomplished by just directly reading it out of DMA1_Channel5->MADDR.
 
  In general this is a costly operation to run, to emulate the processor, but, it runs in its
- own thread.
+ own thread. Instructions are predecoded a basic block at a time and cached until the memory they
+ were decoded from is written. When the processor is halted the thread sleeps until it is resumed,
+ and when it is only spinning on SysTick the thread sleeps in short steps instead of emulating the
+ spin.
+
+ In deterministic mode there is no thread. The processor is stepped from the main loop by fake time
+ instead, and SysTick follows fake time rather than the host's clock.
  */
 
 //==============================================================================
@@ -26,6 +32,7 @@
 
 #include "hdw-ch32v003.h"
 #include "hdw-ch32c003_emu.h"
+#include "emu_args.h"
 
 //==============================================================================
 // Functions being stubbed.
@@ -73,14 +80,64 @@ struct MiniRV32IMAState ch32v003state;
 static int CHPLoad(uint32_t address, uint32_t* regret, int size);
 static int CHPStore(uint32_t address, uint32_t regret, int size);
 
+static uint32_t expandCompressed(uint16_t ci);
+static void decodeBlock(uint32_t ofs);
+static uint32_t fetchDecoded(uint32_t ofs, uint32_t* trap);
+static inline void noteStore(uint32_t ofs, int size);
+static void lockCh32v003(void);
+static void unlockCh32v003(void);
+
+/// @brief One predecode slot for every halfword of flash and RAM
+#define DECODE_SLOTS ((FLASH_SIZE + RAM_SIZE) / 2)
+
+/// @brief The most instructions to predecode at once, if a basic block is longer
+#define DECODE_MAX_BLOCK 64
+
+/// @brief Executing this traps as an illegal instruction, so it stands in for encodings that can't be expanded
+#define ILLEGAL_INSTRUCTION 0xffffffff
+
+/// @brief SysTick reads with no stores in between before the processor is considered to be spinning on SysTick
+#define IDLE_POLLS 16
+
+/// @brief How long the thread sleeps when the processor is spinning on SysTick
+#define IDLE_SLEEP_US 1000
+
+/// @brief The most time emulated at once, so a stall on the host isn't followed by a long catch-up
+#define MAX_SLICE_US 10000
+
+/**
+ * @brief Predecoded instructions, or 0 for slots which aren't decoded yet. Compressed instructions are expanded to
+ * their 32-bit equivalents and stored with bit 0 cleared, since every 32-bit instruction has it set
+ */
+static uint32_t decodedIr[DECODE_SLOTS];
+
+/// @brief Whether any instructions were decoded from RAM, which RAM stores need to check for
+static bool ramDecoded;
+
+/// @brief SysTick reads since the last store
+static int idlePolls;
+
+/// @brief In deterministic mode, how much fake time the processor has been stepped by, which SysTick follows
+static uint64_t stepClockUs;
+
+/// @brief In deterministic mode, whether the processor is waiting for an interrupt until ch32v003Resume()
+static bool waitingForInterrupt;
+
 #define MINI_RV32_RAM_SIZE        (0x20000000 + RAM_SIZE)
 #define MINIRV32_RAM_IMAGE_OFFSET 0x00000000
 #define MINIRV32WARN(x...)        fprintf(stderr, x)
-#define MINIRV32_MMIO_RANGE(n)    ((0x40000000 <= (n) && (n) < 0x50000000)) || (0xe0000000 <= (n) && (n) < 0xe0004000)
+#define MINIRV32_MMIO_RANGE(n)    ((0x40000000 <= (n) && (n) < 0x50000000) || (0xe0000000 <= (n) && (n) < 0xe0010000))
 
 // These should not be accessable.
 #define MINIRV32_HANDLE_MEM_STORE_CONTROL(addy, val) CHPStore(addy, val, 4);
-#define MINIRV32_HANDLE_MEM_LOAD_CONTROL(addy, val)  CHPLoad(addy, &val, 4);
+
+// Loads go to CHPLoad() too. Stop executing once the CPU is only spinning on SysTick, so the thread can sleep
+#define MINIRV32_HANDLE_MEM_LOAD_CONTROL(addy, val) \
+    CHPLoad(addy, &val, 4);                         \
+    if (idlePolls >= IDLE_POLLS)                    \
+    {                                               \
+        icount = count;                             \
+    }
 
 #define RAMOFS 0x20000000
 
@@ -90,10 +147,12 @@ static int CHPStore(uint32_t address, uint32_t regret, int size);
     if (ofs < FLASH_SIZE - 3)                              \
     {                                                      \
         *(uint32_t*)(ch32v003flash + ofs) = val;           \
+        noteStore(ofs, 4);                                 \
     }                                                      \
     else if (ofs >= RAMOFS && ofs < RAMOFS + RAM_SIZE - 3) \
     {                                                      \
         *(uint32_t*)(ch32v003ram + ofs - RAMOFS) = val;    \
+        noteStore(ofs, 4);                                 \
     }                                                      \
     else                                                   \
     {                                                      \
@@ -107,10 +166,12 @@ static int CHPStore(uint32_t address, uint32_t regret, int size);
     if (ofs < FLASH_SIZE - 1)                              \
     {                                                      \
         *(uint16_t*)(ch32v003flash + ofs) = val;           \
+        noteStore(ofs, 2);                                 \
     }                                                      \
     else if (ofs >= RAMOFS && ofs < RAMOFS + RAM_SIZE - 1) \
     {                                                      \
         *(uint16_t*)(ch32v003ram + ofs - RAMOFS) = val;    \
+        noteStore(ofs, 2);                                 \
     }                                                      \
     else                                                   \
     {                                                      \
@@ -124,10 +185,12 @@ static int CHPStore(uint32_t address, uint32_t regret, int size);
     if (ofs < FLASH_SIZE - 0)                              \
     {                                                      \
         *(uint8_t*)(ch32v003flash + ofs) = val;            \
+        noteStore(ofs, 1);                                 \
     }                                                      \
     else if (ofs >= RAMOFS && ofs < RAMOFS + RAM_SIZE - 0) \
     {                                                      \
         *(uint8_t*)(ch32v003ram + ofs - RAMOFS) = val;     \
+        noteStore(ofs, 1);                                 \
     }                                                      \
     else                                                   \
     {                                                      \
@@ -268,236 +331,334 @@ static inline int8_t MINIRV32_LOAD1_SIGNEDs(uint32_t ofs, uint32_t* rval, uint32
 
 #define MINIRV32_IMPLEMENTATION
 
-// https://riscv.github.io/riscv-isa-manual/snapshot/unprivileged/#_compressed_instruction_formats about 1/3 the way
-// down. https://www.cs.sfu.ca/~ashriram/Courses/CS295/assets/notebooks/RISCV/RISCV_CARD.pdf
-// This adds -C extension support to mini-rv32ima.
-
-#define MINIRV32_HANDLE_OTHER_OPCODE                                                                                   \
-    default:                                                                                                           \
-    {                                                                                                                  \
-        int cimm         = ((((ir >> 2) & 0x1f)) | (((ir >> 12) & 1) << 5));                                           \
-        uint32_t cimmext = (cimm & 0x20) ? (cimm | 0xffffffc0) : cimm;                                                 \
-        switch (ir & 3)                                                                                                \
-        {                                                                                                              \
-            case 0b00:                                                                                                 \
-            {                                                                                                          \
-                ir &= 0xffff;                                                                                          \
-                pc -= 2;                                                                                               \
-                uint32_t uimm = (((ir >> 5) & 1) << 6) | (((ir >> 6) & 1) << 2) | (((ir >> 10) & 7) << 3);             \
-                switch (ir >> 13)                                                                                      \
-                {                                                                                                      \
-                    case 0b000: /*c.addi4spn ADD Imm * 4 + SP TODO*/                                                   \
-                        cimm = (((ir >> 5) & 1) << 3) | (((ir >> 6) & 1) << 2) | (((ir >> 7) & 0xf) << 6)              \
-                               | (((ir >> 11) & 3) << 4);                                                              \
-                        cimmext = (cimm & 0x200) ? (cimm | 0xfffffc00) : cimm;                                         \
-                        rdid    = ((ir >> 2) & 7) + 8;                                                                 \
-                        /*printf( "c.addi4spn %08x %d / %d\n", REG( 2 ), cimmext, rdid );*/                            \
-                        rval = REG(2) + cimmext;                                                                       \
-                        break;                                                                                         \
-                    case 0b010: /*c.lw*/                                                                               \
-                        /*printf( "L %08x -> %08x/%08x\n", pc, REG(((ir>>7)&7)+8), uimm );*/                           \
-                        rval = MINIRV32_LOAD4(REG(((ir >> 7) & 7) + 8) + uimm);                                        \
-                        rdid = ((ir >> 2) & 7) + 8;                                                                    \
-                        break;                                                                                         \
-                    case 0b110: /*c.sw*/                                                                               \
-                        /*printf( "S %08x -> %08x/%08x\n", pc, REG(((ir>>7)&7)+8), uimm );*/                           \
-                        MINIRV32_STORE4(REG(((ir >> 7) & 7) + 8) + uimm, REG(((ir >> 2) & 7) + 8));                    \
-                        rdid = 0;                                                                                      \
-                        break;                                                                                         \
-                    default:                                                                                           \
-                        trap = (2 + 1);                                                                                \
-                        break;                                                                                         \
-                }                                                                                                      \
-                break;                                                                                                 \
-            }                                                                                                          \
-            case 0b01:                                                                                                 \
-                ir &= 0xffff;                                                                                          \
-                pc -= 2;                                                                                               \
-                switch (ir >> 13)                                                                                      \
-                {                                                                                                      \
-                    case 0b000: /*c.addi*/                                                                             \
-                        rval = REG(rdid) + cimmext;                                                                    \
-                        break;                                                                                         \
-                    case 0b010: /*c.li*/                                                                               \
-                        rval = cimmext;                                                                                \
-                        break;                                                                                         \
-                    case 0b011: /*c.lui / ADDI16SP*/                                                                   \
-                        switch (((ir >> 7) & 0x1f))                                                                    \
-                        {                                                                                              \
-                            case 0:                                                                                    \
-                                break;                                                                                 \
-                            case 2: /*c.addi16sp TODO: Check me.*/                                                     \
-                            {                                                                                          \
-                                cimm = (((ir >> 12) & 1) << 9) | (((ir >> 2) & 1) << 5) | (((ir >> 5) & 1) << 6)       \
-                                       | (((ir >> 6) & 1) << 4) | (((ir >> 3) & 3) << 7);                              \
-                                cimmext = (cimm & 0x200) ? (cimm | 0xfffffc00) : cimm;                                 \
-                                /*printf( "c.addi16sp -> %08x -> %08x\n",  REG(2), cimmext );*/                        \
-                                rval = REG(2) + cimmext;                                                               \
-                                break;                                                                                 \
-                            }                                                                                          \
-                            default: /*c.lui*/                                                                         \
-                                rval = cimm << 12;                                                                     \
-                                break;                                                                                 \
-                        };                                                                                             \
-                        break;                                                                                         \
-                    case 0b100: /* MISC-ALU */                                                                         \
-                        rdid = (rdid & 7) + 8;                                                                         \
-                        switch ((ir >> 10) & 3)                                                                        \
-                        {                                                                                              \
-                            case 0: /*c.srli*/                                                                         \
-                                rval = REG(rdid) >> cimm;                                                              \
-                                break;                                                                                 \
-                            case 1: /*c.srai*/                                                                         \
-                                rval = ((int32_t)REG(rdid)) >> cimm;                                                   \
-                                break;                                                                                 \
-                            case 2: /*c.andi*/                                                                         \
-                                rval = REG(rdid) & cimm;                                                               \
-                                break;                                                                                 \
-                            case 3: /*c.other*/                                                                        \
-                            {                                                                                          \
-                                uint32_t rs2 = REG((cimm & 7) + 8);                                                    \
-                                switch (cimm >> 3)                                                                     \
-                                {                                                                                      \
-                                    case 0: /* c.sub */                                                                \
-                                        rval = REG(rdid) - (rs2);                                                      \
-                                        break;                                                                         \
-                                    case 1: /* c.xor */                                                                \
-                                        rval = REG(rdid) ^ (rs2);                                                      \
-                                        break;                                                                         \
-                                    case 2: /* c.or  */                                                                \
-                                        rval = REG(rdid) | (rs2);                                                      \
-                                        break;                                                                         \
-                                    case 3: /* c.and */                                                                \
-                                        rval = REG(rdid) & (rs2);                                                      \
-                                        break;                                                                         \
-                                    default: /* res   */                                                               \
-                                        trap = (2 + 1);                                                                \
-                                        break;                                                                         \
-                                }                                                                                      \
-                            }                                                                                          \
-                        }                                                                                              \
-                        break;                                                                                         \
-                    case 0b001: /*c.jal + NOTE: Is c.addiw on RV64*/                                                   \
-                    case 0b101: /*c.j*/                                                                                \
-                    {                                                                                                  \
-                        uint32_t limm = (((ir >> 2) & 0x1) << 5) | (((ir >> 3) & 0x7) << 1) | (((ir >> 6) & 0x1) << 7) \
-                                        | (((ir >> 7) & 0x1) << 6) | (((ir >> 8) & 0x1) << 10)                         \
-                                        | (((ir >> 9) & 0x3) << 8) | (((ir >> 11) & 0x1) << 4)                         \
-                                        | (((ir >> 12) & 1) << 11);                                                    \
-                        if (limm & 0x800)                                                                              \
-                            limm |= 0xfffff000;                                                                        \
-                        if ((ir >> 13) == 0b001)                                                                       \
-                        {                                                                                              \
-                            rdid = 1;                                                                                  \
-                            rval = pc + 4;                                                                             \
-                            /*printf( "jal r1 = %08x\n", rval );*/                                                     \
-                        }                                                                                              \
-                        else                                                                                           \
-                            rdid = 0;                                                                                  \
-                        pc = pc + limm - 2;                                                                            \
-                    }                                                                                                  \
-                    break;                                                                                             \
-                    case 0b110: /*c.beqz*/                                                                             \
-                    case 0b111: /*c.bnez*/                                                                             \
-                    {                                                                                                  \
-                        rdid          = 0;                                                                             \
-                        uint32_t limm = (((ir >> 2) & 0x1) << 5) | (((ir >> 3) & 0x3) << 1)                            \
-                                        | (((ir >> 10) & 0x3) << 3) | (((ir >> 5) & 0x3) << 6)                         \
-                                        | (((ir >> 12) & 0x1) << 8);                                                   \
-                        if (limm & 0x100)                                                                              \
-                            limm |= 0xffffff00;                                                                        \
-                        if ((ir >> 13) == 0b110)                                                                       \
-                        {                                                                                              \
-                            if (REG(((ir >> 7) & 0x7) + 8) == 0)                                                       \
-                            {                                                                                          \
-                                pc = pc + limm - 2;                                                                    \
-                            }                                                                                          \
-                        }                                                                                              \
-                        else                                                                                           \
-                        {                                                                                              \
-                            if (REG(((ir >> 7) & 0x7) + 8) != 0)                                                       \
-                            {                                                                                          \
-                                pc = pc + limm - 2;                                                                    \
-                            }                                                                                          \
-                        }                                                                                              \
-                        break;                                                                                         \
-                    }                                                                                                  \
-                    default:                                                                                           \
-                        trap = (2 + 1);                                                                                \
-                        break;                                                                                         \
-                }                                                                                                      \
-                break;                                                                                                 \
-            case 0b10:                                                                                                 \
-                ir &= 0xffff;                                                                                          \
-                pc -= 2;                                                                                               \
-                switch (ir >> 13)                                                                                      \
-                {                                                                                                      \
-                    case 0b000: /*c.slli*/                                                                             \
-                        rval = REG(rdid) << cimm;                                                                      \
-                        break;                                                                                         \
-                    case 0b100: /*c.mv / c.add / c.jr (/c.ret) / c.jalr */                                             \
-                        if ((ir >> 12) & 1)                                                                            \
-                        {                                                                                              \
-                            if ((((ir >> 2) & 0x1f) != 0) && rdid != 0)                                                \
-                            {                                                                                          \
-                                /*printf( "Adding r %d / %d\n", (ir>>2)&0x1f, rdid );*/                                \
-                                rval = REG((ir >> 2) & 0x1f) + REG(rdid); /* c.add */                                  \
-                            }                                                                                          \
-                            else if (rdid != 0)                                                                        \
-                            {                                                                                          \
-                                rdid = 1; /* c.jalr */                                                                 \
-                                rval = pc + 4;                                                                         \
-                                pc   = REG(rdid) - 4; /*c.jr*/                                                         \
-                            }                                                                                          \
-                            else                                                                                       \
-                            {                                                                                          \
-                                trap = (3 + 1);                                                                        \
-                                break; /* EBREAK 3 = "Breakpoint" */                                                   \
-                            }                                                                                          \
-                        }                                                                                              \
-                        else                                                                                           \
-                        {                                                                                              \
-                            if ((((ir >> 2) & 0x1f) != 0) && rdid != 0)                                                \
-                            {                                                                                          \
-                                rval = REG((ir >> 2) & 0x1f);                                                          \
-                            }                                                                                          \
-                            else if (rdid != 0)                                                                        \
-                            {                                                                                          \
-                                pc   = REG(rdid) - 4;                                                                  \
-                                rdid = 0; /* c.jr */                                                                   \
-                            }                                                                                          \
-                            else                                                                                       \
-                            {                                                                                          \
-                                /* illegal opcode */                                                                   \
-                                trap = (2 + 1);                                                                        \
-                                break;                                                                                 \
-                            }                                                                                          \
-                        }                                                                                              \
-                        break;                                                                                         \
-                    case 0b110: /*c.swsp / c.sw(SP)*/                                                                  \
-                        rdid = 0;                                                                                      \
-                        /*printf( "C.SWSP gp=%08x -> REG(2)=%08x + %08x <<< %08x\n", REG(3), REG(2), (((ir>>7)&3)<<6)  \
-                         * + (((ir>>9)&0xf)<<2), REG(((ir>>2)&0x1f)) ); */                                             \
-                        MINIRV32_STORE4(REG(2) + (((ir >> 7) & 3) << 6) + (((ir >> 9) & 0xf) << 2),                    \
-                                        REG(((ir >> 2) & 0x1f)));                                                      \
-                        break;                                                                                         \
-                    case 0b010: /*c.lwsp / c.lw(SP)*/                                                                  \
-                        /*printf( "C.LWSP gp=%08x -> REG(2)=%08x + %08x <<< %08x\n", REG(3), REG(2), (((ir>>2)&3)<<6)  \
-                         * + (((ir>>4)&0x7)<<2) + (((ir>>12)&1)<<5), REG(((ir>>2)&0x1f)) );*/                          \
-                        rval = MINIRV32_LOAD4(REG(2) + (((ir >> 2) & 3) << 6) + (((ir >> 4) & 0x7) << 2)               \
-                                              + (((ir >> 12) & 1) << 5));                                              \
-                        rdid = ((ir >> 7) & 0x1f);                                                                     \
-                        break;                                                                                         \
-                    default:                                                                                           \
-                        trap = (2 + 1);                                                                                \
-                        break;                                                                                         \
-                }                                                                                                      \
-                break;                                                                                                 \
-            default:                                                                                                   \
-                trap = (2 + 1);                                                                                        \
-                break;                                                                                                 \
-        }                                                                                                              \
+// Compressed (-C extension) instructions are expanded into their 32-bit equivalents when they are predecoded, see
+// expandCompressed(). https://riscv.github.io/riscv-isa-manual/snapshot/unprivileged/#_compressed_instruction_formats
+// Instructions in flash which are already decoded are fetched here, everything else goes through fetchDecoded().
+#define MINIRV32_FETCH(ofs)                                                 \
+    ({                                                                      \
+        uint32_t fetched = ((ofs) < FLASH_SIZE) ? decodedIr[(ofs) / 2] : 0; \
+        if (!fetched)                                                       \
+        {                                                                   \
+            fetched = fetchDecoded(ofs, &trap);                             \
+        }                                                                   \
+        if (!(fetched & 1))                                                 \
+        {                                                                   \
+            pc -= 2;                                                        \
+            fetched |= 1;                                                   \
+        }                                                                   \
+        fetched;                                                            \
+                                                                            \
+    })
+
+//==============================================================================
+// Predecode cache
+//==============================================================================
+
+/// @brief Extract bits hi through lo of a compressed instruction
+#define CI_BITS(ci, hi, lo) (((ci) >> (lo)) & ((1u << ((hi) - (lo) + 1)) - 1))
+
+static inline int32_t signExtend(uint32_t val, int bits)
+{
+    return ((int32_t)(val << (32 - bits))) >> (32 - bits);
+}
+
+static inline uint32_t encodeI(int32_t imm, uint32_t rs1, uint32_t funct3, uint32_t rd, uint32_t opcode)
+{
+    return ((uint32_t)imm << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+
+static inline uint32_t encodeS(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3)
+{
+    return ((((uint32_t)imm >> 5) & 0x7f) << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12)
+           | (((uint32_t)imm & 0x1f) << 7) | 0x23;
+}
+
+static inline uint32_t encodeR(uint32_t funct7, uint32_t rs2, uint32_t rs1, uint32_t funct3, uint32_t rd)
+{
+    return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | 0x33;
+}
+
+static inline uint32_t encodeB(int32_t imm, uint32_t rs1, uint32_t funct3)
+{
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 12) & 1) << 31) | (((u >> 5) & 0x3f) << 25) | (rs1 << 15) | (funct3 << 12) | (((u >> 1) & 0xf) << 8)
+           | (((u >> 11) & 1) << 7) | 0x63;
+}
+
+static inline uint32_t encodeJ(int32_t imm, uint32_t rd)
+{
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 20) & 1) << 31) | (((u >> 1) & 0x3ff) << 21) | (((u >> 11) & 1) << 20) | (((u >> 12) & 0xff) << 12)
+           | (rd << 7) | 0x6f;
+}
+
+/**
+ * @brief Expand a compressed instruction into the 32-bit instruction that does the same thing.
+ *
+ * MINIRV32_FETCH runs an expanded instruction with pc two bytes before the compressed one, so the interpreter's
+ * pc += 4 lands on the next instruction. That's why jump and branch offsets are two bytes longer here, and why a trap
+ * in a compressed instruction reports pc - 2, same as the compressed decoder this replaced.
+ *
+ * @param ci The compressed instruction
+ * @return The equivalent 32-bit instruction, or ILLEGAL_INSTRUCTION
+ */
+static uint32_t expandCompressed(uint16_t ci)
+{
+    uint32_t rd    = CI_BITS(ci, 11, 7); // Also rs1 for the register-register formats
+    uint32_t rs2   = CI_BITS(ci, 6, 2);
+    uint32_t rdp   = CI_BITS(ci, 4, 2) + 8; // rd' or rs2'
+    uint32_t rs1p  = CI_BITS(ci, 9, 7) + 8; // rs1', also rd' for the ALU formats
+    uint32_t shamt = (CI_BITS(ci, 12, 12) << 5) | CI_BITS(ci, 6, 2);
+    int32_t imm6   = signExtend(shamt, 6);
+
+    // Quadrant in bits 4:3, funct3 in bits 2:0
+    uint32_t op = ((ci & 3) << 3) | CI_BITS(ci, 15, 13);
+    switch (op)
+    {
+        case 0x00: // c.addi4spn
+        {
+            uint32_t nzuimm = (CI_BITS(ci, 12, 11) << 4) | (CI_BITS(ci, 10, 7) << 6) | (CI_BITS(ci, 6, 6) << 2)
+                              | (CI_BITS(ci, 5, 5) << 3);
+            return nzuimm ? encodeI(nzuimm, 2, 0, rdp, 0x13) : ILLEGAL_INSTRUCTION;
+        }
+        case 0x02: // c.lw
+        case 0x06: // c.sw
+        {
+            uint32_t uimm = (CI_BITS(ci, 12, 10) << 3) | (CI_BITS(ci, 6, 6) << 2) | (CI_BITS(ci, 5, 5) << 6);
+            return (0x02 == op) ? encodeI(uimm, rs1p, 2, rdp, 0x03) : encodeS(uimm, rdp, rs1p, 2);
+        }
+        case 0x08: // c.addi
+            return encodeI(imm6, rd, 0, rd, 0x13);
+        case 0x09: // c.jal
+        case 0x0D: // c.j
+        {
+            int32_t offset = signExtend((CI_BITS(ci, 12, 12) << 11) | (CI_BITS(ci, 11, 11) << 4)
+                                            | (CI_BITS(ci, 10, 9) << 8) | (CI_BITS(ci, 8, 8) << 10)
+                                            | (CI_BITS(ci, 7, 7) << 6) | (CI_BITS(ci, 6, 6) << 7)
+                                            | (CI_BITS(ci, 5, 3) << 1) | (CI_BITS(ci, 2, 2) << 5),
+                                        12);
+            return encodeJ(offset + 2, (0x09 == op) ? 1 : 0);
+        }
+        case 0x0A: // c.li
+            return encodeI(imm6, 0, 0, rd, 0x13);
+        case 0x0B:
+        {
+            if (2 == rd) // c.addi16sp
+            {
+                int32_t nzimm = signExtend((CI_BITS(ci, 12, 12) << 9) | (CI_BITS(ci, 6, 6) << 4)
+                                               | (CI_BITS(ci, 5, 5) << 6) | (CI_BITS(ci, 4, 3) << 7)
+                                               | (CI_BITS(ci, 2, 2) << 5),
+                                           10);
+                return nzimm ? encodeI(nzimm, 2, 0, 2, 0x13) : ILLEGAL_INSTRUCTION;
+            }
+            // c.lui
+            int32_t nzimm = signExtend((CI_BITS(ci, 12, 12) << 17) | (CI_BITS(ci, 6, 2) << 12), 18);
+            return nzimm ? (((uint32_t)nzimm & 0xfffff000) | (rd << 7) | 0x37) : ILLEGAL_INSTRUCTION;
+        }
+        case 0x0C: // MISC-ALU
+        {
+            switch (CI_BITS(ci, 11, 10))
+            {
+                case 0: // c.srli
+                    return (shamt & 0x20) ? ILLEGAL_INSTRUCTION : encodeI(shamt, rs1p, 5, rs1p, 0x13);
+                case 1: // c.srai
+                    return (shamt & 0x20) ? ILLEGAL_INSTRUCTION : encodeI(0x400 | shamt, rs1p, 5, rs1p, 0x13);
+                case 2: // c.andi
+                    return encodeI(imm6, rs1p, 7, rs1p, 0x13);
+                default:
+                {
+                    if (CI_BITS(ci, 12, 12))
+                    {
+                        // c.subw and c.addw are RV64 only
+                        return ILLEGAL_INSTRUCTION;
+                    }
+                    // c.sub, c.xor, c.or, c.and
+                    static const uint8_t funct3s[] = {0, 4, 6, 7};
+                    uint32_t aluOp                 = CI_BITS(ci, 6, 5);
+                    return encodeR(aluOp ? 0 : 0x20, rdp, rs1p, funct3s[aluOp], rs1p);
+                }
+            }
+        }
+        case 0x0E: // c.beqz
+        case 0x0F: // c.bnez
+        {
+            int32_t offset = signExtend((CI_BITS(ci, 12, 12) << 8) | (CI_BITS(ci, 11, 10) << 3)
+                                            | (CI_BITS(ci, 6, 5) << 6) | (CI_BITS(ci, 4, 3) << 1)
+                                            | (CI_BITS(ci, 2, 2) << 5),
+                                        9);
+            return encodeB(offset + 2, rs1p, CI_BITS(ci, 13, 13));
+        }
+        case 0x10: // c.slli
+            return (shamt & 0x20) ? ILLEGAL_INSTRUCTION : encodeI(shamt, rd, 1, rd, 0x13);
+        case 0x12: // c.lwsp
+        {
+            uint32_t uimm = (CI_BITS(ci, 12, 12) << 5) | (CI_BITS(ci, 6, 4) << 2) | (CI_BITS(ci, 3, 2) << 6);
+            return rd ? encodeI(uimm, 2, 2, rd, 0x03) : ILLEGAL_INSTRUCTION;
+        }
+        case 0x14:
+        {
+            if (0 == CI_BITS(ci, 12, 12))
+            {
+                if (rs2)
+                {
+                    // c.mv
+                    return encodeR(0, rs2, 0, 0, rd);
+                }
+                // c.jr
+                return rd ? encodeI(0, rd, 0, 0, 0x67) : ILLEGAL_INSTRUCTION;
+            }
+            else if (rs2)
+            {
+                // c.add
+                return encodeR(0, rs2, rd, 0, rd);
+            }
+            // c.jalr, or c.ebreak
+            return rd ? encodeI(0, rd, 0, 1, 0x67) : 0x00100073;
+        }
+        case 0x16: // c.swsp
+        {
+            uint32_t uimm = (CI_BITS(ci, 12, 9) << 2) | (CI_BITS(ci, 8, 7) << 6);
+            return encodeS(uimm, rs2, 2, 2);
+        }
+        default:
+            return ILLEGAL_INSTRUCTION;
+    }
+}
+
+/**
+ * @brief Get the predecode slot for an address
+ *
+ * @param ofs An address in flash or RAM
+ * @return The slot for the halfword at ofs, or -1 if ofs isn't in flash or RAM
+ */
+static inline int decodeSlot(uint32_t ofs)
+{
+    if (ofs < FLASH_SIZE)
+    {
+        return ofs / 2;
     }
+    else if (ofs >= RAMOFS && ofs < RAMOFS + RAM_SIZE)
+    {
+        return (FLASH_SIZE + ofs - RAMOFS) / 2;
+    }
+    return -1;
+}
+
+/**
+ * @brief Predecode the basic block starting at an address, stopping after the first jump, branch, or system
+ * instruction, at an instruction which is already predecoded, or at the end of memory
+ *
+ * @param ofs The address of the first instruction, in flash or RAM
+ */
+static void decodeBlock(uint32_t ofs)
+{
+    uint8_t* mem   = ch32v003flash;
+    uint32_t start = 0;
+    uint32_t size  = FLASH_SIZE;
+    if (ofs >= RAMOFS)
+    {
+        mem        = ch32v003ram;
+        start      = RAMOFS;
+        size       = RAM_SIZE;
+        ramDecoded = true;
+    }
+
+    for (int n = 0; n < DECODE_MAX_BLOCK && ofs - start < size; n++)
+    {
+        uint32_t at = ofs - start;
+        int slot    = decodeSlot(ofs);
+        if (n && decodedIr[slot])
+        {
+            return;
+        }
+
+        uint16_t lo = *(uint16_t*)(mem + at);
+        uint32_t ir = ILLEGAL_INSTRUCTION;
+        if (3 != (lo & 3))
+        {
+            ir              = expandCompressed(lo);
+            decodedIr[slot] = ir & ~1;
+            ofs += 2;
+        }
+        else
+        {
+            if (at + 4 <= size)
+            {
+                ir = lo | ((uint32_t)(*(uint16_t*)(mem + at + 2)) << 16);
+            }
+            decodedIr[slot] = ir;
+            ofs += 4;
+        }
+
+        switch (ir & 0x7f)
+        {
+            case 0x63: // Branch
+            case 0x67: // JALR
+            case 0x6F: // JAL
+            case 0x73: // SYSTEM
+                return;
+        }
+    }
+}
+
+/**
+ * @brief Fetch an instruction from the predecode cache, decoding its basic block first if needed
+ *
+ * @param ofs The address of the instruction
+ * @param trap The interpreter's trap, set if ofs isn't in flash or RAM
+ * @return The predecoded instruction, in the same form as decodedIr
+ */
+static uint32_t fetchDecoded(uint32_t ofs, uint32_t* trap)
+{
+    int slot = decodeSlot(ofs);
+    if (slot < 0)
+    {
+        // Instruction access fault, and execute a FENCE, which does nothing
+        *trap = (1 + 1);
+        return 0x0000000f;
+    }
+
+    if (!decodedIr[slot])
+    {
+        decodeBlock(ofs);
+    }
+    return decodedIr[slot];
+}
+
+/**
+ * @brief Note a store to flash or RAM. This drops any predecoded instructions it overwrites, and means the CPU isn't
+ * idle
+ *
+ * @param ofs The address written
+ * @param size The number of bytes written
+ */
+static inline void noteStore(uint32_t ofs, int size)
+{
+    idlePolls = 0;
+    if (ofs >= RAMOFS && !ramDecoded)
+    {
+        return;
+    }
+
+    int first = decodeSlot(ofs);
+    int last  = decodeSlot(ofs + size - 1);
+    if (first < 0 || last < 0)
+    {
+        return;
+    }
+
+    // A 32-bit instruction which starts in the halfword before the store overlaps it too. There is no halfword before
+    // the start of flash
+    if (first > 0 && decodeSlot(ofs - 2) == first - 1)
+    {
+        first--;
+    }
+
+    for (int slot = first; slot <= last; slot++)
+    {
+        decodedIr[slot] = 0;
+    }
+}
 
 #include "mini-rv32ima.h"
 
@@ -511,12 +672,13 @@ static uint32_t DMDATA[2];
 
 uint32_t GetSTK()
 {
-    double dt = OGGetAbsoluteTime();
+    double dt = emulatorArgs.deterministic ? stepClockUs / 1000000.0 : OGGetAbsoluteTime();
     if (STK_CTLR & 2)
         dt *= 48000000;
     else
         dt *= 6000000;
-    return ((uint32_t)dt) - STK_ZERO;
+    // The counter wraps at 32 bits. Casting a tick count past that straight to uint32_t is undefined
+    return (uint32_t)(uint64_t)fmod(dt, 4294967296.0) - STK_ZERO;
 }
 
 static int CHPLoad(uint32_t address, uint32_t* regret, int size)
@@ -539,7 +701,10 @@ static int CHPLoad(uint32_t address, uint32_t* regret, int size)
     else if (address == 0xe00000f4 || address == 0xe00000f8)
         *regret = 0; // Tell DMDATA0/1 that we are free to printf.
     else if (address == 0xe000f008)
+    {
         *regret = GetSTK();
+        idlePolls++;
+    }
     else if (address == 0x40022000)
     {
         *regret = 0;
@@ -590,6 +755,8 @@ static int CHPLoad(uint32_t address, uint32_t* regret, int size)
 
 static int CHPStore(uint32_t address, uint32_t regset, int size)
 {
+    idlePolls = 0;
+
     if (address == 0x1ffff800 || address == 0x1ffff802)
     {
         // Doing weird option byte operations.
@@ -686,26 +853,57 @@ static void ResetPeripherals()
 //==============================================================================
 
 og_thread_t ch32v003thread;
+og_sema_t ch32v003wake;
+
+/// Held by the processor's thread while it runs a slice, so other threads can change the processor between slices
+static og_mutex_t ch32v003lock = NULL;
 
 static void* ch32v003threadFn(void* v)
 {
+    lockCh32v003();
     memset(&ch32v003state, 0, sizeof(ch32v003state));
+    unlockCh32v003();
 
     double dLast = OGGetAbsoluteTime();
     while (ch32v003quitMode == 0)
     {
+        if (!ch32v003runMode)
+        {
+            // Halted, so sleep until ch32v003Resume() or ch32v003Teardown()
+            OGLockSema(ch32v003wake);
+            dLast = OGGetAbsoluteTime();
+            continue;
+        }
+
         double dNow  = OGGetAbsoluteTime();
         uint32_t tus = (dNow - dLast) * 1000000;
-        if (ch32v003runMode)
+        if (tus > MAX_SLICE_US)
         {
-            /*int r = */ MiniRV32IMAStep(&ch32v003state, 0, 0, tus, 24 * tus);
-            // printf( "STEP: %d\n", r );
+            tus = MAX_SLICE_US;
         }
-        OGUSleep(100);
+        dLast = dNow;
 
+        lockCh32v003();
+        idlePolls = 0;
+        int r     = MiniRV32IMAStep(&ch32v003state, 0, 0, tus, 24 * tus);
+        unlockCh32v003();
         // printf( "%08x %08x %d\n", ch32v003state.pc, ch32v003state.mtvec, ch32v003runMode );
 
-        dLast = dNow;
+        if (1 == r)
+        {
+            // Waiting for an interrupt, but no emulated hardware raises one, so sleep until resumed or torn down
+            OGLockSema(ch32v003wake);
+            dLast = OGGetAbsoluteTime();
+        }
+        else if (idlePolls >= IDLE_POLLS)
+        {
+            // Spinning on SysTick, which follows the host's clock, so sleep rather than emulate the spin
+            OGUSleep(IDLE_SLEEP_US);
+        }
+        else
+        {
+            OGUSleep(100);
+        }
     }
     return 0;
 }
@@ -717,17 +915,82 @@ static void* ch32v003threadFn(void* v)
 int initCh32v003(int swdio_pin)
 {
     ch32v003runMode = 0;
-    ch32v003thread  = OGCreateThread(ch32v003threadFn, 0);
+    if (emulatorArgs.deterministic)
+    {
+        // Stepped by ch32v003EmuStep() instead
+        memset(&ch32v003state, 0, sizeof(ch32v003state));
+        return 0;
+    }
+    ch32v003wake   = OGCreateSema();
+    ch32v003lock   = OGCreateMutex();
+    ch32v003thread = OGCreateThread(ch32v003threadFn, 0);
     return 0;
 }
 
+/**
+ * @brief Wait for the processor's thread to finish its slice and keep it from starting another, so memory, the
+ * predecoded instructions, and the processor's state can be changed. There's no thread in deterministic mode
+ */
+static void lockCh32v003(void)
+{
+    if (ch32v003lock)
+    {
+        OGLockMutex(ch32v003lock);
+    }
+}
+
+/**
+ * @brief Let the processor's thread run slices again, see lockCh32v003()
+ */
+static void unlockCh32v003(void)
+{
+    if (ch32v003lock)
+    {
+        OGUnlockMutex(ch32v003lock);
+    }
+}
+
+/**
+ * @brief Step the processor by some fake time. This is only used in deterministic mode, where it's called from the
+ * emulator's main loop once per frame instead of the processor running on its own thread
+ *
+ * @param elapsedUs The fake time since the last step, in microseconds
+ */
+void ch32v003EmuStep(int64_t elapsedUs)
+{
+    if (!emulatorArgs.deterministic)
+    {
+        return;
+    }
+
+    // Step in slices as short as the thread's sleeps, so SysTick waits end about when they would with the thread
+    while (elapsedUs > 0)
+    {
+        uint32_t tus = (elapsedUs > IDLE_SLEEP_US) ? IDLE_SLEEP_US : (uint32_t)elapsedUs;
+        elapsedUs -= tus;
+        stepClockUs += tus;
+
+        if (ch32v003runMode && !waitingForInterrupt)
+        {
+            idlePolls = 0;
+            if (1 == MiniRV32IMAStep(&ch32v003state, 0, 0, tus, 24 * tus))
+            {
+                // No emulated hardware raises an interrupt, so this waits until resumed
+                waitingForInterrupt = true;
+            }
+        }
+    }
+}
+
 int ch32v003WriteMemory(const uint8_t* binary, uint32_t length, uint32_t address)
 {
     uint32_t rval = 0, trap = 0;
+    lockCh32v003();
     ch32v003runMode = 0;
     int i;
     for (i = 0; i < length; i++)
         MINIRV32_STORE1(address + i, binary[i]);
+    unlockCh32v003();
 
     return (trap || rval) ? -1 : 0;
 }
@@ -735,10 +998,12 @@ int ch32v003WriteMemory(const uint8_t* binary, uint32_t length, uint32_t address
 int ch32v003ReadMemory(uint8_t* binary, uint32_t length, uint32_t address)
 {
     uint32_t rval = 0, trap = 0;
+    lockCh32v003();
     ch32v003runMode = 0;
     int i;
     for (i = 0; i < length; i++)
         binary[i] = MINIRV32_LOAD4(address + i);
+    unlockCh32v003();
 
     return (trap || rval) ? -1 : 0;
 }
@@ -771,14 +1036,35 @@ void ch32v003CheckTerminal()
 void ch32v003Teardown()
 {
     ch32v003quitMode = true;
+    if (emulatorArgs.deterministic)
+    {
+        return;
+    }
+    OGUnlockSema(ch32v003wake);
     OGJoinThread(ch32v003thread);
+    OGDeleteSema(ch32v003wake);
+    OGDeleteMutex(ch32v003lock);
+    ch32v003lock = NULL;
 }
 
 int ch32v003Resume()
 {
+    // The processor's thread may still be finishing its last slice, so wait for it before resetting
+    lockCh32v003();
     ResetPeripherals();
     memset(&ch32v003state, 0, sizeof(ch32v003state));
-    ch32v003runMode = 1;
+
+    // Memory may have been written by the last program, so decode it fresh
+    memset(decodedIr, 0, sizeof(decodedIr));
+    ramDecoded = false;
+
+    ch32v003runMode     = 1;
+    waitingForInterrupt = false;
+    unlockCh32v003();
+    if (!emulatorArgs.deterministic)
+    {
+        OGUnlockSema(ch32v003wake);
+    }
     return 0;
 }
 
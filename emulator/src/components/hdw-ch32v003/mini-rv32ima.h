@@ -68,6 +68,12 @@
     #define MINIRV32_ALIGNMENT 3
 #endif
 
+// Override to fetch instructions from somewhere other than the memory bus, like a predecode cache.
+// This may adjust pc, which is the address of the instruction being fetched.
+#ifndef MINIRV32_FETCH
+    #define MINIRV32_FETCH(ofs) MINIRV32_LOAD4(ofs)
+#endif
+
 // Override for vectored operation, etc.
 #ifndef MINIRV32_HANDLE_TRAP_PC
     #define MINIRV32_HANDLE_TRAP_PC pc = (CSR(mtvec) - 4);
@@ -195,7 +201,7 @@ MINIRV32_STEPPROTO
             }
             else
             {
-                ir = MINIRV32_LOAD4(ofs_pc);
+                ir = MINIRV32_FETCH(ofs_pc);
                 // printf( "PC: %08x IR: %08x  %08x / s0:%x s1:%x a0:%x/%x/%x/%x/%x/%x\n", ofs_pc, ir, REG(2), REG(8),
                 // REG(9), REG(10), REG(11), REG(12), REG(13), REG(14), REG(15) );
 
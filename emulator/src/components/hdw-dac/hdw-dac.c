@@ -4,15 +4,21 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include "hdw-dac.h"
 #include "hdw-dac_emu.h"
 #include "emu_main.h"
+#include "emu_args.h"
 
 //==============================================================================
 // Defines
 //==============================================================================
 
+/// The number of samples in the ring buffer, half a second. Must be a power of two
+#define DAC_RING_SIZE 8192
+
 //==============================================================================
 // Variables
 //==============================================================================
@@ -23,6 +29,52 @@ static fnDacCallback_t dacCb = NULL;
 static bool shutdownState    = false;
 static bool dacWriting       = false;
 
+/**
+ * Samples flow from the Swadge mode to the host audio through a single-producer, single-consumer ring. dacPoll() on
+ * the main loop is the only writer of ringHead, and dacHandleSoundOutput() on the audio thread is the only writer of
+ * ringTail, so neither side ever waits for the other. Both indices count up forever and are masked when used.
+ */
+static uint8_t ring[DAC_RING_SIZE];
+static atomic_uint_fast32_t ringHead = 0;
+static atomic_uint_fast32_t ringTail = 0;
+
+/**
+ * Where ringHead was when the DAC last stopped. Samples before this were made by a mode which has stopped or exited,
+ * so whichever side owns ringTail skips past them rather than playing them when the DAC starts again. This is only
+ * written while dacPoll() isn't producing, and ringTail keeps a single writer
+ */
+static atomic_uint_fast32_t ringFlushed = 0;
+
+/// The last sample played, repeated during an underrun so it doesn't click
+static uint8_t lastSample = 127;
+
+/// Underrun statistics, written by the audio thread
+static atomic_uint_fast32_t underruns     = 0;
+static atomic_uint_fast32_t missedSamples = 0;
+static atomic_uint_fast32_t minBuffered   = DAC_RING_SIZE;
+
+/**
+ * In batch and deterministic modes, samples are played as fake time passes instead of when the host asks for them.
+ * This is when they were last played
+ */
+static int64_t simPlayedUs = 0;
+
+/**
+ * In deterministic mode, dacPoll() copies the samples it plays here, and dacHandleSoundOutput() plays them to the host
+ * instead of taking them from the Swadge's ring, so the host's timing never changes when the DAC callback runs
+ */
+static uint8_t heardRing[DAC_RING_SIZE];
+static atomic_uint_fast32_t heardHead = 0;
+static atomic_uint_fast32_t heardTail = 0;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static void dacFlushRing(void);
+static uint32_t dacSkipFlushed(uint32_t tail);
+static void heardPush(uint32_t tail, uint32_t count);
+
 //==============================================================================
 // Functions
 //==============================================================================
@@ -51,6 +103,7 @@ void deinitDac(void)
     ESP_LOGI(DAC_TAG, " ");
     shutdownState = true;
     dacWriting    = false;
+    dacFlushRing();
 }
 
 /**
@@ -82,13 +135,40 @@ void dacStart(void)
 }
 
 /**
- * @brief TODO
- *
+ * @brief Stop the DAC, and drop any samples which are still buffered so they don't play when it starts again
  */
 void dacStop(void)
 {
     ESP_LOGI(DAC_TAG, " ");
     dacWriting = false;
+    dacFlushRing();
+}
+
+/**
+ * @brief Mark every sample in the ring as stale, and restart the fake time samples are played by. dacPoll() must not be
+ * producing when this is called
+ */
+static void dacFlushRing(void)
+{
+    atomic_store_explicit(&ringFlushed, atomic_load_explicit(&ringHead, memory_order_relaxed), memory_order_release);
+    simPlayedUs = 0;
+}
+
+/**
+ * @brief Move a ring tail past any samples which were buffered when the DAC last stopped
+ *
+ * @param tail The ring index of the next sample to play
+ * @return The ring index of the next sample which isn't stale
+ */
+static uint32_t dacSkipFlushed(uint32_t tail)
+{
+    uint32_t flushed = atomic_load_explicit(&ringFlushed, memory_order_acquire);
+    // The indices wrap, so compare the distance between them
+    if ((int32_t)(flushed - tail) > 0)
+    {
+        return flushed;
+    }
+    return tail;
 }
 
 /**
@@ -97,7 +177,89 @@ void dacStop(void)
 void dacPoll(void)
 {
     // In actual firmware, this function will fill sample buffers received in interrupts.
-    // In the emulator, that's handled in dacHandleSoundOutput() instead
+    // In the emulator, it keeps the ring buffer filled to the lead time ahead of the audio thread
+    if (NULL == dacCb || !dacWriting)
+    {
+        return;
+    }
+
+    uint32_t target = dacGetLeadSamples();
+    uint32_t head   = atomic_load_explicit(&ringHead, memory_order_relaxed);
+    uint32_t tail   = atomic_load_explicit(&ringTail, memory_order_acquire);
+
+    if (emulatorArgs.batch || emulatorArgs.deterministic)
+    {
+        // dacPoll() owns ringTail in these modes, so it drops the stale samples itself
+        tail = dacSkipFlushed(tail);
+        atomic_store_explicit(&ringTail, tail, memory_order_release);
+
+        // Play however many samples the Swadge would have in the time that passed, so the DAC callback runs at the
+        // same rate it would with sound, no matter when the host wants samples
+        int64_t now = esp_timer_get_time();
+        if (0 == simPlayedUs || now < simPlayedUs)
+        {
+            simPlayedUs = now;
+        }
+        uint64_t played = ((uint64_t)(now - simPlayedUs) * DAC_SAMPLE_RATE_HZ) / 1000000;
+        if (played)
+        {
+            // Keep the remainder, so the rate doesn't drift
+            simPlayedUs += (int64_t)(played * 1000000 / DAC_SAMPLE_RATE_HZ);
+            if (played > head - tail)
+            {
+                played = head - tail;
+            }
+
+            if (!emulatorArgs.batch)
+            {
+                heardPush(tail, played);
+            }
+
+            tail += played;
+            atomic_store_explicit(&ringTail, tail, memory_order_release);
+        }
+    }
+
+    while (head - tail + DAC_BUF_SIZE <= target)
+    {
+        // Fill at most one DMA buffer's worth at a time, without wrapping around the end of the ring
+        uint32_t start = head & (DAC_RING_SIZE - 1);
+        uint32_t len   = DAC_RING_SIZE - start;
+        if (len > DAC_BUF_SIZE)
+        {
+            len = DAC_BUF_SIZE;
+        }
+
+        dacCb(&ring[start], len);
+        head += len;
+
+        // Publish the samples to the audio thread
+        atomic_store_explicit(&ringHead, head, memory_order_release);
+        tail = atomic_load_explicit(&ringTail, memory_order_acquire);
+    }
+}
+
+/**
+ * @brief Copy samples which were played by fake time from the Swadge's ring for the host audio thread to play. If the
+ * host falls behind, the samples which don't fit are dropped
+ *
+ * @param tail The ring index of the first sample played
+ * @param count The number of samples played
+ */
+static void heardPush(uint32_t tail, uint32_t count)
+{
+    uint32_t head  = atomic_load_explicit(&heardHead, memory_order_relaxed);
+    uint32_t space = DAC_RING_SIZE - (head - atomic_load_explicit(&heardTail, memory_order_acquire));
+    if (count > space)
+    {
+        count = space;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        heardRing[(head + i) & (DAC_RING_SIZE - 1)] = ring[(tail + i) & (DAC_RING_SIZE - 1)];
+    }
+    atomic_store_explicit(&heardHead, head + count, memory_order_release);
 }
 
 /**
@@ -112,39 +274,121 @@ void dacHandleSoundOutput(short* out, int framesp, short numChannels)
     // Make sure there is a buffer to fill
     if (NULL != out)
     {
-        // Make sure there is a callback function to call
-        if (NULL != dacCb && dacWriting)
+        // Make sure there is a callback function filling the ring
+        if (NULL != dacCb && dacWriting && !shutdownState)
         {
-            // Get samples from the Swadge mode
-            uint8_t tempSamps[framesp];
-            dacCb(tempSamps, framesp);
+            // In deterministic mode, play what dacPoll() already played rather than taking from the Swadge's ring
+            const uint8_t* src            = ring;
+            atomic_uint_fast32_t* srcHead = &ringHead;
+            atomic_uint_fast32_t* srcTail = &ringTail;
+            if (emulatorArgs.deterministic)
+            {
+                src     = heardRing;
+                srcHead = &heardHead;
+                srcTail = &heardTail;
+            }
+
+            // Skip stale samples before loading the head, so the head is never behind the new tail
+            uint32_t tail = atomic_load_explicit(srcTail, memory_order_relaxed);
+            if (src == ring)
+            {
+                tail = dacSkipFlushed(tail);
+            }
+            uint32_t head     = atomic_load_explicit(srcHead, memory_order_acquire);
+            uint32_t buffered = head - tail;
+
+            if (buffered < atomic_load_explicit(&minBuffered, memory_order_relaxed))
+            {
+                atomic_store_explicit(&minBuffered, buffered, memory_order_relaxed);
+            }
+
+            // Only copy here. Anything the Swadge mode didn't produce in time is an underrun
+            int available = (buffered < (uint32_t)framesp) ? (int)buffered : framesp;
+            if (available < framesp)
+            {
+                atomic_fetch_add_explicit(&underruns, 1, memory_order_relaxed);
+                atomic_fetch_add_explicit(&missedSamples, framesp - available, memory_order_relaxed);
+            }
 
             // Write the samples to the emulator output, in signed short format
             for (int i = 0; i < framesp; i++)
             {
-                short samp = (tempSamps[i] - 127) * 256;
+                if (i < available)
+                {
+                    lastSample = src[(tail + i) & (DAC_RING_SIZE - 1)];
+                }
+                short samp = (lastSample - 127) * 256;
                 // Copy the same sample to each channel
                 for (int j = 0; j < numChannels; j++)
                 {
-                    if (shutdownState)
-                    {
-                        out[i * numChannels + j] = 0;
-                    }
-                    else
-                    {
-                        out[i * numChannels + j] = samp;
-                    }
+                    out[i * numChannels + j] = samp;
                 }
             }
+
+            // Give the space back to dacPoll()
+            atomic_store_explicit(srcTail, tail + available, memory_order_release);
         }
         else
         {
             // No callback function, write zeros
-            memset(out, 0, sizeof(short) * 2 * framesp);
+            memset(out, 0, sizeof(short) * numChannels * framesp);
+
+            // Drop the stale samples now, so dacPoll() has the whole ring when the DAC starts again
+            if (!emulatorArgs.deterministic)
+            {
+                atomic_store_explicit(&ringTail, dacSkipFlushed(atomic_load_explicit(&ringTail, memory_order_relaxed)),
+                                      memory_order_release);
+            }
         }
     }
 }
 
+/**
+ * @brief Get the number of samples dacPoll() keeps buffered ahead of the host audio, from the --audio-lead argument
+ *
+ * @return The lead time in samples
+ */
+uint32_t dacGetLeadSamples(void)
+{
+    uint32_t lead = emulatorArgs.audioLeadMs * DAC_SAMPLE_RATE_HZ / 1000;
+    if (lead < DAC_BUF_SIZE)
+    {
+        lead = DAC_BUF_SIZE;
+    }
+    else if (lead > DAC_RING_SIZE)
+    {
+        lead = DAC_RING_SIZE;
+    }
+    return lead;
+}
+
+/**
+ * @brief Get statistics about the audio ring buffer
+ *
+ * @param[out] stats The statistics are written here
+ */
+void dacGetRingStats(dacRingStats_t* stats)
+{
+    uint32_t head = atomic_load_explicit(&ringHead, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ringTail, memory_order_relaxed);
+
+    stats->buffered      = head - tail;
+    stats->lead          = dacGetLeadSamples();
+    stats->minBuffered   = atomic_load_explicit(&minBuffered, memory_order_relaxed);
+    stats->underruns     = atomic_load_explicit(&underruns, memory_order_relaxed);
+    stats->missedSamples = atomic_load_explicit(&missedSamples, memory_order_relaxed);
+}
+
+/**
+ * @brief Reset the audio underrun statistics
+ */
+void dacResetRingStats(void)
+{
+    atomic_store_explicit(&underruns, 0, memory_order_relaxed);
+    atomic_store_explicit(&missedSamples, 0, memory_order_relaxed);
+    atomic_store_explicit(&minBuffered, DAC_RING_SIZE, memory_order_relaxed);
+}
+
 /**
  * @brief Set the shutdown state of the DAC
  *
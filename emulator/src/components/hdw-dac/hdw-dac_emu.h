@@ -1,3 +1,25 @@
 #pragma once
 
+#include <stdint.h>
+
+/**
+ * @brief Statistics about the ring buffer between dacPoll() and the host audio
+ */
+typedef struct
+{
+    /// @brief The number of samples currently buffered
+    uint32_t buffered;
+    /// @brief The number of samples dacPoll() tries to keep buffered
+    uint32_t lead;
+    /// @brief The fewest samples buffered when the host audio asked for more
+    uint32_t minBuffered;
+    /// @brief The number of times the host audio asked for more samples than were buffered
+    uint32_t underruns;
+    /// @brief The total number of samples the host audio asked for which weren't buffered
+    uint32_t missedSamples;
+} dacRingStats_t;
+
 void dacHandleSoundOutput(short* out, int framesp, short numChannels);
+uint32_t dacGetLeadSamples(void);
+void dacGetRingStats(dacRingStats_t* stats);
+void dacResetRingStats(void);
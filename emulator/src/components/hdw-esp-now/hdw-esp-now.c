@@ -37,11 +37,15 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <math.h>
+#include <inttypes.h>
 
 #include "hdw-esp-now.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
 #include "emu_main.h"
+#include "emu_args.h"
+#include "esp_timer.h"
 
 #include "p2pConnection.h"
 
@@ -49,9 +53,63 @@
 // Defines
 //==============================================================================
 
-#define ESP_NOW_PORT  32888
 #define MAXRECVSTRING 1024 // Longest string to receive
 
+// Identifies emulator ESP-NOW frames, and changes if the frame header does
+#define ESP_NOW_MAGIC   "SWN1"
+#define ESP_NOW_MAX_LEN 250
+
+// Packets received but held back by the simulated latency
+#define RADIO_MAX_PENDING 64
+
+// Log-distance path loss model for RSSI: RSSI at 1m, and the path loss exponent for indoors with obstacles
+#define RADIO_RSSI_1M     -40.0f
+#define RADIO_PATH_LOSS_N 3.0f
+
+// Below RADIO_RSSI_FADE packets start getting lost, and below RADIO_RSSI_MIN they all are
+#define RADIO_RSSI_FADE -85.0f
+#define RADIO_RSSI_MIN  -95.0f
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief The header at the start of every emulated ESP-NOW frame. Multi-byte fields are in network byte order
+ */
+typedef struct __attribute__((packed))
+{
+    /// @brief ::ESP_NOW_MAGIC, without the null terminator
+    char magic[4];
+    /// @brief The sender's MAC address
+    uint8_t srcMac[6];
+    /// @brief The sender's X position, in centimeters
+    int32_t posX;
+    /// @brief The sender's Y position, in centimeters
+    int32_t posY;
+} espNowFrameHdr_t;
+
+/**
+ * @brief A received packet waiting for its simulated delivery time
+ */
+typedef struct
+{
+    int64_t deliverUs;
+    uint8_t srcMac[6];
+    int8_t rssi;
+    uint8_t len;
+    uint8_t data[ESP_NOW_MAX_LEN];
+} radioPacket_t;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static uint32_t radioRand(void);
+static bool radioChance(float pct);
+static void radioReceive(const uint8_t* frame, int frameLen, const uint8_t* ourMac);
+static void radioQueue(const espNowFrameHdr_t* hdr, const uint8_t* data, uint8_t len, int8_t rssi);
+
 //==============================================================================
 // Variables
 //==============================================================================
@@ -61,6 +119,18 @@ hostEspNowSendCb_t hostEspNowSendCb = NULL;
 
 int socketFd;
 
+/// Received packets waiting to be delivered, in no particular order
+static radioPacket_t radioPending[RADIO_MAX_PENDING];
+static int radioNumPending = 0;
+
+/// State for the channel model's random numbers, kept apart from esp_random() so seeded runs stay reproducible
+static uint32_t radioRandState = 0;
+
+/// Channel statistics, logged when ESP-NOW is deinitialized
+static uint32_t radioRxCount   = 0;
+static uint32_t radioLostCount = 0;
+static uint32_t radioDupCount  = 0;
+
 //==============================================================================
 // Functions
 //==============================================================================
@@ -85,6 +155,12 @@ esp_err_t initEspNow(hostEspNowRecvCb_t recvCb, hostEspNowSendCb_t sendCb, gpio_
     hostEspNowRecvCb = recvCb;
     hostEspNowSendCb = sendCb;
 
+    // Seed the channel model from the MAC, so each instance gets different but repeatable losses
+    uint8_t mac[6] = {0};
+    getMacAddrNvs(mac);
+    radioRandState  = 0x9E3779B9 ^ ((uint32_t)mac[2] << 24 | mac[3] << 16 | mac[4] << 8 | mac[5]);
+    radioNumPending = 0;
+
 #if defined(USING_WINDOWS)
     // Initialize Winsock
     WSADATA wsaData;
@@ -132,8 +208,14 @@ esp_err_t initEspNow(hostEspNowRecvCb_t recvCb, hostEspNowSendCb_t sendCb, gpio_
         return ESP_ERR_WIFI_IF;
     }
 #else
-    int optval_enable = 1;
-    setsockopt(socketFd, SOL_SOCKET, O_NONBLOCK, (char*)&optval_enable, sizeof(optval_enable));
+    // O_NONBLOCK is a file flag, not a socket option. Without it every recvfrom() waits for SO_RCVTIMEO, which stalls
+    // batch mode and fake time, where frames are meant to take no real time
+    int flags = fcntl(socketFd, F_GETFL, 0);
+    if (flags < 0 || fcntl(socketFd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        ESP_LOGE("WIFI", "fcntl() failed");
+        return ESP_ERR_WIFI_IF;
+    }
 #endif
 
     // Set nonblocking timeout
@@ -144,10 +226,10 @@ esp_err_t initEspNow(hostEspNowRecvCb_t recvCb, hostEspNowSendCb_t sendCb, gpio_
 
     // Construct bind structure
     struct sockaddr_in broadcastAddr;                    // Broadcast Address
-    memset(&broadcastAddr, 0, sizeof(broadcastAddr));    // Zero out structure
-    broadcastAddr.sin_family      = AF_INET;             // Internet address family
-    broadcastAddr.sin_addr.s_addr = htonl(INADDR_ANY);   // Any incoming interface
-    broadcastAddr.sin_port        = htons(ESP_NOW_PORT); // Broadcast port
+    memset(&broadcastAddr, 0, sizeof(broadcastAddr));               // Zero out structure
+    broadcastAddr.sin_family      = AF_INET;                        // Internet address family
+    broadcastAddr.sin_addr.s_addr = htonl(INADDR_ANY);              // Any incoming interface
+    broadcastAddr.sin_port        = htons(emulatorArgs.espNowPort); // Broadcast port
 
     // Bind to the broadcast port
     if (bind(socketFd, (struct sockaddr*)&broadcastAddr, sizeof(broadcastAddr)) < 0)
@@ -220,42 +302,166 @@ esp_err_t espNowPostLightSleep(void)
 /**
  * Check the ESP NOW receive queue. If there are any received packets, send
  * them to hostEspNowRecvCb()
+ *
+ * Packets are first read from the socket and passed through the simulated channel, which may drop, duplicate, or
+ * delay them. Then every packet whose delivery time has passed is sent to the application, oldest first.
  */
 void checkEspNowRxQueue(void)
 {
-    char recvString[MAXRECVSTRING + 1]; // Buffer for received string
-    int recvStringLen;                  // Length of received string
+    uint8_t recvFrame[MAXRECVSTRING]; // Buffer for received frame
+    int recvFrameLen;                 // Length of received frame
+
+    uint8_t ourMac[6] = {0};
+    getMacAddrNvs(ourMac);
 
     // While we've received a packet
-    while ((recvStringLen = recvfrom(socketFd, recvString, MAXRECVSTRING, 0, NULL, 0)) > 0)
+    while ((recvFrameLen = recvfrom(socketFd, (char*)recvFrame, sizeof(recvFrame), 0, NULL, 0)) > 0)
+    {
+        radioReceive(recvFrame, recvFrameLen, ourMac);
+    }
+
+    // Deliver due packets in order
+    int64_t now = esp_timer_get_time();
+    while (radioNumPending > 0)
     {
-        // If the packet matches the ESP_NOW format
-        uint8_t recvMac[6] = {0};
-        if (6
-            == sscanf(recvString, "ESP_NOW-%02hhX%02hhX%02hhX%02hhX%02hhX%02hhX-", &recvMac[0], &recvMac[1],
-                      &recvMac[2], &recvMac[3], &recvMac[4], &recvMac[5]))
+        int next = 0;
+        for (int i = 1; i < radioNumPending; i++)
         {
-            // Make sure the MAC differs from our own
-            uint8_t ourMac[6] = {0};
-            getMacAddrNvs(ourMac);
-            if (0 != memcmp(recvMac, ourMac, sizeof(ourMac)))
+            if (radioPending[i].deliverUs < radioPending[next].deliverUs)
             {
-                // Set up the receive info
-                esp_now_recv_info_t espNowInfo = {0};
-                espNowInfo.src_addr            = recvMac;
-                espNowInfo.des_addr            = ourMac;
-
-                wifi_pkt_rx_ctrl_t packetRxCtrl = {0};
-                packetRxCtrl.rssi               = 0x7F;
-                espNowInfo.rx_ctrl              = &packetRxCtrl;
-
-                // If it does, send it to the application through the callback
-                hostEspNowRecvCb(&espNowInfo, (uint8_t*)&recvString[21], recvStringLen - 21, packetRxCtrl.rssi);
+                next = i;
             }
         }
+
+        if (radioPending[next].deliverUs > now)
+        {
+            break;
+        }
+
+        // Copy the packet out and remove it before the callback, which may send more packets
+        radioPacket_t pkt  = radioPending[next];
+        radioPending[next] = radioPending[--radioNumPending];
+
+        // Set up the receive info
+        esp_now_recv_info_t espNowInfo = {0};
+        espNowInfo.src_addr            = pkt.srcMac;
+        espNowInfo.des_addr            = ourMac;
+
+        wifi_pkt_rx_ctrl_t packetRxCtrl = {0};
+        packetRxCtrl.rssi               = pkt.rssi;
+        espNowInfo.rx_ctrl              = &packetRxCtrl;
+
+        // Send it to the application through the callback
+        hostEspNowRecvCb(&espNowInfo, pkt.data, pkt.len, pkt.rssi);
+    }
+}
+
+/**
+ * @brief Validate a frame from the socket and pass it through the simulated channel
+ *
+ * @param frame The received frame, starting with an ::espNowFrameHdr_t
+ * @param frameLen The length of the frame
+ * @param ourMac This Swadge's MAC address, so our own broadcasts can be ignored
+ */
+static void radioReceive(const uint8_t* frame, int frameLen, const uint8_t* ourMac)
+{
+    espNowFrameHdr_t hdr;
+    int dataLen = frameLen - (int)sizeof(hdr);
+    if (dataLen < 0 || dataLen > ESP_NOW_MAX_LEN)
+    {
+        return;
+    }
+    memcpy(&hdr, frame, sizeof(hdr));
+
+    // Make sure it's an ESP-NOW frame and the MAC differs from our own
+    if (0 != memcmp(hdr.magic, ESP_NOW_MAGIC, sizeof(hdr.magic)) || 0 == memcmp(hdr.srcMac, ourMac, 6))
+    {
+        return;
+    }
+    radioRxCount++;
+
+    // Derive RSSI from the distance between the two Swadges, never closer than 1m
+    float dx       = (int32_t)ntohl(hdr.posX) / 100.0f - emulatorArgs.radioX;
+    float dy       = (int32_t)ntohl(hdr.posY) / 100.0f - emulatorArgs.radioY;
+    float distance = fmaxf(1.0f, sqrtf(dx * dx + dy * dy));
+    float rssi     = RADIO_RSSI_1M - 10.0f * RADIO_PATH_LOSS_N * log10f(distance);
+
+    // Weak signals fade out linearly between RADIO_RSSI_FADE and RADIO_RSSI_MIN, on top of the receiver-wide loss
+    float fadePct = 0;
+    if (rssi < RADIO_RSSI_FADE)
+    {
+        fadePct = fminf(100.0f, 100.0f * (RADIO_RSSI_FADE - rssi) / (RADIO_RSSI_FADE - RADIO_RSSI_MIN));
+    }
+
+    if (radioChance(emulatorArgs.radioRxLossPct) || radioChance(fadePct))
+    {
+        radioLostCount++;
+        return;
+    }
+
+    radioQueue(&hdr, &frame[sizeof(hdr)], dataLen, (int8_t)fmaxf(rssi, -127.0f));
+    if (radioChance(emulatorArgs.radioRxDupPct))
+    {
+        radioDupCount++;
+        radioQueue(&hdr, &frame[sizeof(hdr)], dataLen, (int8_t)fmaxf(rssi, -127.0f));
     }
 }
 
+/**
+ * @brief Hold a received packet until its simulated latency and jitter have passed
+ *
+ * @param hdr The frame header of the packet
+ * @param data The packet payload
+ * @param len The length of the payload
+ * @param rssi The simulated RSSI of the packet
+ */
+static void radioQueue(const espNowFrameHdr_t* hdr, const uint8_t* data, uint8_t len, int8_t rssi)
+{
+    if (radioNumPending >= RADIO_MAX_PENDING)
+    {
+        // A real receive queue would overflow too
+        radioLostCount++;
+        return;
+    }
+
+    float delayMs = emulatorArgs.radioRxDelayMs;
+    if (emulatorArgs.radioRxJitterMs > 0)
+    {
+        delayMs += emulatorArgs.radioRxJitterMs * (radioRand() / (float)UINT32_MAX);
+    }
+
+    radioPacket_t* pkt = &radioPending[radioNumPending++];
+    pkt->deliverUs     = esp_timer_get_time() + (int64_t)(delayMs * 1000.0f);
+    pkt->rssi          = rssi;
+    pkt->len           = len;
+    memcpy(pkt->srcMac, hdr->srcMac, sizeof(pkt->srcMac));
+    memcpy(pkt->data, data, len);
+}
+
+/**
+ * @brief Get a random number for the channel model, using xorshift32
+ *
+ * @return A random number
+ */
+static uint32_t radioRand(void)
+{
+    radioRandState ^= radioRandState << 13;
+    radioRandState ^= radioRandState >> 17;
+    radioRandState ^= radioRandState << 5;
+    return radioRandState;
+}
+
+/**
+ * @brief Roll for a channel event
+ *
+ * @param pct The percent chance of the event, from 0 to 100
+ * @return true if the event happens
+ */
+static bool radioChance(float pct)
+{
+    return (pct > 0) && (radioRand() % 10000) < (uint32_t)(pct * 100.0f);
+}
+
 /**
  * This is a wrapper for esp_now_send(). It also sets the wifi power with
  * wifi_set_user_fixed_rate()
@@ -268,30 +474,39 @@ void espNowSend(const char* data, uint8_t dataLen)
     struct sockaddr_in broadcastAddr; // Broadcast address
 
     // Construct local address structure
-    memset(&broadcastAddr, 0, sizeof(broadcastAddr));    // Zero out structure
-    broadcastAddr.sin_family      = AF_INET;             // Internet address family
-    broadcastAddr.sin_addr.s_addr = htonl(0x7FFFFFFF);   // Local broadcast IP address, 127.255.255.255
-    broadcastAddr.sin_port        = htons(ESP_NOW_PORT); // Broadcast port
-
-    // Tack on ESP-NOW header and randomized MAC address
-    char espNowPacket[dataLen + 24];
-    uint8_t mac[6] = {0};
-    getMacAddrNvs(mac);
-    sprintf(espNowPacket, "ESP_NOW-%02X%02X%02X%02X%02X%02X-", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-    int hdrLen = strlen(espNowPacket);
-    memcpy(&espNowPacket[hdrLen], data, dataLen);
+    memset(&broadcastAddr, 0, sizeof(broadcastAddr));               // Zero out structure
+    broadcastAddr.sin_family      = AF_INET;                        // Internet address family
+    broadcastAddr.sin_addr.s_addr = htonl(0x7FFFFFFF);              // Local broadcast IP address, 127.255.255.255
+    broadcastAddr.sin_port        = htons(emulatorArgs.espNowPort); // Broadcast port
 
     // For the callback
     uint8_t bcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
+    if (dataLen > ESP_NOW_MAX_LEN)
+    {
+        ESP_LOGE("WIFI", "Can't send %d bytes, ESP-NOW packets are at most %d", dataLen, ESP_NOW_MAX_LEN);
+        hostEspNowSendCb(bcastMac, ESP_NOW_SEND_FAIL);
+        return;
+    }
+
+    // Tack on the binary header with our MAC address and position
+    uint8_t espNowPacket[sizeof(espNowFrameHdr_t) + dataLen];
+    espNowFrameHdr_t hdr;
+    memcpy(hdr.magic, ESP_NOW_MAGIC, sizeof(hdr.magic));
+    getMacAddrNvs(hdr.srcMac);
+    hdr.posX = htonl((int32_t)lroundf(emulatorArgs.radioX * 100.0f));
+    hdr.posY = htonl((int32_t)lroundf(emulatorArgs.radioY * 100.0f));
+    memcpy(espNowPacket, &hdr, sizeof(hdr));
+    memcpy(&espNowPacket[sizeof(hdr)], data, dataLen);
+    int frameLen = sizeof(hdr) + dataLen;
+
     errno = 0;
     // Send the packet
-    int sentLen
-        = sendto(socketFd, espNowPacket, hdrLen + dataLen, 0, (struct sockaddr*)&broadcastAddr, sizeof(broadcastAddr));
-    if (sentLen != (hdrLen + dataLen))
+    int sentLen = sendto(socketFd, (const char*)espNowPacket, frameLen, 0, (struct sockaddr*)&broadcastAddr,
+                         sizeof(broadcastAddr));
+    if (sentLen != frameLen)
     {
-        ESP_LOGE("WIFI", "sendto() sent a different number of bytes than expected: %d, not %d", sentLen,
-                 hdrLen + dataLen);
+        ESP_LOGE("WIFI", "sendto() sent a different number of bytes than expected: %d, not %d", sentLen, frameLen);
         if (errno != 0)
         {
             ESP_LOGE("WIFI", "errno was: %d", errno);
@@ -310,6 +525,16 @@ void espNowSend(const char* data, uint8_t dataLen)
  */
 void deinitEspNow(void)
 {
+    if (radioRxCount)
+    {
+        ESP_LOGI("WIFI", "Simulated radio: %" PRIu32 " packets received, %" PRIu32 " lost, %" PRIu32 " duplicated",
+                 radioRxCount, radioLostCount, radioDupCount);
+    }
+    radioRxCount    = 0;
+    radioLostCount  = 0;
+    radioDupCount   = 0;
+    radioNumPending = 0;
+
     close(socketFd);
 #if defined(USING_WINDOWS)
     WSACleanup();
@@ -3,9 +3,11 @@
 //==============================================================================
 
 #include <esp_log.h>
+#include <esp_timer.h>
 #include "hdw-mic.h"
 #include "hdw-mic_emu.h"
 #include "emu_main.h"
+#include "emu_args.h"
 
 //==============================================================================
 // Defines
@@ -13,6 +15,9 @@
 
 #define SSBUF 8192
 
+/// A 12-bit sample of silence, the midpoint of the ADC's range
+#define SILENT_SAMPLE ((0 + INT16_MAX) >> 4)
+
 //==============================================================================
 // Variables
 //==============================================================================
@@ -23,6 +28,10 @@ static int sshead               = 0;
 static int sstail               = 0;
 static bool adcSampling         = false;
 
+/// In deterministic mode the host's microphone is ignored and silence is sampled as fake time passes. This is when the
+/// last sample was taken
+static int64_t simSampledUs = 0;
+
 static const char MIC_TAG[] = "MIC";
 
 //==============================================================================
@@ -66,7 +75,8 @@ void powerUpMic(void)
 void startMic(void)
 {
     ESP_LOGI(MIC_TAG, " ");
-    adcSampling = true;
+    adcSampling  = true;
+    simSampledUs = 0;
 }
 
 /**
@@ -79,6 +89,26 @@ void startMic(void)
  */
 uint32_t loopMic(uint16_t* outSamples, uint32_t outSamplesMax)
 {
+    if (emulatorArgs.deterministic && adcSampling)
+    {
+        // Sample however much silence the ADC would have in the time that passed, so the audio callback runs at the
+        // same rate every run
+        int64_t now = esp_timer_get_time();
+        if (0 == simSampledUs || now < simSampledUs)
+        {
+            simSampledUs = now;
+        }
+        uint64_t sampled = ((uint64_t)(now - simSampledUs) * ADC_SAMPLE_RATE_HZ) / 1000000;
+
+        // Keep the remainder, so the rate doesn't drift
+        simSampledUs += (int64_t)(sampled * 1000000 / ADC_SAMPLE_RATE_HZ);
+        while (sampled-- && sstail != ((sshead + 1) % SSBUF))
+        {
+            ssamples[sshead] = SILENT_SAMPLE;
+            sshead           = (sshead + 1) % SSBUF;
+        }
+    }
+
     uint32_t samplesRead = 0;
     while (adcSampling && (sshead != sstail) && samplesRead < outSamplesMax)
     {
@@ -116,8 +146,8 @@ void deinitMic(void)
  */
 void micHandleSoundInput(short* in, int framesr, short numChannels)
 {
-    // If there are samples to read
-    if (adcSampling && framesr)
+    // If there are samples to read. In deterministic mode, loopMic() samples silence instead
+    if (adcSampling && framesr && !emulatorArgs.deterministic)
     {
         // For each sample
         for (int i = 0; i < framesr; i++)
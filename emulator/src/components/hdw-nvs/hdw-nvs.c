@@ -17,9 +17,12 @@
 #include "hdw-nvs_emu.h"
 #include "cJSON.h"
 #include "emu_main.h"
+#include "emu_args.h"
 #include "emu_utils.h"
 #include "hashMap.h"
+#include "macros.h"
 #include "esp_heap_caps.h"
+#include "esp_heap_caps_emu.h"
 
 //==============================================================================
 // Defines
@@ -32,6 +35,15 @@
 #define NVS_ENTRY_BYTES      32
 #define NVS_OVERHEAD_ENTRIES 12
 
+// The journal is folded back into the JSON file after this many writes, or when NVS is deinitialized
+#define NVS_JOURNAL_COMPACT_ENTRIES 256
+
+#define NVS_JOURNAL_SUFFIX ".journal"
+#define NVS_TMP_SUFFIX     ".tmp"
+
+#define NVS_JOURNAL_SET   "S"
+#define NVS_JOURNAL_ERASE "E"
+
 //==============================================================================
 // Structs
 //==============================================================================
@@ -48,6 +60,17 @@ typedef struct
     };
 } emuNvsInjectedData_t;
 
+/**
+ * @brief An entry in the index of the in-memory NVS store, pointing at a value in ::nvsJson
+ */
+typedef struct
+{
+    /// @brief The value, owned by its namespace object in ::nvsJson
+    cJSON* item;
+    /// @brief The "namespace:key" string this entry is indexed by
+    char fullKey[];
+} emuNvsIndexEntry_t;
+
 //==============================================================================
 // Function Prototypes
 //==============================================================================
@@ -55,7 +78,16 @@ typedef struct
 static char* blobToStr(const void* value, size_t length);
 static int hexCharToInt(char c);
 static void strToBlob(char* str, void* outBlob, size_t blobLen);
-static FILE* openNvsFile(const char* mode);
+static bool loadNvsStore(void);
+static void unloadNvsStore(void);
+static void replayNvsJournal(void);
+static bool compactNvsStore(void);
+static bool appendNvsJournal(const char* op, const char* namespace, const char* key, const cJSON* value);
+static cJSON* getNvsNamespace(const char* namespace, bool create);
+static cJSON* getNvsItem(const char* namespace, const char* key);
+static void setNvsItem(const char* namespace, const char* key, cJSON* value);
+static void indexNvsItem(const char* namespace, const char* key, cJSON* item);
+static bool eraseNvsItem(const char* namespace, const char* key);
 static size_t emuGetInjectedBlobLength(const char* namespace, const char* key);
 static void* emuGetInjectedBlob(const char* namespace, const char* key);
 static bool emuGetInjected32(const char* namespace, const char* key, int32_t* out);
@@ -79,10 +111,26 @@ static const char* defaultNvsFiles[] = {
 //==============================================================================
 // Variables
 //==============================================================================
+/// The file given with --nvs-file, which is used instead of the defaults
+static const char* customNvsFile[1] = {NULL};
+
 static const char** nvsFileName = defaultNvsFiles;
 static bool nvsInjectedDataInit = false;
 static hashMap_t nvsInjectedData;
 
+/// The whole NVS file, parsed once when NVS is initialized, and kept in sync with every write
+static cJSON* nvsJson = NULL;
+/// An index of emuNvsIndexEntry_t for every value in ::nvsJson, keyed by "namespace:key"
+static hashMap_t nvsIndex;
+/// The expanded path to the NVS JSON file
+static char nvsFilePath[1024];
+/// The expanded path to the journal of writes which haven't been compacted into the NVS JSON file yet
+static char nvsJournalPath[1024 + sizeof(NVS_JOURNAL_SUFFIX)];
+/// The open journal file, appended to with every write
+static FILE* nvsJournal = NULL;
+/// The number of writes in the journal since it was last compacted
+static int nvsJournalEntries = 0;
+
 //==============================================================================
 // Functions
 //==============================================================================
@@ -98,13 +146,24 @@ bool initNvs(bool firstTry)
 {
     if (!nvsInjectedDataInit)
     {
+        emuHeapBeginEmulatorAllocs();
         hashInit(&nvsInjectedData, 16);
+        emuHeapEndEmulatorAllocs();
         nvsInjectedDataInit = true;
     }
 
+    const char** nvsFiles = defaultNvsFiles;
+    size_t numNvsFiles    = ARRAY_SIZE(defaultNvsFiles);
+    if (emulatorArgs.nvsFile)
+    {
+        // Only use the given file, so separate emulators don't share one
+        customNvsFile[0] = emulatorArgs.nvsFile;
+        nvsFiles         = customNvsFile;
+        numNvsFiles      = 1;
+    }
+
     const char** curFile;
-    for (curFile = defaultNvsFiles; curFile < (defaultNvsFiles + (sizeof(defaultNvsFiles) / sizeof(*defaultNvsFiles)));
-         curFile++)
+    for (curFile = nvsFiles; curFile < nvsFiles + numNvsFiles; curFile++)
     {
         char expanded[1024];
         expandPath(expanded, sizeof(expanded), *curFile);
@@ -145,7 +204,7 @@ bool initNvs(bool firstTry)
                         fclose(nvsFile);
                         nvsFileName = curFile;
                         printf("Using NVS file %s\n", *nvsFileName);
-                        return true;
+                        return loadNvsStore();
                     }
                     else
                     {
@@ -160,7 +219,7 @@ bool initNvs(bool firstTry)
             // File exists
             nvsFileName = curFile;
             printf("Using NVS file %s\n", *nvsFileName);
-            return true;
+            return loadNvsStore();
         }
 
         printf("Could not load NVS file %s\n", *curFile);
@@ -187,7 +246,11 @@ bool deinitNvs(void)
         hashDeinit(&nvsInjectedData);
         nvsInjectedDataInit = false;
     }
-    return true; // Nothing to do
+
+    // Fold the journal back into the JSON file before exiting
+    bool ok = (NULL == nvsJson) || compactNvsStore();
+    unloadNvsStore();
+    return ok;
 }
 
 /**
@@ -197,6 +260,14 @@ bool deinitNvs(void)
  */
 bool eraseNvs(void)
 {
+    unloadNvsStore();
+
+    // The journal must go too, or it would be replayed over the fresh file
+    if (0 == access(nvsJournalPath, F_OK) && 0 != remove(nvsJournalPath))
+    {
+        return false;
+    }
+
     // Check if the json file exists
     if (access(NVS_JSON_FILE, F_OK) != 0)
     {
@@ -257,66 +328,12 @@ bool readNamespaceNvs32(const char* namespace, const char* key, int32_t* outVal)
         return true;
     }
 
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
+    cJSON* item = getNvsItem(namespace, key);
+    if (NULL != item)
     {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        if (fsize == 0)
-        {
-            fclose(nvsFile);
-            return false;
-        }
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
-        {
-            // Close the file
-            fclose(nvsFile);
-
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
-            cJSON* jsonIter;
-
-            if (!json)
-            {
-                return false;
-            }
-
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
-
-            if (cJSON_IsObject(jsonNs))
-            {
-                // Find the requested key
-                char* current_key = NULL;
-                cJSON_ArrayForEach(jsonIter, jsonNs)
-                {
-                    current_key = jsonIter->string;
-                    if (current_key != NULL)
-                    {
-                        // If the key matches
-                        if (0 == strcmp(current_key, key))
-                        {
-                            // Return the value
-                            *outVal = (int32_t)cJSON_GetNumberValue(jsonIter);
-                            cJSON_Delete(json);
-                            return true;
-                        }
-                    }
-                }
-            }
-            cJSON_Delete(json);
-        }
-        else
-        {
-            fclose(nvsFile);
-        }
+        // Return the value
+        *outVal = (int32_t)cJSON_GetNumberValue(item);
+        return true;
     }
     return false;
 }
@@ -331,86 +348,14 @@ bool readNamespaceNvs32(const char* namespace, const char* key, int32_t* outVal)
  */
 bool writeNamespaceNvs32(const char* namespace, const char* key, int32_t val)
 {
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
-    {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
-        {
-            // Close the file
-            fclose(nvsFile);
-
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
-
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
-
-            if (NULL == jsonNs)
-            {
-                jsonNs = cJSON_CreateObject();
-                cJSON_AddItemToObject(json, namespace, jsonNs);
-            }
-
-            // Check if the key alredy exists
-            cJSON* jsonIter;
-            bool keyExists = false;
-            cJSON_ArrayForEach(jsonIter, jsonNs)
-            {
-                if (0 == strcmp(jsonIter->string, key))
-                {
-                    keyExists = true;
-                }
-            }
-
-            // Add or replace the item
-            cJSON* jsonVal = cJSON_CreateNumber(val);
-            if (keyExists)
-            {
-                cJSON_ReplaceItemInObject(jsonNs, key, jsonVal);
-            }
-            else
-            {
-                cJSON_AddItemToObject(jsonNs, key, jsonVal);
-            }
-
-            // Write the new JSON back to the file
-            FILE* nvsFileW = openNvsFile("wb");
-            if (NULL != nvsFileW)
-            {
-                char* jsonStr = cJSON_Print(json);
-                fprintf(nvsFileW, "%s", jsonStr);
-                fclose(nvsFileW);
-
-                free(jsonStr);
-                cJSON_Delete(json);
-
-                return true;
-            }
-            else
-            {
-                // Couldn't open file to write
-            }
-            cJSON_Delete(json);
-        }
-        else
-        {
-            // Couldn't read file
-            fclose(nvsFile);
-        }
-    }
-    else
+    if (NULL == nvsJson)
     {
-        // couldn't open file to read
+        return false;
     }
-    return false;
+
+    cJSON* jsonVal = cJSON_CreateNumber(val);
+    setNvsItem(namespace, key, jsonVal);
+    return appendNvsJournal(NVS_JOURNAL_SET, namespace, key, jsonVal);
 }
 
 /**
@@ -442,66 +387,27 @@ bool readNamespaceNvsBlob(const char* namespace, const char* key, void* out_valu
         return true;
     }
 
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
+    cJSON* item = getNvsItem(namespace, key);
+    if (NULL != item)
     {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
+        // Return the value
+        char* strBlob = cJSON_GetStringValue(item);
+        if (NULL == strBlob)
         {
-            // Close the file
-            fclose(nvsFile);
-
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
-            cJSON* jsonIter;
-
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
-
-            if (NULL != jsonNs && cJSON_IsObject(jsonNs))
-            {
-                // Find the requested key
-                char* current_key = NULL;
-                cJSON_ArrayForEach(jsonIter, jsonNs)
-                {
-                    current_key = jsonIter->string;
-                    if (current_key != NULL)
-                    {
-                        // If the key matches
-                        if (0 == strcmp(current_key, key))
-                        {
-                            // Return the value
-                            char* strBlob = cJSON_GetStringValue(jsonIter);
+            return false;
+        }
 
-                            if (out_value != NULL)
-                            {
-                                // The call to read, using returned length
-                                strToBlob(strBlob, out_value, *length);
-                            }
-                            else
-                            {
-                                // The call to get length of blob
-                                *length = strlen(strBlob) / 2;
-                            }
-                            cJSON_Delete(json);
-                            return true;
-                        }
-                    }
-                }
-            }
-            cJSON_Delete(json);
+        if (out_value != NULL)
+        {
+            // The call to read, using returned length
+            strToBlob(strBlob, out_value, *length);
         }
         else
         {
-            fclose(nvsFile);
+            // The call to get length of blob
+            *length = strlen(strBlob) / 2;
         }
+        return true;
     }
     return false;
 }
@@ -517,88 +423,16 @@ bool readNamespaceNvsBlob(const char* namespace, const char* key, void* out_valu
  */
 bool writeNamespaceNvsBlob(const char* namespace, const char* key, const void* value, size_t length)
 {
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
-    {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
-        {
-            // Close the file
-            fclose(nvsFile);
-
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
-
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
-
-            if (NULL == jsonNs)
-            {
-                jsonNs = cJSON_CreateObject();
-                cJSON_AddItemToObject(json, namespace, jsonNs);
-            }
-
-            // Check if the key alredy exists
-            cJSON* jsonIter;
-            bool keyExists = false;
-            cJSON_ArrayForEach(jsonIter, jsonNs)
-            {
-                if (0 == strcmp(jsonIter->string, key))
-                {
-                    keyExists = true;
-                }
-            }
-
-            // Add or replace the item
-            char* blobStr  = blobToStr(value, length);
-            cJSON* jsonVal = cJSON_CreateString(blobStr);
-            free(blobStr);
-            if (keyExists)
-            {
-                cJSON_ReplaceItemInObject(jsonNs, key, jsonVal);
-            }
-            else
-            {
-                cJSON_AddItemToObject(jsonNs, key, jsonVal);
-            }
-
-            // Write the new JSON back to the file
-            FILE* nvsFileW = openNvsFile("wb");
-            if (NULL != nvsFileW)
-            {
-                char* jsonStr = cJSON_Print(json);
-                fprintf(nvsFileW, "%s", jsonStr);
-                fclose(nvsFileW);
-
-                free(jsonStr);
-                cJSON_Delete(json);
-
-                return true;
-            }
-            else
-            {
-                // Couldn't open file to write
-            }
-            cJSON_Delete(json);
-        }
-        else
-        {
-            // Couldn't read file
-            fclose(nvsFile);
-        }
-    }
-    else
+    if (NULL == nvsJson)
     {
-        // couldn't open file to read
+        return false;
     }
-    return false;
+
+    char* blobStr  = blobToStr(value, length);
+    cJSON* jsonVal = cJSON_CreateString(blobStr);
+    free(blobStr);
+    setNvsItem(namespace, key, jsonVal);
+    return appendNvsJournal(NVS_JOURNAL_SET, namespace, key, jsonVal);
 }
 
 /**
@@ -650,79 +484,11 @@ bool eraseNvsKey(const char* key)
  */
 bool eraseNamespaceNvsKey(const char* namespace, const char* key)
 {
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
-    {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
-        {
-            // Close the file
-            fclose(nvsFile);
-
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
-
-            // Check if the key exists
-            cJSON* jsonIter;
-            bool keyExists = false;
-
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
-
-            if (NULL != jsonNs)
-            {
-                cJSON_ArrayForEach(jsonIter, jsonNs)
-                {
-                    if (0 == strcmp(jsonIter->string, key))
-                    {
-                        keyExists = true;
-                    }
-                }
-            }
-
-            // Remove the key if it exists
-            if (keyExists)
-            {
-                cJSON_DeleteItemFromObject(jsonNs, key);
-            }
-
-            // Write the new JSON back to the file
-            FILE* nvsFileW = openNvsFile("wb");
-            if (NULL != nvsFileW)
-            {
-                char* jsonStr = cJSON_Print(json);
-                fprintf(nvsFileW, "%s", jsonStr);
-                fclose(nvsFileW);
-
-                free(jsonStr);
-                cJSON_Delete(json);
-
-                return keyExists;
-            }
-            else
-            {
-                // Couldn't open file to write
-            }
-            cJSON_Delete(json);
-        }
-        else
-        {
-            // Couldn't read file
-            fclose(nvsFile);
-        }
-    }
-    else
+    if (!eraseNvsItem(namespace, key))
     {
-        // couldn't open file to read
+        return false;
     }
-    return false;
+    return appendNvsJournal(NVS_JOURNAL_ERASE, namespace, key, NULL);
 }
 
 /**
@@ -734,93 +500,71 @@ bool eraseNamespaceNvsKey(const char* namespace, const char* key)
  */
 bool readNvsStats(nvs_stats_t* outStats)
 {
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
-    {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
-        {
-            // Close the file
-            fclose(nvsFile);
+    if (NULL == nvsJson)
+    {
+        return false;
+    }
 
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
-            cJSON* jsonIter;
-            cJSON* namespace;
+    cJSON* jsonIter;
+    cJSON* namespace;
 
-            cJSON_ArrayForEach(namespace, json)
+    cJSON_ArrayForEach(namespace, nvsJson)
+    {
+        // 1 entry is always used by each namespace, and there should only ever be 1 namespace
+        outStats->used_entries++;
+        // TODO: I just checked a Swadge and it said it was using 5 namespaces. Why?
+        outStats->namespace_count++;
+        /**
+         * When running readNvsStats() on an actual Swadge, the total NVS
+         * size is displayed as 12 entries less than the partition size.
+         *
+         * It's unknown if this is a percentage of total size,
+         * or a fixed number of overhead/control entries.
+         * I'm assuming it's a fixed number here.
+         */
+        outStats->total_entries = NVS_PARTITION_SIZE / NVS_ENTRY_BYTES - NVS_OVERHEAD_ENTRIES;
+
+        cJSON_ArrayForEach(jsonIter, namespace)
+        {
+            if (jsonIter->string != NULL)
             {
-                // 1 entry is always used by each namespace, and there should only ever be 1 namespace
-                outStats->used_entries++;
-                // TODO: I just checked a Swadge and it said it was using 5 namespaces. Why?
-                outStats->namespace_count++;
-                /**
-                 * When running readNvsStats() on an actual Swadge, the total NVS
-                 * size is displayed as 12 entries less than the partition size.
-                 *
-                 * It's unknown if this is a percentage of total size,
-                 * or a fixed number of overhead/control entries.
-                 * I'm assuming it's a fixed number here.
-                 */
-                outStats->total_entries = NVS_PARTITION_SIZE / NVS_ENTRY_BYTES - NVS_OVERHEAD_ENTRIES;
-
-                cJSON_ArrayForEach(jsonIter, namespace)
+                switch (jsonIter->type)
                 {
-                    if (jsonIter->string != NULL)
+                    case cJSON_Number:
                     {
-                        switch (jsonIter->type)
-                        {
-                            case cJSON_Number:
-                            {
-                                outStats->used_entries += 1;
-                                break;
-                            }
-                            case cJSON_String:
-                            {
-                                char* strBlob = cJSON_GetStringValue(jsonIter);
-
-                                /**
-                                 * Get length of blob
-                                 *
-                                 * When the ESP32 is storing blobs, it uses 1 entry to index chunks,
-                                 * 1 entry per chunk, then 1 entry for every 32 bytes of data, rounding up.
-                                 *
-                                 * I don't know how to find out how many chunks the ESP32 would split
-                                 * certain length blobs into, so for now I'm assuming 1 chunk per blob.
-                                 *
-                                 * Blobs in the JSON are encoded as hexadecimal, so every 2 characters are
-                                 * 1 byte of data. Then, every 32 bytes of data is an entry.
-                                 */
-                                outStats->used_entries += 2 + ceil(strlen(strBlob) / 2.0f / NVS_ENTRY_BYTES);
-                                break;
-                            }
-                            default:
-                            {
-                                break;
-                            }
-                        }
+                        outStats->used_entries += 1;
+                        break;
+                    }
+                    case cJSON_String:
+                    {
+                        char* strBlob = cJSON_GetStringValue(jsonIter);
+
+                        /**
+                         * Get length of blob
+                         *
+                         * When the ESP32 is storing blobs, it uses 1 entry to index chunks,
+                         * 1 entry per chunk, then 1 entry for every 32 bytes of data, rounding up.
+                         *
+                         * I don't know how to find out how many chunks the ESP32 would split
+                         * certain length blobs into, so for now I'm assuming 1 chunk per blob.
+                         *
+                         * Blobs in the JSON are encoded as hexadecimal, so every 2 characters are
+                         * 1 byte of data. Then, every 32 bytes of data is an entry.
+                         */
+                        outStats->used_entries += 2 + ceil(strlen(strBlob) / 2.0f / NVS_ENTRY_BYTES);
+                        break;
+                    }
+                    default:
+                    {
+                        break;
                     }
                 }
             }
-
-            outStats->free_entries = outStats->total_entries - outStats->used_entries;
-            cJSON_Delete(json);
-            return true;
-        }
-        else
-        {
-            fclose(nvsFile);
         }
     }
-    return false;
+
+    outStats->free_entries = outStats->total_entries - outStats->used_entries;
+    return true;
 }
 
 /**
@@ -839,113 +583,91 @@ bool readNvsStats(nvs_stats_t* outStats)
 bool readNamespaceNvsEntryInfos(const char* namespace, nvs_stats_t* outStats, nvs_entry_info_t* outEntryInfos,
                                 size_t* numEntryInfos)
 {
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
-    {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
-        {
-            // Close the file
-            fclose(nvsFile);
+    if (NULL == nvsJson)
+    {
+        return false;
+    }
 
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
-            cJSON* jsonIter;
+    cJSON* jsonIter;
 
-            // If the user doesn't want to receive the stats, only use them internally
-            bool freeOutStats = false;
-            if (outStats == NULL)
-            {
-                outStats     = heap_caps_calloc(1, sizeof(nvs_stats_t), MALLOC_CAP_8BIT);
-                freeOutStats = true;
-            }
+    // If the user doesn't want to receive the stats, only use them internally
+    bool freeOutStats = false;
+    if (outStats == NULL)
+    {
+        outStats     = heap_caps_calloc(1, sizeof(nvs_stats_t), MALLOC_CAP_8BIT);
+        freeOutStats = true;
+    }
 
-            if (!readNvsStats(outStats))
-            {
-                if (freeOutStats)
-                {
-                    free(outStats);
-                }
-                return false;
-            }
+    if (!readNvsStats(outStats))
+    {
+        if (freeOutStats)
+        {
+            free(outStats);
+        }
+        return false;
+    }
 
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
+    cJSON* jsonNs = getNvsNamespace(namespace, false);
 
-            if (NULL != jsonNs && cJSON_IsObject(jsonNs))
+    if (NULL != jsonNs && cJSON_IsObject(jsonNs))
+    {
+        int i = 0;
+        char* current_key;
+        cJSON_ArrayForEach(jsonIter, jsonNs)
+        {
+            current_key = jsonIter->string;
+            if (current_key != NULL)
             {
-                int i = 0;
-                char* current_key;
-                cJSON_ArrayForEach(jsonIter, jsonNs)
+                if (outEntryInfos != NULL)
                 {
-                    current_key = jsonIter->string;
-                    if (current_key != NULL)
+                    switch (jsonIter->type)
                     {
-                        if (outEntryInfos != NULL)
+                        case cJSON_Number:
                         {
-                            switch (jsonIter->type)
-                            {
-                                case cJSON_Number:
-                                {
 #ifdef USING_U32
-                                    // cJSON cannot store any integer larger than 2^53 or smaller than -(2^53), since
-                                    // those are the limits of a double
-                                    int64_t val = (int64_t)cJSON_GetNumberValue(jsonIter);
-                                    if (val > INT32_MAX)
-                                    {
-                                        outEntryInfos[i].type = NVS_TYPE_U32;
-                                    }
-                                    else
+                            // cJSON cannot store any integer larger than 2^53 or smaller than -(2^53), since
+                            // those are the limits of a double
+                            int64_t val = (int64_t)cJSON_GetNumberValue(jsonIter);
+                            if (val > INT32_MAX)
+                            {
+                                outEntryInfos[i].type = NVS_TYPE_U32;
+                            }
+                            else
 #endif
-                                    {
-                                        outEntryInfos[i].type = NVS_TYPE_I32;
-                                    }
-                                    break;
-                                }
-                                case cJSON_String:
-                                {
-                                    outEntryInfos[i].type = NVS_TYPE_BLOB;
-                                    break;
-                                }
-                                default:
-                                {
-                                    break;
-                                }
+                            {
+                                outEntryInfos[i].type = NVS_TYPE_I32;
                             }
-                            snprintf(outEntryInfos[i].namespace_name, NVS_KEY_NAME_MAX_SIZE, "%s", namespace);
-                            snprintf(outEntryInfos[i].key, NVS_KEY_NAME_MAX_SIZE, "%s", current_key);
+                            break;
+                        }
+                        case cJSON_String:
+                        {
+                            outEntryInfos[i].type = NVS_TYPE_BLOB;
+                            break;
+                        }
+                        default:
+                        {
+                            break;
                         }
-                        i++;
                     }
+                    snprintf(outEntryInfos[i].namespace_name, NVS_KEY_NAME_MAX_SIZE, "%s", namespace);
+                    snprintf(outEntryInfos[i].key, NVS_KEY_NAME_MAX_SIZE, "%s", current_key);
                 }
-
-                if (outEntryInfos == NULL)
-                {
-                    *numEntryInfos = i;
-                }
+                i++;
             }
-
-            if (freeOutStats)
-            {
-                free(outStats);
-            }
-
-            cJSON_Delete(json);
-            return true;
         }
-        else
+
+        if (outEntryInfos == NULL)
         {
-            fclose(nvsFile);
+            *numEntryInfos = i;
         }
     }
-    return false;
+
+    if (freeOutStats)
+    {
+        free(outStats);
+    }
+
+    return true;
 }
 
 /**
@@ -974,43 +696,8 @@ bool readAllNvsEntryInfos(nvs_stats_t* outStats, nvs_entry_info_t* outEntryInfos
  */
 bool nvsNamespaceInUse(const char* namespace)
 {
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-
-    if (NULL != nvsFile)
-    {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
-        {
-            // Close the file
-            fclose(nvsFile);
-
-            // Parse the JSON
-            cJSON* json   = cJSON_Parse(fbuf);
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
-            bool result   = false;
-
-            if (NULL != jsonNs && cJSON_IsObject(jsonNs))
-            {
-                result = (cJSON_GetArraySize(jsonNs) != 0);
-            }
-
-            cJSON_Delete(json);
-            return result;
-        }
-        else
-        {
-            fclose(nvsFile);
-        }
-    }
-    return false;
+    cJSON* jsonNs = getNvsNamespace(namespace, false);
+    return (NULL != jsonNs) && (cJSON_GetArraySize(jsonNs) != 0);
 }
 
 /**
@@ -1023,7 +710,9 @@ bool nvsNamespaceInUse(const char* namespace)
 static char* blobToStr(const void* value, size_t length)
 {
     const uint8_t* value8 = (const uint8_t*)value;
-    char* blobStr         = heap_caps_malloc((length * 2) + 1, MALLOC_CAP_8BIT);
+    // This is the host's scratch space, not the Swadge's, so it isn't tracked by heap_caps_malloc()
+    char* blobStr = malloc((length * 2) + 1);
+    blobStr[0]    = '\0';
     for (size_t i = 0; i < length; i++)
     {
         sprintf(&blobStr[i * 2], "%02X", value8[i]);
@@ -1064,9 +753,10 @@ static int hexCharToInt(char c)
 static void strToBlob(char* str, void* outBlob, size_t blobLen)
 {
     uint8_t* outBlob8 = (uint8_t*)outBlob;
+    size_t strLen     = strlen(str);
     for (size_t i = 0; i < blobLen; i++)
     {
-        if (((2 * i) + 1) < strlen(str))
+        if (((2 * i) + 1) < strLen)
         {
             uint8_t upperNib = hexCharToInt(str[2 * i]);
             uint8_t lowerNib = hexCharToInt(str[(2 * i) + 1]);
@@ -1079,12 +769,355 @@ static void strToBlob(char* str, void* outBlob, size_t blobLen)
     }
 }
 
-static FILE* openNvsFile(const char* mode)
+/**
+ * @brief Parse the NVS JSON file into memory, index every value, and apply any writes left in the journal by an
+ * emulator which didn't exit cleanly. After this, reads never touch the file, and writes are appended to the journal.
+ *
+ * @return true if the store was loaded, false if it wasn't
+ */
+static bool loadNvsStore(void)
 {
-    char buffer[1024];
-    expandPath(buffer, sizeof(buffer), NVS_JSON_FILE);
+    unloadNvsStore();
+
+    expandPath(nvsFilePath, sizeof(nvsFilePath), NVS_JSON_FILE);
+    snprintf(nvsJournalPath, sizeof(nvsJournalPath), "%s" NVS_JOURNAL_SUFFIX, nvsFilePath);
+
+    // Read the whole file
+    FILE* nvsFile = fopen(nvsFilePath, "rb");
+    if (NULL == nvsFile)
+    {
+        return false;
+    }
+
+    fseek(nvsFile, 0L, SEEK_END);
+    size_t fsize = ftell(nvsFile);
+    fseek(nvsFile, 0L, SEEK_SET);
+
+    char* fbuf = malloc(fsize + 1);
+    if (NULL == fbuf || fsize != fread(fbuf, 1, fsize, nvsFile))
+    {
+        free(fbuf);
+        fclose(nvsFile);
+        return false;
+    }
+    fbuf[fsize] = 0;
+    fclose(nvsFile);
+
+    // Parse it once
+    nvsJson = cJSON_Parse(fbuf);
+    free(fbuf);
+    if (!cJSON_IsObject(nvsJson))
+    {
+        printf("Could not parse NVS file %s\n", nvsFilePath);
+        cJSON_Delete(nvsJson);
+        nvsJson = NULL;
+        return false;
+    }
+
+    // Index every value by namespace and key. The index is on the Swadge's heap, but belongs to the emulator
+    emuHeapBeginEmulatorAllocs();
+    hashInit(&nvsIndex, 64);
+    emuHeapEndEmulatorAllocs();
+    cJSON* jsonNs;
+    cJSON_ArrayForEach(jsonNs, nvsJson)
+    {
+        cJSON* jsonIter;
+        cJSON_ArrayForEach(jsonIter, jsonNs)
+        {
+            indexNvsItem(jsonNs->string, jsonIter->string, jsonIter);
+        }
+    }
+
+    // Apply writes which never made it into the JSON file, then fold them in and start a fresh journal
+    replayNvsJournal();
+    return compactNvsStore();
+}
+
+/**
+ * @brief Close the journal and free the in-memory NVS store without writing anything
+ */
+static void unloadNvsStore(void)
+{
+    if (NULL != nvsJournal)
+    {
+        fclose(nvsJournal);
+        nvsJournal = NULL;
+    }
+    nvsJournalEntries = 0;
+
+    if (NULL != nvsJson)
+    {
+        hashIterator_t iter = {0};
+        while (hashIterate(&nvsIndex, &iter))
+        {
+            free(iter.value);
+            hashIterRemove(&nvsIndex, &iter);
+        }
+        hashDeinit(&nvsIndex);
+
+        cJSON_Delete(nvsJson);
+        nvsJson = NULL;
+    }
+}
+
+/**
+ * @brief Apply every complete entry in the journal to the in-memory NVS store. Each entry is one line of JSON, so an
+ * entry which was only partially written when the emulator stopped won't parse, and is ignored.
+ */
+static void replayNvsJournal(void)
+{
+    FILE* journal = fopen(nvsJournalPath, "rb");
+    if (NULL == journal)
+    {
+        return;
+    }
+
+    int replayed = 0;
+    char* line   = NULL;
+    size_t cap   = 0;
+    while (-1 != getline(&line, &cap, journal))
+    {
+        // Each entry is ["op", "namespace", "key", value]
+        cJSON* entry = cJSON_Parse(line);
+        cJSON* op    = cJSON_GetArrayItem(entry, 0);
+        cJSON* ns    = cJSON_GetArrayItem(entry, 1);
+        cJSON* key   = cJSON_GetArrayItem(entry, 2);
+        if (cJSON_IsString(op) && cJSON_IsString(ns) && cJSON_IsString(key))
+        {
+            if (0 == strcmp(NVS_JOURNAL_SET, op->valuestring))
+            {
+                cJSON* value = cJSON_GetArrayItem(entry, 3);
+                if (cJSON_IsNumber(value) || cJSON_IsString(value))
+                {
+                    setNvsItem(ns->valuestring, key->valuestring, cJSON_Duplicate(value, true));
+                    replayed++;
+                }
+            }
+            else if (0 == strcmp(NVS_JOURNAL_ERASE, op->valuestring))
+            {
+                eraseNvsItem(ns->valuestring, key->valuestring);
+                replayed++;
+            }
+        }
+        cJSON_Delete(entry);
+    }
+    free(line);
+    fclose(journal);
+
+    if (replayed)
+    {
+        printf("Recovered %d NVS writes from %s\n", replayed, nvsJournalPath);
+    }
+}
+
+/**
+ * @brief Write the in-memory NVS store to the JSON file and empty the journal.
+ *
+ * The JSON is written to a temporary file and renamed over the old one, so the file on disk is always complete. If
+ * the emulator stops after the rename but before the journal is emptied, replaying the journal on top of the new file
+ * changes nothing.
+ *
+ * @return true if the store was written, false if it wasn't
+ */
+static bool compactNvsStore(void)
+{
+    char tmpPath[sizeof(nvsFilePath) + sizeof(NVS_TMP_SUFFIX)];
+    snprintf(tmpPath, sizeof(tmpPath), "%s" NVS_TMP_SUFFIX, nvsFilePath);
+
+    FILE* tmpFile = fopen(tmpPath, "wb");
+    if (NULL == tmpFile)
+    {
+        return false;
+    }
+
+    char* jsonStr = cJSON_Print(nvsJson);
+    bool ok       = (NULL != jsonStr) && (EOF != fputs(jsonStr, tmpFile));
+    free(jsonStr);
+    ok = (0 == fclose(tmpFile)) && ok;
 
-    return fopen(buffer, mode);
+    if (!ok || 0 != rename(tmpPath, nvsFilePath))
+    {
+        remove(tmpPath);
+        return false;
+    }
+
+    // Start a new, empty journal
+    if (NULL != nvsJournal)
+    {
+        fclose(nvsJournal);
+    }
+    nvsJournal        = fopen(nvsJournalPath, "wb");
+    nvsJournalEntries = 0;
+    return (NULL != nvsJournal);
+}
+
+/**
+ * @brief Append a write to the journal, and flush it so it survives the emulator crashing. Compacts the journal into
+ * the JSON file when it gets long.
+ *
+ * @param op ::NVS_JOURNAL_SET or ::NVS_JOURNAL_ERASE
+ * @param namespace The NVS namespace written to
+ * @param key The key written to
+ * @param value The value written, or NULL for an erase
+ * @return true if the write was journaled, false if it wasn't
+ */
+static bool appendNvsJournal(const char* op, const char* namespace, const char* key, const cJSON* value)
+{
+    if (NULL == nvsJournal)
+    {
+        return false;
+    }
+
+    cJSON* entry = cJSON_CreateArray();
+    cJSON_AddItemToArray(entry, cJSON_CreateString(op));
+    cJSON_AddItemToArray(entry, cJSON_CreateString(namespace));
+    cJSON_AddItemToArray(entry, cJSON_CreateString(key));
+    if (NULL != value)
+    {
+        cJSON_AddItemToArray(entry, cJSON_Duplicate(value, true));
+    }
+
+    char* line = cJSON_PrintUnformatted(entry);
+    cJSON_Delete(entry);
+    if (NULL == line)
+    {
+        return false;
+    }
+
+    bool ok = (0 <= fprintf(nvsJournal, "%s\n", line)) && (0 == fflush(nvsJournal));
+    free(line);
+
+    if (ok && ++nvsJournalEntries >= NVS_JOURNAL_COMPACT_ENTRIES)
+    {
+        ok = compactNvsStore();
+    }
+    return ok;
+}
+
+/**
+ * @brief Get a namespace object from the in-memory NVS store
+ *
+ * @param namespace The NVS namespace to get
+ * @param create true to create the namespace if it doesn't exist
+ * @return The namespace object, or NULL if it doesn't exist and wasn't created
+ */
+static cJSON* getNvsNamespace(const char* namespace, bool create)
+{
+    if (NULL == nvsJson)
+    {
+        return NULL;
+    }
+
+    cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(nvsJson, namespace);
+    if (NULL == jsonNs && create)
+    {
+        jsonNs = cJSON_CreateObject();
+        cJSON_AddItemToObject(nvsJson, namespace, jsonNs);
+    }
+    return jsonNs;
+}
+
+/**
+ * @brief Look up a value in the in-memory NVS store
+ *
+ * @param namespace The NVS namespace to look in
+ * @param key The key to look up
+ * @return The value, or NULL if it doesn't exist
+ */
+static cJSON* getNvsItem(const char* namespace, const char* key)
+{
+    if (NULL == nvsJson)
+    {
+        return NULL;
+    }
+
+    char fullKey[strlen(namespace) + strlen(key) + 2];
+    snprintf(fullKey, sizeof(fullKey), "%s:%s", namespace, key);
+
+    emuNvsIndexEntry_t* entry = hashGet(&nvsIndex, fullKey);
+    return (NULL != entry) ? entry->item : NULL;
+}
+
+/**
+ * @brief Add or replace a value in the in-memory NVS store
+ *
+ * @param namespace The NVS namespace to write to
+ * @param key The key to write
+ * @param value The new value, which the store takes ownership of
+ */
+static void setNvsItem(const char* namespace, const char* key, cJSON* value)
+{
+    cJSON* jsonNs = getNvsNamespace(namespace, true);
+
+    char fullKey[strlen(namespace) + strlen(key) + 2];
+    snprintf(fullKey, sizeof(fullKey), "%s:%s", namespace, key);
+
+    emuNvsIndexEntry_t* entry = hashGet(&nvsIndex, fullKey);
+    if (NULL != entry)
+    {
+        // Replace the value in place, which keeps the key order of the file. The new value takes the old one's key
+        value->string       = entry->item->string;
+        entry->item->string = NULL;
+        cJSON_ReplaceItemViaPointer(jsonNs, entry->item, value);
+        entry->item = value;
+    }
+    else
+    {
+        cJSON_AddItemToObject(jsonNs, key, value);
+        indexNvsItem(namespace, key, value);
+    }
+}
+
+/**
+ * @brief Add a value which is already in the in-memory NVS store to the index
+ *
+ * @param namespace The NVS namespace the value is in
+ * @param key The value's key
+ * @param item The value
+ */
+static void indexNvsItem(const char* namespace, const char* key, cJSON* item)
+{
+    size_t fullKeyLen = strlen(namespace) + strlen(key) + 2;
+
+    // The hash map keeps a pointer to the key, so it's stored in the entry
+    emuNvsIndexEntry_t* entry = malloc(sizeof(emuNvsIndexEntry_t) + fullKeyLen);
+    snprintf(entry->fullKey, fullKeyLen, "%s:%s", namespace, key);
+    entry->item = item;
+
+    // Free the old entry if the file had the same key twice
+    emuHeapBeginEmulatorAllocs();
+    free(hashRemove(&nvsIndex, entry->fullKey));
+    hashPut(&nvsIndex, entry->fullKey, entry);
+    emuHeapEndEmulatorAllocs();
+}
+
+/**
+ * @brief Remove a value from the in-memory NVS store
+ *
+ * @param namespace The NVS namespace to remove from
+ * @param key The key to remove
+ * @return true if the value was removed, false if it didn't exist
+ */
+static bool eraseNvsItem(const char* namespace, const char* key)
+{
+    cJSON* jsonNs = getNvsNamespace(namespace, false);
+    if (NULL == jsonNs)
+    {
+        return false;
+    }
+
+    char fullKey[strlen(namespace) + strlen(key) + 2];
+    snprintf(fullKey, sizeof(fullKey), "%s:%s", namespace, key);
+
+    emuNvsIndexEntry_t* entry = hashRemove(&nvsIndex, fullKey);
+    if (NULL == entry)
+    {
+        return false;
+    }
+
+    cJSON_Delete(cJSON_DetachItemViaPointer(jsonNs, entry->item));
+    free(entry);
+    return true;
 }
 
 bool emuNvsInjectBlobFile(const char* namespace, const char* key, const char* filename)
@@ -1125,6 +1158,9 @@ bool emuNvsInjectBlobFile(const char* namespace, const char* key, const char* fi
 
 void emuInjectNvsBlob(const char* namespace, const char* key, size_t length, const void* blob)
 {
+    // Injected values are on the Swadge's heap, but belong to the emulator
+    emuHeapBeginEmulatorAllocs();
+
     if (!nvsInjectedDataInit)
     {
         hashInit(&nvsInjectedData, 16);
@@ -1144,10 +1180,15 @@ void emuInjectNvsBlob(const char* namespace, const char* key, size_t length, con
 
         hashPut(&nvsInjectedData, data->key, alloc);
     }
+
+    emuHeapEndEmulatorAllocs();
 }
 
 void emuInjectNvs32(const char* namespace, const char* key, int32_t value)
 {
+    // Injected values are on the Swadge's heap, but belong to the emulator
+    emuHeapBeginEmulatorAllocs();
+
     if (!nvsInjectedDataInit)
     {
         hashInit(&nvsInjectedData, 16);
@@ -1166,6 +1207,8 @@ void emuInjectNvs32(const char* namespace, const char* key, int32_t value)
 
         hashPut(&nvsInjectedData, data->key, alloc);
     }
+
+    emuHeapEndEmulatorAllocs();
 }
 
 static size_t emuGetInjectedBlobLength(const char* namespace, const char* key)
@@ -1246,42 +1289,100 @@ static bool emuGetInjected32(const char* namespace, const char* key, int32_t* ou
  */
 void getNvsKeys(const char* namespace, list_t* list)
 {
-    // Open the file
-    FILE* nvsFile = openNvsFile("rb");
-    if (NULL != nvsFile)
-    {
-        // Get the file size
-        fseek(nvsFile, 0L, SEEK_END);
-        size_t fsize = ftell(nvsFile);
-        fseek(nvsFile, 0L, SEEK_SET);
-
-        // Read the file
-        char fbuf[fsize + 1];
-        fbuf[fsize] = 0;
-        if (fsize == fread(fbuf, 1, fsize, nvsFile))
+    cJSON* jsonIter;
+    cJSON* jsonNs = getNvsNamespace(namespace, false);
+
+    if (NULL != jsonNs)
+    {
+        cJSON_ArrayForEach(jsonIter, jsonNs)
         {
-            // Parse the JSON
-            cJSON* json = cJSON_Parse(fbuf);
+            // Make a copy of the key
+            size_t keySize = sizeof(char) * (strlen(jsonIter->string) + 1);
+            char* keyCopy  = heap_caps_calloc(1, keySize, MALLOC_CAP_8BIT);
+            memcpy(keyCopy, jsonIter->string, keySize);
+            // Push it into the list
+            push(list, keyCopy);
+        }
+    }
+}
 
-            // Check if the key exists
-            cJSON* jsonIter;
-            cJSON* jsonNs = cJSON_GetObjectItemCaseSensitive(json, namespace);
+/**
+ * @brief Save everything in NVS
+ *
+ * @return The saved NVS contents, which must be freed with emuNvsFreeState(), or NULL if NVS isn't loaded
+ */
+emuNvsState_t* emuNvsSaveState(void)
+{
+    return (emuNvsState_t*)cJSON_Duplicate(nvsJson, true);
+}
 
-            if (NULL != jsonNs)
+/**
+ * @brief Put NVS back the way it was when its contents were saved. Only values which changed are written, and they're
+ * written to the NVS file like any other write, so the file always matches what the Swadge sees
+ *
+ * @param state The saved NVS contents, which are still valid afterwards
+ * @return true if NVS was restored, false if a write failed
+ */
+bool emuNvsRestoreState(const emuNvsState_t* state)
+{
+    const cJSON* saved = (const cJSON*)state;
+    if (NULL == nvsJson || NULL == saved)
+    {
+        return false;
+    }
+
+    bool ok = true;
+
+    // Erase values which were written after the snapshot. Keys are collected first, since erasing changes the tree
+    list_t erased = {0};
+    cJSON* jsonNs;
+    cJSON_ArrayForEach(jsonNs, nvsJson)
+    {
+        const cJSON* savedNs = cJSON_GetObjectItemCaseSensitive(saved, jsonNs->string);
+        cJSON* jsonIter;
+        cJSON_ArrayForEach(jsonIter, jsonNs)
+        {
+            if (NULL == cJSON_GetObjectItemCaseSensitive(savedNs, jsonIter->string))
             {
-                cJSON_ArrayForEach(jsonIter, jsonNs)
-                {
-                    // Make a copy of the key
-                    size_t keySize = sizeof(char) * (strlen(jsonIter->string) + 1);
-                    char* keyCopy  = heap_caps_calloc(1, keySize, MALLOC_CAP_8BIT);
-                    memcpy(keyCopy, jsonIter->string, keySize);
-                    // Push it into the list
-                    push(list, keyCopy);
-                }
+                push(&erased, jsonNs->string);
+                push(&erased, jsonIter->string);
             }
-            cJSON_Delete(json);
         }
-        // Close the file
-        fclose(nvsFile);
     }
-}
\ No newline at end of file
+    while (erased.length)
+    {
+        char* namespace = shift(&erased);
+        char* key       = shift(&erased);
+
+        // The strings are owned by the tree, so they're journaled before they're erased
+        ok = appendNvsJournal(NVS_JOURNAL_ERASE, namespace, key, NULL) && ok;
+        eraseNvsItem(namespace, key);
+    }
+
+    // Write values which changed or were erased after the snapshot
+    cJSON_ArrayForEach(jsonNs, saved)
+    {
+        cJSON* jsonIter;
+        cJSON_ArrayForEach(jsonIter, jsonNs)
+        {
+            const cJSON* current = getNvsItem(jsonNs->string, jsonIter->string);
+            if (NULL == current || !cJSON_Compare(current, jsonIter, true))
+            {
+                cJSON* value = cJSON_Duplicate(jsonIter, true);
+                setNvsItem(jsonNs->string, jsonIter->string, value);
+                ok = appendNvsJournal(NVS_JOURNAL_SET, jsonNs->string, jsonIter->string, value) && ok;
+            }
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Free saved NVS contents
+ *
+ * @param state The saved NVS contents, or NULL to do nothing
+ */
+void emuNvsFreeState(emuNvsState_t* state)
+{
+    cJSON_Delete((cJSON*)state);
+}
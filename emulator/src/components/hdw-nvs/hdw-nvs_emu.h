@@ -1,8 +1,16 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/// @brief Saved NVS contents, see emuNvsSaveState()
+typedef struct emuNvsState emuNvsState_t;
+
 bool emuNvsInjectBlobFile(const char* namespace, const char* key, const char* filename);
 void emuInjectNvsBlob(const char* namespace, const char* key, size_t length, const void* blob);
 void emuInjectNvs32(const char* namespace, const char* key, int32_t value);
+
+emuNvsState_t* emuNvsSaveState(void);
+bool emuNvsRestoreState(const emuNvsState_t* state);
+void emuNvsFreeState(emuNvsState_t* state);
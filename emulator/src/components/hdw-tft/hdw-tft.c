@@ -8,6 +8,54 @@
 #include "hdw-tft.h"
 #include "hdw-tft_emu.h"
 #include "emu_main.h"
+#include "macros.h"
+#include "os_generic.h"
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// How many threads scale frames up for the window, including the render thread
+#define TFT_SCALE_THREADS 4
+
+/// The smallest multiplier which is scaled on more than one thread. Smaller frames are faster on one thread
+#define TFT_SCALE_THREADED_MULT 2
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief A thread which scales a band of rows of each frame
+ */
+typedef struct
+{
+    og_thread_t thread; ///< The thread
+    og_sema_t start;    ///< Signaled when there's a frame to scale, or when the thread should stop
+    int16_t firstRow;   ///< The first row of the frame this thread scales
+    int16_t endRow;     ///< The row after the last one this thread scales
+} scaleWorker_t;
+
+/**
+ * @brief The frame being scaled by the scale threads
+ */
+typedef struct
+{
+    const uint32_t* lut;      ///< The colors of each palette index
+    const paletteColor_t* fb; ///< The frame to scale
+    uint32_t* bitmap;         ///< The bitmap to write
+    uint8_t mult;             ///< The multiplier for the display
+    bool stop;                ///< Whether the threads should stop instead
+} scaleJob_t;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static void fillColorLut(uint32_t* lut, uint8_t brightness);
+static void scaleRows(const uint32_t* lut, const paletteColor_t* fb, uint32_t* bitmap, uint8_t mult, int16_t firstRow,
+                      int16_t endRow);
+static void* scaleThreadFn(void* arg);
 
 //==============================================================================
 // Const variables
@@ -79,14 +127,19 @@ static const uint32_t paletteColorsEmu[217] = {
 // Variables
 //==============================================================================
 
-static paletteColor_t* lastBuffer    = NULL;
-static paletteColor_t* frameBuffer   = NULL;
-static uint32_t* scaledBitmapDisplay = NULL;
-static int bitmapWidth               = 0;
-static int bitmapHeight              = 0;
-static int displayMult               = 1;
-static bool tftDisabled              = false;
-static uint8_t tftBrightness         = CONFIG_TFT_MAX_BRIGHTNESS;
+static paletteColor_t* lastBuffer  = NULL;
+static paletteColor_t* frameBuffer = NULL;
+static bool tftDisabled            = false;
+static uint8_t tftBrightness       = CONFIG_TFT_MAX_BRIGHTNESS;
+
+/// The window's colors for each palette index, only used by the render thread. Regenerated when the brightness changes
+static uint32_t windowLut[256];
+static int windowLutBrightness = -1;
+
+/// Threads which scale bands of rows for the render thread. The render thread scales the first band itself
+static scaleWorker_t scaleWorkers[TFT_SCALE_THREADS - 1];
+static og_sema_t scaleDoneSema = NULL;
+static scaleJob_t scaleJob;
 
 //==============================================================================
 // Functions
@@ -111,10 +164,6 @@ void initTFT(spi_host_device_t spiHost, gpio_num_t sclk, gpio_num_t mosi, gpio_n
              gpio_num_t backlight, bool isPwmBacklight, ledc_channel_t ledcChannel, ledc_timer_t ledcTimer,
              uint8_t brightness)
 {
-    // ARGB pixels
-    bitmapWidth  = TFT_WIDTH;
-    bitmapHeight = TFT_HEIGHT;
-
     // Set up underlying bitmap
     if (NULL == frameBuffer)
     {
@@ -126,13 +175,6 @@ void initTFT(spi_host_device_t spiHost, gpio_num_t sclk, gpio_num_t mosi, gpio_n
         lastBuffer = calloc(TFT_WIDTH * TFT_HEIGHT, sizeof(paletteColor_t));
     }
 
-    // This may be setup by the emulator already
-    if (NULL == scaledBitmapDisplay)
-    {
-        displayMult         = 1;
-        scaledBitmapDisplay = calloc(TFT_WIDTH * TFT_HEIGHT, sizeof(uint32_t));
-    }
-
     setTFTBacklightBrightness(brightness);
 }
 
@@ -153,12 +195,6 @@ void deinitTFT(void)
         free(lastBuffer);
         lastBuffer = NULL;
     }
-
-    if (scaledBitmapDisplay)
-    {
-        free(scaledBitmapDisplay);
-        scaledBitmapDisplay = NULL;
-    }
 }
 
 /**
@@ -279,68 +315,17 @@ void drawDisplayTft(fnBackgroundDrawCallback_t fnBackgroundDrawCallback)
     // Save the framebuffer before it gets cleared by background drawing callbacks
     memcpy(lastBuffer, frameBuffer, TFT_WIDTH * TFT_HEIGHT);
 
-    /* Copy the current framebuffer to memory that won't be modified by the
-     * Swadge mode. rawdraw will use this non-changing bitmap to draw
-     */
-    int16_t y;
-    for (y = 0; y < TFT_HEIGHT; y++)
-    {
-        for (int16_t x = 0; x < TFT_WIDTH; x++)
-        {
-            for (uint16_t mY = 0; mY < displayMult; mY++)
-            {
-                for (uint16_t mX = 0; mX < displayMult; mX++)
-                {
-                    int dstX  = ((x * displayMult) + mX);
-                    int dstY  = ((y * displayMult) + mY);
-                    int pxIdx = (dstY * (TFT_WIDTH * displayMult)) + dstX;
-
-                    int paletteIdx = frameBuffer[(y * TFT_WIDTH) + x];
-                    // Draw out-of-bounds colors as bright red as a warning
-                    if (paletteIdx >= (sizeof(paletteColorsEmu) / sizeof(paletteColorsEmu[0])))
-                    {
-                        paletteIdx = c500;
-                    }
-
-                    uint32_t color = paletteColorsEmu[paletteIdx];
+    // Hand the frame to the render thread, which scales it up and draws it to the window
+    emulatorSubmitFrame(lastBuffer, tftBrightness);
 
-#if defined(CNFGOGL)
-                    // ARGB
-                    uint32_t a = (color) & 0xFF;
-                    uint32_t r = (color >> 8) & 0xFF;
-                    r          = (r * tftBrightness) / CONFIG_TFT_MAX_BRIGHTNESS;
-                    uint32_t g = (color >> 16) & 0xFF;
-                    g          = (g * tftBrightness) / CONFIG_TFT_MAX_BRIGHTNESS;
-                    uint32_t b = (color >> 24) & 0xFF;
-                    b          = (b * tftBrightness) / CONFIG_TFT_MAX_BRIGHTNESS;
-
-                    color = (b << 24) | (g << 16) | (r << 8) | (a);
-#else
-                    // RGBA
-                    uint32_t r = (color >> 0) & 0xFF;
-                    r          = (r * tftBrightness) / CONFIG_TFT_MAX_BRIGHTNESS;
-                    uint32_t g = (color >> 8) & 0xFF;
-                    g          = (g * tftBrightness) / CONFIG_TFT_MAX_BRIGHTNESS;
-                    uint32_t b = (color >> 16) & 0xFF;
-                    b          = (b * tftBrightness) / CONFIG_TFT_MAX_BRIGHTNESS;
-                    uint32_t a = (color >> 24) & 0xFF;
-
-                    color = (a << 24) | (b << 16) | (g << 8) | (r << 0);
-#endif
-                    scaledBitmapDisplay[pxIdx] = color;
-                }
-            }
-        }
-
-        if ((y & 0xf) == 0 && fnBackgroundDrawCallback && y > 0)
+    // The background is drawn in 16 row chunks while the frame is sent on real hardware
+    if (fnBackgroundDrawCallback)
+    {
+        for (int16_t y = 16; y < TFT_HEIGHT; y += 16)
         {
             fnBackgroundDrawCallback(0, y - 16, TFT_WIDTH, 16, (y - 16) / 16, TFT_HEIGHT / 16);
         }
-    }
-
-    if (fnBackgroundDrawCallback)
-    {
-        fnBackgroundDrawCallback(0, y - 16, TFT_WIDTH, 16, (y - 16) / 16, TFT_HEIGHT / 16);
+        fnBackgroundDrawCallback(0, TFT_HEIGHT - 16, TFT_WIDTH, 16, (TFT_HEIGHT - 16) / 16, TFT_HEIGHT / 16);
     }
 }
 
@@ -359,34 +344,247 @@ esp_err_t setTFTBacklightBrightness(uint8_t intensity)
 }
 
 /**
- * Set a multiplier to draw the TFT to the window at
+ * @brief Convert a frame to pixels for the window, applying the backlight brightness and scaling it up. Large frames
+ * are split into bands of rows which are scaled on several threads. This must only be called from the render thread
+ *
+ * @param fb The frame's pixels, (TFT_WIDTH * TFT_HEIGHT) palette colors
+ * @param brightness The backlight brightness, from CONFIG_TFT_MIN_BRIGHTNESS to CONFIG_TFT_MAX_BRIGHTNESS
+ * @param bitmap The bitmap to write, ((TFT_WIDTH * mult) * (TFT_HEIGHT * mult)) pixels
+ * @param mult The multiplier for the display, no less than 1
+ */
+void convertTftBitmap(const paletteColor_t* fb, uint8_t brightness, uint32_t* bitmap, uint8_t mult)
+{
+    if (brightness != windowLutBrightness)
+    {
+        fillColorLut(windowLut, brightness);
+        windowLutBrightness = brightness;
+    }
+
+    if (mult < TFT_SCALE_THREADED_MULT)
+    {
+        scaleRows(windowLut, fb, bitmap, mult, 0, TFT_HEIGHT);
+        return;
+    }
+
+    // Start the scale threads the first time they're needed
+    if (NULL == scaleDoneSema)
+    {
+        scaleDoneSema = OGCreateSema();
+        for (int i = 0; i < TFT_SCALE_THREADS - 1; i++)
+        {
+            scaleWorkers[i].firstRow = ((i + 1) * TFT_HEIGHT) / TFT_SCALE_THREADS;
+            scaleWorkers[i].endRow   = ((i + 2) * TFT_HEIGHT) / TFT_SCALE_THREADS;
+            scaleWorkers[i].start    = OGCreateSema();
+            scaleWorkers[i].thread   = OGCreateThread(scaleThreadFn, &scaleWorkers[i]);
+        }
+    }
+
+    scaleJob.lut    = windowLut;
+    scaleJob.fb     = fb;
+    scaleJob.bitmap = bitmap;
+    scaleJob.mult   = mult;
+    for (int i = 0; i < TFT_SCALE_THREADS - 1; i++)
+    {
+        OGUnlockSema(scaleWorkers[i].start);
+    }
+
+    // Scale the first band here while the other threads scale theirs
+    scaleRows(windowLut, fb, bitmap, mult, 0, TFT_HEIGHT / TFT_SCALE_THREADS);
+
+    for (int i = 0; i < TFT_SCALE_THREADS - 1; i++)
+    {
+        OGLockSema(scaleDoneSema);
+    }
+}
+
+/**
+ * @brief Stop the threads which scale frames for the window. This must only be called from the render thread
+ */
+void stopTftScaleThreads(void)
+{
+    if (NULL == scaleDoneSema)
+    {
+        return;
+    }
+
+    scaleJob.stop = true;
+    for (int i = 0; i < TFT_SCALE_THREADS - 1; i++)
+    {
+        OGUnlockSema(scaleWorkers[i].start);
+    }
+    for (int i = 0; i < TFT_SCALE_THREADS - 1; i++)
+    {
+        OGJoinThread(scaleWorkers[i].thread);
+        OGDeleteSema(scaleWorkers[i].start);
+    }
+    OGDeleteSema(scaleDoneSema);
+    scaleDoneSema = NULL;
+    scaleJob.stop = false;
+}
+
+/**
+ * @brief Convert the last frame drawn to pixels for the window, like for a screenshot
  *
- * @param multiplier The multiplier for the display, no less than 1
+ * @param bitmap The bitmap to write, ((TFT_WIDTH * mult) * (TFT_HEIGHT * mult)) pixels
+ * @param mult The multiplier for the display, no less than 1
  */
-void setDisplayBitmapMultiplier(uint8_t multiplier)
+void getLastTftDisplayBitmap(uint32_t* bitmap, uint8_t mult)
 {
-    displayMult = multiplier;
+    // This isn't called from the render thread, so it can't use the render thread's table
+    uint32_t lut[256];
+    fillColorLut(lut, tftBrightness);
+    scaleRows(lut, lastBuffer, bitmap, mult, 0, TFT_HEIGHT);
+}
+
+/**
+ * @brief Fill a table with the window's color for each palette index at a backlight brightness
+ *
+ * @param lut The table to fill, 256 colors
+ * @param brightness The backlight brightness, from CONFIG_TFT_MIN_BRIGHTNESS to CONFIG_TFT_MAX_BRIGHTNESS
+ */
+static void fillColorLut(uint32_t* lut, uint8_t brightness)
+{
+    for (int paletteIdx = 0; paletteIdx < 256; paletteIdx++)
+    {
+        // Draw out-of-bounds colors as bright red as a warning
+        uint32_t color = paletteColorsEmu[(paletteIdx < ARRAY_SIZE(paletteColorsEmu)) ? paletteIdx : c500];
+
+#if defined(CNFGOGL)
+        // ARGB
+        uint32_t a = (color) & 0xFF;
+        uint32_t r = (color >> 8) & 0xFF;
+        r          = (r * brightness) / CONFIG_TFT_MAX_BRIGHTNESS;
+        uint32_t g = (color >> 16) & 0xFF;
+        g          = (g * brightness) / CONFIG_TFT_MAX_BRIGHTNESS;
+        uint32_t b = (color >> 24) & 0xFF;
+        b          = (b * brightness) / CONFIG_TFT_MAX_BRIGHTNESS;
+
+        lut[paletteIdx] = (b << 24) | (g << 16) | (r << 8) | (a);
+#else
+        // RGBA
+        uint32_t r = (color >> 0) & 0xFF;
+        r          = (r * brightness) / CONFIG_TFT_MAX_BRIGHTNESS;
+        uint32_t g = (color >> 8) & 0xFF;
+        g          = (g * brightness) / CONFIG_TFT_MAX_BRIGHTNESS;
+        uint32_t b = (color >> 16) & 0xFF;
+        b          = (b * brightness) / CONFIG_TFT_MAX_BRIGHTNESS;
+        uint32_t a = (color >> 24) & 0xFF;
+
+        lut[paletteIdx] = (a << 24) | (b << 16) | (g << 8) | (r << 0);
+#endif
+    }
+}
+
+/**
+ * @brief Scale up a band of rows of a frame. Each row is expanded horizontally once, then copied for the rest of its
+ * multiplied rows
+ *
+ * @param lut The window's color for each palette index
+ * @param fb The frame's pixels, (TFT_WIDTH * TFT_HEIGHT) palette colors
+ * @param bitmap The bitmap to write, ((TFT_WIDTH * mult) * (TFT_HEIGHT * mult)) pixels
+ * @param mult The multiplier for the display, no less than 1
+ * @param firstRow The first row of the frame to scale
+ * @param endRow The row after the last one to scale
+ */
+static void scaleRows(const uint32_t* lut, const paletteColor_t* fb, uint32_t* bitmap, uint8_t mult, int16_t firstRow,
+                      int16_t endRow)
+{
+    int dstW = TFT_WIDTH * mult;
+    for (int16_t y = firstRow; y < endRow; y++)
+    {
+        const paletteColor_t* src = &fb[y * TFT_WIDTH];
+        uint32_t* dstRow          = &bitmap[(y * mult) * dstW];
+
+        if (1 == mult)
+        {
+            for (int16_t x = 0; x < TFT_WIDTH; x++)
+            {
+                dstRow[x] = lut[src[x]];
+            }
+            continue;
+        }
+
+        uint32_t* dst = dstRow;
+        for (int16_t x = 0; x < TFT_WIDTH; x++)
+        {
+            uint32_t color = lut[src[x]];
+            for (uint8_t mX = 0; mX < mult; mX++)
+            {
+                *(dst++) = color;
+            }
+        }
 
-    // Reallocate scaledBitmapDisplay
-    free(scaledBitmapDisplay);
-    scaledBitmapDisplay = calloc((multiplier * TFT_WIDTH) * (multiplier * TFT_HEIGHT), sizeof(uint32_t));
+        for (uint8_t mY = 1; mY < mult; mY++)
+        {
+            memcpy(&dstRow[mY * dstW], dstRow, dstW * sizeof(uint32_t));
+        }
+    }
 }
 
 /**
- * @brief Get a pointer to the display memory.
+ * @brief A thread which scales its band of rows each time the render thread starts a frame
  *
- * @param width A pointer to return the width of the display through
- * @param height A pointer to return the height of the display through
- * @return A pointer to the bitmap pixels for the display
+ * @param arg The thread's ::scaleWorker_t
+ * @return NULL
  */
-uint32_t* getDisplayBitmap(uint16_t* width, uint16_t* height)
+static void* scaleThreadFn(void* arg)
 {
-    *width  = (bitmapWidth * displayMult);
-    *height = (bitmapHeight * displayMult);
-    return scaledBitmapDisplay;
+    scaleWorker_t* worker = (scaleWorker_t*)arg;
+    while (true)
+    {
+        OGLockSema(worker->start);
+        if (scaleJob.stop)
+        {
+            break;
+        }
+
+        scaleRows(scaleJob.lut, scaleJob.fb, scaleJob.bitmap, scaleJob.mult, worker->firstRow, worker->endRow);
+        OGUnlockSema(scaleDoneSema);
+    }
+    return NULL;
 }
 
 const paletteColor_t* getLastTftBitmap(void)
 {
     return lastBuffer;
+}
+
+/**
+ * @brief Save what's on the display and in the framebuffer, and the backlight
+ *
+ * @return The saved display state, which must be freed with emulatorFreeTftState()
+ */
+emuTftState_t* emulatorSaveTftState(void)
+{
+    emuTftState_t* state = calloc(1, sizeof(emuTftState_t));
+    memcpy(state->frameBuffer, frameBuffer, sizeof(state->frameBuffer));
+    memcpy(state->lastBuffer, lastBuffer, sizeof(state->lastBuffer));
+    state->brightness = tftBrightness;
+    state->disabled   = tftDisabled;
+    return state;
+}
+
+/**
+ * @brief Put the display and framebuffer back the way they were when their state was saved, and show the restored
+ * frame in the window
+ *
+ * @param state The saved display state, which is still valid afterwards
+ */
+void emulatorRestoreTftState(const emuTftState_t* state)
+{
+    memcpy(frameBuffer, state->frameBuffer, sizeof(state->frameBuffer));
+    memcpy(lastBuffer, state->lastBuffer, sizeof(state->lastBuffer));
+    tftBrightness = state->brightness;
+    tftDisabled   = state->disabled;
+    emulatorSubmitFrame(lastBuffer, tftBrightness);
+}
+
+/**
+ * @brief Free saved display state
+ *
+ * @param state The saved display state, or NULL to do nothing
+ */
+void emulatorFreeTftState(emuTftState_t* state)
+{
+    free(state);
 }
\ No newline at end of file
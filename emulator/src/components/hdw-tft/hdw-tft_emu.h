@@ -1,5 +1,27 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hdw-tft.h"
+
+/**
+ * @brief The emulator's saved display state, see emulatorSaveTftState()
+ */
+typedef struct
+{
+    /// The framebuffer the Swadge draws to
+    paletteColor_t frameBuffer[TFT_WIDTH * TFT_HEIGHT];
+    /// The last frame sent to the display
+    paletteColor_t lastBuffer[TFT_WIDTH * TFT_HEIGHT];
+    uint8_t brightness;
+    bool disabled;
+} emuTftState_t;
+
 const paletteColor_t* getLastTftBitmap(void);
-uint32_t* getDisplayBitmap(uint16_t* width, uint16_t* height);
-void setDisplayBitmapMultiplier(uint8_t multiplier);
\ No newline at end of file
+void convertTftBitmap(const paletteColor_t* fb, uint8_t brightness, uint32_t* bitmap, uint8_t mult);
+void stopTftScaleThreads(void);
+void getLastTftDisplayBitmap(uint32_t* bitmap, uint8_t mult);
+emuTftState_t* emulatorSaveTftState(void);
+void emulatorRestoreTftState(const emuTftState_t* state);
+void emulatorFreeTftState(emuTftState_t* state);
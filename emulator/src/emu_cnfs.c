@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "esp_heap_caps.h"
+#include "esp_heap_caps_emu.h"
 #include "esp_log.h"
 #include "cnfs.h"
 #include "cnfs_image.h"
@@ -54,7 +55,10 @@ bool emuCnfsInjectFile(const char* name, const char* filePath)
 
         if (fileSize > 0)
         {
+            // The file is on the Swadge's heap, but belongs to the emulator
+            emuHeapBeginEmulatorAllocs();
             void* fileData = heap_caps_malloc(fileSize, MALLOC_CAP_8BIT);
+            emuHeapEndEmulatorAllocs();
             if (fileData != NULL)
             {
                 if (fileSize == fread(fileData, 1, fileSize, dataFile))
@@ -11,8 +11,10 @@
         #define _GNU_SOURCE
     #endif
     #include <dlfcn.h>
+    #include <pthread.h>
 #endif
 #include <time.h>
+#include <stdatomic.h>
 
 #include <esp_system.h>
 #include <esp_timer.h>
@@ -20,6 +22,7 @@
 #include <errno.h>
 #include <string.h>
 #include <stdio.h>
+#include <inttypes.h>
 
 #ifdef ENABLE_GCOV
     #include <gcov.h>
@@ -37,6 +40,8 @@
 #include "hdw-mic_emu.h"
 #include "hdw-dac.h"
 #include "hdw-dac_emu.h"
+#include "hdw-ch32c003_emu.h"
+#include "midi_device_emu.h"
 
 #include "swadge2024.h"
 #include "macros.h"
@@ -44,7 +49,10 @@
 
 #include "hdw-esp-now.h"
 #include "esp_random_emu.h"
+#include "esp_heap_caps_emu.h"
+#include "emu_snapshot.h"
 #include "mainMenu.h"
+#include "os_generic.h"
 
 // clang-format off
 // Necessary for CNFA
@@ -110,15 +118,107 @@
     #define RECORDING_COLOR 0xFFFF0000
 #endif
 
+/// The most input events queued for the Swadge's thread at once. More are dropped
+#define INPUT_QUEUE_LEN 256
+
+/// The random seed used with --deterministic if --seed wasn't given
+#define EMU_DETERMINISTIC_SEED 0x5EED
+
+//==============================================================================
+// Enums
+//==============================================================================
+
+/**
+ * @brief The kinds of input events the render thread receives from rawdraw
+ */
+typedef enum
+{
+    EMU_INPUT_KEY,
+    EMU_INPUT_MOUSE_BUTTON,
+    EMU_INPUT_MOUSE_MOVE,
+} emuInputType_t;
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief An input event received by the render thread, to be handled on the Swadge's thread
+ */
+typedef struct
+{
+    emuInputType_t type; ///< The kind of event
+    int x;               ///< The mouse X position, for mouse events
+    int y;               ///< The mouse Y position, for mouse events
+    int code;            ///< The key code, mouse button, or mouse button mask
+    int down;            ///< Whether the key or button was pressed or released
+} emuInputEvt_t;
+
+/**
+ * @brief A finished frame handed from drawDisplayTft() to the render thread
+ */
+typedef struct
+{
+    paletteColor_t pixels[TFT_WIDTH * TFT_HEIGHT]; ///< The frame's pixels
+    uint8_t brightness;                            ///< The backlight brightness when the frame was drawn
+} emuFrame_t;
+
 //==============================================================================
 // Variables
 //==============================================================================
 
-static bool isRunning = true;
+/// Cleared from either thread to quit
+static atomic_bool isRunning = true;
+
+/// Whether to run frames unthrottled and without drawing, like batch mode, even with a window
+static bool fastForward = false;
+
+/// The process exit code, set when something like a replay check fails
+static int exitCode = 0;
+
+/// The wall clock time when the last frame finished, watched by the hang watchdog
+static atomic_int_fast64_t lastFrameWallUs = 0;
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__LINUX__) || defined(__APPLE__)
+/// The thread which runs the Swadge, which the hang watchdog interrupts to get its backtrace
+static pthread_t mainThread;
+#endif
+
+/// The wall clock time when app_main() started, for measuring batch speed
+static int64_t wallStartUs = 0;
 
 /// The sound driver
 static struct CNFADriver* soundDriver = NULL;
 
+/// The thread which owns the window, handles its input, and draws it. NULL in batch mode
+static og_thread_t renderThread = NULL;
+
+/// The thread which watches for hangs, if --hang-timeout was given. It stops when isRunning is cleared
+static og_thread_t hangWatchdog = NULL;
+
+/// Signaled by the render thread once the window has been created
+static og_sema_t windowReadySema = NULL;
+
+/// Held while calling extensions, which are called from both the Swadge's thread and the render thread
+static og_mutex_t extMutex = NULL;
+
+/// The frames being handed off. The Swadge's thread fills backFrame and swaps it with readyFrame, and the render thread
+/// swaps readyFrame with frontFrame to draw it, so neither thread waits for the other to copy or draw a frame
+static emuFrame_t frames[3];
+static emuFrame_t* backFrame  = &frames[0];
+static emuFrame_t* readyFrame = &frames[1];
+static emuFrame_t* frontFrame = &frames[2];
+static bool frameReady        = false;
+static og_mutex_t frameMutex  = NULL;
+
+/// How much the display is scaled up in the window
+static atomic_uint displayScale = 1;
+
+/// Input events queued by the render thread, oldest first
+static emuInputEvt_t inputQueue[INPUT_QUEUE_LEN];
+static int inputQueueCount   = 0;
+static og_mutex_t inputMutex = NULL;
+
 //==============================================================================
 // Function Prototypes
 //==============================================================================
@@ -131,6 +231,16 @@ void signalHandler_crash(int signum, siginfo_t* si, void* vcontext);
 static void drawBitmapPixel(uint32_t* bitmapDisplay, int w, int h, int x, int y, uint32_t col);
 static void EmuSoundCb(struct CNFADriver* sd, short* out, short* in, int framesp, int framesr);
 void handleArgs(int argc, char** argv);
+static int64_t getWallTimeUs(void);
+static void checkExitLimits(uint64_t frameNum);
+static void emulatorShutdown(uint64_t frameNum);
+static void* hangWatchdogThread(void* arg);
+static void createWindow(void);
+static void* renderThreadFn(void* arg);
+static void drawWindow(void);
+static void queueInput(const emuInputEvt_t* evt);
+static void handleQueuedInputs(void);
+static void handleKeyInput(int keycode, int bDown);
 
 //==============================================================================
 // Functions
@@ -145,6 +255,63 @@ void emulatorQuit(void)
     isRunning = false;
 }
 
+/**
+ * @brief Run frames as fast as possible without drawing them, like in batch mode, or go back to normal speed. This is
+ * only faster when fake time is in use
+ *
+ * @param enable true to fast forward, false to run at normal speed
+ */
+void emulatorSetFastForward(bool enable)
+{
+    fastForward = enable;
+}
+
+/**
+ * @brief Set the exit code the emulator returns when it quits, so scripts can tell a failed check from a clean run
+ *
+ * @param code The exit code
+ */
+void emulatorSetExitCode(int code)
+{
+    exitCode = code;
+}
+
+/**
+ * @brief Hand a finished frame to the render thread to be drawn. This only copies the frame, so it's cheap for the
+ * Swadge's thread. Frames the render thread doesn't get to before the next one is submitted are skipped
+ *
+ * @param fb The frame's pixels, (TFT_WIDTH * TFT_HEIGHT) palette colors
+ * @param brightness The backlight brightness, from CONFIG_TFT_MIN_BRIGHTNESS to CONFIG_TFT_MAX_BRIGHTNESS
+ */
+void emulatorSubmitFrame(const paletteColor_t* fb, uint8_t brightness)
+{
+    if (NULL == renderThread)
+    {
+        // Nothing draws frames in batch mode
+        return;
+    }
+
+    memcpy(backFrame->pixels, fb, sizeof(backFrame->pixels));
+    backFrame->brightness = brightness;
+
+    OGLockMutex(frameMutex);
+    emuFrame_t* tmp = readyFrame;
+    readyFrame      = backFrame;
+    backFrame       = tmp;
+    frameReady      = true;
+    OGUnlockMutex(frameMutex);
+}
+
+/**
+ * @brief Get how much the display is scaled up in the window
+ *
+ * @return The display's scale, at least 1
+ */
+uint8_t emulatorGetDisplayScale(void)
+{
+    return atomic_load(&displayScale);
+}
+
 /**
  * @brief Parse and handle command line arguments
  *
@@ -182,6 +349,12 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    if (emulatorArgs.deterministic && emulatorArgs.seed == UINT32_MAX)
+    {
+        // Deterministic runs always use the same seed, so it doesn't need to be given to repeat a run
+        emulatorArgs.seed = EMU_DETERMINISTIC_SEED;
+    }
+
     // Call any init callbacks we may have and pass them the parsed command-line arguments
     // We also determine which extensions are enabled here, which is important for laying out the window properly
     initExtensions(&emulatorArgs);
@@ -197,37 +370,25 @@ int main(int argc, char** argv)
         emulatorSetEspRandomSeed(emulatorArgs.seed);
     }
 
-    // First initialize rawdraw
-    // Screen-specific configurations
-    // Save window dimensions from the last loop
-    if (emulatorArgs.fullscreen)
-    {
-        CNFGSetupFullscreen("Swadge 2024 Simulator", 0);
-    }
-    else
-    {
-        // Get all the pane info to see how much space we need aside from the simulated TFT screen
-        emuPaneMinimum_t paneMins[4] = {0};
-        calculatePaneMinimums(paneMins);
-        int32_t sidePanesW      = paneMins[PANE_LEFT].min + paneMins[PANE_RIGHT].min;
-        int32_t topBottomPanesH = paneMins[PANE_TOP].min + paneMins[PANE_BOTTOM].min;
-        int32_t winW            = (TFT_WIDTH) * 2 + sidePanesW;
-        int32_t winH            = (TFT_HEIGHT) * 2 + topBottomPanesH;
+    // The heap is modeled from here on, before the Swadge starts allocating
+    emuSetHeapModel(emulatorArgs.heapModel);
+    emuSetHeapFailRate(emulatorArgs.heapFailRate);
 
-        if (emulatorArgs.headless)
-        {
-            // If the window dimensions are negative, the window will still exist but not be displayed.
-            // TODO does this work on all platforms?
-            winW = -winW;
-            winH = -winH;
-        }
+    extMutex   = OGCreateMutex();
+    inputMutex = OGCreateMutex();
 
-        // Add the screen size to the minimum pane sizes to get our window size
-        CNFGSetup("Swadge 2024 Simulator", winW, winH);
+    // The window is created and drawn on its own thread, so drawing doesn't slow down the Swadge. Batch mode has no
+    // window at all
+    if (!emulatorArgs.batch)
+    {
+        frameMutex      = OGCreateMutex();
+        windowReadySema = OGCreateSema();
+        renderThread    = OGCreateThread(renderThreadFn, NULL);
+        OGLockSema(windowReadySema);
     }
 
-    // Then initialize audio
-    if (!soundDriver)
+    // Then initialize audio, unless running in batch mode which doesn't play sound
+    if (!soundDriver && !emulatorArgs.batch)
     {
         soundDriver = CNFAInit(NULL,               // const char* driver_name
                                "Swadge Emulator",  // const char* your_name
@@ -256,18 +417,32 @@ int main(int argc, char** argv)
     // This is called automatically on ESP, so it must be called before app_main() here
     esp_timer_init();
 
+    // Note when the Swadge started, to report simulated time against wall time
+    wallStartUs = getWallTimeUs();
+
+    if (emulatorArgs.hangTimeoutUs)
+    {
+        atomic_store(&lastFrameWallUs, wallStartUs);
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__LINUX__) || defined(__APPLE__)
+        mainThread = pthread_self();
+#endif
+        hangWatchdog = OGCreateThread(hangWatchdogThread, NULL);
+    }
+
     // This is the 'main' that gets called when the ESP boots. It does not return
     app_main();
 }
 
 /**
  * @brief This is called from app_main() once each loop. This is effectively the emulator's main loop which handles key
- * inputs, drawing to the screen (both TFT and LEDs), and checking timers.
+ * inputs, checking timers, and pausing. The window is drawn by the render thread in the meantime.
  */
 void taskYIELD(void)
 {
     // Count total frames, just for callback reasons
     static uint64_t frameNum = 0;
+
+    OGLockMutex(extMutex);
     doExtPostFrameCb(frameNum);
 
     // Calculate time between calls
@@ -285,157 +460,464 @@ void taskYIELD(void)
         tLastCallUs    = tNowUs;
     }
 
-    // These are persistent!
-    static short lastWindow_w = 0;
-    static short lastWindow_h = 0;
+    // Quit if a frame or time limit was reached
+    checkExitLimits(frameNum);
+
+    if (emulatorArgs.deterministic)
+    {
+        // Step what would otherwise run on host threads, always in the same order and by the same fake time, before the
+        // timers and extensions below
+        ch32v003EmuStep(tElapsedUs);
+        midiLatchInput();
+    }
+
+    if (emulatorArgs.hangTimeoutUs)
+    {
+        // Let the watchdog know a frame finished
+        atomic_store(&lastFrameWallUs, getWallTimeUs());
+    }
+
+    if (emulatorArgs.batch || fastForward)
+    {
+        // No pausing and no sleeping, just the timers and extensions. The window is still drawn while fast forwarding
+        handleQueuedInputs();
+
+        if (!isRunning)
+        {
+            OGUnlockMutex(extMutex);
+            emulatorShutdown(frameNum);
+            return;
+        }
+
+        check_esp_timer(tElapsedUs);
+        doExtPreFrameCb(++frameNum);
+        OGUnlockMutex(extMutex);
+        return;
+    }
+    OGUnlockMutex(extMutex);
 
     // Below: Support for pausing and unpausing the emulator
     // Keep track of whether we've called the pre-frame callbacks yet
     bool preFrameCalled = false;
     do
     {
+        OGLockMutex(extMutex);
+
         // Always handle inputs
-        if (!CNFGHandleInput())
-        {
-            isRunning = false;
-        }
+        handleQueuedInputs();
 
-        // If not running anymore, don't handle graphics
-        // Must be checked after handling input, before graphics
+        // If not running anymore, stop here
         if (!isRunning)
         {
-            deinitSystem();
-            // This is registered with atexit()
-            // CNFGTearDown();
-
-            deinitExtensions();
-
-#ifdef ENABLE_GCOV
-            __gcov_dump();
-#endif
-
-            exit(0);
+            OGUnlockMutex(extMutex);
+            emulatorShutdown(frameNum);
             return;
         }
 
         // Check things here which are called by interrupts or timers on the Swadge
         check_esp_timer(tElapsedUs);
+        OGUnlockMutex(extMutex);
 
-        // Grey Background
-        CNFGBGColor = BG_COLOR;
-        CNFGClearFrame();
+        // Sleep for one ms
+        static struct timespec tRemaining = {0};
+        const struct timespec tSleep      = {
+                 .tv_sec  = 0 + tRemaining.tv_sec,
+                 .tv_nsec = 1000000 + tRemaining.tv_nsec,
+        };
+        nanosleep(&tSleep, &tRemaining);
 
-        // Get the current window dimensions
-        short window_w, window_h;
-        CNFGGetDimensions(&window_w, &window_h);
-        static emuPane_t screenPane;
+        // This means that the pre-frame callback gets called once (assuming the post-frame
+        // callback didn't already pause) and then, if one of them pauses, they don't get called
+        // again until after, which is good since that's the only way we'd be able to handle input
+        // as normal
+        OGLockMutex(extMutex);
+        if (!preFrameCalled && !emuTimerIsPaused())
+        {
+            preFrameCalled = true;
 
-        emuPaneMinimum_t paneMins[4];
-        bool panesChanged = calculatePaneMinimums(paneMins);
+            // Call the pre-frame callbacks just before we return to the swadge main loop
+            // When fnPreFrameCb is first called, the system is always initialized
+            // and this is the optimal time to inject button presses, pause, etc.
+            doExtPreFrameCb(++frameNum);
+        }
+        OGUnlockMutex(extMutex);
 
-        // If the dimensions changed
-        if (panesChanged || (lastWindow_h != window_h) || (lastWindow_w != window_w))
-        {
-            uint8_t screenMult;
-            // Recalculate the window layout and get the settings for the screen
-            layoutPanes(window_w, window_h, TFT_WIDTH, TFT_HEIGHT, &screenPane, &screenMult);
+        // Set the elapsed micros to 0 so ESP timer tasks don't get called repeatedly if we pause
+        // (if we just updated the time normally instead, this would be 0 anyway since time is paused, but this
+        // shortcuts that)
+        tElapsedUs = 0;
+
+        // Make sure we stop if no longer running, but otherwise run until the emulator is unpaused
+        // and the pre-frame callbacks have all been called
+    } while (isRunning && (!preFrameCalled || emuTimerIsPaused()));
+}
 
-            // Set the multiplier
-            setDisplayBitmapMultiplier(screenMult);
+/**
+ * @brief Create the window, sized to fit the display and every extension's panes. This is called from the render
+ * thread, which owns the window
+ */
+static void createWindow(void)
+{
+    if (emulatorArgs.fullscreen)
+    {
+        CNFGSetupFullscreen("Swadge 2024 Simulator", 0);
+    }
+    else
+    {
+        // Get all the pane info to see how much space we need aside from the simulated TFT screen
+        emuPaneMinimum_t paneMins[4] = {0};
+        calculatePaneMinimums(paneMins);
+        int32_t sidePanesW      = paneMins[PANE_LEFT].min + paneMins[PANE_RIGHT].min;
+        int32_t topBottomPanesH = paneMins[PANE_TOP].min + paneMins[PANE_BOTTOM].min;
+        int32_t winW            = (TFT_WIDTH) * 2 + sidePanesW;
+        int32_t winH            = (TFT_HEIGHT) * 2 + topBottomPanesH;
 
-            // Save for the next loop
-            lastWindow_w = window_w;
-            lastWindow_h = window_h;
+        if (emulatorArgs.headless)
+        {
+            // If the window dimensions are negative, the window will still exist but not be displayed.
+            // TODO does this work on all platforms?
+            winW = -winW;
+            winH = -winH;
         }
 
-        // Draw dividing lines, if they're on-screen
-        CNFGColor(DIV_COLOR);
+        // Add the screen size to the minimum pane sizes to get our window size
+        CNFGSetup("Swadge 2024 Simulator", winW, winH);
+    }
+}
+
+/**
+ * @brief The render thread. It creates the window, then handles its input and draws the newest frame until the
+ * emulator quits. Input is queued for the Swadge's thread rather than handled here
+ *
+ * @param arg Unused
+ * @return NULL
+ */
+static void* renderThreadFn(void* arg)
+{
+    createWindow();
+    OGUnlockSema(windowReadySema);
 
-        // Draw Left Divider
-        if (paneMins[PANE_LEFT].count > 0)
+    while (isRunning)
+    {
+        // rawdraw calls HandleKey() and friends from here, which queue the input
+        if (!CNFGHandleInput())
         {
-            CNFGTackSegment(screenPane.paneX - 1, 0, screenPane.paneX - 1, window_h);
+            isRunning = false;
+            break;
         }
 
-        // Draw Right Divider
-        if (paneMins[PANE_RIGHT].count > 0)
+        drawWindow();
+
+        // Display the image. This may wait for vsync, which no longer holds up the Swadge
+        CNFGSwapBuffers();
+
+        // Sleep for one ms
+        static struct timespec tRemaining = {0};
+        const struct timespec tSleep      = {
+                 .tv_sec  = 0 + tRemaining.tv_sec,
+                 .tv_nsec = 1000000 + tRemaining.tv_nsec,
+        };
+        nanosleep(&tSleep, &tRemaining);
+    }
+
+    stopTftScaleThreads();
+    return NULL;
+}
+
+/**
+ * @brief Draw the newest frame, the pane dividers, and everything extensions render. This is called from the render
+ * thread
+ */
+static void drawWindow(void)
+{
+    // These are persistent!
+    static short lastWindow_w    = 0;
+    static short lastWindow_h    = 0;
+    static emuPane_t screenPane  = {0};
+    static uint8_t screenMult    = 1;
+    static uint32_t* scaledFrame = NULL;
+
+    // Take the newest frame, if there is one
+    OGLockMutex(frameMutex);
+    bool newFrame = frameReady;
+    if (frameReady)
+    {
+        emuFrame_t* tmp = frontFrame;
+        frontFrame      = readyFrame;
+        readyFrame      = tmp;
+        frameReady      = false;
+    }
+    OGUnlockMutex(frameMutex);
+
+    // Grey Background
+    CNFGBGColor = BG_COLOR;
+    CNFGClearFrame();
+
+    // Get the current window dimensions
+    short window_w, window_h;
+    CNFGGetDimensions(&window_w, &window_h);
+
+    // Panes belong to the extensions
+    OGLockMutex(extMutex);
+    emuPaneMinimum_t paneMins[4];
+    bool panesChanged = calculatePaneMinimums(paneMins);
+
+    // If the dimensions changed
+    if (panesChanged || (lastWindow_h != window_h) || (lastWindow_w != window_w) || NULL == scaledFrame)
+    {
+        // Recalculate the window layout and get the settings for the screen
+        layoutPanes(window_w, window_h, TFT_WIDTH, TFT_HEIGHT, &screenPane, &screenMult);
+
+        // Reallocate the scaled frame
+        free(scaledFrame);
+        scaledFrame = calloc((screenMult * TFT_WIDTH) * (screenMult * TFT_HEIGHT), sizeof(uint32_t));
+        atomic_store(&displayScale, screenMult);
+        newFrame = true;
+
+        // Save for the next loop
+        lastWindow_w = window_w;
+        lastWindow_h = window_h;
+    }
+    OGUnlockMutex(extMutex);
+
+    // Draw dividing lines, if they're on-screen
+    CNFGColor(DIV_COLOR);
+
+    // Draw Left Divider
+    if (paneMins[PANE_LEFT].count > 0)
+    {
+        CNFGTackSegment(screenPane.paneX - 1, 0, screenPane.paneX - 1, window_h);
+    }
+
+    // Draw Right Divider
+    if (paneMins[PANE_RIGHT].count > 0)
+    {
+        CNFGTackSegment(screenPane.paneX + screenPane.paneW, 0, screenPane.paneX + screenPane.paneW, window_h);
+    }
+
+    // Draw Top Divider
+    if (paneMins[PANE_TOP].count > 0)
+    {
+        CNFGTackSegment(screenPane.paneX, screenPane.paneY - 1, screenPane.paneX + screenPane.paneW,
+                        screenPane.paneY - 1);
+    }
+
+    // Draw Bottom Divider
+    if (paneMins[PANE_BOTTOM].count > 0)
+    {
+        CNFGTackSegment(screenPane.paneX, screenPane.paneY + screenPane.paneH, screenPane.paneX + screenPane.paneW,
+                        screenPane.paneY + screenPane.paneH);
+    }
+
+    if (NULL != scaledFrame)
+    {
+        uint16_t bitmapWidth  = TFT_WIDTH * screenMult;
+        uint16_t bitmapHeight = TFT_HEIGHT * screenMult;
+
+        // Only scale frames once, not every time the window is drawn
+        if (newFrame)
         {
-            CNFGTackSegment(screenPane.paneX + screenPane.paneW, 0, screenPane.paneX + screenPane.paneW, window_h);
+            convertTftBitmap(frontFrame->pixels, frontFrame->brightness, scaledFrame, screenMult);
         }
 
-        // Draw Top Divider
-        if (paneMins[PANE_TOP].count > 0)
+#if defined(CONFIG_GC9307_240x280)
+        uint32_t cornerColor = CORNER_COLOR;
+        if (emuTimerIsPaused())
         {
-            CNFGTackSegment(screenPane.paneX, screenPane.paneY - 1, screenPane.paneX + screenPane.paneW,
-                            screenPane.paneY - 1);
+            cornerColor = PAUSED_COLOR;
         }
-
-        // Draw Bottom Divider
-        if (paneMins[PANE_BOTTOM].count > 0)
+        else if (isScreenRecording())
         {
-            CNFGTackSegment(screenPane.paneX, screenPane.paneY + screenPane.paneH, screenPane.paneX + screenPane.paneW,
-                            screenPane.paneY + screenPane.paneH);
+            cornerColor = RECORDING_COLOR;
         }
 
-        // Get the display memory
-        uint16_t bitmapWidth, bitmapHeight;
-        uint32_t* bitmapDisplay = getDisplayBitmap(&bitmapWidth, &bitmapHeight);
+        plotRoundedCorners(scaledFrame, bitmapWidth, bitmapHeight, screenMult * 40, cornerColor);
+#endif
+        // Update the display, centered
+        CNFGBlitImage(scaledFrame, screenPane.paneX, screenPane.paneY, bitmapWidth, bitmapHeight);
+    }
+
+    // After the screen has been fully rendered, call all the render callbacks to render anything else
+    OGLockMutex(extMutex);
+    doExtRenderCb(window_w, window_h);
+    OGUnlockMutex(extMutex);
+}
+
+/**
+ * @brief Queue an input event from rawdraw for the Swadge's thread. This is called from the render thread
+ *
+ * @param evt The event to queue
+ */
+static void queueInput(const emuInputEvt_t* evt)
+{
+    OGLockMutex(inputMutex);
+    emuInputEvt_t* last = inputQueueCount ? &inputQueue[inputQueueCount - 1] : NULL;
+    if (last && EMU_INPUT_MOUSE_MOVE == evt->type && EMU_INPUT_MOUSE_MOVE == last->type && last->code == evt->code)
+    {
+        // Only the newest position matters
+        *last = *evt;
+    }
+    else if (inputQueueCount < INPUT_QUEUE_LEN)
+    {
+        inputQueue[inputQueueCount++] = *evt;
+    }
+    OGUnlockMutex(inputMutex);
+}
 
-        if ((0 != bitmapWidth) && (0 != bitmapHeight) && (NULL != bitmapDisplay))
+/**
+ * @brief Handle the input events the render thread has queued, in the order they happened. This is called from the
+ * Swadge's thread
+ */
+static void handleQueuedInputs(void)
+{
+    // Copy the events out, so the render thread can keep queueing while they're handled
+    emuInputEvt_t events[INPUT_QUEUE_LEN];
+    OGLockMutex(inputMutex);
+    int count = inputQueueCount;
+    memcpy(events, inputQueue, count * sizeof(emuInputEvt_t));
+    inputQueueCount = 0;
+    OGUnlockMutex(inputMutex);
+
+    for (int i = 0; i < count; i++)
+    {
+        const emuInputEvt_t* evt = &events[i];
+        switch (evt->type)
         {
-#if defined(CONFIG_GC9307_240x280)
-            uint32_t cornerColor = CORNER_COLOR;
-            if (emuTimerIsPaused())
+            case EMU_INPUT_KEY:
             {
-                cornerColor = PAUSED_COLOR;
+                handleKeyInput(evt->code, evt->down);
+                break;
             }
-            else if (isScreenRecording())
+            case EMU_INPUT_MOUSE_BUTTON:
             {
-                cornerColor = RECORDING_COLOR;
+#ifdef DEBUG_INPUTS
+                printf("HandleButton(x=%d, y=%d, button=%x, bDown=%s\n", evt->x, evt->y, evt->code,
+                       evt->down ? "true" : "false");
+#endif
+                doExtMouseButtonCb(evt->x, evt->y, evt->code, evt->down);
+                break;
             }
-
-            plotRoundedCorners(bitmapDisplay, bitmapWidth, bitmapHeight, (bitmapWidth / TFT_WIDTH) * 40, cornerColor);
+            case EMU_INPUT_MOUSE_MOVE:
+            {
+#ifdef DEBUG_INPUTS
+                printf("HandleMotion(x=%d, y=%d, mask=%x\n", evt->x, evt->y, evt->code);
 #endif
-            // Update the display, centered
-            CNFGBlitImage(bitmapDisplay, screenPane.paneX, screenPane.paneY, bitmapWidth, bitmapHeight);
+                doExtMouseMoveCb(evt->x, evt->y, evt->code);
+                break;
+            }
         }
+    }
+}
 
-        // After the screen has been fully rendered, call all the render callbacks to render anything else
-        doExtRenderCb(window_w, window_h);
+/**
+ * @brief Get the host's monotonic clock time
+ *
+ * @return The wall clock time in microseconds
+ */
+static int64_t getWallTimeUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
 
-        // Display the image and wait for time to display next frame.
-        CNFGSwapBuffers();
+/**
+ * @brief Stop the emulator if it has run for the number of frames or the simulated time given by --frames or
+ * --duration
+ *
+ * @param frameNum The number of frames run so far
+ */
+static void checkExitLimits(uint64_t frameNum)
+{
+    if ((emulatorArgs.exitFrames && frameNum >= emulatorArgs.exitFrames)
+        || (emulatorArgs.exitTimeUs && (uint64_t)esp_timer_get_time() >= emulatorArgs.exitTimeUs))
+    {
+        isRunning = false;
+    }
+}
 
-        // Sleep for one ms
-        static struct timespec tRemaining = {0};
-        const struct timespec tSleep      = {
-                 .tv_sec  = 0 + tRemaining.tv_sec,
-                 .tv_nsec = 1000000 + tRemaining.tv_nsec,
-        };
-        nanosleep(&tSleep, &tRemaining);
+/**
+ * @brief Watch for frames which take longer than the --hang-timeout. When one does, report a hang and interrupt the
+ * Swadge's thread so the crash handler prints where it was stuck
+ *
+ * @param arg Unused
+ * @return NULL
+ */
+static void* hangWatchdogThread(void* arg)
+{
+    while (isRunning)
+    {
+        OGUSleep(100000);
 
-        // This means that the pre-frame callback gets called once (assuming the post-frame
-        // callback didn't already pause) and then, if one of them pauses, they don't get called
-        // again until after, which is good since that's the only way we'd be able to handle input
-        // as normal
-        if (!preFrameCalled && !emuTimerIsPaused())
+        int64_t nowUs = getWallTimeUs();
+        if (emuTimerIsPaused())
         {
-            preFrameCalled = true;
+            // Time spent paused isn't a hang
+            atomic_store(&lastFrameWallUs, nowUs);
+            continue;
+        }
 
-            // Call the pre-frame callbacks just before we return to the swadge main loop
-            // When fnPreFrameCb is first called, the system is always initialized
-            // and this is the optimal time to inject button presses, pause, etc.
-            doExtPreFrameCb(++frameNum);
+        int64_t stalledUs = nowUs - atomic_load(&lastFrameWallUs);
+        if (stalledUs > (int64_t)emulatorArgs.hangTimeoutUs)
+        {
+            printf("HANG: No frame finished in %.1f seconds, at %.3f simulated seconds\n", stalledUs / 1000000.0,
+                   esp_timer_get_time() / 1000000.0);
+            fflush(stdout);
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__LINUX__) || defined(__APPLE__)
+            pthread_kill(mainThread, SIGABRT);
+#else
+            _exit(1);
+#endif
+            break;
         }
+    }
+    return NULL;
+}
 
-        // Set the elapsed micros to 0 so ESP timer tasks don't get called repeatedly if we pause
-        // (if we just updated the time normally instead, this would be 0 anyway since time is paused, but this
-        // shortcuts that)
-        tElapsedUs = 0;
+/**
+ * @brief Deinitialize everything and exit the emulator. In batch mode, or when a frame or time limit was given, print
+ * how fast simulated time ran compared to the wall clock first
+ *
+ * @param frameNum The number of frames run
+ */
+static void emulatorShutdown(uint64_t frameNum)
+{
+    // Stop drawing before anything is deinitialized
+    isRunning = false;
+    if (renderThread)
+    {
+        OGJoinThread(renderThread);
+        renderThread = NULL;
+    }
+    if (hangWatchdog)
+    {
+        OGJoinThread(hangWatchdog);
+        hangWatchdog = NULL;
+    }
 
-        // Make sure we stop if no longer running, but otherwise run until the emulator is unpaused
-        // and the pre-frame callbacks have all been called
-    } while (isRunning && (!preFrameCalled || emuTimerIsPaused()));
+    if (emulatorArgs.batch || emulatorArgs.exitFrames || emulatorArgs.exitTimeUs)
+    {
+        double simSecs  = esp_timer_get_time() / 1000000.0;
+        double wallSecs = (getWallTimeUs() - wallStartUs) / 1000000.0;
+        printf("Ran %" PRIu64 " frames, %.3f simulated seconds in %.3f wall seconds (%.2f simulated seconds per wall "
+               "second)\n",
+               frameNum, simSecs, wallSecs, (wallSecs > 0) ? (simSecs / wallSecs) : 0.0);
+        fflush(stdout);
+    }
+
+    // Snapshots keep freed memory from going back to the host, so they go first
+    emuSnapshotDropAll();
+    deinitSystem();
+    // This is registered with atexit()
+    // CNFGTearDown();
+
+    deinitExtensions();
+
+#ifdef ENABLE_GCOV
+    __gcov_dump();
+#endif
+
+    exit(exitCode);
 }
 
 /**
@@ -493,12 +975,29 @@ void plotRoundedCorners(uint32_t* bitmapDisplay, int width, int height, int r, u
 }
 
 /**
- * This function must be provided for rawdraw. Key events are received here
+ * This function must be provided for rawdraw. Key events are received here, on the render thread, and queued for the
+ * Swadge's thread
  *
  * @param keycode The key code, a lowercase ascii char
  * @param bDown true if the key was pressed, false if it was released
  */
 void HandleKey(int keycode, int bDown)
+{
+    emuInputEvt_t evt = {
+        .type = EMU_INPUT_KEY,
+        .code = keycode,
+        .down = bDown,
+    };
+    queueInput(&evt);
+}
+
+/**
+ * @brief Handle a key event queued by HandleKey(). This is called from the Swadge's thread
+ *
+ * @param keycode The key code, a lowercase ascii char
+ * @param bDown true if the key was pressed, false if it was released
+ */
+static void handleKeyInput(int keycode, int bDown)
 {
     static modKey_t modifiers = EMU_MOD_NONE;
 
@@ -596,7 +1095,7 @@ void HandleKey(int keycode, int bDown)
 }
 
 /**
- * @brief Handle mouse click events from rawdraw
+ * @brief Handle mouse click events from rawdraw, on the render thread, by queueing them for the Swadge's thread
  *
  * @param x The x coordinate of the mouse event
  * @param y The y coordinate of the mouse event
@@ -605,15 +1104,18 @@ void HandleKey(int keycode, int bDown)
  */
 void HandleButton(int x, int y, int button, int bDown)
 {
-#ifdef DEBUG_INPUTS
-    printf("HandleButton(x=%d, y=%d, button=%x, bDown=%s\n", x, y, button, bDown ? "true" : "false");
-#endif
-
-    doExtMouseButtonCb(x, y, button, bDown);
+    emuInputEvt_t evt = {
+        .type = EMU_INPUT_MOUSE_BUTTON,
+        .x    = x,
+        .y    = y,
+        .code = button,
+        .down = bDown,
+    };
+    queueInput(&evt);
 }
 
 /**
- * @brief Handle mouse motion events from rawdraw
+ * @brief Handle mouse motion events from rawdraw, on the render thread, by queueing them for the Swadge's thread
  *
  * @param x The x coordinate of the mouse event
  * @param y The y coordinate of the mouse event
@@ -621,11 +1123,13 @@ void HandleButton(int x, int y, int button, int bDown)
  */
 void HandleMotion(int x, int y, int mask)
 {
-#ifdef DEBUG_INPUTS
-    printf("HandleMotion(x=%d, y=%d, mask=%x\n", x, y, mask);
-#endif
-
-    doExtMouseMoveCb(x, y, mask);
+    emuInputEvt_t evt = {
+        .type = EMU_INPUT_MOUSE_MOVE,
+        .x    = x,
+        .y    = y,
+        .code = mask,
+    };
+    queueInput(&evt);
 }
 
 #if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "palette.h"
+
 #define WARN_UNIMPLEMENTED()                           \
     {                                                  \
         static bool printed = false;                   \
@@ -15,4 +17,8 @@
     }
 
 void emulatorQuit(void);
+void emulatorSetFastForward(bool enable);
+void emulatorSetExitCode(int code);
+void emulatorSubmitFrame(const paletteColor_t* fb, uint8_t brightness);
+uint8_t emulatorGetDisplayScale(void);
 void plotRoundedCorners(uint32_t* bitmapDisplay, int w, int h, int r, uint32_t col);
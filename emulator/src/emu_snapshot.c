@@ -0,0 +1,230 @@
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "emu_snapshot.h"
+#include "esp_heap_caps_emu.h"
+#include "esp_random_emu.h"
+#include "esp_timer.h"
+#include "esp_timer_emu.h"
+#include "hdw-btn_emu.h"
+#include "hdw-imu_emu.h"
+#include "hdw-nvs_emu.h"
+#include "hdw-tft_emu.h"
+#include "macros.h"
+#include "swadge2024.h"
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief A saved state of the emulated Swadge
+ */
+typedef struct emuSnapshot
+{
+    char* name;
+    /// The mode which was running when the snapshot was saved
+    const swadgeMode_t* mode;
+    /// When the snapshot was saved, from esp_timer_get_time()
+    int64_t time;
+
+    emuHeapSnapshot_t* heap;
+    emuTimerState_t* timers;
+    emuRandomState_t random;
+    emuButtonState_t* buttons;
+    int16_t accel[3];
+    emuTftState_t* tft;
+    emuNvsState_t* nvs;
+
+    struct emuSnapshot* next;
+} emuSnapshot_t;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static emuSnapshot_t** findSnapshot(const char* name);
+static void freeSnapshot(emuSnapshot_t* snap);
+
+//==============================================================================
+// Variables
+//==============================================================================
+
+/// Every saved snapshot, most recent first
+static emuSnapshot_t* snapshots = NULL;
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+/**
+ * @brief Save the state of the emulated Swadge. A snapshot with the same name is replaced
+ *
+ * @param name The snapshot's name
+ * @return true if the snapshot was saved, false if it wasn't
+ */
+bool emuSnapshotSave(const char* name)
+{
+    if (NULL == getSwadgeMode())
+    {
+        printf("ERR! emu_snapshot.c: No mode is running\n");
+        return false;
+    }
+
+    emuSnapshot_t* snap = calloc(1, sizeof(emuSnapshot_t));
+    snap->heap          = emuHeapSaveSnapshot();
+    if (NULL == snap->heap)
+    {
+        printf("ERR! emu_snapshot.c: Not enough memory to save the heap\n");
+        free(snap);
+        return false;
+    }
+
+    snap->name    = strdup(name);
+    snap->mode    = getSwadgeMode();
+    snap->time    = esp_timer_get_time();
+    snap->timers  = emuTimerSaveState();
+    snap->buttons = emulatorSaveButtonState();
+    snap->tft     = emulatorSaveTftState();
+    snap->nvs     = emuNvsSaveState();
+    emulatorSaveRandomState(&snap->random);
+    emulatorGetAccelerometer(&snap->accel[0], &snap->accel[1], &snap->accel[2]);
+
+    // Replace the old snapshot after saving the new one, so memory they both have stays where it is
+    emuSnapshotDrop(name);
+    snap->next = snapshots;
+    snapshots  = snap;
+    return true;
+}
+
+/**
+ * @brief Put the emulated Swadge back the way it was when a snapshot was saved. The snapshot is kept, so it can be
+ * restored again
+ *
+ * @param name The snapshot's name
+ * @return true if the snapshot was restored, false if it doesn't exist or can't be restored in this mode
+ */
+bool emuSnapshotRestore(const char* name)
+{
+    emuSnapshot_t** link = findSnapshot(name);
+    if (NULL == link)
+    {
+        printf("ERR! emu_snapshot.c: No snapshot named %s\n", name);
+        return false;
+    }
+
+    emuSnapshot_t* snap = *link;
+    if (snap->mode != getSwadgeMode() || !emuHeapRestoreSnapshot(snap->heap))
+    {
+        printf("ERR! emu_snapshot.c: Snapshot %s was saved in %s, and the mode has changed since then\n", name,
+               snap->mode->modeName);
+        return false;
+    }
+
+    // Timers are on the heap, so they're restored after it
+    emuTimerRestoreState(snap->timers);
+    emulatorRestoreButtonState(snap->buttons);
+    emulatorSetAccelerometer(snap->accel[0], snap->accel[1], snap->accel[2]);
+    emulatorRestoreTftState(snap->tft);
+    emulatorRestoreRandomState(&snap->random);
+    if (snap->nvs && !emuNvsRestoreState(snap->nvs))
+    {
+        printf("ERR! emu_snapshot.c: Couldn't write NVS while restoring %s\n", name);
+    }
+    return true;
+}
+
+/**
+ * @brief Delete a snapshot
+ *
+ * @param name The snapshot's name
+ * @return true if the snapshot was deleted, false if it doesn't exist
+ */
+bool emuSnapshotDrop(const char* name)
+{
+    emuSnapshot_t** link = findSnapshot(name);
+    if (NULL == link)
+    {
+        return false;
+    }
+
+    emuSnapshot_t* snap = *link;
+    *link               = snap->next;
+    freeSnapshot(snap);
+    return true;
+}
+
+/**
+ * @brief Delete every snapshot
+ */
+void emuSnapshotDropAll(void)
+{
+    while (snapshots)
+    {
+        emuSnapshot_t* snap = snapshots;
+        snapshots           = snap->next;
+        freeSnapshot(snap);
+    }
+}
+
+/**
+ * @brief Write a list of every snapshot, one per line
+ *
+ * @param out The buffer to write to
+ * @param size The size of the buffer
+ * @return The number of characters written, not counting the terminator
+ */
+int emuSnapshotList(char* out, size_t size)
+{
+    int len = 0;
+    out[0]  = '\0';
+    for (const emuSnapshot_t* snap = snapshots; NULL != snap && len < (int)size; snap = snap->next)
+    {
+        uint32_t numAllocs = 0;
+        size_t bytes       = emuHeapGetSnapshotSize(snap->heap, &numAllocs);
+        len += snprintf(out + len, size - len, "%s: %s at %" PRId64 " ms, %" PRIu32 " allocations, %zu bytes\n",
+                        snap->name, snap->mode->modeName, snap->time / 1000, numAllocs, bytes);
+    }
+    return MIN(len, (int)size - 1);
+}
+
+/**
+ * @brief Find a snapshot by name
+ *
+ * @param name The snapshot's name
+ * @return The link to the snapshot in ::snapshots, or NULL if there isn't one with that name
+ */
+static emuSnapshot_t** findSnapshot(const char* name)
+{
+    for (emuSnapshot_t** link = &snapshots; NULL != *link; link = &(*link)->next)
+    {
+        if (!strcmp((*link)->name, name))
+        {
+            return link;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Free a snapshot which isn't in ::snapshots anymore
+ *
+ * @param snap The snapshot to free
+ */
+static void freeSnapshot(emuSnapshot_t* snap)
+{
+    emuHeapFreeSnapshot(snap->heap);
+    emuTimerFreeState(snap->timers);
+    emulatorFreeButtonState(snap->buttons);
+    emulatorFreeTftState(snap->tft);
+    emuNvsFreeState(snap->nvs);
+    free(snap->name);
+    free(snap);
+}
@@ -0,0 +1,40 @@
+/*! \file emu_snapshot.h
+ *
+ * \section emu_snapshot Emulator Snapshots
+ *
+ * A snapshot saves the state of the emulated Swadge so it can be put back later, to replay the same few seconds of a
+ * mode over and over while debugging or measuring it. A snapshot has:
+ * - Everything the Swadge has allocated on its heap, like mode state and MIDI players, at the same addresses, and
+ *   where it was in the modeled heap
+ * - Every esp_timer, and how long until each running timer expires
+ * - The state of esp_random(), so the same random numbers are generated after a restore
+ * - Which buttons are held, button events which haven't been handled yet, the touchpad, and the accelerometer
+ * - The framebuffer, the last frame sent to the display, and the backlight
+ * - Everything in NVS. Restoring writes the changed values back to the NVS file, like the Swadge writing them
+ *
+ * Snapshots are only kept in memory, and can only be restored in the same mode they were saved in, without switching
+ * modes in between. They can't be saved to a file, since the Swadge's memory is full of pointers which are only valid
+ * in this process.
+ *
+ * Some state isn't saved:
+ * - Static variables which aren't on the heap, in modes or elsewhere in the firmware. Modes which keep all their state
+ *   in memory allocated in \c fnEnterMode restore completely
+ * - The clock. esp_timer_get_time() keeps going forward after a restore, since the main loop would break if time went
+ *   backward. Timers still expire as long after the restore as they would have after the snapshot
+ * - Audio and LEDs, which are overwritten by the mode anyway
+ * - Random numbers from rand(), rather than esp_random()
+ *
+ * Snapshots must only be saved and restored on the Swadge's thread between frames, like from an extension's pre-frame
+ * or post-frame callback or a console command.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+bool emuSnapshotSave(const char* name);
+bool emuSnapshotRestore(const char* name);
+bool emuSnapshotDrop(const char* name);
+void emuSnapshotDropAll(void);
+int emuSnapshotList(char* out, size_t size);
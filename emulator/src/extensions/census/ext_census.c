@@ -0,0 +1,413 @@
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ext_census.h"
+#include "ext_modes.h"
+#include "emu_args.h"
+#include "emu_main.h"
+#include "esp_heap_caps.h"
+#include "esp_random_emu.h"
+#include "esp_sleep_emu.h"
+#include "profiler.h"
+#include "swadge2024.h"
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// The fuzzer seed used if --seed wasn't given
+#define CENSUS_DEFAULT_SEED 0x5EED
+
+/// How many frames a mode switch is retried for before the mode is skipped
+#define CENSUS_SWITCH_FRAMES 10
+
+//==============================================================================
+// Enums
+//==============================================================================
+
+typedef enum
+{
+    /// The census hasn't started
+    CENSUS_IDLE,
+    /// A mode switch was requested and will happen at the end of the frame
+    CENSUS_SWITCHING,
+    /// The mode is running and its frames are being measured
+    CENSUS_RUNNING,
+    /// Every mode has been measured
+    CENSUS_DONE,
+} censusState_t;
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief The measurements for one mode
+ */
+typedef struct
+{
+    const char* name;
+    bool skipped;
+    double frameAvgUs;
+    double frameP99Us;
+    double audioAvgUs;
+    double audioP99Us;
+    size_t peakInternal;
+    size_t peakSpiram;
+    double loadMs;
+} censusResult_t;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static bool censusInit(emuArgs_t* emuArgs);
+static void censusDeinit(void);
+static void censusPreFrame(uint64_t frame);
+static void censusPostFrame(uint64_t frame);
+static void startMode(int idx);
+static void finishMode(void);
+static void nextMode(void);
+static void writeResults(void);
+static int compareTicks(const void* a, const void* b);
+static double percentileUs(uint64_t* samples, uint32_t count, uint32_t percent);
+
+//==============================================================================
+// Variables
+//==============================================================================
+
+emuExtension_t censusEmuExtension = {
+    .name            = "census",
+    .fnInitCb        = censusInit,
+    .fnDeinitCb      = censusDeinit,
+    .fnPreFrameCb    = censusPreFrame,
+    .fnPostFrameCb   = censusPostFrame,
+    .fnKeyCb         = NULL,
+    .fnMouseMoveCb   = NULL,
+    .fnMouseButtonCb = NULL,
+    .fnRenderCb      = NULL,
+};
+
+static censusState_t state = CENSUS_IDLE;
+
+/// Every mode, in the order they're measured
+static swadgeMode_t* const* modes = NULL;
+static int numModes               = 0;
+static int modeIdx                = 0;
+
+/// Per-frame samples for the current mode, in profiler ticks
+static uint64_t* frameTicks = NULL;
+static uint64_t* audioTicks = NULL;
+static uint32_t numFrames   = 0;
+
+/// Time spent entering the current mode, in profiler ticks
+static uint64_t loadTicks = 0;
+
+/// Frames since the current mode switch was requested
+static uint32_t switchFrames = 0;
+
+/// Every mode's measurements. Modes which haven't been measured or skipped yet have no name
+static censusResult_t* results = NULL;
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+/**
+ * @brief Set up the census if --census was given
+ *
+ * @param emuArgs The parsed command-line arguments
+ * @return true if running a census, false if not
+ */
+static bool censusInit(emuArgs_t* emuArgs)
+{
+    if (!emuArgs->censusFile)
+    {
+        return false;
+    }
+
+    modes      = emulatorGetSwadgeModes(&numModes);
+    results    = calloc(numModes, sizeof(censusResult_t));
+    frameTicks = calloc(emuArgs->censusFrames, sizeof(uint64_t));
+    audioTicks = calloc(emuArgs->censusFrames, sizeof(uint64_t));
+
+    // Modes the fuzzer wanders into can't switch away, only the census can
+    emulatorSetSwadgeModeLocked(true);
+
+    printf("Census: Running %d modes for %" PRIu32 " frames each\n", numModes, emuArgs->censusFrames);
+    return true;
+}
+
+/**
+ * @brief Write what was measured if the emulator quit before the census finished, and fail the run if any mode was
+ * skipped or not reached
+ */
+static void censusDeinit(void)
+{
+    if (!emulatorArgs.censusFile)
+    {
+        return;
+    }
+
+    bool failed = (CENSUS_DONE != state);
+    if (failed)
+    {
+        printf("ERR! ext_census.c: The emulator quit before the census finished\n");
+        writeResults();
+    }
+
+    for (int i = 0; i < numModes && !failed; i++)
+    {
+        failed = results[i].skipped;
+    }
+    free(results);
+    results = NULL;
+
+    if (failed)
+    {
+        emulatorSetExitCode(1);
+    }
+}
+
+/**
+ * @brief Start the census with the first mode
+ *
+ * @param frame The frame about to run
+ */
+static void censusPreFrame(uint64_t frame)
+{
+    if (CENSUS_IDLE == state)
+    {
+        startMode(0);
+    }
+}
+
+/**
+ * @brief Measure the frame which just ended, and move on to the next mode after enough frames
+ *
+ * @param frame The frame which just ended
+ */
+static void censusPostFrame(uint64_t frame)
+{
+    if (CENSUS_SWITCHING == state)
+    {
+        const profileZoneStats_t* enter = profileFindZone("fnEnterMode");
+        if (enter && enter->lastCalls)
+        {
+            loadTicks = enter->lastTicks;
+        }
+
+        // A pending mode switch usually happens at the end of the next frame, but ask again for a few frames in case
+        // it didn't take, then skip the mode so the rest still get measured
+        if (getSwadgeMode() != modes[modeIdx])
+        {
+            if (++switchFrames < CENSUS_SWITCH_FRAMES)
+            {
+                emulatorForceSwitchToSwadgeMode(modes[modeIdx]);
+            }
+            else
+            {
+                printf("ERR! ext_census.c: Couldn't switch to %s, skipping it\n", modes[modeIdx]->modeName);
+                results[modeIdx].name    = modes[modeIdx]->modeName;
+                results[modeIdx].skipped = true;
+                nextMode();
+            }
+            return;
+        }
+
+        // Each mode gets the same input no matter what ran before it
+        uint32_t seed = (UINT32_MAX != (uint32_t)emulatorArgs.seed) ? (uint32_t)emulatorArgs.seed : CENSUS_DEFAULT_SEED;
+        for (const char* c = modes[modeIdx]->modeName; *c; c++)
+        {
+            seed = (seed ^ (uint8_t)*c) * 0x01000193U;
+        }
+        emulatorSetEspRandomSeed(seed);
+
+        numFrames = 0;
+        state     = CENSUS_RUNNING;
+    }
+    else if (CENSUS_RUNNING == state)
+    {
+        uint32_t numEvents = 0;
+        uint64_t start     = 0;
+        uint64_t end       = 0;
+        profileGetFrameEvents(&numEvents, &start, &end);
+
+        frameTicks[numFrames] = end - start;
+        audioTicks[numFrames] = profileGetZoneLastTicks("fnAudioCallback") + profileGetZoneLastTicks("fnDacCb");
+        numFrames++;
+
+        if (numFrames >= emulatorArgs.censusFrames)
+        {
+            finishMode();
+            nextMode();
+        }
+    }
+}
+
+/**
+ * @brief Switch to a mode to measure it
+ *
+ * @param idx The mode's index in the mode list
+ */
+static void startMode(int idx)
+{
+    modeIdx      = idx;
+    loadTicks    = 0;
+    switchFrames = 0;
+    state        = CENSUS_SWITCHING;
+
+    printf("Census: %d/%d %s\n", idx + 1, numModes, modes[idx]->modeName);
+    emulatorForceSwitchToSwadgeMode(modes[idx]);
+}
+
+/**
+ * @brief Save the current mode's measurements
+ */
+static void finishMode(void)
+{
+    censusResult_t* result = &results[modeIdx];
+    double ticksPerUs      = profileGetTicksPerUs();
+
+    uint64_t frameSum = 0;
+    uint64_t audioSum = 0;
+    for (uint32_t i = 0; i < numFrames; i++)
+    {
+        frameSum += frameTicks[i];
+        audioSum += audioTicks[i];
+    }
+
+    result->name       = modes[modeIdx]->modeName;
+    result->frameAvgUs = frameSum / ticksPerUs / numFrames;
+    result->audioAvgUs = audioSum / ticksPerUs / numFrames;
+    result->frameP99Us = percentileUs(frameTicks, numFrames, 99);
+    result->audioP99Us = percentileUs(audioTicks, numFrames, 99);
+    result->loadMs     = loadTicks / ticksPerUs / 1000.0;
+
+    // The mode's peak is reset when it's entered, so this is only this mode
+    heapCapsStats_t stats;
+    heapCapsGetStats(&stats);
+    result->peakInternal = stats.modePeakInternal;
+    result->peakSpiram   = stats.modePeakSpiram;
+}
+
+/**
+ * @brief Start the next mode, or write the results and quit if this was the last one
+ */
+static void nextMode(void)
+{
+    if (modeIdx + 1 < numModes)
+    {
+        startMode(modeIdx + 1);
+    }
+    else
+    {
+        state = CENSUS_DONE;
+        writeResults();
+        emulatorQuit();
+    }
+}
+
+/**
+ * @brief Write the measurements of every mode which was measured or skipped to the census file as CSV, and print them
+ * as a table
+ */
+static void writeResults(void)
+{
+    FILE* csv = fopen(emulatorArgs.censusFile, "w");
+    if (!csv)
+    {
+        printf("ERR! ext_census.c: Unable to open %s for writing\n", emulatorArgs.censusFile);
+    }
+    else
+    {
+        fprintf(csv, "Mode,Frames,Frame Avg us,Frame P99 us,Audio Avg us,Audio P99 us,Internal Peak,SPIRAM Peak,"
+                     "Load ms,Skipped\n");
+    }
+
+    printf("\n%-24s %10s %10s %10s %10s %10s %10s %9s\n", "Mode", "Frame avg", "Frame p99", "Audio avg", "Audio p99",
+           "Int peak", "SPI peak", "Load ms");
+    for (int i = 0; i < numModes; i++)
+    {
+        const censusResult_t* r = &results[i];
+        if (!r->name)
+        {
+            continue;
+        }
+        else if (r->skipped)
+        {
+            printf("%-24s skipped, couldn't switch to it\n", r->name);
+        }
+        else
+        {
+            printf("%-24s %10.1f %10.1f %10.1f %10.1f %10zu %10zu %9.2f\n", r->name, r->frameAvgUs, r->frameP99Us,
+                   r->audioAvgUs, r->audioP99Us, r->peakInternal, r->peakSpiram, r->loadMs);
+        }
+
+        if (csv)
+        {
+            // Mode names may contain commas
+            fputc('"', csv);
+            for (const char* c = r->name; *c; c++)
+            {
+                if ('"' == *c)
+                {
+                    fputc('"', csv);
+                }
+                fputc(*c, csv);
+            }
+            fprintf(csv, "\",%" PRIu32 ",%.1f,%.1f,%.1f,%.1f,%zu,%zu,%.2f,%d\n",
+                    r->skipped ? 0 : emulatorArgs.censusFrames, r->frameAvgUs, r->frameP99Us, r->audioAvgUs,
+                    r->audioP99Us, r->peakInternal, r->peakSpiram, r->loadMs, r->skipped);
+        }
+    }
+
+    if (csv)
+    {
+        fclose(csv);
+        printf("Census: Wrote %s\n", emulatorArgs.censusFile);
+    }
+
+    free(frameTicks);
+    free(audioTicks);
+    frameTicks = NULL;
+    audioTicks = NULL;
+}
+
+/**
+ * @brief qsort() comparator for ticks, smallest first
+ */
+static int compareTicks(const void* a, const void* b)
+{
+    uint64_t aTicks = *(const uint64_t*)a;
+    uint64_t bTicks = *(const uint64_t*)b;
+    return (aTicks > bTicks) - (aTicks < bTicks);
+}
+
+/**
+ * @brief Get a percentile of some samples. The samples are sorted in place
+ *
+ * @param samples The samples, in profiler ticks
+ * @param count The number of samples
+ * @param percent The percentile to get, from 1 to 100
+ * @return The percentile, in microseconds
+ */
+static double percentileUs(uint64_t* samples, uint32_t count, uint32_t percent)
+{
+    if (0 == count)
+    {
+        return 0;
+    }
+
+    qsort(samples, count, sizeof(uint64_t), compareTicks);
+
+    // The smallest sample which at least this percent of samples are no bigger than
+    uint32_t idx = (count * percent + 99) / 100;
+    idx          = (idx > 0) ? idx - 1 : 0;
+    return samples[idx] / (double)profileGetTicksPerUs();
+}
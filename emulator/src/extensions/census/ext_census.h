@@ -0,0 +1,26 @@
+/*! \file ext_census.h
+ *
+ * \section ext_census Census Emulator Extension
+ *
+ * When the emulator is run with \c --census=FILE, it enters every mode in the mode list one after another, runs each
+ * for \c --census-frames frames with fuzzed input, and writes a CSV table of how each mode performed to \c FILE. A
+ * census runs in batch mode, so it is headless, uses fake time, and runs as fast as possible.
+ *
+ * For each mode, the table has the average and 99th percentile time of a whole frame and of the audio callbacks
+ * (\c fnAudioCallback and \c fnDacCb) in each frame, the peak heap usage while the mode ran, and how long \c
+ * fnEnterMode took, which is mostly loading assets. Times are real time spent by the host, measured by the profiling
+ * zones in profiler.h, so they're only comparable between runs on the same computer.
+ *
+ * The fuzzer is seeded again when each mode starts, so each mode gets the same input every run, no matter which modes
+ * came before it.
+ *
+ * A mode which still isn't running a few frames after switching to it is skipped and marked as skipped in the table.
+ * The table is written even if the emulator quits before the census finishes, and the emulator's exit code is nonzero
+ * if any mode was skipped or not reached.
+ */
+
+#pragma once
+
+#include "emu_ext.h"
+
+extern emuExtension_t censusEmuExtension;
@@ -76,6 +76,8 @@ static const struct option* findOption(char shortOpt, const char* longOpt);
 static void getOptionsStr(char* buffer, int buflen);
 static void printColWordWrap(const char* text, int* col, int startCol, int wrapCol);
 static bool parseBoolArg(const char* val, bool defaultValue);
+static bool parseFloatArg(const char* arg, float min, float max, float* out);
+static bool parseIntArg(const char* arg, long min, long max, long* out);
 
 //==============================================================================
 // Variables
@@ -94,6 +96,15 @@ emuArgs_t emulatorArgs = {
 
     .headless = false,
 
+    .batch         = false,
+    .deterministic = false,
+    .exitFrames    = 0,
+    .exitTimeUs    = 0,
+
+    .hangTimeoutUs = 0,
+    .hitchBudgetUs = 0,
+    .nvsFile       = NULL,
+
     .keymap = NULL,
 
     .lock = false,
@@ -111,8 +122,33 @@ emuArgs_t emulatorArgs = {
     .record   = false,
     .playback = false,
 
-    .recordFile = NULL,
-    .replayFile = NULL,
+    .recordFile    = NULL,
+    .replayFile    = NULL,
+    .replayConvert     = NULL,
+    .seekUs            = 0,
+    .replayCrcInterval = 0,
+
+    .audioLeadMs = 64,
+
+    .videoPipe   = NULL,
+    .videoFormat = "y4m",
+    .videoFps    = 60,
+
+    .traceFile = NULL,
+
+    .heapModel    = false,
+    .heapFailRate = 0,
+
+    .censusFile   = NULL,
+    .censusFrames = 600,
+
+    .radioRxDelayMs  = 0,
+    .radioRxJitterMs = 0,
+    .radioRxLossPct  = 0,
+    .radioRxDupPct   = 0,
+    .radioX          = 0,
+    .radioY          = 0,
+    .espNowPort      = 32888,
 
     .seed = UINT32_MAX,
 
@@ -128,16 +164,28 @@ static const char mainDoc[] = "Emulates a swadge";
 // Long argument name definitions
 // These MUST be defined here, so that they are
 // the same in both options and argDocs
+static const char argAudioLead[]     = "audio-lead";
+static const char argBatch[]         = "batch";
+static const char argCensus[]        = "census";
+static const char argCensusFrames[]  = "census-frames";
+static const char argDeterministic[] = "deterministic";
+static const char argDuration[]      = "duration";
+static const char argEspNowPort[]    = "espnow-port";
 static const char argFakeFps[]       = "fake-fps";
 static const char argFakeTime[]      = "fake-time";
+static const char argFrames[]        = "frames";
 static const char argFullscreen[]    = "fullscreen";
 static const char argFuzz[]          = "fuzz";
 static const char argFuzzButtons[]   = "fuzz-buttons";
 static const char argFuzzTouch[]     = "fuzz-touch";
 static const char argFuzzTime[]      = "fuzz-time";
 static const char argFuzzMotion[]    = "fuzz-motion";
+static const char argHangTimeout[]   = "hang-timeout";
 static const char argHeadless[]      = "headless";
+static const char argHeapFail[]      = "heap-fail";
+static const char argHeapModel[]     = "heap-model";
 static const char argHideLeds[]      = "hide-leds";
+static const char argHitchBudget[]   = "hitch-budget";
 static const char argJoystick[]      = "joystick";
 static const char argJsPreset[]      = "preset";
 static const char argKeymap[]        = "keymap";
@@ -145,13 +193,26 @@ static const char argLock[]          = "lock";
 static const char argMidiFile[]      = "midi-file";
 static const char argMegaPulseFile[] = "mega-pulse-file";
 static const char argMode[]          = "mode";
+static const char argNvsFile[]       = "nvs-file";
 static const char argModeSwitch[]    = "mode-switch";
 static const char argModeList[]      = "modes-list";
 static const char argPlayback[]      = "playback";
+static const char argRadioPos[]      = "radio-pos";
+static const char argRadioRxDelay[]  = "radio-rx-delay";
+static const char argRadioRxDup[]    = "radio-rx-dup";
+static const char argRadioRxJitter[] = "radio-rx-jitter";
+static const char argRadioRxLoss[]   = "radio-rx-loss";
 static const char argRecord[]        = "record";
+static const char argReplayConvert[] = "replay-convert";
+static const char argReplayCrc[]     = "replay-crc";
 static const char argSeed[]          = "seed";
+static const char argSeek[]          = "seek";
 static const char argShowFps[]       = "show-fps";
 static const char argTouch[]         = "touch";
+static const char argTrace[]         = "trace";
+static const char argVideoFormat[]   = "video-format";
+static const char argVideoFps[]      = "video-fps";
+static const char argVideoPipe[]     = "video-pipe";
 static const char argVsync[]         = "vsync";
 static const char argHelp[]          = "help";
 static const char argUsage[]         = "usage";
@@ -162,16 +223,28 @@ static const char argUsage[]         = "usage";
  */
 static const struct option options[] =
 {
+    { argAudioLead,   required_argument, NULL,                             0    },
+    { argBatch,       no_argument,       (int*)&emulatorArgs.batch,        true },
+    { argCensus,      required_argument, NULL,                             0    },
+    { argCensusFrames, required_argument, NULL,                            0    },
+    { argDeterministic, no_argument,     (int*)&emulatorArgs.deterministic, true },
+    { argDuration,    required_argument, NULL,                             0    },
+    { argEspNowPort,  required_argument, NULL,                             0    },
     { argFakeFps,     required_argument, NULL,                             0    },
     { argFakeTime,    no_argument,       (int*)&emulatorArgs.fakeTime,     true },
+    { argFrames,      required_argument, NULL,                             0    },
     { argFullscreen,  no_argument,       (int*)&emulatorArgs.fullscreen,   true },
     { argFuzz,        no_argument,       (int*)&emulatorArgs.fuzz,         true },
     { argFuzzButtons, optional_argument, (int*)&emulatorArgs.fuzzButtons,  true },
     { argFuzzTime,    optional_argument, (int*)&emulatorArgs.fuzzTime,     true },
     { argFuzzTouch,   optional_argument, (int*)&emulatorArgs.fuzzTouch,    true },
     { argFuzzMotion,  optional_argument, (int*)&emulatorArgs.fuzzMotion,   true },
+    { argHangTimeout, required_argument, NULL,                             0    },
     { argHeadless,    no_argument,       (int*)&emulatorArgs.headless,     true },
+    { argHeapFail,    required_argument, NULL,                             0    },
+    { argHeapModel,   no_argument,       (int*)&emulatorArgs.heapModel,    true },
     { argHideLeds,    no_argument,       (int*)&emulatorArgs.hideLeds,     true },
+    { argHitchBudget, required_argument, NULL,                             0    },
     { argJoystick,    required_argument, (int*)&emulatorArgs.joystick,     'j'  },
     { argJsPreset,    required_argument, (int*)&emulatorArgs.jsPreset,     0    },
     { argKeymap,      required_argument, NULL,                             'k'  },
@@ -179,13 +252,26 @@ static const struct option options[] =
     { argMidiFile,    required_argument, NULL,                             0    },
     { argMegaPulseFile,    required_argument, NULL,                             0    },
     { argMode,        required_argument, NULL,                             'm'  },
+    { argNvsFile,     required_argument, NULL,                             0    },
     { argPlayback,    required_argument, (int*)&emulatorArgs.playback,     'p'  },
+    { argRadioPos,    required_argument, NULL,                             0    },
+    { argRadioRxDelay, required_argument, NULL,                            0    },
+    { argRadioRxDup,  required_argument, NULL,                             0    },
+    { argRadioRxJitter, required_argument, NULL,                           0    },
+    { argRadioRxLoss, required_argument, NULL,                             0    },
     { argRecord,      optional_argument, (int*)&emulatorArgs.record,       'r'  },
+    { argReplayConvert, required_argument, NULL,                           0    },
+    { argReplayCrc,   optional_argument, NULL,                             0    },
     { argSeed,        required_argument, (int*)&emulatorArgs.seed,         0    },
+    { argSeek,        required_argument, NULL,                             0    },
     { argShowFps,     optional_argument, (int*)&emulatorArgs.showFps,      'c'  },
     { argModeSwitch,  optional_argument, NULL,                             10   },
     { argModeList,    no_argument,       NULL,                             0    },
     { argTouch,       no_argument,       (int*)&emulatorArgs.emulateTouch, 't'  },
+    { argTrace,       required_argument, NULL,                             0    },
+    { argVideoFormat, required_argument, NULL,                             0    },
+    { argVideoFps,    required_argument, NULL,                             0    },
+    { argVideoPipe,   required_argument, NULL,                             0    },
     { argVsync,       optional_argument, (int*)&emulatorArgs.vsync,        true },
     { argHelp,        no_argument,       NULL,                             'h'  },
     { argUsage,       no_argument,       NULL,                             0    },
@@ -197,30 +283,55 @@ static const struct option options[] =
  */
 static const optDoc_t argDocs[] =
 {
+    { 0,  argAudioLead,   "MS",    "Generate audio MS milliseconds ahead of the host's audio output. Defaults to 64" },
+    { 0,  argBatch,       NULL,    "Run without a window, sound, or sleeping, using fake time, as fast as possible. Prints the speed when done" },
+    { 0,  argCensus,      "FILE",  "Run every mode in turn with fuzzed input, in batch mode, and write how each performed to FILE as CSV" },
+    { 0,  argCensusFrames, "COUNT", "Run each mode for COUNT frames during a census. Defaults to 600" },
+    { 0,  argDeterministic, NULL,  "Step emulated hardware from the main loop by fake time instead of on host threads, so runs repeat exactly" },
+    { 0,  argDuration,    "SECS",  "Quit after SECS seconds of simulated time. SECS can be a decimal number" },
+    { 0,  argEspNowPort,  "PORT",  "Send and receive emulated ESP-NOW packets on UDP port PORT. Defaults to 32888" },
     { 0,  argFakeFps,     "RATE",  "Set a fake framerate. RATE can be a decimal number"},
     { 0,  argFakeTime,    NULL,    "Use a fake timer that ticks at a constant "},
+    { 0,  argFrames,      "COUNT", "Quit after COUNT frames" },
     {'f', argFullscreen,  NULL,    "Open in fullscreen mode" },
     { 0,  argFuzz,        NULL,    "Enable fuzzing mode, which injects random input in order to test modes" },
     { 0,  argFuzzButtons, "y|n",   "Set whether buttons are fuzzed" },
     { 0,  argFuzzTouch,   "y|n",   "Set whether touchpad inputs are fuzzed" },
     { 0,  argFuzzTime,    "y|n",   "Set whether frame durations are fuzzed" },
     { 0,  argFuzzMotion,  "y|n",   "Set whether motion inputs are fuzzed" },
+    { 0,  argHangTimeout, "SECS",  "Report a hang with a backtrace and quit if a frame takes SECS seconds of real time" },
     { 0,  argHeadless,    NULL,    "Runs the emulator without a window." },
+    { 0,  argHeapFail,    "N",     "Make one in N heap allocations fail on purpose, the same ones every run" },
+    { 0,  argHeapModel,   NULL,    "Limit heap allocations to the Swadge's memory regions, so they fail like they would on a Swadge" },
     {'j', argJoystick,   "JOYDEV", "Sets the joystick device to use." },
     { 0,  argJsPreset,   "PRESET", "Sets the joystick config preset to use. PRESET can be swadge or switch"},
     { 0,  argHideLeds,    NULL,    "Don't draw simulated LEDs next to the display" },
+    { 0,  argHitchBudget, "MS",    "Report each frame where the mode's main loop and drawing take over MS milliseconds of real time" },
     {'k', argKeymap,     "LAYOUT", "Use an alternative keymap. LAYOUT can be azerty, colemak, or dvorak"},
     {'l', argLock,        NULL,    "Lock the emulator in the start mode" },
     { 0,  argMidiFile,    "FILE",  "Open and immediately play a MIDI file" },
     { 0,  argMegaPulseFile,    "FILE",  "Load a custom level file into Mega Pulse EX, immediately launching into said mode" },
     {'m', argMode,        "MODE",  "Start the emulator in the swadge mode MODE instead of the main menu"},
+    { 0,  argNvsFile,     "FILE",  "Use FILE for NVS instead of the default nvs.json" },
     { 0,  argModeSwitch,  "TIME",  "Enable or set the timer to switch modes automatically" },
     { 0,  argModeList,    NULL,    "Print out a list of all possible values for MODE" },
     {'p', argPlayback,    "FILE",  "Play back recorded emulator inputs from a file" },
-    {'r', argRecord,      "FILE",  "Record emulator inputs to a file" },
+    { 0,  argRadioPos,    "X,Y",   "Place this Swadge at X,Y meters, for per-sender ESP-NOW RSSI and range loss" },
+    { 0,  argRadioRxDelay, "MS",   "Delay every received ESP-NOW packet, from any sender, by MS milliseconds" },
+    { 0,  argRadioRxDup,  "PCT",   "Deliver PCT percent of all received ESP-NOW packets twice" },
+    { 0,  argRadioRxJitter, "MS",  "Add up to MS milliseconds of random delay to every received ESP-NOW packet" },
+    { 0,  argRadioRxLoss, "PCT",   "Drop PCT percent of all received ESP-NOW packets, on top of range loss" },
+    {'r', argRecord,      "FILE",  "Record emulator inputs to a file. Files ending in .csv are recorded as CSV, others as binary" },
+    { 0,  argReplayConvert, "FILE", "Convert the --playback recording to FILE, choosing the format by its extension, and quit" },
+    { 0,  argReplayCrc,   "N",     "Record a CRC of the display every N frames, or every frame, to check on playback" },
     {'s', argSeed,        "SEED",  "Seed the random number generator with a specific value" },
+    { 0,  argSeek,        "SECS",  "Play back the --playback recording unthrottled until SECS seconds in, then at normal speed" },
     {'c', argShowFps,     NULL,    "Display an FPS counter" },
     {'t', argTouch,       NULL,    "Simulate touch sensor readings with a virtual touchpad" },
+    { 0,  argTrace,       "FILE",  "Write profiling zones to FILE as a Chrome trace, and print a summary when done" },
+    { 0,  argVideoFormat, "FMT",   "Set the --video-pipe format. FMT can be y4m (the default) or rgb, for headerless RGB24" },
+    { 0,  argVideoFps,    "RATE",  "Set the --video-pipe frame rate. Defaults to 60" },
+    { 0,  argVideoPipe,   "FILE",  "Stream every frame to FILE, a named pipe, or fd:N for an open file descriptor" },
     { 0,  argVsync,       "y|n",   "Set whether VSync is enabled" },
     {'h', argHelp,        NULL,    "Give this help list" },
     { 0,  argUsage,       NULL,    "Give a short usage message" },
@@ -231,6 +342,52 @@ static const optDoc_t argDocs[] =
 // Functions
 //==============================================================================
 
+/**
+ * @brief Parse a decimal number argument and check that it's in range
+ *
+ * @param arg The argument string
+ * @param min The smallest valid value
+ * @param max The largest valid value
+ * @param[out] out The parsed value is written here
+ * @return true if the argument was valid, false if it was not
+ */
+static bool parseFloatArg(const char* arg, float min, float max, float* out)
+{
+    char* end = NULL;
+    float val = strtof(arg, &end);
+    if (end == arg || val < min || val > max)
+    {
+        printf("ERR: Invalid value '%s', must be a number from %g to %g\n", arg, min, max);
+        return false;
+    }
+    *out = val;
+    return true;
+}
+
+/**
+ * @brief Parse a whole number argument and check that it's in range. Unlike parseFloatArg(), anything after the
+ * number is rejected
+ *
+ * @param arg The argument string
+ * @param min The smallest valid value
+ * @param max The largest valid value
+ * @param[out] out The parsed value is written here
+ * @return true if the argument was valid, false if it was not
+ */
+static bool parseIntArg(const char* arg, long min, long max, long* out)
+{
+    char* end = NULL;
+    errno     = 0;
+    long val  = strtol(arg, &end, 10);
+    if (end == arg || *end || errno || val < min || val > max)
+    {
+        printf("ERR: Invalid value '%s', must be a whole number from %ld to %ld\n", arg, min, max);
+        return false;
+    }
+    *out = val;
+    return true;
+}
+
 /**
  * @brief Handle a command-line option
  *
@@ -269,6 +426,156 @@ static bool handleArgument(const char* optName, const char* arg, int optVal)
             emulatorArgs.fakeFps = 24.0;
         }
     }
+    else if (argAudioLead == optName)
+    {
+        float leadMs = 0;
+        if (!parseFloatArg(arg, 1, 500, &leadMs))
+        {
+            return false;
+        }
+        emulatorArgs.audioLeadMs = (uint32_t)leadMs;
+    }
+    else if (argBatch == optName)
+    {
+        // Batch mode is headless and uses fake time. If no fake FPS is given, time advances one Swadge frame per loop
+        emulatorArgs.headless = true;
+        emulatorArgs.fakeTime = true;
+    }
+    else if (argDeterministic == optName)
+    {
+        // Deterministic mode is driven by fake time. If no fake FPS is given, time advances one Swadge frame per loop
+        emulatorArgs.fakeTime = true;
+    }
+    else if (argCensus == optName)
+    {
+        // A census runs in batch mode, and fuzzes everything unless told what to fuzz
+        emulatorArgs.censusFile = arg;
+        emulatorArgs.batch      = true;
+        emulatorArgs.headless   = true;
+        emulatorArgs.fakeTime   = true;
+        if (!emulatorArgs.fuzz)
+        {
+            emulatorArgs.fuzz        = true;
+            emulatorArgs.fuzzButtons = true;
+            emulatorArgs.fuzzTouch   = true;
+            emulatorArgs.fuzzMotion  = true;
+        }
+    }
+    else if (argCensusFrames == optName)
+    {
+        long frames = 0;
+        if (!parseIntArg(arg, 1, 1000000, &frames))
+        {
+            return false;
+        }
+        emulatorArgs.censusFrames = (uint32_t)frames;
+    }
+    else if (argFrames == optName)
+    {
+        char* end               = NULL;
+        emulatorArgs.exitFrames = strtoull(arg, &end, 10);
+        if (end == arg || emulatorArgs.exitFrames == 0)
+        {
+            printf("ERR: Invalid frame count '%s'\n", arg);
+            return false;
+        }
+    }
+    else if (argDuration == optName)
+    {
+        char* end   = NULL;
+        double secs = strtod(arg, &end);
+        if (end == arg || secs <= 0)
+        {
+            printf("ERR: Invalid duration '%s'\n", arg);
+            return false;
+        }
+        emulatorArgs.exitTimeUs = (uint64_t)(secs * 1000000.0);
+    }
+    else if (argHangTimeout == optName)
+    {
+        float secs = 0;
+        if (!parseFloatArg(arg, 0.1, 86400, &secs))
+        {
+            return false;
+        }
+        emulatorArgs.hangTimeoutUs = (uint64_t)(secs * 1000000.0);
+    }
+    else if (argHitchBudget == optName)
+    {
+        float budgetMs = 0;
+        if (!parseFloatArg(arg, 0.1, 60000, &budgetMs))
+        {
+            return false;
+        }
+        emulatorArgs.hitchBudgetUs = (uint64_t)(budgetMs * 1000.0);
+    }
+    else if (argNvsFile == optName)
+    {
+        emulatorArgs.nvsFile = arg;
+    }
+    else if (argEspNowPort == optName)
+    {
+        long port = 0;
+        if (!parseIntArg(arg, 1, UINT16_MAX, &port))
+        {
+            return false;
+        }
+        emulatorArgs.espNowPort = (uint16_t)port;
+    }
+    else if (argRadioRxDelay == optName)
+    {
+        return parseFloatArg(arg, 0, 60000, &emulatorArgs.radioRxDelayMs);
+    }
+    else if (argRadioRxJitter == optName)
+    {
+        return parseFloatArg(arg, 0, 60000, &emulatorArgs.radioRxJitterMs);
+    }
+    else if (argRadioRxLoss == optName)
+    {
+        return parseFloatArg(arg, 0, 100, &emulatorArgs.radioRxLossPct);
+    }
+    else if (argRadioRxDup == optName)
+    {
+        return parseFloatArg(arg, 0, 100, &emulatorArgs.radioRxDupPct);
+    }
+    else if (argRadioPos == optName)
+    {
+        if (2 != sscanf(arg, "%f,%f", &emulatorArgs.radioX, &emulatorArgs.radioY))
+        {
+            printf("ERR: Invalid position '%s', expected X,Y\n", arg);
+            return false;
+        }
+    }
+    else if (argTrace == optName)
+    {
+        emulatorArgs.traceFile = arg;
+    }
+    else if (argHeapFail == optName)
+    {
+        float oneIn = 0;
+        if (!parseFloatArg(arg, 1, UINT32_MAX, &oneIn))
+        {
+            return false;
+        }
+        emulatorArgs.heapFailRate = (uint32_t)oneIn;
+    }
+    else if (argVideoPipe == optName)
+    {
+        emulatorArgs.videoPipe = arg;
+    }
+    else if (argVideoFormat == optName)
+    {
+        if (strcmp(arg, "y4m") && strcmp(arg, "rgb"))
+        {
+            printf("ERR: Invalid video format '%s', must be y4m or rgb\n", arg);
+            return false;
+        }
+        emulatorArgs.videoFormat = arg;
+    }
+    else if (argVideoFps == optName)
+    {
+        return parseFloatArg(arg, 1, 1000, &emulatorArgs.videoFps);
+    }
     else if (argFuzz == optName)
     {
         // Enable Fuzz
@@ -397,6 +704,33 @@ static bool handleArgument(const char* optName, const char* arg, int optVal)
             emulatorArgs.replayFile = arg;
         }
     }
+    else if (argReplayConvert == optName)
+    {
+        emulatorArgs.replayConvert = arg;
+    }
+    else if (argReplayCrc == optName)
+    {
+        emulatorArgs.replayCrcInterval = 1;
+        if (arg)
+        {
+            char* end                      = NULL;
+            emulatorArgs.replayCrcInterval = strtoul(arg, &end, 10);
+            if (end == arg || *end || 0 == emulatorArgs.replayCrcInterval)
+            {
+                printf("ERR: Invalid frame interval '%s'\n", arg);
+                return false;
+            }
+        }
+    }
+    else if (argSeek == optName)
+    {
+        float secs = 0;
+        if (!parseFloatArg(arg, 0, 1e9, &secs))
+        {
+            return false;
+        }
+        emulatorArgs.seekUs = (uint64_t)(secs * 1000000.0);
+    }
     else if (argSeed == optName)
     {
         if (arg)
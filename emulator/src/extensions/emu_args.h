@@ -35,6 +35,27 @@ typedef struct
 
     int headless;
 
+    /// @brief Run with no window, no sound, no sleeping, and fake time, as fast as possible
+    int batch;
+
+    /// @brief Step the CH32V003, MIDI input, mic, and DAC from the main loop by fake time, so runs repeat exactly
+    int deterministic;
+
+    /// @brief Quit after this many frames, or 0 to never quit
+    uint64_t exitFrames;
+
+    /// @brief Quit after this many simulated microseconds, or 0 to never quit
+    uint64_t exitTimeUs;
+
+    /// @brief Report a hang and print a backtrace if a frame takes this many wall clock microseconds, or 0 to not
+    uint64_t hangTimeoutUs;
+
+    /// @brief Report a frame if its main loop and drawing take this many wall clock microseconds, or 0 to not
+    uint64_t hitchBudgetUs;
+
+    /// @brief The NVS file to use instead of the default ones, or NULL
+    const char* nvsFile;
+
     /// @brief Name of the keymap to use, or NULL if none
     const char* keymap;
 
@@ -66,6 +87,15 @@ typedef struct
     /// @brief Name of the file to replay inputs from
     const char* replayFile;
 
+    /// @brief If set, convert replayFile to this file and quit instead of playing it back
+    const char* replayConvert;
+
+    /// @brief Play back unthrottled until this many microseconds into the recording, or 0 to not seek
+    uint64_t seekUs;
+
+    /// @brief Record a CRC of the framebuffer every this many frames, or 0 to not record them
+    uint32_t replayCrcInterval;
+
     /// @brief A value to use to manually seed the random number generator
     int seed;
 
@@ -75,6 +105,56 @@ typedef struct
     /// @brief Whether VSync is enabled
     int vsync;
 
+    /// @brief How far ahead of the host audio the DAC ring buffer is filled, in milliseconds
+    uint32_t audioLeadMs;
+
+    /// @brief A path, named pipe, or "fd:N" to stream raw video frames to, or NULL to not stream
+    const char* videoPipe;
+
+    /// @brief The video stream format, "y4m" or "rgb"
+    const char* videoFormat;
+
+    /// @brief The video stream's constant frame rate
+    float videoFps;
+
+    /// @brief A file to write profiling zones to as a Chrome trace, or NULL to not trace
+    const char* traceFile;
+
+    /// @brief Whether allocations are limited to the Swadge's heap capacity and fragmentation
+    int heapModel;
+
+    /// @brief Fail one in this many allocations on purpose, or 0 to not fail them
+    uint32_t heapFailRate;
+
+    /// @brief A file to write the per-mode performance census to, or NULL to not run a census
+    const char* censusFile;
+
+    /// @brief How many frames each mode runs for during a census
+    uint32_t censusFrames;
+
+    // Simulated ESP-NOW radio. The radioRx settings apply to every packet this Swadge receives, whoever sent it
+
+    /// @brief Base delay before a received ESP-NOW packet is delivered, in milliseconds
+    float radioRxDelayMs;
+
+    /// @brief Maximum random delay added to radioRxDelayMs, in milliseconds
+    float radioRxJitterMs;
+
+    /// @brief Percent chance that a received ESP-NOW packet is dropped, on top of the range loss from radioX and radioY
+    float radioRxLossPct;
+
+    /// @brief Percent chance that a received ESP-NOW packet is delivered twice
+    float radioRxDupPct;
+
+    /// @brief This Swadge's X position in meters, used to derive RSSI from the distance to other Swadges
+    float radioX;
+
+    /// @brief This Swadge's Y position in meters, used to derive RSSI from the distance to other Swadges
+    float radioY;
+
+    /// @brief The UDP port emulated ESP-NOW packets are broadcast on. Only emulators on the same port hear each other
+    uint16_t espNowPort;
+
     // MIDI
     const char* midiFile;
 
@@ -5,6 +5,7 @@
 #include "emu_args.h"
 #include "macros.h"
 #include "linked_list.h"
+#include "esp_heap_caps_emu.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -24,6 +25,9 @@
 #include "ext_replay.h"
 #include "ext_tools.h"
 #include "ext_mega_pulse_ex.h"
+#include "ext_profiler.h"
+#include "ext_census.h"
+#include "ext_hitch.h"
 
 //==============================================================================
 // Registered Extensions
@@ -34,9 +38,10 @@
 //==============================================================================
 
 static const emuExtension_t* registeredExtensions[]
-    = {&touchEmuCallback,   &ledEmuExtension,   &ledEyesEmuExtension,  &fuzzerEmuExtension,
-       &toolsEmuExtension,  &keymapEmuCallback, &modesEmuExtension,    &gamepadEmuExtension,
-       &replayEmuExtension, &midiEmuExtension,  &megaPulseEmuExtension};
+    = {&touchEmuCallback,   &ledEmuExtension,   &ledEyesEmuExtension,   &fuzzerEmuExtension,
+       &toolsEmuExtension,  &keymapEmuCallback, &modesEmuExtension,     &gamepadEmuExtension,
+       &replayEmuExtension, &midiEmuExtension,  &megaPulseEmuExtension, &profilerEmuExtension,
+       &censusEmuExtension, &hitchEmuExtension};
 
 //==============================================================================
 // Macros
@@ -196,7 +201,10 @@ static void preloadExtensions(void)
         emuExtInfo_t* info        = calloc(1, sizeof(emuExtInfo_t));
         info->extension           = ext;
 
+        // List nodes are on the Swadge's heap, but belong to the emulator
+        emuHeapBeginEmulatorAllocs();
         push(&extManager.extensions, info);
+        emuHeapEndEmulatorAllocs();
     }
 
     extManager.extsLoaded = true;
@@ -365,7 +373,9 @@ int requestPane(const emuExtension_t* ext, paneLocation_t loc, uint32_t minW, ui
         paneInfo->pane.visible = true;
         paneInfo->pane.id      = extInfo->panes.length;
 
+        emuHeapBeginEmulatorAllocs();
         push(&extInfo->panes, paneInfo);
+        emuHeapEndEmulatorAllocs();
         extManager.paneMinsCalculated = false;
 
         return paneInfo->pane.id;
@@ -205,6 +205,9 @@ typedef struct
     /**
      * @brief Function to be called whenever a key is pressed.
      *
+     * Input is received by the render thread but this and the mouse callbacks are called from the Swadge's thread,
+     * between frames, like the frame callbacks.
+     *
      * To allow the key press to be sent to other callbacks and the emulator, return 0.
      * To consume the key press and stop it from being sent to the emulator, return a negative value.
      * To replace the key press with a new one, return the new key code.
@@ -244,6 +247,9 @@ typedef struct
      * If this callback is associated with a pane, its dimensions and location are included.
      * Otherwise, paneW, paneH, paneX, and paneY will be zero.
      *
+     * This is called from the render thread, which draws the window while the Swadge keeps running. No other callback
+     * is called at the same time, so it may read the extension's own state, but it should not change the Swadge's.
+     *
      * @param winW The window width, in pixels
      * @param winH The window height, in pixels
      * @param panes A pointer to an array of panes, in the order they were requested
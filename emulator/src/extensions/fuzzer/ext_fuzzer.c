@@ -11,6 +11,7 @@
 #include "hdw-btn_emu.h"
 #include "hdw-imu_emu.h"
 #include "esp_timer_emu.h"
+#include "esp_random.h"
 
 //==============================================================================
 // Function Prototypes
@@ -85,7 +86,7 @@ static void fuzzerPreFrameCb(uint64_t frame)
         buttonBit_t buttonState = emulatorGetButtonState();
 
         // Pick a random button
-        uint8_t i              = rand() % 8;
+        uint8_t i              = esp_random() % 8;
         buttonBit_t fuzzButton = (1 << i);
 
         if (fuzzButton & fuzzer.buttonMask)
@@ -97,10 +98,10 @@ static void fuzzerPreFrameCb(uint64_t frame)
 
     if (fuzzer.touch)
     {
-        if (0 == (rand() % 2))
+        if (0 == (esp_random() % 2))
         {
             // Set a random angle, radius (up to 1024, not 1023), and intensity value 50% of the time
-            emulatorSetTouchJoystick(rand() % 360, rand() % 1025, rand() % (1 << 18));
+            emulatorSetTouchJoystick(esp_random() % 360, esp_random() % 1025, esp_random() % (1 << 18));
         }
         else
         {
@@ -119,9 +120,9 @@ static void fuzzerPreFrameCb(uint64_t frame)
         }
 
         // Set the accelerometer to 3 random readings
-        emulatorSetAccelerometer((rand() % (1 + accelMax - accelMin)) + accelMin,
-                                 (rand() % (1 + accelMax - accelMin)) + accelMin,
-                                 (rand() % (1 + accelMax - accelMin)) + accelMin);
+        emulatorSetAccelerometer((esp_random() % (1 + accelMax - accelMin)) + accelMin,
+                                 (esp_random() % (1 + accelMax - accelMin)) + accelMin,
+                                 (esp_random() % (1 + accelMax - accelMin)) + accelMin);
     }
 
     if (fuzzer.time)
@@ -132,7 +133,7 @@ static void fuzzerPreFrameCb(uint64_t frame)
         //  60FPS is  16666us per frame
         //  25FPS is  40000us per frame
         //   1FPS = 1000000us per frame
-        fakeTime += (rand() % 128) * 1000 << (rand() % (4));
+        fakeTime += (esp_random() % 128) * 1000 << (esp_random() % (4));
         emuSetEspTimerTime(fakeTime);
     }
 }
@@ -0,0 +1,275 @@
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <esp_timer.h>
+
+#include "ext_hitch.h"
+#include "ext_tools.h"
+#include "emu_args.h"
+#include "hdw-btn.h"
+#include "hdw-btn_emu.h"
+#include "hdw-imu_emu.h"
+#include "hdw-tft_emu.h"
+#include "profiler.h"
+#include "swadge2024.h"
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// How much simulated time before a hitch has its input written to the report
+#define HITCH_HISTORY_US 5000000
+
+/// The most drawn frames kept for the input history, which limits the history when the fake frame rate is high
+#define HITCH_HISTORY_FRAMES 2048
+
+/// The most reports written in one run. Hitches after this are only counted
+#define HITCH_MAX_REPORTS 50
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief The input and time of one drawn frame
+ */
+typedef struct
+{
+    uint64_t frame;
+    int64_t timeUs;
+    uint64_t workTicks;
+    buttonBit_t buttons;
+    int32_t touchPhi;
+    int32_t touchR;
+    int32_t touchIntensity;
+    int16_t accelX;
+    int16_t accelY;
+    int16_t accelZ;
+} hitchSample_t;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static bool hitchInit(emuArgs_t* emuArgs);
+static void hitchDeinit(void);
+static void hitchPostFrame(uint64_t frame);
+static void writeReport(uint64_t frame, uint64_t workTicks);
+static void writeHistory(FILE* report);
+
+//==============================================================================
+// Variables
+//==============================================================================
+
+emuExtension_t hitchEmuExtension = {
+    .name            = "hitch",
+    .fnInitCb        = hitchInit,
+    .fnDeinitCb      = hitchDeinit,
+    .fnPreFrameCb    = NULL,
+    .fnPostFrameCb   = hitchPostFrame,
+    .fnKeyCb         = NULL,
+    .fnMouseMoveCb   = NULL,
+    .fnMouseButtonCb = NULL,
+    .fnRenderCb      = NULL,
+};
+
+/// The drawn frames before the current one, oldest first. historyHead counts up forever and is wrapped when used
+static hitchSample_t history[HITCH_HISTORY_FRAMES];
+static uint32_t historyHead = 0;
+
+/// Frames which went over the budget, and how many of them were reported
+static uint32_t numHitches = 0;
+static uint32_t numReports = 0;
+
+/// The slowest frame so far, in profiler ticks
+static uint64_t worstTicks = 0;
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+/**
+ * @brief Start watching frame times if --hitch-budget was given
+ *
+ * @param emuArgs The parsed command-line arguments
+ * @return true if watching frame times, false if not
+ */
+static bool hitchInit(emuArgs_t* emuArgs)
+{
+    if (!emuArgs->hitchBudgetUs)
+    {
+        return false;
+    }
+
+    printf("Hitch: Reporting frames which take longer than %.2f ms\n", emuArgs->hitchBudgetUs / 1000.0);
+    return true;
+}
+
+/**
+ * @brief Print how many frames went over the budget
+ */
+static void hitchDeinit(void)
+{
+    if (!emulatorArgs.hitchBudgetUs)
+    {
+        return;
+    }
+
+    printf("Hitch: %" PRIu32 " frames went over the %.2f ms budget", numHitches, emulatorArgs.hitchBudgetUs / 1000.0);
+    if (numHitches)
+    {
+        double worstMs = worstTicks / (profileGetTicksPerUs() * 1000.0);
+        printf(", the slowest took %.2f ms. Wrote %" PRIu32 " reports", worstMs, numReports);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Record the frame which just ended, and report it if it went over the budget
+ *
+ * @param frame The frame which just ended
+ */
+static void hitchPostFrame(uint64_t frame)
+{
+    // The main loop runs more often than the mode does, so only look at loops where the mode ran or the display drew
+    const profileZoneStats_t* mainLoop = profileFindZone("fnMainLoop");
+    const profileZoneStats_t* draw     = profileFindZone("drawDisplayTft");
+    if (!(mainLoop && mainLoop->lastCalls) && !(draw && draw->lastCalls))
+    {
+        return;
+    }
+
+    uint64_t workTicks = profileGetZoneLastTicks("fnMainLoop") + profileGetZoneLastTicks("drawDisplayTft");
+
+    hitchSample_t* sample = &history[historyHead++ % HITCH_HISTORY_FRAMES];
+    sample->frame         = frame;
+    sample->timeUs        = esp_timer_get_time();
+    sample->workTicks     = workTicks;
+    sample->buttons       = emulatorGetButtonState();
+    if (!getTouchJoystick(&sample->touchPhi, &sample->touchR, &sample->touchIntensity))
+    {
+        sample->touchPhi       = 0;
+        sample->touchR         = 0;
+        sample->touchIntensity = 0;
+    }
+    emulatorGetAccelerometer(&sample->accelX, &sample->accelY, &sample->accelZ);
+
+    if (workTicks <= emulatorArgs.hitchBudgetUs * profileGetTicksPerUs())
+    {
+        return;
+    }
+
+    numHitches++;
+    if (workTicks > worstTicks)
+    {
+        worstTicks = workTicks;
+    }
+
+    if (numReports < HITCH_MAX_REPORTS)
+    {
+        numReports++;
+        writeReport(frame, workTicks);
+    }
+}
+
+/**
+ * @brief Write a report of a frame which went over the budget, and save the frame it drew
+ *
+ * @param frame The frame which went over the budget
+ * @param workTicks How long the mode's main loop and drawing the display took, in profiler ticks
+ */
+static void writeReport(uint64_t frame, uint64_t workTicks)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "hitch-%" PRIu64 ".txt", frame);
+    FILE* report = fopen(name, "w");
+    if (!report)
+    {
+        printf("ERR! ext_hitch.c: Unable to open %s for writing\n", name);
+        return;
+    }
+
+    double ticksPerMs          = profileGetTicksPerUs() * 1000.0;
+    const swadgeMode_t* mode   = getSwadgeMode();
+    uint32_t numEvents         = 0;
+    uint64_t start             = 0;
+    uint64_t end               = 0;
+    const profileEvent_t* evts = profileGetFrameEvents(&numEvents, &start, &end);
+
+    fprintf(report, "Hitch in frame %" PRIu64 " at %.3f s in %s\n", frame, esp_timer_get_time() / 1000000.0,
+            mode ? mode->modeName : "no mode");
+    fprintf(report, "fnMainLoop and drawDisplayTft took %.2f ms, over the %.2f ms budget\n\n", workTicks / ticksPerMs,
+            emulatorArgs.hitchBudgetUs / 1000.0);
+
+    // Split the frame between the mode's callbacks and drawing. Whatever is left was spent outside of any zone,
+    // including in the emulator between frames
+    uint64_t mainTicks  = profileGetZoneLastTicks("fnMainLoop");
+    uint64_t drawTicks  = profileGetZoneLastTicks("drawDisplayTft");
+    uint64_t audioTicks = profileGetZoneLastTicks("fnAudioCallback") + profileGetZoneLastTicks("fnDacCb");
+    uint64_t enterTicks = profileGetZoneLastTicks("fnEnterMode");
+    uint64_t zoneTicks  = mainTicks + drawTicks + audioTicks + enterTicks;
+    uint64_t frameTicks = end - start;
+
+    fprintf(report, "Frame split:\n");
+    fprintf(report, "  %-32s %9.2f ms\n", "Whole frame", frameTicks / ticksPerMs);
+    fprintf(report, "  %-32s %9.2f ms\n", "Main loop (fnMainLoop)", mainTicks / ticksPerMs);
+    fprintf(report, "  %-32s %9.2f ms\n", "Display (drawDisplayTft)", drawTicks / ticksPerMs);
+    fprintf(report, "  %-32s %9.2f ms\n", "Audio (fnAudioCallback, fnDacCb)", audioTicks / ticksPerMs);
+    fprintf(report, "  %-32s %9.2f ms\n", "Mode entry (fnEnterMode)", enterTicks / ticksPerMs);
+    fprintf(report, "  %-32s %9.2f ms\n", "Everything else",
+            (frameTicks > zoneTicks) ? (frameTicks - zoneTicks) / ticksPerMs : 0.0);
+
+    // Every zone, nested under the zone it ran in
+    fprintf(report, "\nZones, in the order they ended:\n");
+    fprintf(report, "  %10s %10s  %s\n", "Start ms", "Took ms", "Zone");
+    for (uint32_t i = 0; i < numEvents; i++)
+    {
+        fprintf(report, "  %10.3f %10.3f  %*s%s\n", (evts[i].start - start) / ticksPerMs, evts[i].duration / ticksPerMs,
+                evts[i].depth * 2, "", evts[i].name);
+    }
+    if (PROFILE_MAX_EVENTS == numEvents)
+    {
+        fprintf(report, "  Later zones weren't recorded. Raise PROFILE_MAX_EVENTS to record them\n");
+    }
+
+    writeHistory(report);
+    fclose(report);
+
+    snprintf(name, sizeof(name), "hitch-%" PRIu64 ".png", frame);
+    saveFramePng(name, getLastTftBitmap());
+
+    printf("Hitch: Frame %" PRIu64 " took %.2f ms, wrote hitch-%" PRIu64 ".txt\n", frame, workTicks / ticksPerMs,
+           frame);
+}
+
+/**
+ * @brief Write the input and frame times of the frames leading up to a hitch as CSV, oldest first
+ *
+ * @param report The report to write to
+ */
+static void writeHistory(FILE* report)
+{
+    uint32_t count    = (historyHead < HITCH_HISTORY_FRAMES) ? historyHead : HITCH_HISTORY_FRAMES;
+    int64_t since     = esp_timer_get_time() - HITCH_HISTORY_US;
+    double ticksPerMs = profileGetTicksPerUs() * 1000.0;
+
+    fprintf(report, "\nInput over the last %.1f s, one row per drawn frame:\n", HITCH_HISTORY_US / 1000000.0);
+    fprintf(report, "Frame,Time s,Work ms,Buttons,Touch Phi,Touch R,Touch Intensity,Accel X,Accel Y,Accel Z\n");
+    for (uint32_t i = historyHead - count; i != historyHead; i++)
+    {
+        const hitchSample_t* sample = &history[i % HITCH_HISTORY_FRAMES];
+        if (sample->timeUs < since)
+        {
+            continue;
+        }
+
+        fprintf(report, "%" PRIu64 ",%.3f,%.2f,0x%04X,%" PRId32 ",%" PRId32 ",%" PRId32 ",%d,%d,%d\n", sample->frame,
+                sample->timeUs / 1000000.0, sample->workTicks / ticksPerMs, (unsigned)sample->buttons,
+                sample->touchPhi, sample->touchR, sample->touchIntensity, sample->accelX, sample->accelY,
+                sample->accelZ);
+    }
+}
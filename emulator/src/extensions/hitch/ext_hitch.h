@@ -0,0 +1,19 @@
+/*! \file ext_hitch.h
+ *
+ * \section ext_hitch Hitch Capture Emulator Extension
+ *
+ * When the emulator is run with \c --hitch-budget=MS, the real time the mode's \c fnMainLoop and drawDisplayTft() take
+ * in each frame is measured with the profiling zones in profiler.h. Whenever a frame takes longer than the budget, a
+ * report of the frame is written to \c hitch-FRAME.txt and the frame is saved to \c hitch-FRAME.png.
+ *
+ * The report has how the frame's time was split between the main loop, the other mode callbacks, and drawing the
+ * display, every profiling zone which ran during the frame, and the input and frame times of the last few seconds of
+ * simulated time leading up to it. Hitches from loading assets or rebuilding lists are often intermittent, so this
+ * catches them when they happen rather than needing them to be spotted by eye.
+ */
+
+#pragma once
+
+#include "emu_ext.h"
+
+extern emuExtension_t hitchEmuExtension;
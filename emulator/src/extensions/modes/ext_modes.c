@@ -5,6 +5,7 @@
 #include "ext_modes.h"
 #include "emu_main.h"
 #include "esp_timer.h"
+#include "esp_random.h"
 #include "esp_sleep_emu.h"
 #include "macros.h"
 
@@ -126,7 +127,7 @@ const swadgeMode_t* emulatorFindSwadgeMode(const char* name)
 
 swadgeMode_t* getRandomSwadgeMode(void)
 {
-    return allSwadgeModes[rand() % modeListGetCount()];
+    return allSwadgeModes[esp_random() % modeListGetCount()];
 }
 
 bool emulatorSetSwadgeModeByName(const char* name)
@@ -0,0 +1,154 @@
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "ext_profiler.h"
+#include "emu_args.h"
+#include "profiler.h"
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static bool profilerInit(emuArgs_t* emuArgs);
+static void profilerDeinit(void);
+static void profilerPostFrame(uint64_t frame);
+static void writeTraceEvent(const char* name, uint64_t start, uint64_t duration, uint64_t frame);
+
+//==============================================================================
+// Variables
+//==============================================================================
+
+emuExtension_t profilerEmuExtension = {
+    .name            = "profiler",
+    .fnInitCb        = profilerInit,
+    .fnDeinitCb      = profilerDeinit,
+    .fnPreFrameCb    = NULL,
+    .fnPostFrameCb   = profilerPostFrame,
+    .fnKeyCb         = NULL,
+    .fnMouseMoveCb   = NULL,
+    .fnMouseButtonCb = NULL,
+    .fnRenderCb      = NULL,
+};
+
+/// The trace being written, or NULL if not tracing
+static FILE* traceFile = NULL;
+
+/// The profiler's ticks at the start of the first traced frame, so the trace starts at zero
+static uint64_t traceOrigin = 0;
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+/**
+ * @brief Open the trace file and write its header
+ *
+ * @param emuArgs The parsed command-line arguments
+ * @return true if tracing, false if not
+ */
+static bool profilerInit(emuArgs_t* emuArgs)
+{
+    if (!emuArgs->traceFile)
+    {
+        return false;
+    }
+
+    traceFile = fopen(emuArgs->traceFile, "w");
+    if (!traceFile)
+    {
+        printf("ERR! ext_profiler.c: Unable to open %s for writing the trace\n", emuArgs->traceFile);
+        return false;
+    }
+
+    // Every zone runs on the Swadge main loop, so there is a single process and thread
+    fprintf(traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                       "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+                       "\"args\":{\"name\":\"Swadge main loop\"}}");
+    return true;
+}
+
+/**
+ * @brief Finish the trace file and print a summary of all zones
+ */
+static void profilerDeinit(void)
+{
+    if (!traceFile)
+    {
+        return;
+    }
+
+    fprintf(traceFile, "\n]}\n");
+    fclose(traceFile);
+    traceFile = NULL;
+
+    profilePrintSummary();
+    if (profileGetDroppedEvents())
+    {
+        printf("Trace is missing %" PRIu32 " zones. Raise PROFILE_MAX_EVENTS to record them\n",
+               profileGetDroppedEvents());
+    }
+}
+
+/**
+ * @brief Write the frame which just ended, and every zone in it, to the trace
+ *
+ * @param frame The number of the frame which just ended
+ */
+static void profilerPostFrame(uint64_t frame)
+{
+    if (!traceFile)
+    {
+        return;
+    }
+
+    uint32_t numEvents = 0;
+    uint64_t start     = 0;
+    uint64_t end       = 0;
+
+    const profileEvent_t* events = profileGetFrameEvents(&numEvents, &start, &end);
+    if (end <= start)
+    {
+        // No frame has ended yet
+        return;
+    }
+
+    if (0 == traceOrigin)
+    {
+        traceOrigin = start;
+    }
+
+    writeTraceEvent("Frame", start, end - start, frame);
+    for (uint32_t i = 0; i < numEvents; i++)
+    {
+        writeTraceEvent(events[i].name, events[i].start, events[i].duration, frame);
+    }
+}
+
+/**
+ * @brief Write a single complete event to the trace
+ *
+ * @param name The event's name
+ * @param start When the event started, in profiler ticks
+ * @param duration How long the event took, in profiler ticks
+ * @param frame The frame the event was in
+ */
+static void writeTraceEvent(const char* name, uint64_t start, uint64_t duration, uint64_t frame)
+{
+    double ticksPerUs = profileGetTicksPerUs();
+
+    fputs(",\n{\"name\":\"", traceFile);
+    for (const char* c = name; *c; c++)
+    {
+        if ('"' == *c || '\\' == *c)
+        {
+            fputc('\\', traceFile);
+        }
+        fputc(*c, traceFile);
+    }
+    fprintf(traceFile, "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%" PRIu64 "}}",
+            (start - traceOrigin) / ticksPerUs, duration / ticksPerUs, frame);
+}
@@ -0,0 +1,15 @@
+/*! \file ext_profiler.h
+ *
+ * \section ext_profiler Profiler Emulator Extension
+ *
+ * When the emulator is run with \c --trace=FILE, every profiling zone from profiler.h is written to \c FILE in the
+ * Chrome trace event format, along with a zone for each whole frame. The file can be opened with \c chrome://tracing
+ * or https://ui.perfetto.dev to see where each frame's time goes. A summary of every zone is printed when the emulator
+ * exits.
+ */
+
+#pragma once
+
+#include "emu_ext.h"
+
+extern emuExtension_t profilerEmuExtension;
@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <inttypes.h>
 #include <unistd.h>
 
@@ -26,6 +27,40 @@
 
 #define HEADER "Time,Type,Value\n"
 
+/// @brief The file extension which selects the CSV format when recording. Anything else is recorded as binary
+#define CSV_EXTENSION ".csv"
+
+/// @brief Magic bytes at the start of a binary recording
+#define BIN_MAGIC "SWRP"
+
+/// @brief Magic bytes at the very end of a binary recording with a summary
+#define BIN_SUMMARY_MAGIC "SWRS"
+
+/// @brief The binary format version written to the header
+#define BIN_VERSION 1
+
+/// @brief Header flag set when the recording was made with fake time
+#define BIN_FLAG_FAKE_TIME 0x01
+
+/// @brief Header flag set when the header has a random seed
+#define BIN_FLAG_SEED 0x02
+
+/// @brief Tag byte for a keyframe, which holds the full input state. Types after ::COMMAND don't fit in the low
+/// nibble, so they're written with this low nibble and their offset from ::COMMAND in the high nibble
+#define BIN_TAG_KEYFRAME 0x0E
+
+/// @brief Low nibble of a tag byte for the summary written when a recording is stopped
+#define BIN_TAG_SUMMARY 0x0F
+
+/// @brief How often a keyframe is written to a binary recording, in microseconds of recording time
+#define BIN_KEYFRAME_INTERVAL_US 1000000
+
+/// @brief The number of touch and accelerometer values, which are delta-encoded in binary recordings
+#define NUM_AXES (ACCEL_Z - TOUCH_PHI + 1)
+
+/// @brief The size of the palettized framebuffer which frame CRCs are computed over
+#define FRAME_SIZE (TFT_WIDTH * TFT_HEIGHT)
+
 #ifdef DEBUG
     #define REPLAY_DEBUG(str, ...) printf(str "\n", __VA_ARGS__);
 #else
@@ -58,9 +93,10 @@ typedef enum
     SET_MODE,
     RANDOM_SEED,
     COMMAND,
+    FRAME_CRC,
 } replayLogType_t;
 
-#define LAST_TYPE COMMAND
+#define LAST_TYPE FRAME_CRC
 
 //==============================================================================
 // Structs
@@ -81,9 +117,28 @@ typedef struct
         char* filename;
         char* modeName;
         char* commandStr;
+        uint32_t crcVal;
     };
 } replayEntry_t;
 
+/**
+ * @brief The input state which the binary format's deltas are relative to. The reader and writer both track it
+ */
+typedef struct
+{
+    /// @brief The time of the last event or keyframe
+    int64_t time;
+
+    /// @brief The buttons currently held
+    buttonBit_t buttons;
+
+    /// @brief The last touch and accelerometer values, indexed by type minus ::TOUCH_PHI
+    int32_t axes[NUM_AXES];
+
+    /// @brief The recording time at which the next keyframe will be written
+    int64_t nextKeyframeUs;
+} replayBinState_t;
+
 typedef struct
 {
     FILE* file;
@@ -92,6 +147,46 @@ typedef struct
     replayMode_t mode;
     bool headerHandled;
 
+    /// @brief Whether the file uses the binary format instead of CSV
+    bool binary;
+
+    /// @brief Delta-encoding state for the binary format
+    replayBinState_t bin;
+
+    /// @brief The number of keyframes in the binary recording
+    int keyframeCount;
+
+    /// @brief The time of the last event in the recording, or 0 if unknown
+    int64_t endTime;
+
+    /// @brief A start mode from a binary header, returned as the first ::SET_MODE entry
+    char* headerMode;
+
+    /// @brief Whether the binary header had a random seed which hasn't been returned as an entry yet
+    bool headerSeedPending;
+    uint32_t headerSeed;
+
+    /// @brief The fake frame rate stored in a binary header, or a negative value if it didn't use fake time
+    float headerFakeFps;
+
+    /// @brief If nonzero, playback runs unthrottled until this time
+    int64_t seekUs;
+
+    /// @brief The number of frame CRCs compared during playback
+    uint32_t crcsChecked;
+
+    /// @brief The number of frame CRCs which didn't match during playback
+    uint32_t crcMismatches;
+
+    /// @brief The frame number of the first CRC mismatch
+    uint64_t firstMismatchFrame;
+
+    /// @brief A copy of the last frame whose CRC matched, saved next to the first mismatched frame
+    paletteColor_t* lastMatchFrame;
+
+    /// @brief The frame number of lastMatchFrame
+    uint64_t lastMatchFrameNum;
+
     buttonBit_t lastButtons;
 
     int32_t lastTouchPhi;
@@ -115,9 +210,32 @@ static bool replayInit(emuArgs_t* emuArgs);
 static void replayRecordFrame(uint64_t frame);
 static void replayPlaybackFrame(uint64_t frame);
 static void replayPreFrame(uint64_t frame);
-
-static bool readEntry(replayEntry_t* out);
-static void writeEntry(const replayEntry_t* entry);
+static void replayPostFrame(uint64_t frame);
+static uint32_t frameCrc(const paletteColor_t* fb);
+static void checkFrameCrc(uint32_t expected, uint64_t frame);
+static void printCrcSummary(void);
+
+static bool readEntry(replay_t* rp, replayEntry_t* out);
+static void writeEntry(replay_t* rp, const replayEntry_t* entry);
+static bool readCsvEntry(replay_t* rp, replayEntry_t* out);
+static void writeCsvEntry(replay_t* rp, const replayEntry_t* entry);
+
+static bool openReplayFile(replay_t* rp, const char* filename);
+static void closeReplayFile(replay_t* rp);
+static bool readBinHeader(replay_t* rp);
+static void writeBinHeader(replay_t* rp, const char* startMode, bool hasSeed, uint32_t seed, float fakeFps);
+static bool readBinEntry(replay_t* rp, replayEntry_t* out);
+static void writeBinEntry(replay_t* rp, const replayEntry_t* entry);
+static bool readSummary(replay_t* rp);
+static void buildSummary(replay_t* rp);
+static void writeSummary(replay_t* rp);
+static void freeEntryString(replayEntry_t* entry);
+static void replayDeinit(void);
+
+static void writeVarint(FILE* file, uint64_t val);
+static bool readVarint(FILE* file, uint64_t* val);
+static void writeSignedVarint(FILE* file, int64_t val);
+static bool readSignedVarint(FILE* file, int64_t* val);
 
 //==============================================================================
 // Variables
@@ -125,18 +243,19 @@ static void writeEntry(const replayEntry_t* entry);
 
 static const char* replayLogTypeStrs[] = {
     "BtnDown", "BtnUp", "TouchPhi", "TouchR",     "TouchI",  "AccelX", "AccelY",
-    "AccelZ",  "Fuzz",  "Quit",     "Screenshot", "SetMode", "Seed",   "Command",
+    "AccelZ",  "Fuzz",  "Quit",     "Screenshot", "SetMode", "Seed",   "Command", "FrameCrc",
 };
 
 emuExtension_t replayEmuExtension = {
     .name            = "replay",
     .fnInitCb        = replayInit,
     .fnPreFrameCb    = replayPreFrame,
-    .fnPostFrameCb   = NULL,
+    .fnPostFrameCb   = replayPostFrame,
     .fnKeyCb         = NULL,
     .fnMouseMoveCb   = NULL,
     .fnMouseButtonCb = NULL,
     .fnRenderCb      = NULL,
+    .fnDeinitCb      = replayDeinit,
 };
 
 bool replayInitialized = false;
@@ -159,29 +278,67 @@ static bool replayInit(emuArgs_t* emuArgs)
 
     if (emuArgs->record)
     {
+        if (emuArgs->replayCrcInterval && !emuArgs->fakeTime)
+        {
+            printf("WARN: Replay: Frame CRCs will only match on playback with --fake-time\n");
+        }
+
         startRecording(emuArgs->recordFile);
 
         return (replayInitialized = (replay.file != NULL));
     }
     else if (emuArgs->playback)
     {
+        if (emuArgs->replayConvert)
+        {
+            // Convert the recording and quit without running anything
+            if (!convertReplay(emuArgs->replayFile, emuArgs->replayConvert))
+            {
+                printf("ERR: Replay: Couldn't convert %s to %s\n", emuArgs->replayFile, emuArgs->replayConvert);
+            }
+            emulatorQuit();
+            return false;
+        }
+
         startPlayback(emuArgs->replayFile);
+
+        if (replay.headerFakeFps >= 0 && (!emuArgs->fakeTime || replay.headerFakeFps != emuArgs->fakeFps))
+        {
+            // Follow the same clock the recording was made with, so the inputs land on the same frames
+            printf("Replay: Using fake time from the recording\n");
+            enableFakeTime(replay.headerFakeFps);
+        }
+
+        if (emuArgs->seekUs)
+        {
+            if (!emuArgs->fakeTime && replay.headerFakeFps < 0)
+            {
+                // Real time can't be sped up, so run one Swadge frame per loop instead
+                printf("Replay: Seeking requires fake time, enabling it\n");
+                enableFakeTime(0);
+            }
+            seekPlayback(emuArgs->seekUs);
+        }
         return (replayInitialized = true);
     }
 
     return false;
 }
 
+/**
+ * @brief Finish a recording in progress so binary recordings get their summary
+ */
+static void replayDeinit(void)
+{
+    printCrcSummary();
+    stopRecording();
+    closeReplayFile(&replay);
+}
+
 static void replayRecordFrame(uint64_t frame)
 {
     replayEntry_t logEntry = {0};
 
-    if (!replay.headerHandled)
-    {
-        replay.headerHandled = true;
-        fwrite(HEADER, 1, strlen(HEADER), replay.file);
-    }
-
     logEntry.time = esp_timer_get_time();
 
     int32_t touchPhi, touchR, touchIntensity;
@@ -213,7 +370,7 @@ static void replayRecordFrame(uint64_t frame)
                         bool press         = (curButtons & btn) == btn;
                         logEntry.type      = press ? BUTTON_PRESS : BUTTON_RELEASE;
                         logEntry.buttonVal = btn;
-                        writeEntry(&logEntry);
+                        writeEntry(&replay, &logEntry);
 
                         if (press)
                         {
@@ -236,8 +393,8 @@ static void replayRecordFrame(uint64_t frame)
             {
                 if (touchPhi != replay.lastTouchPhi)
                 {
-                    logEntry.accelVal = touchPhi;
-                    writeEntry(&logEntry);
+                    logEntry.touchVal = touchPhi;
+                    writeEntry(&replay, &logEntry);
                 }
                 break;
             }
@@ -247,7 +404,7 @@ static void replayRecordFrame(uint64_t frame)
                 if (touchR != replay.lastTouchR)
                 {
                     logEntry.touchVal = touchR;
-                    writeEntry(&logEntry);
+                    writeEntry(&replay, &logEntry);
                 }
                 break;
             }
@@ -257,7 +414,7 @@ static void replayRecordFrame(uint64_t frame)
                 if (touchIntensity != replay.lastTouchIntensity)
                 {
                     logEntry.touchVal = touchIntensity;
-                    writeEntry(&logEntry);
+                    writeEntry(&replay, &logEntry);
                 }
                 break;
             }
@@ -267,7 +424,7 @@ static void replayRecordFrame(uint64_t frame)
                 if (accelX != replay.lastAccelX)
                 {
                     logEntry.accelVal = accelX;
-                    writeEntry(&logEntry);
+                    writeEntry(&replay, &logEntry);
                 }
                 break;
             }
@@ -277,7 +434,7 @@ static void replayRecordFrame(uint64_t frame)
                 if (accelY != replay.lastAccelY)
                 {
                     logEntry.accelVal = accelY;
-                    writeEntry(&logEntry);
+                    writeEntry(&replay, &logEntry);
                 }
                 break;
             }
@@ -287,7 +444,7 @@ static void replayRecordFrame(uint64_t frame)
                 if (accelZ != replay.lastAccelZ)
                 {
                     logEntry.accelVal = accelZ;
-                    writeEntry(&logEntry);
+                    writeEntry(&replay, &logEntry);
                 }
                 break;
             }
@@ -299,6 +456,7 @@ static void replayRecordFrame(uint64_t frame)
             case SET_MODE:
             case RANDOM_SEED:
             case COMMAND:
+            case FRAME_CRC:
                 break;
         }
     }
@@ -322,6 +480,14 @@ static void replayRecordFrame(uint64_t frame)
  */
 static void replayPlaybackFrame(uint64_t frame)
 {
+    if (replay.seekUs && (replay.readCompleted || esp_timer_get_time() >= replay.seekUs))
+    {
+        // Go back to normal speed once the seek target, or the end of the recording, is reached
+        printf("Replay: Seeked to %.3fs\n", esp_timer_get_time() / 1000000.0);
+        replay.seekUs = 0;
+        emulatorSetFastForward(false);
+    }
+
     // Unless we've finished reading the file completely
     if (!replay.readCompleted)
     {
@@ -334,7 +500,8 @@ static void replayPlaybackFrame(uint64_t frame)
         int16_t accelY = replay.lastAccelY;
         int16_t accelZ = replay.lastAccelZ;
 
-        while (time >= replay.nextEntry.time)
+        // Frame CRCs are checked after the frame at their time is drawn, in replayPostFrame()
+        while (time > replay.nextEntry.time || (time == replay.nextEntry.time && FRAME_CRC != replay.nextEntry.type))
         {
             switch (replay.nextEntry.type)
             {
@@ -459,10 +626,17 @@ static void replayPlaybackFrame(uint64_t frame)
                     replay.nextEntry.commandStr = NULL;
                     break;
                 }
+
+                case FRAME_CRC:
+                {
+                    // The frame this was recorded after was skipped, so compare the latest one
+                    checkFrameCrc(replay.nextEntry.crcVal, frame - 1);
+                    break;
+                }
             }
 
             // Get the next entry
-            if (!readEntry(&replay.nextEntry))
+            if (!readEntry(&replay, &replay.nextEntry))
             {
                 printf("Replay: Reached end of recording\n");
                 replay.readCompleted = true;
@@ -491,6 +665,148 @@ static void replayPlaybackFrame(uint64_t frame)
     }
 }
 
+/**
+ * @brief Record or check the CRC of the frame which was just drawn
+ *
+ * @param frame The number of the frame which was just drawn
+ */
+static void replayPostFrame(uint64_t frame)
+{
+    if (RECORD == replay.mode && replay.file && emulatorArgs.replayCrcInterval
+        && 0 == frame % emulatorArgs.replayCrcInterval)
+    {
+        replayEntry_t entry = {
+            .time   = esp_timer_get_time(),
+            .type   = FRAME_CRC,
+            .crcVal = frameCrc(getLastTftBitmap()),
+        };
+        writeEntry(&replay, &entry);
+    }
+    else if (REPLAY == replay.mode && !replay.readCompleted)
+    {
+        int64_t time = esp_timer_get_time();
+        while (FRAME_CRC == replay.nextEntry.type && time >= replay.nextEntry.time)
+        {
+            checkFrameCrc(replay.nextEntry.crcVal, frame);
+
+            if (!readEntry(&replay, &replay.nextEntry))
+            {
+                printf("Replay: Reached end of recording\n");
+                replay.readCompleted = true;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compute the CRC-32 of a palettized frame
+ *
+ * @param fb The frame to compute the CRC of
+ * @return The CRC-32 of the frame
+ */
+static uint32_t frameCrc(const paletteColor_t* fb)
+{
+    static uint32_t table[256];
+    if (!table[1])
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+    }
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (int i = 0; i < FRAME_SIZE; i++)
+    {
+        crc = table[(crc ^ fb[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+/**
+ * @brief Compare the CRC of the frame which was just drawn to the recorded one. The first time they differ, the frame
+ * and the last matching frame are saved as PNGs
+ *
+ * @param expected The recorded CRC
+ * @param frame The number of the frame which was just drawn
+ */
+static void checkFrameCrc(uint32_t expected, uint64_t frame)
+{
+    const paletteColor_t* fb = getLastTftBitmap();
+    uint32_t actual          = frameCrc(fb);
+    replay.crcsChecked++;
+
+    if (actual == expected)
+    {
+        if (!replay.crcMismatches)
+        {
+            // Keep the last good frame until there's a mismatch to compare it with
+            if (!replay.lastMatchFrame)
+            {
+                replay.lastMatchFrame = malloc(FRAME_SIZE * sizeof(paletteColor_t));
+            }
+            if (replay.lastMatchFrame)
+            {
+                memcpy(replay.lastMatchFrame, fb, FRAME_SIZE * sizeof(paletteColor_t));
+                replay.lastMatchFrameNum = frame;
+            }
+        }
+        return;
+    }
+
+    if (0 == replay.crcMismatches++)
+    {
+        replay.firstMismatchFrame = frame;
+        printf("Replay: Frame %" PRIu64 " at %.3fs diverged from the recording, CRC %08" PRIX32
+               " but expected %08" PRIX32 "\n",
+               frame, esp_timer_get_time() / 1000000.0, actual, expected);
+
+        char name[64];
+        snprintf(name, sizeof(name), "replay-frame-%" PRIu64 "-actual.png", frame);
+        if (saveFramePng(name, fb))
+        {
+            printf("Replay: Saved the diverged frame to %s\n", name);
+        }
+
+        if (replay.lastMatchFrame)
+        {
+            snprintf(name, sizeof(name), "replay-frame-%" PRIu64 "-last-match.png", replay.lastMatchFrameNum);
+            if (saveFramePng(name, replay.lastMatchFrame))
+            {
+                printf("Replay: Saved the last matching frame to %s\n", name);
+            }
+        }
+
+        // A diverged replay is a failed test, so let scripts notice
+        emulatorSetExitCode(1);
+    }
+}
+
+/**
+ * @brief Print the results of the frame CRC checks, if there were any
+ */
+static void printCrcSummary(void)
+{
+    if (replay.crcsChecked)
+    {
+        if (replay.crcMismatches)
+        {
+            printf("Replay: %" PRIu32 " of %" PRIu32 " frame CRCs didn't match, starting at frame %" PRIu64 "\n",
+                   replay.crcMismatches, replay.crcsChecked, replay.firstMismatchFrame);
+        }
+        else
+        {
+            printf("Replay: All %" PRIu32 " frame CRCs matched\n", replay.crcsChecked);
+        }
+    }
+}
+
 static void replayPreFrame(uint64_t frame)
 {
     switch (replay.mode)
@@ -509,24 +825,58 @@ static void replayPreFrame(uint64_t frame)
     }
 }
 
-static bool readEntry(replayEntry_t* entry)
+/**
+ * @brief Read the next entry from a recording in either format
+ *
+ * @param rp The recording to read from
+ * @param entry The entry to read into. Any string in it is allocated and must be freed by the caller
+ * @return true if an entry was read, false at the end of the file or on an error
+ */
+static bool readEntry(replay_t* rp, replayEntry_t* entry)
+{
+    if (!rp->file)
+    {
+        return false;
+    }
+    return rp->binary ? readBinEntry(rp, entry) : readCsvEntry(rp, entry);
+}
+
+/**
+ * @brief Write an entry to a recording in either format
+ *
+ * @param rp The recording to write to
+ * @param entry The entry to write
+ */
+static void writeEntry(replay_t* rp, const replayEntry_t* entry)
+{
+    if (rp->binary)
+    {
+        writeBinEntry(rp, entry);
+    }
+    else
+    {
+        writeCsvEntry(rp, entry);
+    }
+}
+
+static bool readCsvEntry(replay_t* rp, replayEntry_t* entry)
 {
     char buffer[1024];
-    if (!replay.headerHandled)
+    if (!rp->headerHandled)
     {
-        if (1 != fscanf(replay.file, "%63[^\n]\n", buffer) || strncmp(buffer, HEADER, strlen(buffer)))
+        if (1 != fscanf(rp->file, "%63[^\n]\n", buffer) || strncmp(buffer, HEADER, strlen(buffer)))
         {
             // Couldn't read, anything.
             printf("ERR: Invalid playback file, could not parse header\n");
             return false;
         }
 
-        replay.headerHandled = true;
+        rp->headerHandled = true;
     }
 
     int result;
     // Read timestamp index
-    result = fscanf(replay.file, "%" PRId64 ",", &entry->time);
+    result = fscanf(rp->file, "%" PRId64 ",", &entry->time);
 
     // Check if the index key was readable
     if (result != 1)
@@ -534,6 +884,7 @@ static bool readEntry(replayEntry_t* entry)
         if (EOF == result)
         {
             // EOF returned; return false without printing an error
+            rp->readCompleted = true;
             return false;
         }
         else
@@ -543,7 +894,7 @@ static bool readEntry(replayEntry_t* entry)
         return false;
     }
 
-    if (1 != fscanf(replay.file, "%63[^,],", buffer))
+    if (1 != fscanf(rp->file, "%63[^,],", buffer))
     {
         printf("ERR: Can't read action type\n");
         return false;
@@ -571,7 +922,7 @@ static bool readEntry(replayEntry_t* entry)
         case BUTTON_PRESS:
         case BUTTON_RELEASE:
         {
-            if (1 != fscanf(replay.file, "%63s\n", buffer))
+            if (1 != fscanf(rp->file, "%63s\n", buffer))
             {
                 printf("ERR: Can't read button name\n");
                 return false;
@@ -593,7 +944,7 @@ static bool readEntry(replayEntry_t* entry)
         case TOUCH_R:
         case TOUCH_INTENSITY:
         {
-            if (1 != fscanf(replay.file, "%" PRId32 "\n", &entry->touchVal))
+            if (1 != fscanf(rp->file, "%" PRId32 "\n", &entry->touchVal))
             {
                 return false;
             }
@@ -604,7 +955,7 @@ static bool readEntry(replayEntry_t* entry)
         case ACCEL_Y:
         case ACCEL_Z:
         {
-            if (1 != fscanf(replay.file, "%hd\n", &entry->accelVal))
+            if (1 != fscanf(rp->file, "%hd\n", &entry->accelVal))
             {
                 return false;
             }
@@ -614,7 +965,7 @@ static bool readEntry(replayEntry_t* entry)
         case FUZZ:
         {
             // Just advance to the next line, with warning suppression
-            if (fscanf(replay.file, "%*[^\n]\n"))
+            if (fscanf(rp->file, "%*[^\n]\n"))
             {
                 ;
             }
@@ -625,7 +976,7 @@ static bool readEntry(replayEntry_t* entry)
         case QUIT:
         {
             // Just advance to the next line
-            while (fgetc(replay.file) != '\n')
+            while (fgetc(rp->file) != '\n')
                 ;
             break;
         }
@@ -633,10 +984,10 @@ static bool readEntry(replayEntry_t* entry)
         case SCREENSHOT:
         {
             // Read the filename from the screenshot
-            if (1 != fscanf(replay.file, "%63[^\n]\n", buffer))
+            if (1 != fscanf(rp->file, "%63[^\n]\n", buffer))
             {
                 // Skip to the end
-                while (fgetc(replay.file) != '\n')
+                while (fgetc(rp->file) != '\n')
                     ;
                 entry->filename = NULL;
             }
@@ -653,7 +1004,7 @@ static bool readEntry(replayEntry_t* entry)
         case SET_MODE:
         {
             // Read the mode name from the file
-            if (1 != fscanf(replay.file, "%63[^\n]\n", buffer))
+            if (1 != fscanf(rp->file, "%63[^\n]\n", buffer))
             {
                 return false;
             }
@@ -668,7 +1019,7 @@ static bool readEntry(replayEntry_t* entry)
         case RANDOM_SEED:
         {
             // Read the seed value from the file
-            if (1 != fscanf(replay.file, "%" PRIu32 "\n", &entry->seedVal))
+            if (1 != fscanf(rp->file, "%" PRIu32 "\n", &entry->seedVal))
             {
                 return false;
             }
@@ -677,7 +1028,7 @@ static bool readEntry(replayEntry_t* entry)
 
         case COMMAND:
         {
-            if (1 != fscanf(replay.file, "%1023[^\n]\n", buffer))
+            if (1 != fscanf(rp->file, "%1023[^\n]\n", buffer))
             {
                 return false;
             }
@@ -688,6 +1039,15 @@ static bool readEntry(replayEntry_t* entry)
             break;
         }
 
+        case FRAME_CRC:
+        {
+            if (1 != fscanf(rp->file, "%" SCNx32 "\n", &entry->crcVal))
+            {
+                return false;
+            }
+            break;
+        }
+
         default:
         {
             return false;
@@ -697,8 +1057,14 @@ static bool readEntry(replayEntry_t* entry)
     return true;
 }
 
-static void writeEntry(const replayEntry_t* entry)
+static void writeCsvEntry(replay_t* rp, const replayEntry_t* entry)
 {
+    if (!rp->headerHandled)
+    {
+        rp->headerHandled = true;
+        fwrite(HEADER, 1, strlen(HEADER), rp->file);
+    }
+
     char buffer[1024];
     char* ptr = buffer;
 #define BUFSIZE (buffer + sizeof(buffer) - 1 - ptr)
@@ -737,6 +1103,7 @@ static void writeEntry(const replayEntry_t* entry)
         case FUZZ:
         case QUIT:
         {
+            snprintf(ptr, BUFSIZE, "\n");
             break;
         }
 
@@ -763,112 +1130,855 @@ static void writeEntry(const replayEntry_t* entry)
             snprintf(ptr, BUFSIZE, "%s\n", entry->commandStr ? entry->commandStr : "");
             break;
         }
+
+        case FRAME_CRC:
+        {
+            snprintf(ptr, BUFSIZE, "%08" PRIX32 "\n", entry->crcVal);
+            break;
+        }
     }
 
-    fwrite(buffer, 1, strlen(buffer), replay.file);
+    fwrite(buffer, 1, strlen(buffer), rp->file);
 }
 
 /**
- * @brief Begins recording emulator inputs to the given filename
+ * @brief Open a recording file for reading or writing. The format is chosen by the file's magic bytes when reading,
+ * and by its extension when writing
  *
- * @param filename The name of the recording file to write
+ * @param rp The recording to set up. Its mode must already be set
+ * @param filename The name of the file to open
+ * @return true if the file was opened, false if not
  */
-void startRecording(const char* filename)
+static bool openReplayFile(replay_t* rp, const char* filename)
 {
-    if (replay.file != NULL)
+    replayMode_t mode = rp->mode;
+    closeReplayFile(rp);
+    memset(rp, 0, sizeof(replay_t));
+    rp->mode          = mode;
+    rp->headerFakeFps = -1;
+    rp->lastAccelZ    = 256;
+
+    if (RECORD == mode)
     {
-        fclose(replay.file);
-        replay.file = NULL;
+        size_t len  = strlen(filename);
+        size_t eLen = strlen(CSV_EXTENSION);
+        rp->binary  = !(len >= eLen && !strcasecmp(filename + len - eLen, CSV_EXTENSION));
+        rp->file    = fopen(filename, "wb");
+        return (NULL != rp->file);
     }
 
-    char buf[128];
-    if (!filename || !*filename)
+    rp->file = fopen(filename, "rb");
+    if (NULL == rp->file)
     {
-        filename = getTimestampFilename(buf, sizeof(buf) - 1, "rec-", "csv");
+        return false;
     }
 
-    // If specified, use custom filename, otherwise use timestamp one
-    printf("\nReplay: Recording inputs to file %s\n", filename);
-    replay.file = fopen(filename, "w");
-    replay.mode = RECORD;
-    if (replay.file != NULL)
+    char magic[4];
+    if (sizeof(magic) == fread(magic, 1, sizeof(magic), rp->file) && !memcmp(magic, BIN_MAGIC, sizeof(magic)))
     {
-        if (emulatorArgs.startMode)
+        rp->binary = true;
+        if (!readBinHeader(rp))
         {
-            if (!replay.headerHandled)
-            {
-                replay.headerHandled = true;
-                fwrite(HEADER, 1, strlen(HEADER), replay.file);
-            }
-
-            // Immediately record the start mode
-            replayEntry_t modeEntry = {
-                .type     = SET_MODE,
-                .time     = 0,
-                .modeName = NULL,
-            };
-
-            char* tmpStr = malloc(strlen(emulatorArgs.startMode) + 1);
-            strncpy(tmpStr, emulatorArgs.startMode, strlen(emulatorArgs.startMode) + 1);
-            modeEntry.modeName = tmpStr;
-
-            writeEntry(&modeEntry);
-            free(tmpStr);
+            printf("ERR: Replay: Invalid binary recording header\n");
+            fclose(rp->file);
+            rp->file = NULL;
+            return false;
         }
 
-        if (emulatorArgs.seed)
+        // Load the summary from the end of the file, or rebuild it if the recording wasn't stopped cleanly
+        long dataStart = ftell(rp->file);
+        if (!readSummary(rp))
         {
-            if (!replay.headerHandled)
-            {
-                replay.headerHandled = true;
-                fwrite(HEADER, 1, strlen(HEADER), replay.file);
-            }
-
-            // Immediately record the start mode
-            replayEntry_t seedEntry = {
-                .type    = RANDOM_SEED,
-                .time    = 0,
-                .seedVal = emulatorArgs.seed,
-            };
-            writeEntry(&seedEntry);
+            rp->keyframeCount = 0;
+            rp->endTime       = 0;
+            fseek(rp->file, dataStart, SEEK_SET);
+            buildSummary(rp);
         }
+        fseek(rp->file, dataStart, SEEK_SET);
+        memset(&rp->bin, 0, sizeof(rp->bin));
+    }
+    else
+    {
+        rewind(rp->file);
     }
+    return true;
 }
 
-void stopRecording(void)
+/**
+ * @brief Close a recording file, writing the summary first if it's a binary recording being written
+ *
+ * @param rp The recording to close
+ */
+static void closeReplayFile(replay_t* rp)
 {
-    if (replay.file != NULL && replay.mode == RECORD)
+    if (rp->file)
     {
-        fclose(replay.file);
-        replay.file = NULL;
-        printf("\nStopped recording inputs\n");
+        if (RECORD == rp->mode && rp->binary)
+        {
+            writeSummary(rp);
+        }
+        fclose(rp->file);
+        rp->file = NULL;
     }
+
+    rp->keyframeCount = 0;
+
+    free(rp->headerMode);
+    rp->headerMode = NULL;
+
+    free(rp->lastMatchFrame);
+    rp->lastMatchFrame = NULL;
+
+    freeEntryString(&rp->nextEntry);
 }
 
-bool isRecordingInput(void)
+/**
+ * @brief Free the string in an entry, if its type has one
+ *
+ * @param entry The entry to free the string of
+ */
+static void freeEntryString(replayEntry_t* entry)
 {
-    return replay.file != NULL && replay.mode == RECORD;
+    switch (entry->type)
+    {
+        case SCREENSHOT:
+        case SET_MODE:
+        case COMMAND:
+        {
+            // These all share the same union member
+            free(entry->filename);
+            entry->filename = NULL;
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
 }
 
 /**
- * @brief Begins playing back emulator inputs from the given file
+ * @brief Write the binary recording header
  *
- * @param recordingName The name of the recording file to play back
+ * The header is the magic bytes, a version byte, a flags byte, the fake frame rate in thousandths of a frame per second
+ * and the random seed as little-endian 32-bit values, and the start mode name prefixed by its length
+ *
+ * @param rp The recording to write to
+ * @param startMode The name of the mode the recording starts in, or NULL
+ * @param hasSeed Whether the recording has a random seed
+ * @param seed The random seed
+ * @param fakeFps The fake frame rate the recording uses, 0 for fake time at the Swadge's frame rate, or a negative
+ * value for real time
  */
-void startPlayback(const char* recordingName)
+static void writeBinHeader(replay_t* rp, const char* startMode, bool hasSeed, uint32_t seed, float fakeFps)
 {
-    if (replay.file != NULL)
+    uint32_t fpsMilli = (fakeFps > 0) ? (uint32_t)(fakeFps * 1000) : 0;
+    size_t modeLen    = startMode ? MIN(strlen(startMode), 255) : 0;
+
+    uint8_t header[16] = {0};
+    memcpy(header, BIN_MAGIC, 4);
+    header[4] = BIN_VERSION;
+    header[5] = (fakeFps >= 0 ? BIN_FLAG_FAKE_TIME : 0) | (hasSeed ? BIN_FLAG_SEED : 0);
+    for (int i = 0; i < 4; i++)
     {
-        fclose(replay.file);
-        replay.file = NULL;
+        header[6 + i]  = (fpsMilli >> (8 * i)) & 0xFF;
+        header[10 + i] = (seed >> (8 * i)) & 0xFF;
     }
+    header[14] = (uint8_t)modeLen;
 
-    printf("\nReplay: Replaying inputs from file %s\n", recordingName);
-    replay.file = fopen(recordingName, "r");
-    replay.mode = REPLAY;
+    fwrite(header, 1, 15, rp->file);
+    if (modeLen)
+    {
+        fwrite(startMode, 1, modeLen, rp->file);
+    }
+    rp->headerHandled = true;
+}
 
-    // Return true if the file was opened OK and has a valid header and first entry
-    readEntry(&replay.nextEntry);
+/**
+ * @brief Read the rest of the binary recording header, after the magic bytes
+ *
+ * @param rp The recording to read from
+ * @return true if the header was valid, false if not
+ */
+static bool readBinHeader(replay_t* rp)
+{
+    uint8_t header[11];
+    if (sizeof(header) != fread(header, 1, sizeof(header), rp->file) || BIN_VERSION != header[0])
+    {
+        return false;
+    }
+
+    uint32_t fpsMilli = 0;
+    uint32_t seed     = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        fpsMilli |= (uint32_t)header[2 + i] << (8 * i);
+        seed |= (uint32_t)header[6 + i] << (8 * i);
+    }
+
+    rp->headerFakeFps     = (header[1] & BIN_FLAG_FAKE_TIME) ? fpsMilli / 1000.0f : -1;
+    rp->headerSeedPending = (header[1] & BIN_FLAG_SEED);
+    rp->headerSeed        = seed;
+
+    uint8_t modeLen = header[10];
+    if (modeLen)
+    {
+        rp->headerMode = malloc(modeLen + 1);
+        if (modeLen != fread(rp->headerMode, 1, modeLen, rp->file))
+        {
+            return false;
+        }
+        rp->headerMode[modeLen] = '\0';
+    }
+
+    rp->headerHandled = true;
+    return true;
+}
+
+/**
+ * @brief Write an entry in the binary format
+ *
+ * Each entry is a tag byte with the type in the low nibble, and for buttons the button's bit number in the high nibble,
+ * then the time since the previous entry as a signed varint, then the value. Touch and accelerometer values are stored
+ * as a signed varint difference from the previous value of the same type, and strings are prefixed by their length.
+ * A keyframe holding the full input state is written before the first entry in each ::BIN_KEYFRAME_INTERVAL_US
+ *
+ * @param rp The recording to write to
+ * @param entry The entry to write
+ */
+static void writeBinEntry(replay_t* rp, const replayEntry_t* entry)
+{
+    replayBinState_t* bin = &rp->bin;
+
+    if (entry->time >= bin->nextKeyframeUs)
+    {
+        rp->keyframeCount++;
+
+        fputc(BIN_TAG_KEYFRAME, rp->file);
+        writeSignedVarint(rp->file, entry->time - bin->time);
+        writeVarint(rp->file, bin->buttons);
+        for (int i = 0; i < NUM_AXES; i++)
+        {
+            writeSignedVarint(rp->file, bin->axes[i]);
+        }
+
+        bin->time           = entry->time;
+        bin->nextKeyframeUs = entry->time - (entry->time % BIN_KEYFRAME_INTERVAL_US) + BIN_KEYFRAME_INTERVAL_US;
+    }
+
+    uint8_t tag = entry->type;
+    if (BUTTON_PRESS == entry->type || BUTTON_RELEASE == entry->type)
+    {
+        tag |= (__builtin_ctz(entry->buttonVal) << 4);
+    }
+    else if (entry->type > COMMAND)
+    {
+        tag = BIN_TAG_KEYFRAME | ((entry->type - COMMAND) << 4);
+    }
+    fputc(tag, rp->file);
+    writeSignedVarint(rp->file, entry->time - bin->time);
+    bin->time = entry->time;
+
+    if (entry->time > rp->endTime)
+    {
+        rp->endTime = entry->time;
+    }
+
+    switch (entry->type)
+    {
+        case BUTTON_PRESS:
+        {
+            bin->buttons |= entry->buttonVal;
+            break;
+        }
+
+        case BUTTON_RELEASE:
+        {
+            bin->buttons &= ~entry->buttonVal;
+            break;
+        }
+
+        case TOUCH_PHI:
+        case TOUCH_R:
+        case TOUCH_INTENSITY:
+        case ACCEL_X:
+        case ACCEL_Y:
+        case ACCEL_Z:
+        {
+            int32_t val = (entry->type <= TOUCH_INTENSITY) ? entry->touchVal : entry->accelVal;
+            writeSignedVarint(rp->file, (int64_t)val - bin->axes[entry->type - TOUCH_PHI]);
+            bin->axes[entry->type - TOUCH_PHI] = val;
+            break;
+        }
+
+        case FUZZ:
+        case QUIT:
+        {
+            break;
+        }
+
+        case SCREENSHOT:
+        case SET_MODE:
+        case COMMAND:
+        {
+            // These all share the same union member
+            size_t len = entry->filename ? strlen(entry->filename) : 0;
+            writeVarint(rp->file, len);
+            if (len)
+            {
+                fwrite(entry->filename, 1, len, rp->file);
+            }
+            break;
+        }
+
+        case RANDOM_SEED:
+        {
+            writeVarint(rp->file, entry->seedVal);
+            break;
+        }
+
+        case FRAME_CRC:
+        {
+            writeVarint(rp->file, entry->crcVal);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Read the next entry in the binary format. The start mode and seed from the header are returned first
+ *
+ * @param rp The recording to read from
+ * @param entry The entry to read into
+ * @return true if an entry was read, false at the end of the recording or on an error
+ */
+static bool readBinEntry(replay_t* rp, replayEntry_t* entry)
+{
+    replayBinState_t* bin = &rp->bin;
+
+    if (rp->headerMode)
+    {
+        // The entry takes ownership of the string
+        entry->time     = 0;
+        entry->type     = SET_MODE;
+        entry->modeName = rp->headerMode;
+        rp->headerMode  = NULL;
+        return true;
+    }
+
+    if (rp->headerSeedPending)
+    {
+        entry->time           = 0;
+        entry->type           = RANDOM_SEED;
+        entry->seedVal        = rp->headerSeed;
+        rp->headerSeedPending = false;
+        return true;
+    }
+
+    while (true)
+    {
+        int tag = fgetc(rp->file);
+        if (EOF == tag || BIN_TAG_SUMMARY == (tag & 0x0F))
+        {
+            rp->readCompleted = true;
+            return false;
+        }
+
+        int64_t delta;
+        if (!readSignedVarint(rp->file, &delta))
+        {
+            printf("ERR: Replay: Truncated entry\n");
+            return false;
+        }
+        bin->time += delta;
+        entry->time = bin->time;
+
+        if (BIN_TAG_KEYFRAME == tag)
+        {
+            // Resynchronize to the full input state. It matches the deltas read so far unless the file is damaged
+            uint64_t buttons;
+            if (!readVarint(rp->file, &buttons))
+            {
+                return false;
+            }
+            bin->buttons = buttons;
+            for (int i = 0; i < NUM_AXES; i++)
+            {
+                int64_t val;
+                if (!readSignedVarint(rp->file, &val))
+                {
+                    return false;
+                }
+                bin->axes[i] = val;
+            }
+            continue;
+        }
+
+        int type = (BIN_TAG_KEYFRAME == (tag & 0x0F)) ? COMMAND + (tag >> 4) : (tag & 0x0F);
+        if (type > LAST_TYPE)
+        {
+            printf("ERR: Replay: Unknown entry tag %02X\n", tag);
+            return false;
+        }
+        entry->type = type;
+
+        switch (entry->type)
+        {
+            case BUTTON_PRESS:
+            case BUTTON_RELEASE:
+            {
+                entry->buttonVal = (buttonBit_t)(1 << (tag >> 4));
+                if (BUTTON_PRESS == entry->type)
+                {
+                    bin->buttons |= entry->buttonVal;
+                }
+                else
+                {
+                    bin->buttons &= ~entry->buttonVal;
+                }
+                return true;
+            }
+
+            case TOUCH_PHI:
+            case TOUCH_R:
+            case TOUCH_INTENSITY:
+            case ACCEL_X:
+            case ACCEL_Y:
+            case ACCEL_Z:
+            {
+                int64_t diff;
+                if (!readSignedVarint(rp->file, &diff))
+                {
+                    return false;
+                }
+                int32_t val                        = bin->axes[entry->type - TOUCH_PHI] + diff;
+                bin->axes[entry->type - TOUCH_PHI] = val;
+                if (entry->type <= TOUCH_INTENSITY)
+                {
+                    entry->touchVal = val;
+                }
+                else
+                {
+                    entry->accelVal = val;
+                }
+                return true;
+            }
+
+            case FUZZ:
+            case QUIT:
+            {
+                return true;
+            }
+
+            case SCREENSHOT:
+            case SET_MODE:
+            case COMMAND:
+            {
+                uint64_t len;
+                if (!readVarint(rp->file, &len) || len > 1023)
+                {
+                    return false;
+                }
+
+                // An empty screenshot name means an automatic one
+                entry->filename = NULL;
+                if (len || SCREENSHOT != entry->type)
+                {
+                    entry->filename = malloc(len + 1);
+                    if (len != fread(entry->filename, 1, len, rp->file))
+                    {
+                        free(entry->filename);
+                        entry->filename = NULL;
+                        return false;
+                    }
+                    entry->filename[len] = '\0';
+                }
+                return true;
+            }
+
+            case RANDOM_SEED:
+            {
+                uint64_t seed;
+                if (!readVarint(rp->file, &seed))
+                {
+                    return false;
+                }
+                entry->seedVal = seed;
+                return true;
+            }
+
+            case FRAME_CRC:
+            {
+                uint64_t crc;
+                if (!readVarint(rp->file, &crc))
+                {
+                    return false;
+                }
+                entry->crcVal = crc;
+                return true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Write the summary at the end of a binary recording
+ *
+ * The summary is the summary tag, then the end time and keyframe count as varints. The file ends with the summary's
+ * offset as a little-endian 32-bit value and ::BIN_SUMMARY_MAGIC, so it can be found from the end
+ *
+ * @param rp The recording to write to
+ */
+static void writeSummary(replay_t* rp)
+{
+    long summaryOffset = ftell(rp->file);
+
+    fputc(BIN_TAG_SUMMARY, rp->file);
+    writeVarint(rp->file, rp->endTime);
+    writeVarint(rp->file, rp->keyframeCount);
+
+    uint8_t trailer[8];
+    for (int i = 0; i < 4; i++)
+    {
+        trailer[i] = ((uint32_t)summaryOffset >> (8 * i)) & 0xFF;
+    }
+    memcpy(&trailer[4], BIN_SUMMARY_MAGIC, 4);
+    fwrite(trailer, 1, sizeof(trailer), rp->file);
+}
+
+/**
+ * @brief Read the summary from the end of a binary recording
+ *
+ * @param rp The recording to read from
+ * @return true if the summary was read, false if there isn't one
+ */
+static bool readSummary(replay_t* rp)
+{
+    uint8_t trailer[8];
+    if (fseek(rp->file, -(long)sizeof(trailer), SEEK_END)
+        || sizeof(trailer) != fread(trailer, 1, sizeof(trailer), rp->file)
+        || memcmp(&trailer[4], BIN_SUMMARY_MAGIC, 4))
+    {
+        return false;
+    }
+
+    uint32_t summaryOffset = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        summaryOffset |= (uint32_t)trailer[i] << (8 * i);
+    }
+
+    uint64_t endTime, count;
+    if (fseek(rp->file, summaryOffset, SEEK_SET) || BIN_TAG_SUMMARY != fgetc(rp->file)
+        || !readVarint(rp->file, &endTime) || !readVarint(rp->file, &count))
+    {
+        return false;
+    }
+    rp->endTime       = endTime;
+    rp->keyframeCount = count;
+    return true;
+}
+
+/**
+ * @brief Rebuild the summary of a binary recording which doesn't have one, by reading every entry
+ *
+ * @param rp The recording to summarize. The file must be positioned at the first entry
+ */
+static void buildSummary(replay_t* rp)
+{
+    // Hold on to the header's entries so they aren't read here
+    char* headerMode      = rp->headerMode;
+    bool headerSeed       = rp->headerSeedPending;
+    rp->headerMode        = NULL;
+    rp->headerSeedPending = false;
+
+    replayEntry_t entry = {0};
+    int tag;
+    while (EOF != (tag = fgetc(rp->file)))
+    {
+        ungetc(tag, rp->file);
+        if (!readBinEntry(rp, &entry))
+        {
+            break;
+        }
+        freeEntryString(&entry);
+
+        if (BIN_TAG_KEYFRAME == tag)
+        {
+            // readBinEntry() skips over keyframes and returns the entry after it
+            rp->keyframeCount++;
+        }
+        rp->endTime = MAX(rp->endTime, entry.time);
+    }
+
+    rp->headerMode        = headerMode;
+    rp->headerSeedPending = headerSeed;
+    rp->readCompleted     = false;
+}
+
+/**
+ * @brief Write an unsigned LEB128 varint
+ *
+ * @param file The file to write to
+ * @param val The value to write
+ */
+static void writeVarint(FILE* file, uint64_t val)
+{
+    do
+    {
+        uint8_t byte = val & 0x7F;
+        val >>= 7;
+        fputc(byte | (val ? 0x80 : 0), file);
+    } while (val);
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint
+ *
+ * @param file The file to read from
+ * @param[out] val The value read
+ * @return true if a value was read, false at the end of the file
+ */
+static bool readVarint(FILE* file, uint64_t* val)
+{
+    *val = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = fgetc(file);
+        if (EOF == byte)
+        {
+            return false;
+        }
+        *val |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Write a signed varint, zigzag encoded so small negative values stay short
+ *
+ * @param file The file to write to
+ * @param val The value to write
+ */
+static void writeSignedVarint(FILE* file, int64_t val)
+{
+    writeVarint(file, ((uint64_t)val << 1) ^ (uint64_t)(val >> 63));
+}
+
+/**
+ * @brief Read a zigzag encoded signed varint
+ *
+ * @param file The file to read from
+ * @param[out] val The value read
+ * @return true if a value was read, false at the end of the file
+ */
+static bool readSignedVarint(FILE* file, int64_t* val)
+{
+    uint64_t raw;
+    if (!readVarint(file, &raw))
+    {
+        return false;
+    }
+    *val = (int64_t)(raw >> 1) ^ -(int64_t)(raw & 1);
+    return true;
+}
+
+/**
+ * @brief Begins recording emulator inputs to the given filename. Files ending in `.csv` are recorded as CSV, anything
+ * else uses the binary format
+ *
+ * @param filename The name of the recording file to write
+ */
+void startRecording(const char* filename)
+{
+    char buf[128];
+    if (!filename || !*filename)
+    {
+        filename = getTimestampFilename(buf, sizeof(buf) - 1, "rec-", "swrp");
+    }
+
+    // If specified, use custom filename, otherwise use timestamp one
+    printf("\nReplay: Recording inputs to file %s\n", filename);
+    replay.mode = RECORD;
+    if (openReplayFile(&replay, filename))
+    {
+        if (replay.binary)
+        {
+            // The start mode and seed go in the header
+            writeBinHeader(&replay, emulatorArgs.startMode, 0 != emulatorArgs.seed, emulatorArgs.seed,
+                           emulatorArgs.fakeTime ? emulatorArgs.fakeFps : -1);
+            return;
+        }
+
+        if (emulatorArgs.startMode)
+        {
+            // Immediately record the start mode
+            replayEntry_t modeEntry = {
+                .type     = SET_MODE,
+                .time     = 0,
+                .modeName = NULL,
+            };
+
+            char* tmpStr = malloc(strlen(emulatorArgs.startMode) + 1);
+            strncpy(tmpStr, emulatorArgs.startMode, strlen(emulatorArgs.startMode) + 1);
+            modeEntry.modeName = tmpStr;
+
+            writeEntry(&replay, &modeEntry);
+            free(tmpStr);
+        }
+
+        if (emulatorArgs.seed)
+        {
+            // Immediately record the start mode
+            replayEntry_t seedEntry = {
+                .type    = RANDOM_SEED,
+                .time    = 0,
+                .seedVal = emulatorArgs.seed,
+            };
+            writeEntry(&replay, &seedEntry);
+        }
+    }
+}
+
+void stopRecording(void)
+{
+    if (replay.file != NULL && replay.mode == RECORD)
+    {
+        closeReplayFile(&replay);
+        printf("\nStopped recording inputs\n");
+    }
+}
+
+bool isRecordingInput(void)
+{
+    return replay.file != NULL && replay.mode == RECORD;
+}
+
+/**
+ * @brief Begins playing back emulator inputs from the given file, in either format
+ *
+ * @param recordingName The name of the recording file to play back
+ */
+void startPlayback(const char* recordingName)
+{
+    printf("\nReplay: Replaying inputs from file %s\n", recordingName);
+    replay.mode = REPLAY;
+    if (!openReplayFile(&replay, recordingName))
+    {
+        printf("ERR: Replay: Couldn't open %s\n", recordingName);
+        replay.readCompleted = true;
+        return;
+    }
+
+    if (replay.binary && replay.endTime)
+    {
+        printf("Replay: Recording is %.3fs long with %d keyframes\n", replay.endTime / 1000000.0, replay.keyframeCount);
+    }
+
+    // Return true if the file was opened OK and has a valid header and first entry
+    if (!readEntry(&replay, &replay.nextEntry))
+    {
+        replay.readCompleted = true;
+    }
+}
+
+/**
+ * @brief Run playback unthrottled until the given recording time, then continue at normal speed. This only speeds
+ * things up with fake time, because a real clock can't be sped up. Every frame up to the target still runs, since a
+ * mode's state depends on all the input before it, so there's no skipping ahead to a keyframe
+ *
+ * @param timeUs The recording time to seek to, in microseconds
+ */
+void seekPlayback(int64_t timeUs)
+{
+    if (replay.mode != REPLAY || !replay.file || timeUs <= esp_timer_get_time())
+    {
+        return;
+    }
+
+    if (replay.endTime && timeUs > replay.endTime)
+    {
+        printf("Replay: Seek target is past the end of the recording, stopping at %.3fs\n",
+               replay.endTime / 1000000.0);
+        timeUs = replay.endTime;
+    }
+
+    printf("Replay: Seeking to %.3fs\n", timeUs / 1000000.0);
+    replay.seekUs = timeUs;
+    emulatorSetFastForward(true);
+}
+
+/**
+ * @brief Get the position and length of the recording being played back
+ *
+ * @param[out] timeUs The current playback time, in microseconds
+ * @param[out] endTimeUs The time of the last entry in the recording, or 0 if unknown
+ * @return true if a recording is being played back, false if not
+ */
+bool getPlaybackPosition(int64_t* timeUs, int64_t* endTimeUs)
+{
+    if (replay.mode != REPLAY || !replay.file)
+    {
+        return false;
+    }
+
+    *timeUs    = esp_timer_get_time();
+    *endTimeUs = replay.endTime;
+    return true;
+}
+
+/**
+ * @brief Convert a recording between the CSV and binary formats. The format of the output is chosen by its extension,
+ * so this can also compact a recording or add its missing summary in the same format
+ *
+ * @param inFile The recording to read, in either format
+ * @param outFile The recording to write
+ * @return true if the whole recording was converted, false if there was an error
+ */
+bool convertReplay(const char* inFile, const char* outFile)
+{
+    replay_t in  = {.mode = REPLAY};
+    replay_t out = {.mode = RECORD};
+
+    if (!openReplayFile(&in, inFile))
+    {
+        return false;
+    }
+
+    if (!openReplayFile(&out, outFile))
+    {
+        closeReplayFile(&in);
+        return false;
+    }
+
+    if (out.binary)
+    {
+        // The start mode and seed are read back as entries, so they're written as entries too. A CSV recording doesn't
+        // say whether it used fake time, so the current setting is used for it
+        float fakeFps = in.binary ? in.headerFakeFps : (emulatorArgs.fakeTime ? emulatorArgs.fakeFps : -1);
+        writeBinHeader(&out, NULL, false, 0, fakeFps);
+    }
+
+    int count           = 0;
+    replayEntry_t entry = {0};
+    while (readEntry(&in, &entry))
+    {
+        writeEntry(&out, &entry);
+        freeEntryString(&entry);
+        count++;
+    }
+    bool ok = in.readCompleted;
+
+    closeReplayFile(&in);
+    closeReplayFile(&out);
+
+    printf("Replay: Converted %d entries from %s to %s\n", count, inFile, outFile);
+    return ok;
 }
 
 /**
@@ -893,11 +2003,11 @@ void recordScreenshotTaken(const char* name)
             char tmp[strlen(name) + 1];
             strcpy(tmp, name);
             entry.filename = tmp;
-            writeEntry(&entry);
+            writeEntry(&replay, &entry);
         }
         else
         {
-            writeEntry(&entry);
+            writeEntry(&replay, &entry);
         }
     }
 }
@@ -917,7 +2027,7 @@ void emulatorRecordRandomSeed(uint32_t seed)
             .type    = RANDOM_SEED,
             .seedVal = seed,
         };
-        writeEntry(&entry);
+        writeEntry(&replay, &entry);
     }
 }
 
@@ -947,11 +2057,11 @@ void emulatorRecordCommand(const char* command)
             char tmp[strlen(command) + 1];
             strcpy(tmp, command);
             entry.commandStr = tmp;
-            writeEntry(&entry);
+            writeEntry(&replay, &entry);
         }
         else
         {
-            writeEntry(&entry);
+            writeEntry(&replay, &entry);
         }
     }
 }
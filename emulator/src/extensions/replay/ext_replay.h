@@ -11,21 +11,28 @@
  *
  * \section ext_format Recording File Format
  * If not given a custom name, recording files will be created in the current directory with the
- * name 'rec-TIMESTAMP.csv' As suggested by the name, this is simply a CSV file. The first line
+ * name 'rec-TIMESTAMP.swrp', which uses the compact binary format described below. Recording to a
+ * file name ending in `.csv` uses the CSV format instead. Either format can be played back, and
+ * `--playback=IN --replay-convert=OUT` converts between them, so a binary recording can be exported
+ * to CSV, edited by hand, and imported again.
+ *
+ * \subsection ext_format_csv CSV Format
+ * The first line
  * contains the header, which specifies three columns: Time, Type, and Value. The rest of the lines
  * will be the individual input values or special actions.
  *
  * The first column, `Time`, is the timestamp, in microseconds, of the input. The next column,
  * `Type`, is the type of data or the special action to perform. Possible options are: `BtnDown`,
  * `BtnUp`, `TouchPhi`, `TouchR`, `TouchI`, `AccelX`, `AccelY`, or `AccelZ`, and `Screenshot`,
- * `Fuzz`, `SetMode`, and `Quit`.
+ * `Fuzz`, `SetMode`, `Quit`, and `FrameCrc`.
  *
  * The third column, `Value`, depends on the value of the `Type` column. For `BtnDown` and `BtnUp`,
  * this is the name of the button: `A`, `B`, `Up`, `Down`, `Left`, `Right`, `Select`, or `Start`.
  * For all `Touch*` and `Accel*` types, the value is an integer. For `Screenshot`, the third column
  * is the filename for the screenshot, or it may be left blank for an automatically generated filename.
- * For `SetMode`, the value is the name of the mode to switch to. And, for `Quit` and `Fuzz`, the third
- * column is completely ignored.
+ * For `SetMode`, the value is the name of the mode to switch to. For `FrameCrc`, the value is the CRC-32
+ * of the palettized framebuffer in hex, which is compared with the frame drawn at that time during playback.
+ * And, for `Quit` and `Fuzz`, the third column is completely ignored.
  *
  * The following example recording file will generate a few button presses and touch events, then after
  * about 4 seconds, switch to Pong, take a screenshot, begin fuzzing until 10 seconds have passed, and
@@ -59,6 +66,18 @@
  * 10000000,Screenshot,afterFuzz.bmp
  * 10000000,Quit,
  * \endcode
+ *
+ * \subsection ext_format_bin Binary Format
+ * Binary recordings start with a header holding the start mode, random seed, and fake time settings. Each
+ * entry after that is a tag byte with the type, the time since the previous entry, and the change in value
+ * since the previous entry of the same type, using variable-length integers. Every second of recording time,
+ * a keyframe with the complete input state is written, which the reader resynchronizes to. When the recording
+ * is stopped, a summary with the recording's length and number of keyframes is appended. If the emulator
+ * didn't stop cleanly, the summary is rebuilt when the file is loaded.
+ *
+ * When playing back, `--seek=SECS` runs the emulator unthrottled until the recording reaches SECS seconds,
+ * then continues at normal speed. This needs fake time, which is turned on automatically if the recording
+ * didn't already use it.
  */
 
 #pragma once
@@ -72,6 +91,9 @@ void startRecording(const char* recordingName);
 void stopRecording(void);
 bool isRecordingInput(void);
 void startPlayback(const char* recordingName);
+void seekPlayback(int64_t timeUs);
+bool getPlaybackPosition(int64_t* timeUs, int64_t* endTimeUs);
+bool convertReplay(const char* inFile, const char* outFile);
 void recordScreenshotTaken(const char* name);
 void emulatorRecordRandomSeed(uint32_t seed);
 void emulatorRecordCommand(const char* command);
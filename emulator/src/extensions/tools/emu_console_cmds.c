@@ -2,6 +2,7 @@
 #include "macros.h"
 
 #include <errno.h>
+#include <inttypes.h>
 
 #include "ext_modes.h"
 #include "ext_tools.h"
@@ -11,6 +12,11 @@
 #include "ext_gamepad.h"
 #include "hdw-nvs_emu.h"
 #include "emu_cnfs.h"
+#include "hdw-dac.h"
+#include "hdw-dac_emu.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_emu.h"
+#include "emu_snapshot.h"
 
 // Console command handlers
 static int screenshotCommandCb(const char** args, int argCount, char* out);
@@ -23,6 +29,9 @@ static int touchCommandCb(const char** args, int argCount, char* out);
 static int ledsCommandCb(const char** args, int argCount, char* out);
 static int injectCommandCb(const char** args, int argCount, char* out);
 static int joystickCommandCb(const char** args, int argCount, char* out);
+static int audioCommandCb(const char** args, int argCount, char* out);
+static int heapCommandCb(const char** args, int argCount, char* out);
+static int snapshotCommandCb(const char** args, int argCount, char* out);
 static int helpCommandCb(const char** args, int argCount, char* out);
 
 // command, usage, description
@@ -33,7 +42,9 @@ static const char* commandDocs[][3] = {
     {"gif", "gif [filename]",
      "starts or stops recording the screen to a GIF named [filename], or an auto-generated file name if not specified"},
     {"mode", "mode [name]", "immediately changes the mode to [name], or lists all mode names if not specified"},
-    {"replay", "replay [filename]", "open and replay recorded inputs from replay file [filename]"},
+    {"replay", "replay [filename|seek <secs>]",
+     "open and replay recorded inputs from replay file [filename], fast forward the current replay to <secs>, or print "
+     "the replay position"},
     {"record", "record [name]",
      "begin recording inputs into replay file [filename], or an auto-generated file name if not specified"},
     {"fuzz", "fuzz [on|off]", "toggles the fuzzer"},
@@ -60,6 +71,15 @@ static const char* commandDocs[][3] = {
     {"inject nvs", "inject nvs [namespace] <key> <int|str|file> <value>",
      "injects data into an NVS key. Value can be either an integer, a string, or a file path"},
     {"inject asset", "inject asset <name> <filename>", "injects a file's entire contents as an asset"},
+    {"audio", "audio [reset]", "prints audio buffer underrun statistics, or resets them if [reset] is given"},
+    {"heap", "heap [sites]",
+     "prints current and peak heap usage, or the live allocations from every call site if [sites] is given"},
+    {"heap model", "heap model [on|off]",
+     "toggles limiting allocations to the Swadge's heap regions. Allocations made while it's off aren't modeled"},
+    {"heap fail", "heap fail <n|off>", "makes one in <n> allocations fail on purpose, or stops failing them"},
+    {"snapshot", "snapshot [save|restore|drop] [name]",
+     "saves the Swadge's state as [name], restores it, or deletes it. [name] is \"default\" if not specified. "
+     "Lists all snapshots if nothing is specified"},
     {"help", "help [command]", "prints help text for all commands, or for commands matching [command]"},
 };
 
@@ -69,7 +89,8 @@ static const consoleCommand_t consoleCommands[] = {
     {.name = "record", .cb = recordCommandCb},         {.name = "fuzz", .cb = fuzzCommandCb},
     {.name = "touchpad", .cb = touchCommandCb},        {.name = "leds", .cb = ledsCommandCb},
     {.name = "inject", .cb = injectCommandCb},         {.name = "help", .cb = helpCommandCb},
-    {.name = "joystick", .cb = joystickCommandCb},
+    {.name = "joystick", .cb = joystickCommandCb},     {.name = "audio", .cb = audioCommandCb},
+    {.name = "heap", .cb = heapCommandCb},             {.name = "snapshot", .cb = snapshotCommandCb},
 };
 
 const consoleCommand_t* getConsoleCommands(void)
@@ -153,14 +174,35 @@ static int screenRecordCommandCb(const char** args, int argCount, char* out)
 
 static int replayCommandCb(const char** args, int argCount, char* out)
 {
-    if (argCount > 0)
+    if (argCount > 1 && !strcmp(args[0], "seek"))
+    {
+        if (!emulatorArgs.fakeTime)
+        {
+            return sprintf(out, "Seeking requires --fake-time\n");
+        }
+        seekPlayback((int64_t)(atof(args[1]) * 1000000.0));
+        return sprintf(out, "Seeking to %ss\n", args[1]);
+    }
+    else if (argCount > 0)
     {
         startPlayback(args[0]);
         return sprintf(out, "Playback started\n");
     }
     else
     {
-        return sprintf(out, "Filename is required!\n");
+        int64_t timeUs, endTimeUs;
+        if (!getPlaybackPosition(&timeUs, &endTimeUs))
+        {
+            return sprintf(out, "Not playing back a recording\n");
+        }
+        else if (endTimeUs)
+        {
+            return sprintf(out, "Replay at %.3fs of %.3fs\n", timeUs / 1000000.0, endTimeUs / 1000000.0);
+        }
+        else
+        {
+            return sprintf(out, "Replay at %.3fs\n", timeUs / 1000000.0);
+        }
     }
 }
 
@@ -878,6 +920,136 @@ static int joystickCommandCb(const char** args, int argCount, char* out)
     }
 }
 
+static int audioCommandCb(const char** args, int argCount, char* out)
+{
+    if (argCount > 0)
+    {
+        if (!strncasecmp("reset", args[0], strlen(args[0])))
+        {
+            dacResetRingStats();
+            return sprintf(out, "Audio statistics reset\n");
+        }
+        return 0;
+    }
+
+    dacRingStats_t stats;
+    dacGetRingStats(&stats);
+
+    // Convert samples to milliseconds
+    const float msPerSamp = 1000.0f / DAC_SAMPLE_RATE_HZ;
+    return sprintf(out,
+                   "Buffered: %.1fms of %.1fms lead (lowest %.1fms)\nUnderruns: %" PRIu32 " (%.1fms of audio missed)\n",
+                   stats.buffered * msPerSamp, stats.lead * msPerSamp, stats.minBuffered * msPerSamp, stats.underruns,
+                   stats.missedSamples * msPerSamp);
+}
+
+static int heapCommandCb(const char** args, int argCount, char* out)
+{
+    if (argCount > 0)
+    {
+        if (!strncasecmp("sites", args[0], strlen(args[0])))
+        {
+            // This is too long for the console, so it goes to stdout
+            dumpAllocSites();
+            return sprintf(out, "Call sites printed to stdout\n");
+        }
+        else if (!strncasecmp("model", args[0], strlen(args[0])))
+        {
+            bool enable = !emuGetHeapModel();
+            if (argCount > 1)
+            {
+                enable = !strcasecmp("on", args[1]);
+            }
+            emuSetHeapModel(enable);
+            return sprintf(out, "Heap model %s\n", enable ? "on" : "off");
+        }
+        else if (!strncasecmp("fail", args[0], strlen(args[0])))
+        {
+            if (argCount < 2)
+            {
+                return sprintf(out, "Usage: heap fail <n|off>\n");
+            }
+
+            char* end  = NULL;
+            long oneIn = strtol(args[1], &end, 10);
+            if (!strcasecmp("off", args[1]))
+            {
+                oneIn = 0;
+            }
+            else if (end == args[1] || oneIn < 1)
+            {
+                return sprintf(out, "Invalid rate '%s'\n", args[1]);
+            }
+            emuSetHeapFailRate((uint32_t)oneIn);
+            if (oneIn)
+            {
+                return sprintf(out, "Failing one in %ld allocations\n", oneIn);
+            }
+            return sprintf(out, "Not failing allocations\n");
+        }
+        return 0;
+    }
+
+    heapCapsStats_t stats;
+    heapCapsGetStats(&stats);
+    int len = sprintf(out,
+                      "Internal: %zu used, %zu peak, %zu peak in this mode\nSPIRAM: %zu used, %zu peak, %zu peak in "
+                      "this mode\n%" PRIu32 " live allocations from %" PRIu32 " call sites\n",
+                      stats.usedInternal, stats.peakInternal, stats.modePeakInternal, stats.usedSpiram,
+                      stats.peakSpiram, stats.modePeakSpiram, stats.liveAllocations, stats.callSites);
+    if (emuGetHeapModel())
+    {
+        len += sprintf(out + len,
+                       "Internal: %zu free, %zu largest block, %zu lowest free\nSPIRAM: %zu free, %zu largest block, "
+                       "%zu lowest free\n%" PRIu32 " allocations failed\n",
+                       stats.freeInternal, stats.largestFreeInternal, stats.minimumFreeInternal, stats.freeSpiram,
+                       stats.largestFreeSpiram, stats.minimumFreeSpiram, stats.failures);
+    }
+    if (emuGetHeapFailRate())
+    {
+        len += sprintf(out + len, "Failing one in %" PRIu32 " allocations, %" PRIu32 " failed so far\n",
+                       emuGetHeapFailRate(), stats.injectedFailures);
+    }
+    return len;
+}
+
+static int snapshotCommandCb(const char** args, int argCount, char* out)
+{
+    if (argCount < 1)
+    {
+        int len = emuSnapshotList(out, 1024);
+        return len ? len : sprintf(out, "No snapshots\n");
+    }
+
+    const char* name = (argCount > 1) ? args[1] : "default";
+    if (!strncasecmp("save", args[0], strlen(args[0])))
+    {
+        if (emuSnapshotSave(name))
+        {
+            return sprintf(out, "Saved snapshot %s\n", name);
+        }
+        return sprintf(out, "Couldn't save snapshot %s\n", name);
+    }
+    else if (!strncasecmp("restore", args[0], strlen(args[0])))
+    {
+        if (emuSnapshotRestore(name))
+        {
+            return sprintf(out, "Restored snapshot %s\n", name);
+        }
+        return sprintf(out, "Couldn't restore snapshot %s\n", name);
+    }
+    else if (!strncasecmp("drop", args[0], strlen(args[0])))
+    {
+        if (emuSnapshotDrop(name))
+        {
+            return sprintf(out, "Dropped snapshot %s\n", name);
+        }
+        return sprintf(out, "No snapshot named %s\n", name);
+    }
+
+    return sprintf(out, "Usage: snapshot [save|restore|drop] [name]\n");
+}
+
 static int helpCommandCb(const char** args, int argCount, char* out)
 {
     char* cur = out;
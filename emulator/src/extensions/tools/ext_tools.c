@@ -31,19 +31,47 @@
 #endif
 
 #include "gifenc.h"
+#include "os_generic.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <math.h>
 #include <time.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <signal.h>
 
 #include "hdw-tft_emu.h"
 #include "esp_timer_emu.h"
 #include "swadge2024.h"
 
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// The number of recorded frames which may wait for the GIF encoder thread
+#define GIF_QUEUE_LEN 8
+
+/// The prefix for --video-pipe to write to an already open file descriptor instead of a path
+#define VIDEO_FD_PREFIX "fd:"
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief A recorded frame waiting to be encoded
+ */
+typedef struct
+{
+    /// @brief The framebuffer's palette indices, with the corners made transparent
+    uint8_t pixels[TFT_WIDTH * TFT_HEIGHT];
+    /// @brief How long to show the frame, in hundredths of a second
+    uint16_t delay;
+} gifQueuedFrame_t;
+
 //==============================================================================
 // Function Prototypes
 //==============================================================================
@@ -52,8 +80,16 @@ static bool toolsInit(emuArgs_t* emuArgs);
 static int32_t toolsKeyCb(uint32_t keycode, bool down, modKey_t modifiers);
 static void toolsPreFrame(uint64_t frame);
 static void toolsPostFrame(uint64_t frame);
+static void toolsDeinit(void);
 static void toolsRenderCb(uint32_t winW, uint32_t winH, const emuPane_t* panes, uint8_t numPanes);
 static void makeTransparent(uint8_t* framebuffer);
+static bool startGifThread(ge_GIF* gif);
+static void stopGifThread(void);
+static void queueGifFrame(const paletteColor_t* fb, uint16_t delay);
+static void* gifThreadFn(void* arg);
+static bool openVideoPipe(const emuArgs_t* emuArgs);
+static void closeVideoPipe(void);
+static void streamVideoFrames(void);
 
 static const char* getScreenshotName(char* buffer, size_t maxlen);
 
@@ -70,6 +106,7 @@ emuExtension_t toolsEmuExtension = {
     .fnMouseMoveCb   = NULL,
     .fnMouseButtonCb = NULL,
     .fnRenderCb      = toolsRenderCb,
+    .fnDeinitCb      = toolsDeinit,
 };
 
 static bool useFakeTime       = false;
@@ -79,6 +116,25 @@ static uint64_t fakeFrameTime = 0;
 static bool recordScreen           = false;
 static char recordingFilename[256] = {0};
 
+// Frames are encoded on a worker thread so recording doesn't slow down the emulator
+static og_thread_t gifThread       = NULL;
+static og_mutex_t gifQueueMutex    = NULL;
+static og_sema_t gifQueueSema      = NULL;
+static gifQueuedFrame_t* gifQueue  = NULL;
+static int gifQueueHead            = 0;
+static int gifQueueCount           = 0;
+static bool gifThreadStop          = false;
+static uint32_t gifCoalescedFrames = 0;
+
+// Raw video streaming, for --video-pipe
+static FILE* videoPipe              = NULL;
+static bool videoY4m                = false;
+static int64_t videoStartUs         = 0;
+static int64_t nextVideoFrameUs     = 0;
+static uint64_t videoFramesWritten  = 0;
+static uint8_t videoPalette[256][3] = {0};
+static uint8_t videoFrame[TFT_WIDTH * TFT_HEIGHT * 3];
+
 static bool pauseNextFrame = false;
 
 static bool showFps  = false;
@@ -103,20 +159,45 @@ static char consoleOutput[2048] = {0};
 // Functions
 //==============================================================================
 
-static bool toolsInit(emuArgs_t* emuArgs)
+/**
+ * @brief Switch the emulator to a fake clock which advances a fixed amount each frame. This must be called before the
+ * Swadge starts running
+ *
+ * @param fps The fake frame rate, or 0 to follow the Swadge's own frame rate and run exactly one frame per loop
+ */
+void enableFakeTime(float fps)
 {
-    if (emuArgs->fakeTime)
+    emuSetUseRealTime(false);
+    useFakeTime           = true;
+    emulatorArgs.fakeTime = true;
+    emulatorArgs.fakeFps  = fps;
+    fakeTime              = 1;
+
+    if (fps > 0)
     {
-        emuSetUseRealTime(false);
-        useFakeTime = true;
+        // Calculate the frame time time in us from the FPS value
+        fakeFrameTime = (uint64_t)(1000000.0 / fps);
 
-        //
-        fakeTime = 1;
+        printf("Using fake frame rate of %.1fFPS -- %" PRIu64 "us per frame\n", fps, fakeFrameTime);
+    }
+    else
+    {
+        // No rate given, so follow the Swadge's own frame rate and run exactly one frame per loop
+        fakeFrameTime = 0;
+    }
+}
 
-        // Calculate the frame time time in us from the FPS value
-        fakeFrameTime = (uint64_t)(1000000.0 / emulatorArgs.fakeFps);
+static bool toolsInit(emuArgs_t* emuArgs)
+{
+    if (emuArgs->fakeTime)
+    {
+        enableFakeTime(emuArgs->fakeFps);
+    }
 
-        printf("Using fake frame rate of %.1fFPS -- %" PRIu64 "us per frame\n", emuArgs->fakeFps, fakeFrameTime);
+    if (emuArgs->videoPipe && !videoPipe)
+    {
+        // The emulator keeps running without video if this fails
+        openVideoPipe(emuArgs);
     }
 
     if (emuArgs->showFps)
@@ -330,7 +411,7 @@ static void toolsPreFrame(uint64_t frame)
     if (useFakeTime)
     {
         emuSetEspTimerTime(fakeTime);
-        fakeTime += fakeFrameTime;
+        fakeTime += fakeFrameTime ? fakeFrameTime : getFrameRateUs();
     }
 
     if (pauseNextFrame)
@@ -370,7 +451,11 @@ static void toolsPostFrame(uint64_t frame)
 {
     static uint64_t index = 0;
     static bool setup     = false;
-    static ge_GIF* gif    = NULL;
+
+    if (videoPipe)
+    {
+        streamVideoFrames();
+    }
 
     // Cumulative time of all GIF frames
     static float gifTime = 0;
@@ -419,12 +504,22 @@ static void toolsPostFrame(uint64_t frame)
                 }
             }
 
-            gif = ge_new_gif(recordingFilename, TFT_WIDTH, TFT_HEIGHT, gifPalette, 8, cTransparent, 0);
+            // No background index, so each frame is compared to the last one and only the changed rectangle is
+            // written, with the unchanged pixels in it set to the transparent index
+            ge_GIF* gif = ge_new_gif(recordingFilename, TFT_WIDTH, TFT_HEIGHT, gifPalette, 8, -1, 0);
             if (!gif)
             {
                 printf("ERR! ext_tools.c: Unable to write to file %s for recording.\n", recordingFilename);
                 return;
             }
+            gif->transparent = cTransparent;
+
+            if (!startGifThread(gif))
+            {
+                printf("ERR! ext_tools.c: Unable to start the GIF encoder for %s.\n", recordingFilename);
+                ge_close_gif(gif);
+                return;
+            }
 
             index         = 0;
             gifTime       = 0;
@@ -438,10 +533,6 @@ static void toolsPostFrame(uint64_t frame)
         int64_t frameNow       = esp_timer_get_time();
         int64_t elapsedFrameUs = frameNow - lastGifFrame;
 
-        memcpy(gif->frame, fb, TFT_WIDTH * TFT_HEIGHT);
-
-        // Make the corners of the image transparent
-        makeTransparent(gif->frame);
         float desiredFramerate = elapsedFrameUs / 10000.0;
         uint16_t actualLength  = MAX(2, (int)(desiredFramerate));
         // Cumulative time error, relative to the minimum frame time
@@ -468,7 +559,7 @@ static void toolsPostFrame(uint64_t frame)
 
                 gifTime += actualLength * 10.0;
             }
-            ge_add_frame(gif, actualLength);
+            queueGifFrame(fb, actualLength);
 
             // Only update the last frame time when we actually emit a frame!
             lastGifFrame = frameNow;
@@ -483,15 +574,304 @@ static void toolsPostFrame(uint64_t frame)
     }
     else if (setup)
     {
-        ge_close_gif(gif);
-        gif = NULL;
+        // Wait for the encoder to finish the queued frames
+        stopGifThread();
 
-        printf("Done Recording! Wrote %" PRIu64 " frames to %s (dropped %" PRIu32 ", lengthened %" PRIu32 ")\n", index,
-               recordingFilename, skippedFrames, longFrames);
+        printf("Done Recording! Wrote %" PRIu64 " frames to %s (dropped %" PRIu32 ", lengthened %" PRIu32
+               ", merged %" PRIu32 ")\n",
+               index, recordingFilename, skippedFrames, longFrames, gifCoalescedFrames);
         setup = false;
     }
 }
 
+static void toolsDeinit(void)
+{
+    // Finish a recording in progress, so the file isn't left truncated
+    stopGifThread();
+    closeVideoPipe();
+}
+
+/**
+ * @brief Open the file, named pipe, or file descriptor given by --video-pipe and write the stream header
+ *
+ * @param emuArgs The emulator arguments
+ * @return true if the stream was opened, false if it wasn't
+ */
+static bool openVideoPipe(const emuArgs_t* emuArgs)
+{
+    if (!strncmp(emuArgs->videoPipe, VIDEO_FD_PREFIX, strlen(VIDEO_FD_PREFIX)))
+    {
+        videoPipe = fdopen(atoi(emuArgs->videoPipe + strlen(VIDEO_FD_PREFIX)), "wb");
+    }
+    else
+    {
+        // Opening a named pipe blocks until the encoder opens the other end
+        printf("Waiting to open %s for video\n", emuArgs->videoPipe);
+        videoPipe = fopen(emuArgs->videoPipe, "wb");
+    }
+
+    if (!videoPipe)
+    {
+        printf("ERR! ext_tools.c: Unable to open %s for video streaming\n", emuArgs->videoPipe);
+        return false;
+    }
+
+#ifdef SIGPIPE
+    // If the encoder goes away, fail the write and stop streaming instead of killing the emulator
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    videoY4m           = !strcmp(emuArgs->videoFormat, "y4m");
+    videoStartUs       = 0;
+    nextVideoFrameUs   = 0;
+    videoFramesWritten = 0;
+
+    // Convert the palette once. Y4M gets 4:4:4 BT.601 YCbCr, raw gets RGB24
+    for (int i = 0; i < 256; i++)
+    {
+        uint32_t rgb = (i < cTransparent) ? paletteToRGB((paletteColor_t)i) : 0;
+        int r        = (rgb >> 16) & 0xFF;
+        int g        = (rgb >> 8) & 0xFF;
+        int b        = (rgb & 0xFF);
+
+        if (videoY4m)
+        {
+            videoPalette[i][0] = (uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            videoPalette[i][1] = (uint8_t)(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            videoPalette[i][2] = (uint8_t)(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+        else
+        {
+            videoPalette[i][0] = r;
+            videoPalette[i][1] = g;
+            videoPalette[i][2] = b;
+        }
+    }
+
+    if (videoY4m)
+    {
+        fprintf(videoPipe, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C444\n", TFT_WIDTH, TFT_HEIGHT,
+                (int)lroundf(emuArgs->videoFps * 1000));
+        printf("Streaming %dx%d Y4M video at %.2f FPS to %s\n", TFT_WIDTH, TFT_HEIGHT, emuArgs->videoFps,
+               emuArgs->videoPipe);
+    }
+    else
+    {
+        // Raw RGB has no header, so print what an encoder needs to know
+        printf("Streaming raw video to %s, read it with: -f rawvideo -pixel_format rgb24 -video_size %dx%d "
+               "-framerate %.2f\n",
+               emuArgs->videoPipe, TFT_WIDTH, TFT_HEIGHT, emuArgs->videoFps);
+    }
+
+    if (!emuArgs->fakeTime)
+    {
+        printf("Video frame timing follows the real clock, use --fake-time for smooth video\n");
+    }
+    return true;
+}
+
+/**
+ * @brief Flush and close the video stream
+ */
+static void closeVideoPipe(void)
+{
+    if (videoPipe)
+    {
+        fclose(videoPipe);
+        videoPipe = NULL;
+        printf("Wrote %" PRIu64 " video frames\n", videoFramesWritten);
+    }
+}
+
+/**
+ * @brief Write the display to the video stream once for every video frame period which has passed. The stream has a
+ * constant frame rate, so the display is repeated when the Swadge runs slower than the video and skipped when it runs
+ * faster
+ */
+static void streamVideoFrames(void)
+{
+    const paletteColor_t* fb = getLastTftBitmap();
+    int64_t now              = esp_timer_get_time();
+    if (!fb || now < nextVideoFrameUs)
+    {
+        return;
+    }
+
+    // Convert the frame once, then write it as many times as needed
+    if (videoY4m)
+    {
+        // Planar, all of Y, then all of Cb, then all of Cr
+        for (int plane = 0; plane < 3; plane++)
+        {
+            uint8_t* out = &videoFrame[plane * TFT_WIDTH * TFT_HEIGHT];
+            for (int i = 0; i < TFT_WIDTH * TFT_HEIGHT; i++)
+            {
+                out[i] = videoPalette[fb[i]][plane];
+            }
+        }
+    }
+    else
+    {
+        // Packed RGB
+        for (int i = 0; i < TFT_WIDTH * TFT_HEIGHT; i++)
+        {
+            memcpy(&videoFrame[i * 3], videoPalette[fb[i]], 3);
+        }
+    }
+
+    while (nextVideoFrameUs <= now)
+    {
+        if ((videoY4m && EOF == fputs("FRAME\n", videoPipe))
+            || 1 != fwrite(videoFrame, sizeof(videoFrame), 1, videoPipe))
+        {
+            printf("ERR! ext_tools.c: Video stream closed\n");
+            closeVideoPipe();
+            return;
+        }
+
+        if (0 == videoFramesWritten++)
+        {
+            // The first frame starts the clock
+            videoStartUs = now;
+        }
+
+        // Each frame's time comes from the frame count, so the rounding of one frame's length doesn't add up
+        nextVideoFrameUs = videoStartUs + (int64_t)(videoFramesWritten * 1000000.0 / emulatorArgs.videoFps);
+    }
+}
+
+/**
+ * @brief Start the thread which encodes recorded frames. It owns the GIF until stopGifThread() is called
+ *
+ * @param gif The GIF to encode frames into
+ * @return true if the thread was started, false if it wasn't
+ */
+static bool startGifThread(ge_GIF* gif)
+{
+    // Emulator tools allocate from the host, so they don't use the Swadge's modeled heap
+    gifQueue = calloc(GIF_QUEUE_LEN, sizeof(gifQueuedFrame_t));
+    if (!gifQueue)
+    {
+        return false;
+    }
+
+    gifQueueHead       = 0;
+    gifQueueCount      = 0;
+    gifThreadStop      = false;
+    gifCoalescedFrames = 0;
+    gifQueueMutex      = OGCreateMutex();
+    gifQueueSema       = OGCreateSema();
+    gifThread          = OGCreateThread(gifThreadFn, gif);
+    return true;
+}
+
+/**
+ * @brief Stop the GIF encoder thread after it encodes every queued frame, and close the GIF
+ */
+static void stopGifThread(void)
+{
+    if (!gifThread)
+    {
+        return;
+    }
+
+    OGLockMutex(gifQueueMutex);
+    gifThreadStop = true;
+    OGUnlockMutex(gifQueueMutex);
+    OGUnlockSema(gifQueueSema);
+
+    OGJoinThread(gifThread);
+    gifThread = NULL;
+
+    OGDeleteSema(gifQueueSema);
+    OGDeleteMutex(gifQueueMutex);
+    free(gifQueue);
+    gifQueue = NULL;
+}
+
+/**
+ * @brief Copy a frame into the queue for the GIF encoder thread. If the encoder has fallen behind and the queue is
+ * full, the newest queued frame is replaced and its delay extended instead, so the GIF's timing stays correct and the
+ * emulator never waits
+ *
+ * @param fb The framebuffer to record
+ * @param delay How long to show the frame, in hundredths of a second
+ */
+static void queueGifFrame(const paletteColor_t* fb, uint16_t delay)
+{
+    OGLockMutex(gifQueueMutex);
+
+    gifQueuedFrame_t* slot;
+    bool coalesce = (gifQueueCount == GIF_QUEUE_LEN);
+    if (coalesce)
+    {
+        slot = &gifQueue[(gifQueueHead + gifQueueCount - 1) % GIF_QUEUE_LEN];
+        slot->delay += delay;
+        gifCoalescedFrames++;
+    }
+    else
+    {
+        slot        = &gifQueue[(gifQueueHead + gifQueueCount) % GIF_QUEUE_LEN];
+        slot->delay = delay;
+        gifQueueCount++;
+    }
+
+    // The palette indices go straight into the GIF
+    memcpy(slot->pixels, fb, sizeof(slot->pixels));
+
+    // Make the corners of the image transparent
+    makeTransparent(slot->pixels);
+
+    OGUnlockMutex(gifQueueMutex);
+
+    if (!coalesce)
+    {
+        OGUnlockSema(gifQueueSema);
+    }
+}
+
+/**
+ * @brief Encode queued frames until stopGifThread() is called, then close the GIF
+ *
+ * @param arg The ::ge_GIF to encode into
+ * @return NULL
+ */
+static void* gifThreadFn(void* arg)
+{
+    ge_GIF* gif = (ge_GIF*)arg;
+
+    while (true)
+    {
+        // Wait for a frame, or for the signal to stop
+        OGLockSema(gifQueueSema);
+
+        OGLockMutex(gifQueueMutex);
+        if (0 == gifQueueCount)
+        {
+            bool stop = gifThreadStop;
+            OGUnlockMutex(gifQueueMutex);
+            if (stop)
+            {
+                break;
+            }
+            continue;
+        }
+
+        // Take the frame out of the queue before encoding, so the main thread can reuse the slot
+        gifQueuedFrame_t* slot = &gifQueue[gifQueueHead];
+        memcpy(gif->frame, slot->pixels, sizeof(slot->pixels));
+        uint16_t delay = slot->delay;
+        gifQueueHead   = (gifQueueHead + 1) % GIF_QUEUE_LEN;
+        gifQueueCount--;
+        OGUnlockMutex(gifQueueMutex);
+
+        ge_add_frame(gif, delay);
+    }
+
+    ge_close_gif(gif);
+    return NULL;
+}
+
 static void toolsRenderCb(uint32_t winW, uint32_t winH, const emuPane_t* panes, uint8_t numPanes)
 {
     for (int i = 0; i < numPanes; i++)
@@ -673,8 +1053,16 @@ static const char* getScreenshotName(char* buffer, size_t maxlen)
  */
 bool takeScreenshot(const char* name)
 {
-    uint16_t width, height;
-    uint32_t* bitmap    = getDisplayBitmap(&width, &height);
+    // Screenshots are the size the display is drawn in the window
+    uint8_t mult     = emulatorGetDisplayScale();
+    uint16_t width   = TFT_WIDTH * mult;
+    uint16_t height  = TFT_HEIGHT * mult;
+    uint32_t* bitmap = malloc(sizeof(uint32_t) * width * height);
+    if (!bitmap)
+    {
+        return false;
+    }
+    getLastTftDisplayBitmap(bitmap, mult);
     bool timerWasPaused = emuTimerIsPaused();
 
     if (!timerWasPaused)
@@ -701,6 +1089,7 @@ bool takeScreenshot(const char* name)
             *(out++) = a;
         }
     }
+    free(bitmap);
 
     char buf[64];
     if (!name || !*name)
@@ -731,6 +1120,34 @@ bool takeScreenshot(const char* name)
     return 0 != res;
 }
 
+/**
+ * @brief Save a palettized frame as an unscaled PNG, without the emulator's window decorations
+ *
+ * @param name The file name to write
+ * @param fb The ::TFT_WIDTH by ::TFT_HEIGHT frame to save
+ * @return true if the PNG was written, false if not
+ */
+bool saveFramePng(const char* name, const paletteColor_t* fb)
+{
+    uint8_t* rgb = malloc(TFT_WIDTH * TFT_HEIGHT * 3);
+    if (!rgb)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < TFT_WIDTH * TFT_HEIGHT; i++)
+    {
+        uint32_t color = (fb[i] < cTransparent) ? paletteToRGB(fb[i]) : 0;
+        rgb[i * 3]     = (color >> 16) & 0xFF;
+        rgb[i * 3 + 1] = (color >> 8) & 0xFF;
+        rgb[i * 3 + 2] = color & 0xFF;
+    }
+
+    int res = stbi_write_png(name, TFT_WIDTH, TFT_HEIGHT, 3, rgb, TFT_WIDTH * 3);
+    free(rgb);
+    return 0 != res;
+}
+
 void startScreenRecording(const char* name)
 {
     if (name && *name)
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "emu_ext.h"
+#include "palette.h"
 
 #include <stddef.h>
 
@@ -18,6 +19,8 @@ extern emuExtension_t toolsEmuExtension;
 void handleConsoleCommand(const char* command);
 
 bool takeScreenshot(const char* name);
+bool saveFramePng(const char* name, const paletteColor_t* fb);
 void startScreenRecording(const char* name);
 void stopScreenRecording(void);
-bool isScreenRecording(void);
\ No newline at end of file
+bool isScreenRecording(void);
+void enableFakeTime(float fps);
\ No newline at end of file
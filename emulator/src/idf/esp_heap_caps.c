@@ -4,9 +4,12 @@
 
 #include <stdio.h>
 #include <inttypes.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
 #include "esp_heap_caps.h"
+#include "esp_heap_caps_emu.h"
+#include <stdatomic.h>
 #ifdef ESP_PLATFORM
     #include "esp_timer.h"
 #endif
@@ -21,7 +24,43 @@
 #define SPIRAM_SIZE          2093904
 #define SPIRAM_LARGEST_BLOCK 2064384
 
-#define A_TABLE_SIZE 16384
+/// The Swadge's internal heap regions, from the heap_init log at boot. See docs/SERIAL_DEBUG.md
+#define RAM_REGION_0_SIZE  0x244F0
+#define RAM_REGION_1_SIZE  0x3A10
+#define RTCRAM_REGION_SIZE 0x1FB8
+
+/// Block layout of ESP-IDF's TLSF heap on a 32-bit target
+#define TLSF_ALIGN          4
+#define TLSF_OVERHEAD       4
+#define TLSF_BLOCK_SIZE_MIN 12
+#define TLSF_BLOCK_HEADER   16
+#define TLSF_SL_INDEX_LOG2  5
+#define TLSF_SMALL_BLOCK    128
+
+/// The number of capability priorities each heap region has
+#define NUM_CAP_PRIOS 3
+
+#define NUM_REGIONS (sizeof(regions) / sizeof(regions[0]))
+
+// This file is also built into the asset tools, which don't have macros.h
+#ifndef MIN
+    #define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+    #define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/// Failure injection always starts from the same state, so failures are reproducible
+#define FAIL_SEED 0x5EED2024
+
+/// The starting number of slots in the allocation table. Must be a power of two
+#define A_TABLE_MIN_SIZE 4096
+
+/// The starting number of slots in the call site index. Must be a power of two
+#define SITE_INDEX_MIN_SIZE 1024
+
+/// How many call sites are printed in a leak report
+#define LEAK_REPORT_SITES 20
 
 //==============================================================================
 // Enums
@@ -46,43 +85,248 @@ typedef enum
 // Structs
 //==============================================================================
 
+/**
+ * @brief A block in a modeled heap region, in the Swadge's address space. Blocks tile their region with no gaps
+ */
+typedef struct heapBlock
+{
+    /// Offset of the block's header from the start of the region
+    uint32_t offset;
+    /// Usable bytes in the block, not counting the header
+    uint32_t size;
+    bool free;
+    uint8_t region;
+    /// Neighboring blocks in the region
+    struct heapBlock* prevPhys;
+    struct heapBlock* nextPhys;
+    /// Neighboring free blocks in the region, if this block is free
+    struct heapBlock* prevFree;
+    struct heapBlock* nextFree;
+} heapBlock_t;
+
+/**
+ * @brief A modeled heap region with the same capacity and capabilities as one on the Swadge
+ */
+typedef struct
+{
+    const char* name;
+    memType_t type;
+    uint32_t size;
+    /// The capabilities this region is used for at each priority, the same as ESP-IDF's soc_memory_types
+    uint32_t caps[NUM_CAP_PRIOS];
+    uint32_t freeBytes;
+    uint32_t minFreeBytes;
+    heapBlock_t* freeList;
+} heapRegion_t;
+
+/**
+ * @brief A live allocation. A NULL ptr marks an empty slot in the allocation table
+ */
+typedef struct
+{
+    void* ptr;
+    size_t size;
+    uint32_t caps;
+    memType_t type;
+    /// Where the allocation is in the modeled heap, or NULL if it was made while the model was off
+    heapBlock_t* block;
+    /// Index of the call site in sites
+    uint32_t site;
+    /// The mode epoch this was allocated in, see heapCapsModeExiting()
+    uint32_t epoch;
+    /// Whether this was allocated by the emulator rather than the Swadge, see emuHeapBeginEmulatorAllocs()
+    bool emulator;
+} allocation_t;
+
+/**
+ * @brief An allocation saved in a heap snapshot
+ */
 typedef struct
 {
     void* ptr;
     size_t size;
-    int32_t caps;
+    uint32_t caps;
+    memType_t type;
+    uint32_t site;
+    uint32_t epoch;
+    /// The region of the allocation's block in the modeled heap, or UINT8_MAX if it wasn't modeled
+    uint8_t region;
+    /// The offset and usable size of the allocation's block in the modeled heap
+    uint32_t offset;
+    uint32_t blockSize;
+    /// Where the allocation's contents are in the snapshot's data
+    size_t dataOffset;
+} savedAllocation_t;
+
+/**
+ * @brief Everything the Swadge had allocated at one moment, see emuHeapSaveSnapshot()
+ */
+struct emuHeapSnapshot
+{
+    /// The saved allocations, sorted by pointer
+    savedAllocation_t* allocs;
+    uint32_t numAllocs;
+    /// The contents of every saved allocation
+    uint8_t* data;
+    /// The mode epoch the snapshot was taken in
+    uint32_t epoch;
+    uint32_t failState;
+    /// The next snapshot which is keeping memory from being freed
+    struct emuHeapSnapshot* next;
+};
+
+/**
+ * @brief Totals for every allocation made from one line of code with one tag
+ */
+typedef struct
+{
     const char* file;
     const char* func;
     uint32_t line;
     char tag[32];
-} allocation_t;
+    memType_t type;
+
+    uint32_t liveCount;
+    size_t liveBytes;
+    size_t peakBytes;
+    uint64_t totalCount;
+    uint64_t totalBytes;
+
+    /// Scratch space for leak reports
+    uint32_t leakCount;
+    size_t leakBytes;
+} allocSite_t;
 
 //==============================================================================
 // Variables
 //==============================================================================
 
-allocation_t aTable[A_TABLE_SIZE] = {0};
-size_t usedMemory[MAX_MEM_TYPES]  = {0};
+/// Live allocations, an open addressing hash table keyed by pointer
+static allocation_t* aTable   = NULL;
+static uint32_t aTableSize    = 0;
+static uint32_t aTableEntries = 0;
+
+/// Every call site seen, in the order they were first seen. Never shrinks
+static allocSite_t* sites      = NULL;
+static uint32_t numSites       = 0;
+static uint32_t sitesAllocated = 0;
+
+/// An open addressing hash table of indices into sites, plus one so zero is empty
+static uint32_t* siteIndex    = NULL;
+static uint32_t siteIndexSize = 0;
+
+size_t usedMemory[MAX_MEM_TYPES]        = {0};
+static size_t peakMemory[MAX_MEM_TYPES] = {0};
+static size_t modePeak[MAX_MEM_TYPES]   = {0};
+
+/// The current mode epoch, and the epoch and name of the last mode to start exiting
+static uint32_t epoch                    = 0;
+static uint32_t exitingEpoch             = 0;
+static const char* exitingMode           = NULL;
+static size_t exitingPeak[MAX_MEM_TYPES] = {0};
+
+/// Allocations can come from other threads. This is a spinlock so the asset tools, which also build this file, don't
+/// need a threading library
+static atomic_flag heapLock = ATOMIC_FLAG_INIT;
+
+/// The Swadge's heap regions, in the order ESP-IDF searches them
+static heapRegion_t regions[] = {
+    {
+        .name = "RAM",
+        .type = MEM_INTERNAL,
+        .size = RAM_REGION_0_SIZE,
+        .caps = {MALLOC_CAP_8BIT | MALLOC_CAP_DEFAULT, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA | MALLOC_CAP_32BIT, 0},
+    },
+    {
+        .name = "RAM",
+        .type = MEM_INTERNAL,
+        .size = RAM_REGION_1_SIZE,
+        .caps = {MALLOC_CAP_8BIT | MALLOC_CAP_DEFAULT, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA | MALLOC_CAP_32BIT, 0},
+    },
+    {
+        .name = "RTCRAM",
+        .type = MEM_INTERNAL,
+        .size = RTCRAM_REGION_SIZE,
+        .caps = {MALLOC_CAP_RTCRAM, 0, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL | MALLOC_CAP_32BIT},
+    },
+    {
+        .name = "SPIRAM",
+        .type = MEM_SPIRAM,
+        .size = SPIRAM_SIZE,
+        .caps = {MALLOC_CAP_SPIRAM | MALLOC_CAP_DEFAULT, 0, MALLOC_CAP_8BIT | MALLOC_CAP_32BIT},
+    },
+};
+
+/// Whether new allocations come from the modeled heap, and whether it has been set up
+static bool modelEnabled     = false;
+static bool modelInitialized = false;
+
+/// Fail one in this many allocations on purpose, or never if 0
+static uint32_t failRate  = 0;
+static uint32_t failState = FAIL_SEED;
+
+/// Allocations which failed, either for lack of memory or on purpose
+static uint32_t failedAllocations   = 0;
+static uint32_t injectedAllocations = 0;
+
+/// Snapshots which haven't been freed. Memory in these isn't given back to the host, so it can be restored in place
+static emuHeapSnapshot_t* snapshots = NULL;
+
+/// How many calls to emuHeapBeginEmulatorAllocs() haven't been ended yet on this thread
+static _Thread_local uint32_t emulatorAllocDepth = 0;
 
 //==============================================================================
 // Function declarations
 //==============================================================================
 
-static void printMemoryOperation(memOp_t op, allocation_t* al);
-static void saveAllocation(memOp_t op, void* ptr, allocation_t* oldEntry, uint32_t size, uint32_t caps,
+static void printMemoryOperation(memOp_t op, const allocation_t* al, const char* file, const char* func, uint32_t line);
+static void saveAllocation(memOp_t op, void* ptr, void* oldPtr, uint32_t size, uint32_t caps, heapBlock_t* block,
                            const char* file, const char* func, uint32_t line, const char* tag);
+static bool reserveMemory(const void* oldPtr, size_t size, uint32_t caps, heapBlock_t** block, const char* file,
+                          uint32_t line);
+static void initModel(void);
+static bool regionHasCaps(const heapRegion_t* region, uint32_t caps);
+static uint32_t tlsfAdjustSize(size_t size);
+static uint32_t tlsfSearchSize(uint32_t size);
+static void insertFreeBlock(heapRegion_t* region, heapBlock_t* block);
+static void removeFreeBlock(heapRegion_t* region, heapBlock_t* block);
+static void trimBlock(heapRegion_t* region, heapBlock_t* block, uint32_t size);
+static heapBlock_t* modelAlloc(size_t size, uint32_t caps);
+static heapBlock_t* modelRealloc(heapBlock_t* block, size_t size, uint32_t caps);
+static void modelFree(heapBlock_t* block);
+static size_t largestFreeBlock(uint32_t caps);
+static void lockHeap(void);
+static void unlockHeap(void);
+static uint32_t hashPtr(const void* ptr);
+static allocation_t* findAllocation(const void* ptr);
+static allocation_t* insertAllocation(void* ptr);
+static void removeAllocation(allocation_t* al);
+static void growAllocTable(void);
+static uint32_t hashSite(const char* file, uint32_t line, memType_t type, const char* tag);
+static void indexSite(uint32_t i);
+static uint32_t findSite(const char* file, const char* func, uint32_t line, const char* tag, memType_t type);
+static int compareSitesByLeak(const void* a, const void* b);
+static int compareSitesByLive(const void* a, const void* b);
+static int compareSavedPtrs(const void* a, const void* b);
+static const savedAllocation_t* findSaved(const emuHeapSnapshot_t* snap, const void* ptr);
+static bool isPinned(const void* ptr);
+static bool pinnedSize(const void* ptr, size_t* size);
+static heapBlock_t* claimBlock(const savedAllocation_t* saved);
 
 //==============================================================================
 // Functions
 //==============================================================================
 
 /**
- * @brief TODO
+ * @brief Print a single memory operation as a CSV row, if MEMORY_DEBUG_PRINT is defined
  *
- * @param op
- * @param al
+ * @param op The operation
+ * @param al The allocation which was made, changed, or is about to be freed
+ * @param file The file the operation was called from
+ * @param func The function the operation was called from
+ * @param line The line the operation was called from
  */
-static void printMemoryOperation(memOp_t op, allocation_t* al)
+static void printMemoryOperation(memOp_t op, const allocation_t* al, const char* file, const char* func, uint32_t line)
 {
 #ifdef MEMORY_DEBUG_PRINT
 
@@ -117,7 +361,7 @@ static void printMemoryOperation(memOp_t op, allocation_t* al)
 
     int32_t internalDiff = 0;
     int32_t spiRamDiff   = 0;
-    if (al->caps & MALLOC_CAP_SPIRAM)
+    if (MEM_SPIRAM == al->type)
     {
         spiRamDiff = (OP_FREE == op) ? -al->size : al->size;
     }
@@ -141,259 +385,1645 @@ static void printMemoryOperation(memOp_t op, allocation_t* al)
     #else
            (int64_t)0,
     #endif
-           opStr, al->file, al->func, al->line, al->tag, al->ptr, internalDiff, spiRamDiff, (uint32_t)usedMemory[0],
+           opStr, file, func, line, sites[al->site].tag, al->ptr, internalDiff, spiRamDiff, (uint32_t)usedMemory[0],
            (uint32_t)usedMemory[1]);
 #endif
 }
 
 /**
- * @brief
- *
+ * @brief Print every live allocation as CSV rows, then the totals for every call site with live allocations
  */
 void dumpAllocTable(void)
 {
-    for (int idx = 0; idx < A_TABLE_SIZE; idx++)
+    lockHeap();
+    for (uint32_t idx = 0; idx < aTableSize; idx++)
     {
         allocation_t* al = &aTable[idx];
         if (al->ptr)
         {
-            printf("%s,%s,%s,%u,%s,%p,%d,%u,%d,%d\n", "DUMP", al->file, al->func, al->line, al->tag, al->ptr,
-                   al->caps & MALLOC_CAP_SPIRAM ? 0 : (uint32_t)al->size,
-                   al->caps & MALLOC_CAP_SPIRAM ? (uint32_t)al->size : 0, 0, 0);
+            const allocSite_t* site = &sites[al->site];
+            printf("%s,%s,%s,%u,%s,%p,%d,%u,%d,%d\n", "DUMP", site->file, site->func, site->line, site->tag, al->ptr,
+                   MEM_SPIRAM == al->type ? 0 : (uint32_t)al->size, MEM_SPIRAM == al->type ? (uint32_t)al->size : 0, 0,
+                   0);
         }
     }
+    unlockHeap();
+
+    dumpAllocSites();
 }
 
 /**
- * @brief TODO
- *
- * @param op
- * @param ptr
- * @param oldPtr
- * @param size
- * @param caps
- * @param file
- * @param func
- * @param line
- * @param tag
+ * @brief Print the totals for every call site with live allocations, largest first, and the peak usage of each type
+ * of memory
  */
-static void saveAllocation(memOp_t op, void* ptr, allocation_t* oldEntry, uint32_t size, uint32_t caps,
-                           const char* file, const char* func, uint32_t line, const char* tag)
+void dumpAllocSites(void)
 {
-    allocation_t* al = NULL;
-    // Find the old entry in the table. if oldPtr is NULL, then an empty entry will be found
-    if (NULL == oldEntry)
+    lockHeap();
+
+    uint32_t* order = malloc(sizeof(uint32_t) * (numSites + 1));
+    uint32_t count  = 0;
+    for (uint32_t i = 0; i < numSites; i++)
     {
-        int32_t idx = 0;
-        while (idx < A_TABLE_SIZE && NULL != aTable[idx].ptr)
+        if (sites[i].liveCount)
         {
-            idx++;
+            order[count++] = i;
         }
-        al = &aTable[idx];
     }
-    else
+    qsort(order, count, sizeof(uint32_t), compareSitesByLive);
+
+    printf("%s,%s,%s,%s,%s,%s,%s,%s,%s,%s\n", "SITE", "File", "Function", "Line", "Tag", "Type", "Live", "Live Bytes",
+           "Peak Bytes", "Total Allocs");
+    for (uint32_t i = 0; i < count; i++)
     {
-        al = oldEntry;
+        const allocSite_t* site = &sites[order[i]];
+        printf("SITE,%s,%s,%" PRIu32 ",%s,%s,%" PRIu32 ",%zu,%zu,%" PRIu64 "\n", site->file, site->func, site->line,
+               site->tag, MEM_SPIRAM == site->type ? "SPI" : "INT", site->liveCount, site->liveBytes, site->peakBytes,
+               site->totalCount);
     }
+    printf("Internal: %zu used, %zu peak. SPIRAM: %zu used, %zu peak. %" PRIu32 " live allocations from %" PRIu32
+           " call sites\n",
+           usedMemory[MEM_INTERNAL], peakMemory[MEM_INTERNAL], usedMemory[MEM_SPIRAM], peakMemory[MEM_SPIRAM],
+           aTableEntries, numSites);
 
-    // If the index is valid
-    if (NULL != al)
-    {
-        // Freeing works differently than allocating
-        if (OP_FREE == op)
-        {
-            // Pick a variable to track overall size
-            size_t* usedMem = (MALLOC_CAP_SPIRAM & al->caps) ? &usedMemory[1] : &usedMemory[0];
+    free(order);
+    unlockHeap();
+}
 
-            // Overwrite with free source data for printing later
-            al->file = file;
-            al->func = func;
-            al->line = line;
-            // Don't overwrite tag
+/**
+ * @brief Get the current and peak heap usage
+ *
+ * @param[out] stats The usage is written here
+ */
+void heapCapsGetStats(heapCapsStats_t* stats)
+{
+    lockHeap();
+    stats->usedInternal     = usedMemory[MEM_INTERNAL];
+    stats->usedSpiram       = usedMemory[MEM_SPIRAM];
+    stats->peakInternal     = peakMemory[MEM_INTERNAL];
+    stats->peakSpiram       = peakMemory[MEM_SPIRAM];
+    stats->modePeakInternal = modePeak[MEM_INTERNAL];
+    stats->modePeakSpiram   = modePeak[MEM_SPIRAM];
+    stats->liveAllocations  = aTableEntries;
+    stats->callSites        = numSites;
+    stats->failures         = failedAllocations;
+    stats->injectedFailures = injectedAllocations;
+    unlockHeap();
 
-            // Decrement space
-            if (al->size > *usedMem)
-            {
-                *usedMem = 0;
-                fprintf(stderr, "!! Freeing more than allocated at %s:%u\n", file, line);
-            }
-            else
-            {
-                *usedMem -= al->size;
-            }
+    stats->freeInternal        = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    stats->freeSpiram          = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    stats->largestFreeInternal = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    stats->largestFreeSpiram   = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    stats->minimumFreeInternal = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    stats->minimumFreeSpiram   = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+}
 
-            // Print the operation
-            printMemoryOperation(op, al);
+/**
+ * @brief Note that the current mode is about to exit. Everything allocated from now on belongs to the next mode. Call
+ * heapCapsModeExited() once the mode has exited to report what it leaked
+ *
+ * @param modeName The name of the mode which is exiting
+ */
+void heapCapsModeExiting(const char* modeName)
+{
+    lockHeap();
+    exitingEpoch = epoch++;
+    exitingMode  = modeName;
+    memcpy(exitingPeak, modePeak, sizeof(exitingPeak));
+    unlockHeap();
+}
 
-            // Erase the table entry
-            memset(al, 0, sizeof(allocation_t));
-        }
-        else
-        {
-            if (size >= SPIRAM_LARGEST_BLOCK)
-            {
-                fprintf(stderr, "!! Too large alloc at %s:%u (%u)\n", file, line, size);
-                dumpAllocTable();
-                exit(-1);
-            }
+/**
+ * @brief Report the peak heap usage of the mode passed to heapCapsModeExiting(), and every allocation it made which is
+ * still live, grouped by call site. Then start tracking the next mode's peak
+ */
+void heapCapsModeExited(void)
+{
+    lockHeap();
 
-            // Pick a variable to track overall size
-            size_t* usedMem = (MALLOC_CAP_SPIRAM & caps) ? &usedMemory[1] : &usedMemory[0];
+    for (uint32_t i = 0; i < numSites; i++)
+    {
+        sites[i].leakCount = 0;
+        sites[i].leakBytes = 0;
+    }
 
-            // Save the old size for reallocs
-            uint32_t oldSize = 0;
-            if (OP_REALLOC == op)
-            {
-                oldSize = al->size;
-            }
+    uint32_t leakCount = 0;
+    size_t leakBytes   = 0;
+    for (uint32_t idx = 0; idx < aTableSize; idx++)
+    {
+        allocation_t* al = &aTable[idx];
+        // The emulator's own allocations, like the NVS index, may be made while a mode runs but aren't its leaks
+        if (al->ptr && al->epoch == exitingEpoch && !al->emulator)
+        {
+            sites[al->site].leakCount++;
+            sites[al->site].leakBytes += al->size;
+            leakCount++;
+            leakBytes += al->size;
+        }
+    }
 
-            // Save entry
-            al->ptr  = ptr;
-            al->size = size;
-            al->caps = caps;
-            al->file = file;
-            al->func = func;
-            al->line = line;
-            if (tag)
-            {
-                snprintf(al->tag, sizeof(al->tag) - 1, "%s", tag);
-            }
-            else
+    const char* name = exitingMode ? exitingMode : "(unknown)";
+    printf("Mode \"%s\" heap peak: %zu internal, %zu SPIRAM\n", name, exitingPeak[MEM_INTERNAL],
+           exitingPeak[MEM_SPIRAM]);
+
+    if (leakCount)
+    {
+        uint32_t* order = malloc(sizeof(uint32_t) * (numSites + 1));
+        uint32_t count  = 0;
+        for (uint32_t i = 0; i < numSites; i++)
+        {
+            if (sites[i].leakCount)
             {
-                snprintf(al->tag, sizeof(al->tag) - 1, "%s:%u", al->func, al->line);
+                order[count++] = i;
             }
-
-            // Adjust space
-            *usedMem -= oldSize;
-            *usedMem += al->size;
-
-            // Print it
-            printMemoryOperation(op, al);
         }
+        qsort(order, count, sizeof(uint32_t), compareSitesByLeak);
 
-        if (usedMemory[1] >= SPIRAM_SIZE)
+        printf("!! Mode \"%s\" leaked %" PRIu32 " allocations, %zu bytes:\n", name, leakCount, leakBytes);
+        for (uint32_t i = 0; i < count && i < LEAK_REPORT_SITES; i++)
         {
-            fprintf(stderr, "!! Out of SPIRAM at %s:%u (%u)\n", file, line, (uint32_t)usedMemory[1]);
-            dumpAllocTable();
-            exit(-1);
+            const allocSite_t* site = &sites[order[i]];
+            printf("!!   %8zu bytes in %4" PRIu32 " allocations (%s) from %s() at %s:%" PRIu32 " [%s]\n",
+                   site->leakBytes, site->leakCount, MEM_SPIRAM == site->type ? "SPIRAM" : "internal", site->func,
+                   site->file, site->line, site->tag);
         }
+        if (count > LEAK_REPORT_SITES)
+        {
+            printf("!!   ... and %" PRIu32 " more call sites\n", count - LEAK_REPORT_SITES);
+        }
+        free(order);
     }
-    else if (OP_FREE == op)
-    {
-        // Trying to free an entry not in the table
-        fprintf(stderr, "!! Probable double-free at %s:%u (%p)\n", file, line, ptr);
-    }
-    else
+
+    // The next mode's peak starts from whatever is allocated now
+    memcpy(modePeak, usedMemory, sizeof(modePeak));
+    exitingMode = NULL;
+
+    unlockHeap();
+}
+
+/**
+ * @brief Turn the modeled heap on or off. When it's on, allocations are made from fixed-size regions with the same
+ * capacities and capabilities as the Swadge's heap, using the same block sizes and a similar fit, so they fail where
+ * they would on the Swadge. Memory is still allocated from the host, the model only decides whether it fits.
+ *
+ * This should be turned on before the Swadge starts. Anything allocated before it's turned on isn't in the model
+ *
+ * @param enable true to use the modeled heap, false to allocate without limits
+ */
+void emuSetHeapModel(bool enable)
+{
+    lockHeap();
+    if (enable && !modelInitialized)
     {
-        // Trying to add to the table, but there's no space
-        fprintf(stderr, "!! Allocation table out of space\n");
+        initModel();
     }
+    modelEnabled = enable;
+    unlockHeap();
 }
 
 /**
- * @brief Allocate a chunk of memory which has the given capabilities
- *
- * Equivalent semantics to libc malloc(), for capability-aware memory.
+ * @brief Check if the modeled heap is on
  *
- * In IDF, ``malloc(p)`` is equivalent to ``heap_caps_malloc(p, MALLOC_CAP_8BIT)``.
+ * @return true if allocations are made from the modeled heap
+ */
+bool emuGetHeapModel(void)
+{
+    return modelEnabled;
+}
+
+/**
+ * @brief Make allocations fail on purpose, to test how code handles running out of memory. Which allocations fail is
+ * pseudorandom, but the same every time the rate is set, so failures can be reproduced
  *
- * @param size Size, in bytes, of the amount of memory to allocate
- * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
- *                    of memory to be returned
+ * @param oneIn Fail one in this many allocations, on average, or 0 to never fail on purpose
+ */
+void emuSetHeapFailRate(uint32_t oneIn)
+{
+    lockHeap();
+    failRate  = oneIn;
+    failState = FAIL_SEED;
+    unlockHeap();
+}
+
+/**
+ * @brief Get how often allocations fail on purpose
  *
- * @return A pointer to the memory allocated on success, NULL on failure
+ * @return One in this many allocations fail, or 0 if they never fail on purpose
  */
-void* heap_caps_malloc_dbg(size_t size, uint32_t caps, const char* file, const char* func, int32_t line,
-                           const char* tag)
+uint32_t emuGetHeapFailRate(void)
 {
-#ifdef MEMORY_DEBUG
-    void* ptr = malloc(size);
-    saveAllocation(OP_MALLOC, ptr, NULL, size, caps, file, func, line, tag);
-    return ptr;
-#else
-    return malloc(size);
-#endif
+    return failRate;
 }
 
 /**
- * @brief Allocate a chunk of memory which has the given capabilities. The initialized value in the memory is set to
- * zero.
+ * @brief Start marking allocations as the emulator's rather than the Swadge's, until emuHeapEndEmulatorAllocs() is
+ * called. This is for emulator code which keeps its own state on the Swadge's heap, like the NVS index. These
+ * allocations are still tracked and modeled, but heap snapshots leave them alone. Calls may be nested, and only affect
+ * the calling thread
+ */
+void emuHeapBeginEmulatorAllocs(void)
+{
+    emulatorAllocDepth++;
+}
+
+/**
+ * @brief Stop marking allocations as the emulator's, see emuHeapBeginEmulatorAllocs()
+ */
+void emuHeapEndEmulatorAllocs(void)
+{
+    if (emulatorAllocDepth)
+    {
+        emulatorAllocDepth--;
+    }
+}
+
+/**
+ * @brief Save the contents and layout of everything the Swadge has allocated, so it can be put back with
+ * emuHeapRestoreSnapshot().
  *
- * Equivalent semantics to libc calloc(), for capability-aware memory.
+ * Restored allocations must be at the same addresses, since the Swadge has pointers to them. So until the snapshot is
+ * freed, memory it saved isn't given back to the host when the Swadge frees it, and reallocating it always moves it.
  *
- * In IDF, ``calloc(p)`` is equivalent to ``heap_caps_calloc(p, MALLOC_CAP_8BIT)``.
+ * @return The snapshot, which must be freed with emuHeapFreeSnapshot()
+ */
+emuHeapSnapshot_t* emuHeapSaveSnapshot(void)
+{
+    emuHeapSnapshot_t* snap = calloc(1, sizeof(emuHeapSnapshot_t));
+
+    lockHeap();
+
+    size_t dataSize = 0;
+    for (uint32_t idx = 0; idx < aTableSize; idx++)
+    {
+        if (aTable[idx].ptr && !aTable[idx].emulator)
+        {
+            snap->numAllocs++;
+            dataSize += aTable[idx].size;
+        }
+    }
+
+    snap->allocs = calloc(snap->numAllocs ? snap->numAllocs : 1, sizeof(savedAllocation_t));
+    snap->data   = malloc(dataSize ? dataSize : 1);
+    if (NULL == snap->allocs || NULL == snap->data)
+    {
+        unlockHeap();
+        free(snap->allocs);
+        free(snap->data);
+        free(snap);
+        return NULL;
+    }
+
+    savedAllocation_t* saved = snap->allocs;
+    size_t dataOffset        = 0;
+    for (uint32_t idx = 0; idx < aTableSize; idx++)
+    {
+        const allocation_t* al = &aTable[idx];
+        if (NULL == al->ptr || al->emulator)
+        {
+            continue;
+        }
+
+        saved->ptr        = al->ptr;
+        saved->size       = al->size;
+        saved->caps       = al->caps;
+        saved->type       = al->type;
+        saved->site       = al->site;
+        saved->epoch      = al->epoch;
+        saved->region     = al->block ? al->block->region : UINT8_MAX;
+        saved->offset     = al->block ? al->block->offset : 0;
+        saved->blockSize  = al->block ? al->block->size : 0;
+        saved->dataOffset = dataOffset;
+        memcpy(snap->data + dataOffset, al->ptr, al->size);
+        dataOffset += al->size;
+        saved++;
+    }
+    qsort(snap->allocs, snap->numAllocs, sizeof(savedAllocation_t), compareSavedPtrs);
+
+    snap->epoch     = epoch;
+    snap->failState = failState;
+    snap->next      = snapshots;
+    snapshots       = snap;
+
+    unlockHeap();
+    return snap;
+}
+
+/**
+ * @brief Put the Swadge's allocations back the way they were when a snapshot was saved. Everything the Swadge
+ * allocated since then is freed, everything it freed is allocated again at the same address, and the contents of
+ * every allocation are restored. Modeled allocations go back to the same place in the model if there's room there.
+ * Allocations made by the emulator aren't touched.
  *
- * @param n    Number of continuing chunks of memory to allocate
- * @param size Size, in bytes, of a chunk of memory to allocate
- * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
- *                    of memory to be returned
+ * Snapshots can't be restored after the mode changes, since the new mode doesn't know about the old mode's memory.
  *
- * @return A pointer to the memory allocated on success, NULL on failure
+ * @param snap The snapshot to restore, which is still valid afterwards
+ * @return true if the snapshot was restored, false if it was taken in a different mode and nothing was changed
  */
-void* heap_caps_calloc_dbg(size_t n, size_t size, uint32_t caps, const char* file, const char* func, int32_t line,
-                           const char* tag)
+bool emuHeapRestoreSnapshot(const emuHeapSnapshot_t* snap)
 {
-#ifdef MEMORY_DEBUG
-    void* ptr = calloc(n, size);
-    saveAllocation(OP_CALLOC, ptr, NULL, n * size, caps, file, func, line, tag);
-    return ptr;
-#else
-    return calloc(n, size);
-#endif
+    lockHeap();
+    if (snap->epoch != epoch)
+    {
+        unlockHeap();
+        return false;
+    }
+
+    // Find what the Swadge allocated after the snapshot first, since removing table entries moves other entries
+    uint32_t numNew = 0;
+    void** newPtrs  = malloc(sizeof(void*) * (aTableEntries + 1));
+    for (uint32_t idx = 0; idx < aTableSize; idx++)
+    {
+        const allocation_t* al = &aTable[idx];
+        if (al->ptr && !al->emulator && NULL == findSaved(snap, al->ptr))
+        {
+            newPtrs[numNew++] = al->ptr;
+        }
+    }
+
+    // Free them. Memory which other snapshots need is kept
+    for (uint32_t i = 0; i < numNew; i++)
+    {
+        allocation_t* al = findAllocation(newPtrs[i]);
+        usedMemory[al->type] -= MIN(al->size, usedMemory[al->type]);
+        sites[al->site].liveCount--;
+        sites[al->site].liveBytes -= al->size;
+        if (al->block)
+        {
+            modelFree(al->block);
+        }
+        removeAllocation(al);
+
+        if (!isPinned(newPtrs[i]))
+        {
+            free(newPtrs[i]);
+        }
+    }
+    free(newPtrs);
+
+    for (uint32_t i = 0; i < snap->numAllocs; i++)
+    {
+        const savedAllocation_t* saved = &snap->allocs[i];
+        if (NULL == findAllocation(saved->ptr))
+        {
+            // This was freed after the snapshot, but the memory was kept, so it can be allocated again in place
+            allocation_t* al = insertAllocation(saved->ptr);
+            al->size         = saved->size;
+            al->caps         = saved->caps;
+            al->type         = saved->type;
+            al->block        = claimBlock(saved);
+            al->site         = saved->site;
+            al->epoch        = saved->epoch;
+
+            usedMemory[al->type] += al->size;
+            sites[al->site].liveCount++;
+            sites[al->site].liveBytes += al->size;
+        }
+
+        // Allocations which were live the whole time are still the same size, since they're never resized in place
+        memcpy(saved->ptr, snap->data + saved->dataOffset, saved->size);
+    }
+
+    failState = snap->failState;
+
+    unlockHeap();
+    return true;
 }
 
 /**
- * @brief TODO
+ * @brief Free a heap snapshot, and give any memory only it was keeping back to the host
  *
- * @param ptr
- * @param size
- * @param caps
- * @param file
- * @param func
- * @param line
- * @param tag
- * @return void*
+ * @param snap The snapshot to free, or NULL to do nothing
  */
-void* heap_caps_realloc_dbg(void* ptr, size_t size, uint32_t caps, const char* file, const char* func, int32_t line,
-                            const char* tag)
+void emuHeapFreeSnapshot(emuHeapSnapshot_t* snap)
 {
-#ifdef MEMORY_DEBUG
+    if (NULL == snap)
+    {
+        return;
+    }
 
-    // Find the old entry in the table. if oldPtr is NULL, then an empty entry will be found
-    int32_t idx = 0;
-    while (idx < A_TABLE_SIZE && ptr != aTable[idx].ptr)
+    lockHeap();
+    for (emuHeapSnapshot_t** link = &snapshots; *link; link = &(*link)->next)
     {
-        idx++;
+        if (*link == snap)
+        {
+            *link = snap->next;
+            break;
+        }
     }
 
-    void* newPtr = realloc(ptr, size);
-    saveAllocation(OP_REALLOC, newPtr, &aTable[idx], size, caps, file, func, line, tag);
-    return newPtr;
-#else
-    return realloc(ptr, size);
-#endif
+    for (uint32_t i = 0; i < snap->numAllocs; i++)
+    {
+        void* ptr = snap->allocs[i].ptr;
+        if (NULL == findAllocation(ptr) && !isPinned(ptr))
+        {
+            free(ptr);
+        }
+    }
+    unlockHeap();
+
+    free(snap->allocs);
+    free(snap->data);
+    free(snap);
 }
 
 /**
- * @brief TODO
+ * @brief Get how much memory a heap snapshot saved
  *
- * @param ptr
- * @param file
- * @param func
- * @param line
+ * @param snap The snapshot
+ * @param[out] numAllocs The number of allocations saved is written here. May be NULL
+ * @return The total size of the saved allocations, in bytes
  */
-void heap_caps_free_dbg(void* ptr, const char* file, const char* func, int32_t line, const char* tag)
+size_t emuHeapGetSnapshotSize(const emuHeapSnapshot_t* snap, uint32_t* numAllocs)
 {
-#ifdef MEMORY_DEBUG
+    if (numAllocs)
+    {
+        *numAllocs = snap->numAllocs;
+    }
 
-    // Find the old entry in the table. if oldPtr is NULL, then an empty entry will be found
-    int32_t idx = 0;
-    while (idx < A_TABLE_SIZE && ptr != aTable[idx].ptr)
+    size_t total = 0;
+    for (uint32_t i = 0; i < snap->numAllocs; i++)
     {
-        idx++;
+        total += snap->allocs[i].size;
     }
+    return total;
+}
 
-    saveAllocation(OP_FREE, ptr, &aTable[idx], 0, 0, file, func, line, tag);
-#endif
-    free(ptr);
+/**
+ * @brief Get the total free space in all heap regions with the given capabilities
+ *
+ * @param caps Bitwise OR of MALLOC_CAP_* flags
+ * @return The free space, in bytes. Without the modeled heap, this is an estimate
+ */
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    lockHeap();
+    size_t freeBytes = 0;
+    size_t used[MAX_MEM_TYPES];
+    memcpy(used, usedMemory, sizeof(used));
+    for (uint8_t r = 0; r < NUM_REGIONS; r++)
+    {
+        if (!regionHasCaps(&regions[r], caps))
+        {
+            continue;
+        }
+
+        if (modelInitialized)
+        {
+            freeBytes += regions[r].freeBytes;
+        }
+        else
+        {
+            // Without the model, charge the used memory to the first regions of its type
+            memType_t type = regions[r].type;
+            size_t charged = MIN(used[type], regions[r].size);
+            freeBytes += regions[r].size - charged;
+            used[type] -= charged;
+        }
+    }
+    unlockHeap();
+    return freeBytes;
+}
+
+/**
+ * @brief Get the lowest the free space in all heap regions with the given capabilities has been
+ *
+ * @param caps Bitwise OR of MALLOC_CAP_* flags
+ * @return The minimum free space, in bytes. Without the modeled heap, this is the current free space
+ */
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    if (!modelInitialized)
+    {
+        return heap_caps_get_free_size(caps);
+    }
+
+    lockHeap();
+    size_t minFree = 0;
+    for (uint8_t r = 0; r < NUM_REGIONS; r++)
+    {
+        if (regionHasCaps(&regions[r], caps))
+        {
+            minFree += regions[r].minFreeBytes;
+        }
+    }
+    unlockHeap();
+    return minFree;
+}
+
+/**
+ * @brief Get the total size of all heap regions with the given capabilities
+ *
+ * @param caps Bitwise OR of MALLOC_CAP_* flags
+ * @return The total size, in bytes
+ */
+size_t heap_caps_get_total_size(uint32_t caps)
+{
+    size_t total = 0;
+    for (uint8_t r = 0; r < NUM_REGIONS; r++)
+    {
+        if (regionHasCaps(&regions[r], caps))
+        {
+            total += regions[r].size;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Get the largest block which could be allocated with the given capabilities
+ *
+ * @param caps Bitwise OR of MALLOC_CAP_* flags
+ * @return The largest allocatable size, in bytes. Without the modeled heap, this is an estimate
+ */
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    lockHeap();
+    size_t largest = largestFreeBlock(caps);
+    unlockHeap();
+    return largest;
+}
+
+/**
+ * @brief Track a memory operation and check that the Swadge would have had enough memory for it
+ *
+ * @param op The operation
+ * @param ptr The allocated pointer, or the pointer being freed
+ * @param oldPtr For reallocs, the pointer which was reallocated, or NULL
+ * @param size The size of the allocation, or 0 for frees
+ * @param caps The capabilities of the allocation
+ * @param block Where the allocation is in the modeled heap, from reserveMemory(), or NULL if the model is off
+ * @param file The file the operation was called from
+ * @param func The function the operation was called from
+ * @param line The line the operation was called from
+ * @param tag A tag for the allocation, or NULL to use the function and line
+ */
+static void saveAllocation(memOp_t op, void* ptr, void* oldPtr, uint32_t size, uint32_t caps, heapBlock_t* block,
+                           const char* file, const char* func, uint32_t line, const char* tag)
+{
+    lockHeap();
+
+    // Reallocations stay the emulator's if they started out that way
+    bool emulatorOwned = (0 != emulatorAllocDepth);
+
+    // Reallocs and frees remove the old entry first
+    void* removePtr = (OP_FREE == op) ? ptr : oldPtr;
+    if (NULL != removePtr)
+    {
+        allocation_t* al = findAllocation(removePtr);
+        if (NULL == al)
+        {
+            // Trying to free an entry not in the table
+            fprintf(stderr, "!! Probable double-free at %s:%u (%p)\n", file, line, removePtr);
+        }
+        else
+        {
+            memType_t type    = al->type;
+            allocSite_t* site = &sites[al->site];
+            emulatorOwned |= al->emulator;
+
+            // Decrement space
+            if (al->size > usedMemory[type])
+            {
+                usedMemory[type] = 0;
+                fprintf(stderr, "!! Freeing more than allocated at %s:%u\n", file, line);
+            }
+            else
+            {
+                usedMemory[type] -= al->size;
+            }
+            site->liveCount--;
+            site->liveBytes -= al->size;
+
+            if (OP_FREE == op)
+            {
+                // Print the operation
+                printMemoryOperation(op, al, file, func, line);
+
+                // A realloc already moved or resized the block in reserveMemory()
+                if (al->block)
+                {
+                    modelFree(al->block);
+                }
+            }
+
+            // Erase the table entry
+            removeAllocation(al);
+        }
+    }
+
+    if (OP_FREE != op && NULL == ptr && NULL != block)
+    {
+        // The host ran out of memory, which the model didn't predict. Give the block back. Reallocs aren't saved when
+        // they fail, and their old allocation already owns the block
+        modelFree(block);
+    }
+    else if (OP_FREE != op && NULL != ptr)
+    {
+        if (NULL == block && size >= SPIRAM_LARGEST_BLOCK)
+        {
+            fprintf(stderr, "!! Too large alloc at %s:%u (%u)\n", file, line, size);
+            unlockHeap();
+            dumpAllocTable();
+            exit(-1);
+        }
+
+        // Pick a variable to track overall size. Modeled allocations may end up in SPIRAM without asking for it
+        memType_t type;
+        if (block)
+        {
+            type = regions[block->region].type;
+        }
+        else
+        {
+            type = (MALLOC_CAP_SPIRAM & caps) ? MEM_SPIRAM : MEM_INTERNAL;
+        }
+
+        // Save entry
+        allocation_t* al = insertAllocation(ptr);
+        al->size         = size;
+        al->caps         = caps;
+        al->type         = type;
+        al->block        = block;
+        al->site         = findSite(file, func, line, tag, type);
+        al->epoch        = epoch;
+        al->emulator     = emulatorOwned;
+
+        // Adjust space
+        usedMemory[type] += size;
+        if (usedMemory[type] > peakMemory[type])
+        {
+            peakMemory[type] = usedMemory[type];
+        }
+        if (usedMemory[type] > modePeak[type])
+        {
+            modePeak[type] = usedMemory[type];
+        }
+
+        allocSite_t* site = &sites[al->site];
+        site->liveCount++;
+        site->liveBytes += size;
+        site->totalCount++;
+        site->totalBytes += size;
+        if (site->liveBytes > site->peakBytes)
+        {
+            site->peakBytes = site->liveBytes;
+        }
+
+        // Print it
+        printMemoryOperation(op, al, file, func, line);
+    }
+
+    // The model fails allocations the way the Swadge would, so this is only needed without it
+    if (!modelEnabled && usedMemory[MEM_SPIRAM] >= SPIRAM_SIZE)
+    {
+        fprintf(stderr, "!! Out of SPIRAM at %s:%u (%u)\n", file, line, (uint32_t)usedMemory[MEM_SPIRAM]);
+        unlockHeap();
+        dumpAllocTable();
+        exit(-1);
+    }
+
+    unlockHeap();
+}
+
+/**
+ * @brief Decide whether an allocation would succeed on the Swadge, and where it would go. Failures are printed, and
+ * include ones injected by emuSetHeapFailRate(), which are never injected into the emulator's own allocations
+ *
+ * @param oldPtr For reallocs, the pointer being reallocated, or NULL
+ * @param size The number of bytes to allocate
+ * @param caps The capabilities of the allocation
+ * @param[out] block Where the allocation is in the modeled heap is written here, or NULL if the model is off. For
+ * reallocs, the old allocation's block has already been moved or resized to this
+ * @param file The file the allocation was made from
+ * @param line The line the allocation was made from
+ * @return true if the allocation should be made, false if it should fail
+ */
+static bool reserveMemory(const void* oldPtr, size_t size, uint32_t caps, heapBlock_t** block, const char* file,
+                          uint32_t line)
+{
+    lockHeap();
+    *block = NULL;
+
+    allocation_t* oldAl = oldPtr ? findAllocation(oldPtr) : NULL;
+
+    // Only the Swadge's allocations are failed on purpose, so the emulator's own state stays intact
+    bool emulatorOwned = (0 != emulatorAllocDepth) || (oldAl && oldAl->emulator);
+    if (failRate && !emulatorOwned)
+    {
+        // xorshift32, so failures don't disturb esp_random()
+        failState ^= failState << 13;
+        failState ^= failState >> 17;
+        failState ^= failState << 5;
+        if (0 == failState % failRate)
+        {
+            injectedAllocations++;
+            fprintf(stderr, "!! Injected allocation failure at %s:%" PRIu32 " (%zu bytes)\n", file, line, size);
+            unlockHeap();
+            return false;
+        }
+    }
+
+    if (modelEnabled)
+    {
+        *block = (oldAl && oldAl->block) ? modelRealloc(oldAl->block, size, caps) : modelAlloc(size, caps);
+        if (NULL == *block)
+        {
+            failedAllocations++;
+            fprintf(stderr,
+                    "!! Allocation failed at %s:%" PRIu32 " (%zu bytes). The largest free block with those "
+                    "capabilities is %zu bytes\n",
+                    file, line, size, largestFreeBlock(caps));
+            unlockHeap();
+            return false;
+        }
+    }
+    else if (oldAl && oldAl->block)
+    {
+        // The model was turned off since this was allocated, so the reallocation leaves the model
+        modelFree(oldAl->block);
+    }
+
+    if (oldAl)
+    {
+        oldAl->block = *block;
+    }
+
+    unlockHeap();
+    return true;
+}
+
+/**
+ * @brief Set up every modeled heap region as a single free block
+ */
+static void initModel(void)
+{
+    for (uint8_t r = 0; r < NUM_REGIONS; r++)
+    {
+        heapBlock_t* block = calloc(1, sizeof(heapBlock_t));
+        block->size        = regions[r].size - TLSF_OVERHEAD;
+        block->region      = r;
+        block->free        = true;
+
+        regions[r].freeBytes    = block->size;
+        regions[r].minFreeBytes = block->size;
+        regions[r].freeList     = NULL;
+        insertFreeBlock(&regions[r], block);
+    }
+    modelInitialized = true;
+}
+
+/**
+ * @brief Check if a heap region has all of the given capabilities, at any priority
+ *
+ * @param region The region to check
+ * @param caps The capabilities to check for
+ * @return true if the region has every capability
+ */
+static bool regionHasCaps(const heapRegion_t* region, uint32_t caps)
+{
+    uint32_t allCaps = 0;
+    for (int prio = 0; prio < NUM_CAP_PRIOS; prio++)
+    {
+        allCaps |= region->caps[prio];
+    }
+    return caps == (allCaps & caps);
+}
+
+/**
+ * @brief Round a requested size to the size of the block TLSF would use for it
+ *
+ * @param size The requested size
+ * @return The block's usable size
+ */
+static uint32_t tlsfAdjustSize(size_t size)
+{
+    if (size > UINT32_MAX - TLSF_ALIGN)
+    {
+        return UINT32_MAX;
+    }
+    uint32_t adjusted = (size + TLSF_ALIGN - 1) & ~(TLSF_ALIGN - 1);
+    return MAX(adjusted, TLSF_BLOCK_SIZE_MIN);
+}
+
+/**
+ * @brief Get the smallest free block TLSF would consider for a block size. TLSF rounds large requests up to the next
+ * size class, so it can fail to find a block that would have been big enough
+ *
+ * @param size The block size, from tlsfAdjustSize()
+ * @return The smallest usable size of a free block which could be used
+ */
+static uint32_t tlsfSearchSize(uint32_t size)
+{
+    if (size < TLSF_SMALL_BLOCK)
+    {
+        return size;
+    }
+    uint32_t classBits = (31 - __builtin_clz(size)) - TLSF_SL_INDEX_LOG2;
+    uint64_t rounded   = (uint64_t)size + (1U << classBits) - 1;
+    // The size class boundary may have moved up a bit
+    classBits = (63 - __builtin_clzll(rounded)) - TLSF_SL_INDEX_LOG2;
+    rounded &= ~(((uint64_t)1 << classBits) - 1);
+    return MIN(rounded, UINT32_MAX);
+}
+
+/**
+ * @brief Add a block to the front of its region's free list
+ *
+ * @param region The block's region
+ * @param block The block which is now free
+ */
+static void insertFreeBlock(heapRegion_t* region, heapBlock_t* block)
+{
+    block->free     = true;
+    block->prevFree = NULL;
+    block->nextFree = region->freeList;
+    if (region->freeList)
+    {
+        region->freeList->prevFree = block;
+    }
+    region->freeList = block;
+}
+
+/**
+ * @brief Remove a block from its region's free list
+ *
+ * @param region The block's region
+ * @param block The block which is no longer free
+ */
+static void removeFreeBlock(heapRegion_t* region, heapBlock_t* block)
+{
+    if (block->prevFree)
+    {
+        block->prevFree->nextFree = block->nextFree;
+    }
+    else
+    {
+        region->freeList = block->nextFree;
+    }
+    if (block->nextFree)
+    {
+        block->nextFree->prevFree = block->prevFree;
+    }
+    block->free     = false;
+    block->prevFree = NULL;
+    block->nextFree = NULL;
+}
+
+/**
+ * @brief Shrink a used block to a size, if what's left over is big enough to be its own free block
+ *
+ * @param region The block's region
+ * @param block The block to shrink
+ * @param size The block's new usable size, from tlsfAdjustSize()
+ */
+static void trimBlock(heapRegion_t* region, heapBlock_t* block, uint32_t size)
+{
+    if (block->size < size + TLSF_BLOCK_HEADER)
+    {
+        return;
+    }
+
+    heapBlock_t* rest = calloc(1, sizeof(heapBlock_t));
+    rest->offset      = block->offset + TLSF_OVERHEAD + size;
+    rest->size        = block->size - size - TLSF_OVERHEAD;
+    rest->region      = block->region;
+    rest->prevPhys    = block;
+    rest->nextPhys    = block->nextPhys;
+    if (block->nextPhys)
+    {
+        block->nextPhys->prevPhys = rest;
+    }
+    block->nextPhys = rest;
+    block->size     = size;
+
+    // Free the leftover block normally, so it merges with a free block after it
+    modelFree(rest);
+}
+
+/**
+ * @brief Allocate a block from the modeled heap. Regions are searched in the same order as ESP-IDF's
+ * heap_caps_malloc(), and within a region the smallest free block that TLSF would consider is used
+ *
+ * @param size The number of bytes to allocate
+ * @param caps The capabilities of the allocation
+ * @return The allocated block, or NULL if no region has a block big enough
+ */
+static heapBlock_t* modelAlloc(size_t size, uint32_t caps)
+{
+    uint32_t blockSize  = tlsfAdjustSize(size);
+    uint32_t searchSize = tlsfSearchSize(blockSize);
+
+    for (int prio = 0; prio < NUM_CAP_PRIOS; prio++)
+    {
+        for (uint8_t r = 0; r < NUM_REGIONS; r++)
+        {
+            heapRegion_t* region = &regions[r];
+            if (0 == (region->caps[prio] & caps) || !regionHasCaps(region, caps))
+            {
+                continue;
+            }
+
+            // Free blocks are searched most recently freed first, like TLSF's free lists
+            heapBlock_t* best = NULL;
+            for (heapBlock_t* block = region->freeList; NULL != block; block = block->nextFree)
+            {
+                if (block->size >= searchSize && (NULL == best || block->size < best->size))
+                {
+                    best = block;
+                }
+            }
+
+            if (best)
+            {
+                removeFreeBlock(region, best);
+                region->freeBytes -= best->size;
+                trimBlock(region, best, blockSize);
+                region->minFreeBytes = MIN(region->minFreeBytes, region->freeBytes);
+                return best;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Resize a block in the modeled heap. Like TLSF, the block is resized in place if it is shrinking or the block
+ * after it is free and big enough. Otherwise a new block is allocated and the old one is freed
+ *
+ * @param block The block to resize
+ * @param size The new number of bytes
+ * @param caps The capabilities of the allocation
+ * @return The resized block, or NULL if there wasn't room, in which case the old block is unchanged
+ */
+static heapBlock_t* modelRealloc(heapBlock_t* block, size_t size, uint32_t caps)
+{
+    heapRegion_t* region = &regions[block->region];
+    uint32_t blockSize   = tlsfAdjustSize(size);
+
+    heapBlock_t* next = block->nextPhys;
+    if (block->size < blockSize && next && next->free
+        && (uint64_t)block->size + TLSF_OVERHEAD + next->size >= blockSize)
+    {
+        // Absorb the next block, then give back what isn't needed
+        removeFreeBlock(region, next);
+        region->freeBytes -= next->size;
+        block->size += TLSF_OVERHEAD + next->size;
+        block->nextPhys = next->nextPhys;
+        if (next->nextPhys)
+        {
+            next->nextPhys->prevPhys = block;
+        }
+        free(next);
+    }
+
+    if (block->size >= blockSize)
+    {
+        trimBlock(region, block, blockSize);
+        region->minFreeBytes = MIN(region->minFreeBytes, region->freeBytes);
+        return block;
+    }
+
+    heapBlock_t* moved = modelAlloc(size, caps);
+    if (moved)
+    {
+        modelFree(block);
+    }
+    return moved;
+}
+
+/**
+ * @brief Free a block in the modeled heap, merging it with free blocks next to it
+ *
+ * @param block The block to free
+ */
+static void modelFree(heapBlock_t* block)
+{
+    heapRegion_t* region = &regions[block->region];
+    region->freeBytes += block->size;
+
+    heapBlock_t* next = block->nextPhys;
+    if (next && next->free)
+    {
+        removeFreeBlock(region, next);
+        block->size += TLSF_OVERHEAD + next->size;
+        block->nextPhys = next->nextPhys;
+        if (next->nextPhys)
+        {
+            next->nextPhys->prevPhys = block;
+        }
+        region->freeBytes += TLSF_OVERHEAD;
+        free(next);
+    }
+
+    heapBlock_t* prev = block->prevPhys;
+    if (prev && prev->free)
+    {
+        removeFreeBlock(region, prev);
+        prev->size += TLSF_OVERHEAD + block->size;
+        prev->nextPhys = block->nextPhys;
+        if (block->nextPhys)
+        {
+            block->nextPhys->prevPhys = prev;
+        }
+        region->freeBytes += TLSF_OVERHEAD;
+        free(block);
+        block = prev;
+    }
+
+    insertFreeBlock(region, block);
+}
+
+/**
+ * @brief Get the largest block which could be allocated with the given capabilities
+ *
+ * @param caps The capabilities to check
+ * @return The largest allocatable size, in bytes
+ */
+static size_t largestFreeBlock(uint32_t caps)
+{
+    size_t largest = 0;
+    for (uint8_t r = 0; r < NUM_REGIONS; r++)
+    {
+        if (!regionHasCaps(&regions[r], caps))
+        {
+            continue;
+        }
+
+        if (modelInitialized)
+        {
+            for (heapBlock_t* block = regions[r].freeList; NULL != block; block = block->nextFree)
+            {
+                largest = MAX(largest, block->size);
+            }
+        }
+        else
+        {
+            // Without the model, the best guess is that a region's free space is all in one block
+            size_t used = usedMemory[regions[r].type];
+            largest     = MAX(largest, (used < regions[r].size) ? regions[r].size - used : 0);
+        }
+    }
+    return largest;
+}
+
+/**
+ * @brief Lock the tracking tables
+ */
+static void lockHeap(void)
+{
+    while (atomic_flag_test_and_set_explicit(&heapLock, memory_order_acquire))
+    {
+        // Another thread is allocating
+    }
+}
+
+/**
+ * @brief Unlock the tracking tables
+ */
+static void unlockHeap(void)
+{
+    atomic_flag_clear_explicit(&heapLock, memory_order_release);
+}
+
+/**
+ * @brief Hash a pointer into a table index. Allocations are at least 8-byte aligned, so the low bits are dropped
+ *
+ * @param ptr The pointer to hash
+ * @return A hash which must be masked to the table size
+ */
+static uint32_t hashPtr(const void* ptr)
+{
+    uint64_t h = (uint64_t)(uintptr_t)ptr >> 3;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(h >> 32);
+}
+
+/**
+ * @brief Find a live allocation
+ *
+ * @param ptr The allocated pointer
+ * @return The allocation, or NULL if the pointer isn't tracked
+ */
+static allocation_t* findAllocation(const void* ptr)
+{
+    if (0 == aTableSize)
+    {
+        return NULL;
+    }
+
+    uint32_t mask = aTableSize - 1;
+    for (uint32_t idx = hashPtr(ptr) & mask; NULL != aTable[idx].ptr; idx = (idx + 1) & mask)
+    {
+        if (ptr == aTable[idx].ptr)
+        {
+            return &aTable[idx];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Add an allocation to the table, growing it if it's half full
+ *
+ * @param ptr The allocated pointer
+ * @return The new entry, with only ptr set
+ */
+static allocation_t* insertAllocation(void* ptr)
+{
+    if ((aTableEntries + 1) * 2 > aTableSize)
+    {
+        growAllocTable();
+    }
+
+    uint32_t mask = aTableSize - 1;
+    uint32_t idx  = hashPtr(ptr) & mask;
+    while (NULL != aTable[idx].ptr)
+    {
+        idx = (idx + 1) & mask;
+    }
+
+    memset(&aTable[idx], 0, sizeof(allocation_t));
+    aTable[idx].ptr = ptr;
+    aTableEntries++;
+    return &aTable[idx];
+}
+
+/**
+ * @brief Remove an allocation from the table. Later entries in the same run are shifted back so lookups never need
+ * to skip over deleted slots
+ *
+ * @param al The entry to remove
+ */
+static void removeAllocation(allocation_t* al)
+{
+    uint32_t mask = aTableSize - 1;
+    uint32_t hole = al - aTable;
+    uint32_t idx  = hole;
+    while (true)
+    {
+        idx = (idx + 1) & mask;
+        if (NULL == aTable[idx].ptr)
+        {
+            break;
+        }
+
+        // An entry can fill the hole if the hole is between its home slot and where it is now
+        uint32_t home = hashPtr(aTable[idx].ptr) & mask;
+        if (((idx - home) & mask) >= ((idx - hole) & mask))
+        {
+            aTable[hole] = aTable[idx];
+            hole         = idx;
+        }
+    }
+
+    memset(&aTable[hole], 0, sizeof(allocation_t));
+    aTableEntries--;
+}
+
+/**
+ * @brief Double the size of the allocation table and rehash everything into it
+ */
+static void growAllocTable(void)
+{
+    allocation_t* oldTable = aTable;
+    uint32_t oldSize       = aTableSize;
+
+    aTableSize    = oldSize ? oldSize * 2 : A_TABLE_MIN_SIZE;
+    aTable        = calloc(aTableSize, sizeof(allocation_t));
+    aTableEntries = 0;
+    if (NULL == aTable)
+    {
+        fprintf(stderr, "!! Allocation table out of space\n");
+        exit(-1);
+    }
+
+    for (uint32_t i = 0; i < oldSize; i++)
+    {
+        if (oldTable[i].ptr)
+        {
+            allocation_t* al = insertAllocation(oldTable[i].ptr);
+            *al              = oldTable[i];
+        }
+    }
+    free(oldTable);
+}
+
+/**
+ * @brief Hash a call site's key
+ *
+ * @param file The file the allocation was made from. Only the pointer is hashed, since it's a string literal
+ * @param line The line the allocation was made from
+ * @param type The type of memory allocated
+ * @param tag The allocation's tag
+ * @return A hash which must be masked to the index size
+ */
+static uint32_t hashSite(const char* file, uint32_t line, memType_t type, const char* tag)
+{
+    uint32_t h = hashPtr(file) ^ (line * 0x85EBCA6BU) ^ (uint32_t)type;
+    for (const char* c = tag; *c; c++)
+    {
+        h = (h ^ (uint8_t)*c) * 0x01000193U;
+    }
+    return h;
+}
+
+/**
+ * @brief Add a call site to the index
+ *
+ * @param i The site's index in sites
+ */
+static void indexSite(uint32_t i)
+{
+    uint32_t mask = siteIndexSize - 1;
+    uint32_t idx  = hashSite(sites[i].file, sites[i].line, sites[i].type, sites[i].tag) & mask;
+    while (siteIndex[idx])
+    {
+        idx = (idx + 1) & mask;
+    }
+    siteIndex[idx] = i + 1;
+}
+
+/**
+ * @brief Find the call site for an allocation, adding it if this is the first allocation from there
+ *
+ * @param file The file the allocation was made from
+ * @param func The function the allocation was made from
+ * @param line The line the allocation was made from
+ * @param tag A tag for the allocation, or NULL to use the function and line
+ * @param type The type of memory allocated
+ * @return The index of the call site in sites
+ */
+static uint32_t findSite(const char* file, const char* func, uint32_t line, const char* tag, memType_t type)
+{
+    char tagBuf[sizeof(sites[0].tag)];
+    if (tag)
+    {
+        snprintf(tagBuf, sizeof(tagBuf) - 1, "%s", tag);
+    }
+    else
+    {
+        snprintf(tagBuf, sizeof(tagBuf) - 1, "%s:%" PRIu32, func, line);
+    }
+
+    if (siteIndexSize)
+    {
+        uint32_t mask = siteIndexSize - 1;
+        for (uint32_t idx = hashSite(file, line, type, tagBuf) & mask; siteIndex[idx]; idx = (idx + 1) & mask)
+        {
+            allocSite_t* site = &sites[siteIndex[idx] - 1];
+            if (site->file == file && site->line == line && site->type == type && !strcmp(site->tag, tagBuf))
+            {
+                return siteIndex[idx] - 1;
+            }
+        }
+    }
+
+    // Add a new site
+    if (numSites == sitesAllocated)
+    {
+        sitesAllocated = sitesAllocated ? sitesAllocated * 2 : SITE_INDEX_MIN_SIZE / 2;
+        sites          = realloc(sites, sitesAllocated * sizeof(allocSite_t));
+        if (NULL == sites)
+        {
+            fprintf(stderr, "!! Allocation table out of space\n");
+            exit(-1);
+        }
+    }
+    allocSite_t* site = &sites[numSites];
+    memset(site, 0, sizeof(allocSite_t));
+    site->file = file;
+    site->func = func;
+    site->line = line;
+    site->type = type;
+    memcpy(site->tag, tagBuf, sizeof(site->tag));
+    numSites++;
+
+    // Keep the index at most half full, rebuilding it when it grows
+    if (numSites * 2 > siteIndexSize)
+    {
+        free(siteIndex);
+        siteIndexSize = siteIndexSize ? siteIndexSize * 2 : SITE_INDEX_MIN_SIZE;
+        siteIndex     = calloc(siteIndexSize, sizeof(uint32_t));
+        if (NULL == siteIndex)
+        {
+            fprintf(stderr, "!! Allocation table out of space\n");
+            exit(-1);
+        }
+
+        for (uint32_t i = 0; i < numSites; i++)
+        {
+            indexSite(i);
+        }
+    }
+    else
+    {
+        indexSite(numSites - 1);
+    }
+
+    return numSites - 1;
+}
+
+/**
+ * @brief qsort() comparator for site indices, most leaked bytes first
+ */
+static int compareSitesByLeak(const void* a, const void* b)
+{
+    size_t aBytes = sites[*(const uint32_t*)a].leakBytes;
+    size_t bBytes = sites[*(const uint32_t*)b].leakBytes;
+    return (aBytes < bBytes) - (aBytes > bBytes);
+}
+
+/**
+ * @brief qsort() comparator for site indices, most live bytes first
+ */
+static int compareSitesByLive(const void* a, const void* b)
+{
+    size_t aBytes = sites[*(const uint32_t*)a].liveBytes;
+    size_t bBytes = sites[*(const uint32_t*)b].liveBytes;
+    return (aBytes < bBytes) - (aBytes > bBytes);
+}
+
+/**
+ * @brief Allocate a chunk of memory which has the given capabilities
+ *
+ * Equivalent semantics to libc malloc(), for capability-aware memory.
+ *
+ * In IDF, ``malloc(p)`` is equivalent to ``heap_caps_malloc(p, MALLOC_CAP_8BIT)``.
+ *
+ * @param size Size, in bytes, of the amount of memory to allocate
+ * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
+ *                    of memory to be returned
+ *
+ * @return A pointer to the memory allocated on success, NULL on failure
+ */
+void* heap_caps_malloc_dbg(size_t size, uint32_t caps, const char* file, const char* func, int32_t line,
+                           const char* tag)
+{
+#ifdef MEMORY_DEBUG
+    heapBlock_t* block = NULL;
+    if (!reserveMemory(NULL, size, caps, &block, file, line))
+    {
+        return NULL;
+    }
+    void* ptr = malloc(size);
+    saveAllocation(OP_MALLOC, ptr, NULL, size, caps, block, file, func, line, tag);
+    return ptr;
+#else
+    return malloc(size);
+#endif
+}
+
+/**
+ * @brief Allocate a chunk of memory which has the given capabilities. The initialized value in the memory is set to
+ * zero.
+ *
+ * Equivalent semantics to libc calloc(), for capability-aware memory.
+ *
+ * In IDF, ``calloc(p)`` is equivalent to ``heap_caps_calloc(p, MALLOC_CAP_8BIT)``.
+ *
+ * @param n    Number of continuing chunks of memory to allocate
+ * @param size Size, in bytes, of a chunk of memory to allocate
+ * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
+ *                    of memory to be returned
+ *
+ * @return A pointer to the memory allocated on success, NULL on failure
+ */
+void* heap_caps_calloc_dbg(size_t n, size_t size, uint32_t caps, const char* file, const char* func, int32_t line,
+                           const char* tag)
+{
+#ifdef MEMORY_DEBUG
+    heapBlock_t* block = NULL;
+    if ((0 != n && size > SIZE_MAX / n) || !reserveMemory(NULL, n * size, caps, &block, file, line))
+    {
+        return NULL;
+    }
+    void* ptr = calloc(n, size);
+    saveAllocation(OP_CALLOC, ptr, NULL, n * size, caps, block, file, func, line, tag);
+    return ptr;
+#else
+    return calloc(n, size);
+#endif
+}
+
+/**
+ * @brief Reallocate memory previously allocated via heap_caps_malloc() or heap_caps_realloc()
+ *
+ * @param ptr Pointer to previously allocated memory, or NULL for a new allocation
+ * @param size Size of the new buffer requested, or 0 to free the buffer
+ * @param caps Bitwise OR of MALLOC_CAP_* flags indicating the type of memory desired for the new allocation
+ * @param file The file this was called from
+ * @param func The function this was called from
+ * @param line The line this was called from
+ * @param tag A tag for the allocation, or NULL to use the function and line
+ * @return Pointer to a new buffer of size 'size' with capabilities 'caps', or NULL if allocation failed
+ */
+void* heap_caps_realloc_dbg(void* ptr, size_t size, uint32_t caps, const char* file, const char* func, int32_t line,
+                            const char* tag)
+{
+#ifdef MEMORY_DEBUG
+    if (0 == size && NULL != ptr)
+    {
+        // Reallocating to zero bytes frees the memory
+        heap_caps_free_dbg(ptr, file, func, line, tag);
+        return NULL;
+    }
+
+    heapBlock_t* block = NULL;
+    if (!reserveMemory(ptr, size, caps, &block, file, line))
+    {
+        // The old memory is untouched
+        return NULL;
+    }
+
+    // The old pointer is only used to find its allocation, never dereferenced, so keep it as an integer
+    uintptr_t oldPtr = (uintptr_t)ptr;
+    void* newPtr     = NULL;
+    size_t oldSize   = 0;
+    if (pinnedSize(ptr, &oldSize))
+    {
+        // A snapshot needs the old memory to stay where it is, so the allocation always moves
+        newPtr = malloc(size);
+        if (NULL != newPtr)
+        {
+            memcpy(newPtr, ptr, MIN(oldSize, size));
+        }
+    }
+    else
+    {
+        newPtr = realloc(ptr, size);
+    }
+
+    if (NULL != newPtr)
+    {
+        saveAllocation(OP_REALLOC, newPtr, (void*)oldPtr, size, caps, block, file, func, line, tag);
+    }
+    return newPtr;
+#else
+    return realloc(ptr, size);
+#endif
+}
+
+/**
+ * @brief Free memory previously allocated via heap_caps_malloc(), heap_caps_calloc(), or heap_caps_realloc()
+ *
+ * @param ptr Pointer to the memory to free, or NULL to do nothing
+ * @param file The file this was called from
+ * @param func The function this was called from
+ * @param line The line this was called from
+ * @param tag Unused
+ */
+void heap_caps_free_dbg(void* ptr, const char* file, const char* func, int32_t line, const char* tag)
+{
+#ifdef MEMORY_DEBUG
+    if (NULL != ptr)
+    {
+        saveAllocation(OP_FREE, ptr, NULL, 0, 0, NULL, file, func, line, tag);
+
+        // A snapshot may restore this allocation, so the memory has to stay where it is until then
+        lockHeap();
+        bool pinned = isPinned(ptr);
+        unlockHeap();
+        if (pinned)
+        {
+            return;
+        }
+    }
+#endif
+    free(ptr);
+}
+
+/**
+ * @brief qsort() comparator for saved allocations, lowest pointer first
+ */
+static int compareSavedPtrs(const void* a, const void* b)
+{
+    uintptr_t aPtr = (uintptr_t)((const savedAllocation_t*)a)->ptr;
+    uintptr_t bPtr = (uintptr_t)((const savedAllocation_t*)b)->ptr;
+    return (aPtr > bPtr) - (aPtr < bPtr);
+}
+
+/**
+ * @brief Find an allocation in a heap snapshot
+ *
+ * @param snap The snapshot to search
+ * @param ptr The allocated pointer
+ * @return The saved allocation, or NULL if the snapshot doesn't have it
+ */
+static const savedAllocation_t* findSaved(const emuHeapSnapshot_t* snap, const void* ptr)
+{
+    uint32_t lo = 0;
+    uint32_t hi = snap->numAllocs;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if ((uintptr_t)snap->allocs[mid].ptr < (uintptr_t)ptr)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return (lo < snap->numAllocs && snap->allocs[lo].ptr == ptr) ? &snap->allocs[lo] : NULL;
+}
+
+/**
+ * @brief Check if any snapshot saved an allocation, so its memory can't be given back to the host. The heap must be
+ * locked
+ *
+ * @param ptr The allocated pointer
+ * @return true if a snapshot saved it
+ */
+static bool isPinned(const void* ptr)
+{
+    for (const emuHeapSnapshot_t* snap = snapshots; snap; snap = snap->next)
+    {
+        if (findSaved(snap, ptr))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Get the size of a live allocation which a snapshot saved
+ *
+ * @param ptr The allocated pointer, which may be NULL
+ * @param[out] size The allocation's size is written here, if it's saved in a snapshot
+ * @return true if a snapshot saved the allocation, false if it can be reallocated normally
+ */
+static bool pinnedSize(const void* ptr, size_t* size)
+{
+    if (NULL == ptr)
+    {
+        return false;
+    }
+
+    lockHeap();
+    bool pinned = isPinned(ptr);
+    if (pinned)
+    {
+        const allocation_t* al = findAllocation(ptr);
+        *size                  = al ? al->size : 0;
+    }
+    unlockHeap();
+    return pinned;
+}
+
+/**
+ * @brief Allocate a saved allocation's block in the modeled heap again, in the same place if it's free. If it isn't,
+ * the allocation goes wherever it fits
+ *
+ * @param saved The allocation to put back in the model
+ * @return The allocation's new block, or NULL if it wasn't modeled or doesn't fit
+ */
+static heapBlock_t* claimBlock(const savedAllocation_t* saved)
+{
+    if (UINT8_MAX == saved->region || !modelInitialized)
+    {
+        return NULL;
+    }
+
+    heapRegion_t* region = &regions[saved->region];
+    uint64_t savedEnd    = (uint64_t)saved->offset + TLSF_OVERHEAD + saved->blockSize;
+    for (heapBlock_t* block = region->freeList; NULL != block; block = block->nextFree)
+    {
+        if (block->offset > saved->offset || (uint64_t)block->offset + TLSF_OVERHEAD + block->size < savedEnd)
+        {
+            continue;
+        }
+
+        removeFreeBlock(region, block);
+        region->freeBytes -= block->size;
+        if (block->offset < saved->offset)
+        {
+            // The free space before the saved block was made of whole blocks, so it's big enough to stay free
+            heapBlock_t* claimed = calloc(1, sizeof(heapBlock_t));
+            claimed->offset      = saved->offset;
+            claimed->size        = block->offset + block->size - saved->offset;
+            claimed->region      = block->region;
+            claimed->prevPhys    = block;
+            claimed->nextPhys    = block->nextPhys;
+            if (block->nextPhys)
+            {
+                block->nextPhys->prevPhys = claimed;
+            }
+            block->nextPhys = claimed;
+            block->size     = saved->offset - block->offset - TLSF_OVERHEAD;
+            region->freeBytes += block->size;
+            insertFreeBlock(region, block);
+            block = claimed;
+        }
+        trimBlock(region, block, saved->blockSize);
+        region->minFreeBytes = MIN(region->minFreeBytes, region->freeBytes);
+        return block;
+    }
+
+    heapBlock_t* block = modelAlloc(saved->size, saved->caps);
+    if (NULL == block)
+    {
+        fprintf(stderr, "!! No room to restore %zu bytes from a snapshot in the modeled heap\n", saved->size);
+    }
+    return block;
 }
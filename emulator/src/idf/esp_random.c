@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <stdio.h>
@@ -11,10 +12,22 @@
 #include "ext_replay.h"
 #include "esp_timer.h"
 
+/// The generator is the same additive feedback generator as glibc's rand(), so seeds give the same numbers they did
+/// when this used rand(). Its state is kept here instead of in libc so it can be saved and restored
+#define RAND_TAP 3
+
+/// How many numbers are thrown away after seeding, like glibc's srand()
+#define RAND_DISCARD 310
+
 static bool seeded       = false;
 static bool seedValueSet = false;
 static unsigned int seed = 0;
 
+static emuRandomState_t randState;
+
+static void seedRandom(uint32_t seedVal);
+static uint32_t nextRandom(void);
+
 uint32_t esp_random(void)
 {
     if (!seeded)
@@ -27,23 +40,22 @@ uint32_t esp_random(void)
         }
 
         seeded = true;
-        srand(seed);
+        seedRandom(seed);
 
         printf("Random Seed: %" PRIu32 "\n", seed);
 
         emulatorRecordRandomSeed(seed);
     }
-    uint32_t val = rand();
-    return val;
+    return nextRandom();
 }
 
 void emulatorSetEspRandomSeed(uint32_t seed_)
 {
     seed = seed_;
 
-    if (seedValueSet)
+    if (seedValueSet || seeded)
     {
-        srand(seed);
+        seedRandom(seed);
     }
 
     seedValueSet = true;
@@ -53,3 +65,81 @@ unsigned int emulatorGetEspRandomSeed(void)
 {
     return seed;
 }
+
+/**
+ * @brief Save the state of esp_random(), so the same numbers can be generated again with emulatorRestoreRandomState()
+ *
+ * @param[out] state The state is written here
+ */
+void emulatorSaveRandomState(emuRandomState_t* state)
+{
+    if (!seeded)
+    {
+        // Seed now, so restoring this doesn't depend on when the seed would have been picked
+        esp_random();
+        seedRandom(seed);
+    }
+    memcpy(state, &randState, sizeof(emuRandomState_t));
+}
+
+/**
+ * @brief Put esp_random() back the way it was when its state was saved
+ *
+ * @param state The saved state
+ */
+void emulatorRestoreRandomState(const emuRandomState_t* state)
+{
+    memcpy(&randState, state, sizeof(emuRandomState_t));
+    seeded = true;
+}
+
+/**
+ * @brief Seed the generator the way glibc's srand() does
+ *
+ * @param seedVal The seed
+ */
+static void seedRandom(uint32_t seedVal)
+{
+    int32_t* r = randState.table;
+    r[0]       = seedVal ? (int32_t)seedVal : 1;
+    for (int i = 1; i < EMU_RAND_DEGREE; i++)
+    {
+        // r[i] = (16807 * r[i - 1]) % 2147483647, without overflowing
+        int32_t hi   = r[i - 1] / 127773;
+        int32_t lo   = r[i - 1] % 127773;
+        int32_t word = 16807 * lo - 2836 * hi;
+        if (word < 0)
+        {
+            word += 2147483647;
+        }
+        r[i] = word;
+    }
+
+    randState.front = RAND_TAP;
+    randState.rear  = 0;
+    for (int i = 0; i < RAND_DISCARD; i++)
+    {
+        nextRandom();
+    }
+}
+
+/**
+ * @brief Get the next number from the generator, the way glibc's rand() does
+ *
+ * @return A number from 0 to 2^31 - 1
+ */
+static uint32_t nextRandom(void)
+{
+    uint32_t* r  = (uint32_t*)randState.table;
+    uint32_t val = (r[randState.front] += r[randState.rear]);
+
+    if (++randState.front >= EMU_RAND_DEGREE)
+    {
+        randState.front = 0;
+    }
+    if (++randState.rear >= EMU_RAND_DEGREE)
+    {
+        randState.rear = 0;
+    }
+    return val >> 1;
+}
@@ -1,6 +1,8 @@
 #include <unistd.h>
 #include "esp_sleep.h"
 #include "esp_sleep_emu.h"
+#include "esp_timer_emu.h"
+#include "esp_heap_caps.h"
 #include "swadge2024.h"
 
 static uint64_t timeToLightSleep = 0;
@@ -20,7 +22,11 @@ esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
 
 esp_err_t esp_light_sleep_start(void)
 {
-    usleep(timeToLightSleep);
+    // Sleeping doesn't move fake time, so there is no point to it
+    if (emuGetUseRealTime())
+    {
+        usleep(timeToLightSleep);
+    }
     return ESP_OK;
 }
 
@@ -37,7 +43,10 @@ void esp_deep_sleep_start(void)
 
         // On the emulator, this will switch the Swadge mode without rebooting
         // On an actual Swadge, this function will reboot the system and the new Swadge mode will be used after reboot
+        // Anything the old mode allocated and didn't free by the time the new mode is running is reported as a leak
+        heapCapsModeExiting(getSwadgeMode()->modeName);
         softSwitchToPendingSwadge();
+        heapCapsModeExited();
         return;
     }
 }
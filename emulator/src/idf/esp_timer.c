@@ -3,6 +3,7 @@
 //==============================================================================
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -13,11 +14,36 @@
 #include "esp_timer_emu.h"
 #include "esp_heap_caps.h"
 
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static bool timerIsRunning(esp_timer_handle_t timer);
+static bool timerBefore(esp_timer_handle_t a, esp_timer_handle_t b);
+static void timerHeapSet(uint32_t idx, esp_timer_handle_t timer);
+static void timerHeapSiftUp(uint32_t idx);
+static void timerHeapSiftDown(uint32_t idx);
+static void timerHeapInsert(esp_timer_handle_t timer, uint64_t alarm);
+static void timerHeapRemove(esp_timer_handle_t timer);
+
 //==============================================================================
 // Variables
 //==============================================================================
 
-static list_t* timerList                 = NULL;
+/// Every created timer, so they can be freed
+static list_t* timerList = NULL;
+
+/// Running timers, as a binary min-heap where the next timer to expire is always first
+static esp_timer_handle_t* timerHeap = NULL;
+static uint32_t timerHeapLen         = 0;
+static uint32_t timerHeapCap         = 0;
+
+/// The time which timer alarms are measured against, advanced by check_esp_timer()
+static uint64_t timerNowUs = 0;
+
+/// Counts timer starts, to order timers with the same alarm
+static uint64_t timerSeq = 0;
+
 static unsigned long boot_time_in_micros = 0;
 static unsigned long pause_start_micros  = 0;
 static unsigned long total_pause_micros  = 0;
@@ -66,11 +92,17 @@ esp_err_t esp_timer_deinit(void)
         void* val;
         while (NULL != (val = shift(timerList)))
         {
-            free(val);
+            heap_caps_free(val);
         }
 
         clear(timerList);
         free(timerList);
+        timerList = NULL;
+
+        free(timerHeap);
+        timerHeap    = NULL;
+        timerHeapLen = 0;
+        timerHeapCap = 0;
         return ESP_OK;
     }
     return ESP_ERR_INVALID_STATE;
@@ -129,6 +161,11 @@ esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer
         // Allocate memory for a timer
         (*out_handle) = (esp_timer_handle_t)heap_caps_calloc(1, sizeof(struct esp_timer), MALLOC_CAP_8BIT);
     }
+    else
+    {
+        // Reusing a timer's memory, so make sure it isn't still in the heap
+        timerHeapRemove(*out_handle);
+    }
 
     // Initialize the timer
     (*out_handle)->callback = create_args->callback;
@@ -170,6 +207,8 @@ esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer
  */
 esp_err_t esp_timer_delete(const esp_timer_handle_t timer)
 {
+    timerHeapRemove(timer);
+
     for (node_t* node = timerList->first; NULL != node; node = node->next)
     {
         if (node->val == timer)
@@ -196,6 +235,7 @@ esp_err_t esp_timer_delete(const esp_timer_handle_t timer)
  */
 esp_err_t esp_timer_stop(esp_timer_handle_t timer)
 {
+    timerHeapRemove(timer);
     timer->alarm  = 0;
     timer->period = 0;
     return ESP_OK;
@@ -215,8 +255,8 @@ esp_err_t esp_timer_stop(esp_timer_handle_t timer)
  */
 esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
 {
-    timer->alarm  = timeout_us;
     timer->period = 0;
+    timerHeapInsert(timer, timerNowUs + timeout_us);
     return ESP_OK;
 }
 
@@ -235,54 +275,94 @@ esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
  */
 esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
 {
-    timer->alarm  = period;
+    if (0 == period)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
     timer->period = period;
+    timerHeapInsert(timer, timerNowUs + period);
     return ESP_OK;
 }
 
 /**
- * @brief Check running timers and call any that expire
+ * @brief Get the timestamp when the next timeout is expected to occur
  *
- * @param elapsed_us The elapsed time in microseconds since this was last called
+ * @return Timestamp of the nearest timer event, in microseconds, or INT64_MAX if no timer is running
  */
-void check_esp_timer(uint64_t elapsed_us)
+int64_t esp_timer_get_next_alarm(void)
 {
-    if (0 == timerList->length)
+    if (0 == timerHeapLen)
     {
-        // Nothing linked, so return
-        return;
+        return INT64_MAX;
     }
 
-    for (node_t* node = timerList->first; NULL != node; node = node->next)
+    // Alarms are measured against the timer clock, which may lag a little behind esp_timer_get_time()
+    return esp_timer_get_time() + (int64_t)(timerHeap[0]->alarm - timerNowUs);
+}
+
+/**
+ * @brief Get the period of a timer
+ *
+ * @param timer timer handle allocated using esp_timer_create
+ * @param period memory to store the timer period value in microseconds
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if the arguments are invalid
+ */
+esp_err_t esp_timer_get_period(esp_timer_handle_t timer, uint64_t* period)
+{
+    if (NULL == timer || NULL == period)
     {
-        bool timerExpired      = false;
-        esp_timer_handle_t tmr = node->val;
-        if (tmr->alarm > elapsed_us)
-        {
-            tmr->alarm -= elapsed_us;
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *period = timer->period;
+    return ESP_OK;
+}
+
+/**
+ * @brief Returns status of a timer, active or not
+ *
+ * @param timer timer handle created using esp_timer_create
+ * @return true if the timer is running, false if it is not
+ */
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    return timerIsRunning(timer);
+}
 
-            if (0 == tmr->alarm)
+/**
+ * @brief Check running timers and call any that expire, in the order they expire. A periodic timer fires once for each
+ * period which elapsed, unless it was created with skip_unhandled_events
+ *
+ * @param elapsed_us The elapsed time in microseconds since this was last called
+ */
+void check_esp_timer(uint64_t elapsed_us)
+{
+    timerNowUs += elapsed_us;
+
+    while (timerHeapLen && timerHeap[0]->alarm <= timerNowUs)
+    {
+        esp_timer_handle_t tmr = timerHeap[0];
+        esp_timer_cb_t cb      = tmr->callback;
+        void* arg              = tmr->arg;
+
+        // Re-arm or stop the timer before calling the callback, which may restart, stop, or delete it
+        if (tmr->period)
+        {
+            uint64_t alarm = tmr->alarm + tmr->period;
+            if ((tmr->flags & FL_SKIP_UNHANDLED_EVENTS) && alarm <= timerNowUs)
             {
-                // If it decrements to 0 exactly, expire
-                timerExpired = true;
+                alarm = timerNowUs + tmr->period;
             }
+            timerHeapInsert(tmr, alarm);
         }
-        else if (tmr->alarm)
+        else
         {
-            // If there's less time on left than elapsed, expire
-            timerExpired = true;
+            timerHeapRemove(tmr);
+            tmr->alarm = 0;
         }
 
-        if (timerExpired)
-        {
-            // Call the callback
-            tmr->callback(tmr->arg);
-            // Reset the timer if periodic
-            if (tmr->period)
-            {
-                tmr->alarm = tmr->period;
-            }
-        }
+        cb(arg);
     }
 }
 
@@ -291,6 +371,16 @@ void emuSetUseRealTime(bool val)
     useRealTime = val;
 }
 
+/**
+ * @brief Check if the emulator's timer follows the real clock
+ *
+ * @return true if time is real, false if it is fake and only moves when set
+ */
+bool emuGetUseRealTime(void)
+{
+    return useRealTime;
+}
+
 void emuSetEspTimerTime(int64_t time)
 {
     fakeTime = time;
@@ -335,6 +425,196 @@ bool emuTimerIsPaused(void)
     return (pause_start_micros > 0);
 }
 
+/**
+ * @brief Save which timers exist and when each running timer will expire. The timers themselves are on the Swadge's
+ * heap, so they're saved and restored with it
+ *
+ * @return The saved timer state, which must be freed with emuTimerFreeState()
+ */
+emuTimerState_t* emuTimerSaveState(void)
+{
+    emuTimerState_t* state = calloc(1, sizeof(emuTimerState_t));
+    state->list            = *timerList;
+    state->heapLen         = timerHeapLen;
+    state->heap            = malloc(sizeof(esp_timer_handle_t) * (timerHeapLen ? timerHeapLen : 1));
+    memcpy(state->heap, timerHeap, sizeof(esp_timer_handle_t) * timerHeapLen);
+    state->nowUs = timerNowUs;
+    state->seq   = timerSeq;
+    return state;
+}
+
+/**
+ * @brief Put the timers back the way they were when their state was saved. The Swadge's heap must be restored first,
+ * since that's where the timers are. Time itself doesn't go back, but running timers expire as far in the future as
+ * they would have then
+ *
+ * @param state The saved timer state, which is still valid afterwards
+ */
+void emuTimerRestoreState(const emuTimerState_t* state)
+{
+    *timerList = state->list;
+    if (state->heapLen > timerHeapCap)
+    {
+        timerHeapCap = state->heapLen;
+        timerHeap    = realloc(timerHeap, sizeof(esp_timer_handle_t) * timerHeapCap);
+    }
+    memcpy(timerHeap, state->heap, sizeof(esp_timer_handle_t) * state->heapLen);
+    timerHeapLen = state->heapLen;
+    timerNowUs   = state->nowUs;
+    timerSeq     = state->seq;
+}
+
+/**
+ * @brief Free saved timer state
+ *
+ * @param state The saved timer state, or NULL to do nothing
+ */
+void emuTimerFreeState(emuTimerState_t* state)
+{
+    if (state)
+    {
+        free(state->heap);
+        free(state);
+    }
+}
+
+/**
+ * @brief Check if a timer is in the heap of running timers
+ *
+ * @param timer The timer to check
+ * @return true if the timer is running, false if it is not
+ */
+static bool timerIsRunning(esp_timer_handle_t timer)
+{
+    return timer->heapIdx < timerHeapLen && timerHeap[timer->heapIdx] == timer;
+}
+
+/**
+ * @brief Compare two timers by when they expire. Timers with the same alarm expire in the order they were started
+ *
+ * @param a A timer
+ * @param b Another timer
+ * @return true if a expires before b, false if it doesn't
+ */
+static bool timerBefore(esp_timer_handle_t a, esp_timer_handle_t b)
+{
+    if (a->alarm != b->alarm)
+    {
+        return a->alarm < b->alarm;
+    }
+    return a->seq < b->seq;
+}
+
+/**
+ * @brief Put a timer in a slot of the heap, and remember where it is
+ *
+ * @param idx The slot to put the timer in
+ * @param timer The timer
+ */
+static void timerHeapSet(uint32_t idx, esp_timer_handle_t timer)
+{
+    timerHeap[idx] = timer;
+    timer->heapIdx = idx;
+}
+
+/**
+ * @brief Move a timer toward the top of the heap until its parent expires before it
+ *
+ * @param idx The timer's index in the heap
+ */
+static void timerHeapSiftUp(uint32_t idx)
+{
+    esp_timer_handle_t timer = timerHeap[idx];
+    while (idx > 0)
+    {
+        uint32_t parent = (idx - 1) / 2;
+        if (!timerBefore(timer, timerHeap[parent]))
+        {
+            break;
+        }
+        timerHeapSet(idx, timerHeap[parent]);
+        idx = parent;
+    }
+    timerHeapSet(idx, timer);
+}
+
+/**
+ * @brief Move a timer toward the bottom of the heap until it expires before both of its children
+ *
+ * @param idx The timer's index in the heap
+ */
+static void timerHeapSiftDown(uint32_t idx)
+{
+    esp_timer_handle_t timer = timerHeap[idx];
+    while (true)
+    {
+        uint32_t child = idx * 2 + 1;
+        if (child >= timerHeapLen)
+        {
+            break;
+        }
+        if (child + 1 < timerHeapLen && timerBefore(timerHeap[child + 1], timerHeap[child]))
+        {
+            child++;
+        }
+        if (!timerBefore(timerHeap[child], timer))
+        {
+            break;
+        }
+        timerHeapSet(idx, timerHeap[child]);
+        idx = child;
+    }
+    timerHeapSet(idx, timer);
+}
+
+/**
+ * @brief Start a timer, or move it if it's already running
+ *
+ * @param timer The timer to start
+ * @param alarm When the timer expires, measured against ::timerNowUs
+ */
+static void timerHeapInsert(esp_timer_handle_t timer, uint64_t alarm)
+{
+    timerHeapRemove(timer);
+
+    if (timerHeapLen == timerHeapCap)
+    {
+        // This is emulator bookkeeping, so it doesn't come out of the Swadge's heap
+        timerHeapCap = timerHeapCap ? timerHeapCap * 2 : 16;
+        timerHeap    = realloc(timerHeap, timerHeapCap * sizeof(esp_timer_handle_t));
+    }
+
+    timer->alarm = alarm;
+    timer->seq   = timerSeq++;
+    timerHeapSet(timerHeapLen++, timer);
+    timerHeapSiftUp(timer->heapIdx);
+}
+
+/**
+ * @brief Stop a timer if it's running
+ *
+ * @param timer The timer to stop
+ */
+static void timerHeapRemove(esp_timer_handle_t timer)
+{
+    if (!timerIsRunning(timer))
+    {
+        return;
+    }
+
+    // Fill the hole with the last timer, then move that one wherever it belongs
+    uint32_t idx = timer->heapIdx;
+    timerHeapLen--;
+    if (idx < timerHeapLen)
+    {
+        esp_timer_handle_t moved = timerHeap[timerHeapLen];
+        timerHeapSet(idx, moved);
+        timerHeapSiftUp(idx);
+        timerHeapSiftDown(moved->heapIdx);
+    }
+    timer->heapIdx = UINT32_MAX;
+}
+
 /**
  * @brief
  *
@@ -342,5 +622,9 @@ bool emuTimerIsPaused(void)
  */
 void vTaskDelay(const TickType_t xTicksToDelay)
 {
-    usleep(1000 * xTicksToDelay * portTICK_PERIOD_MS);
+    // Sleeping doesn't move fake time, so there is no point to it
+    if (useRealTime)
+    {
+        usleep(1000 * xTicksToDelay * portTICK_PERIOD_MS);
+    }
 }
@@ -22,15 +22,82 @@
 #include "midi_device_emu.h"
 
 #include "tinyusb.h"
+#include "emu_args.h"
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 // Un-comment to enable printing all received MIDI packets
 // #define DEBUG_MIDI_PACKETS
 
+/// The most messages latched from the host at once in deterministic mode. More than this wait for the next frame
+#define MIDI_LATCH_MSGS 64
+
+/// The longest message read from the host at once
+#define MIDI_MSG_LEN 12
+
+/// A message read from the host in deterministic mode, to be read by the Swadge later
+typedef struct
+{
+    int len;
+    uint8_t data[MIDI_MSG_LEN];
+} latchedMidiMsg_t;
+
 static uint8_t runningStatus                   = 0;
 static struct platform_midi_driver* midiDriver = NULL;
 
+/// In deterministic mode, messages are latched from the host once per frame so they never arrive mid-frame
+static latchedMidiMsg_t latchedMsgs[MIDI_LATCH_MSGS];
+static int latchedHead  = 0;
+static int latchedCount = 0;
+
+/**
+ * @brief Read one message from the host, or from the latched messages in deterministic mode
+ *
+ * @param buffer The buffer to read into
+ * @param bufsize The size of \c buffer
+ * @return The number of bytes read
+ */
+static int midiRead(unsigned char* buffer, int bufsize)
+{
+    if (!emulatorArgs.deterministic)
+    {
+        return midiDriver ? platform_midi_read(midiDriver, buffer, bufsize) : 0;
+    }
+
+    if (0 == latchedCount)
+    {
+        return 0;
+    }
+
+    const latchedMidiMsg_t* msg = &latchedMsgs[latchedHead];
+    int len                     = (msg->len < bufsize) ? msg->len : bufsize;
+    memcpy(buffer, msg->data, len);
+    latchedHead = (latchedHead + 1) % MIDI_LATCH_MSGS;
+    latchedCount--;
+    return len;
+}
+
+/**
+ * @brief Latch every message the host has received since the last frame. This is only used in deterministic mode,
+ * where it's called from the emulator's main loop between frames, so messages arrive at the same point in a frame no
+ * matter when the host's MIDI thread got them
+ */
+void midiLatchInput(void)
+{
+    while (emulatorArgs.deterministic && midiDriver && latchedCount < MIDI_LATCH_MSGS
+           && platform_midi_avail(midiDriver))
+    {
+        latchedMidiMsg_t* msg = &latchedMsgs[(latchedHead + latchedCount) % MIDI_LATCH_MSGS];
+        msg->len              = platform_midi_read(midiDriver, msg->data, sizeof(msg->data));
+        if (msg->len <= 0)
+        {
+            break;
+        }
+        latchedCount++;
+    }
+}
+
 // Check if midi interface is mounted
 bool tud_midi_n_mounted(uint8_t itf)
 {
@@ -40,13 +107,17 @@ bool tud_midi_n_mounted(uint8_t itf)
 // Get the number of bytes available for reading
 uint32_t tud_midi_n_available(uint8_t itf, uint8_t cable_num)
 {
+    if (emulatorArgs.deterministic)
+    {
+        return latchedCount ? latchedMsgs[latchedHead].len : 0;
+    }
     return midiDriver ? platform_midi_avail(midiDriver) : 0;
 }
 
 // Read byte stream              (legacy)
 uint32_t tud_midi_n_stream_read(uint8_t itf, uint8_t cable_num, void* buffer, uint32_t bufsize)
 {
-    return midiDriver ? platform_midi_read(midiDriver, (unsigned char*)buffer, bufsize) : 0;
+    return midiRead((unsigned char*)buffer, bufsize);
 }
 
 // Write byte Stream             (legacy)
@@ -65,8 +136,8 @@ uint32_t tud_midi_n_stream_write(uint8_t itf, uint8_t cable_num, uint8_t const*
 // Read event packet             (4 bytes)
 bool tud_midi_n_packet_read(uint8_t itf, uint8_t packet[4])
 {
-    uint8_t real_packet[12];
-    int read = midiDriver ? platform_midi_read(midiDriver, real_packet, sizeof(real_packet)) : 0;
+    uint8_t real_packet[MIDI_MSG_LEN];
+    int read = midiRead(real_packet, sizeof(real_packet));
     if (read > 0)
     {
 #ifdef DEBUG_MIDI_PACKETS
@@ -195,7 +266,9 @@ void midid_init(void)
 void midid_reset(uint8_t rhport)
 {
     platform_midi_deinit(midiDriver);
-    midiDriver = NULL;
+    midiDriver   = NULL;
+    latchedHead  = 0;
+    latchedCount = 0;
 }
 
 uint16_t midid_open(uint8_t rhport, tusb_desc_interface_t const* itf_desc, uint16_t max_len)
@@ -0,0 +1,205 @@
+/**
+ * @file test_ch32v003.c
+ * @brief Tests for the CH32V003 emulator's instruction predecoding. The emulator's source is included directly so its
+ * static state can be checked. Run with `make test`, which builds this with the sanitizers so stray writes abort
+ */
+
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <assert.h>
+#include <inttypes.h>
+
+#include "hdw-ch32v003.c"
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief A compressed instruction and the 32-bit instruction expandCompressed() should turn it into
+ */
+typedef struct
+{
+    uint16_t ci;       ///< The compressed instruction
+    uint32_t expanded; ///< The 32-bit instruction it should expand to
+    const char* text;  ///< The compressed instruction's assembly, for failure messages
+} rvcCase_t;
+
+//==============================================================================
+// Stubs
+//==============================================================================
+
+emuArgs_t emulatorArgs = {0};
+
+const uint8_t* cnfsGetFile(cnfsFileIdx_t fIdx, size_t* flen)
+{
+    *flen = 0;
+    return NULL;
+}
+
+uint32_t CNFGColor(uint32_t RGB)
+{
+    return RGB;
+}
+
+void CNFGTackRectangle(short x1, short y1, short x2, short y2)
+{
+}
+
+//==============================================================================
+// Variables
+//==============================================================================
+
+/**
+ * @brief Every compressed instruction the CH32V003 supports, with the edges of their immediates, and reserved
+ * encodings. Both columns were assembled with llvm-mc (-triple=riscv32 -mattr=+c), the expansions with .option norvc.
+ * Jump and branch offsets in the expansions are two bytes longer, see expandCompressed()
+ */
+static const rvcCase_t rvcCases[] = {
+    {0x0040, 0x00410413, "c.addi4spn s0, sp, 4"},
+    {0x1FFC, 0x3FC10793, "c.addi4spn a5, sp, 1020"},
+    {0x4104, 0x00052483, "c.lw s1, 0(a0)"},
+    {0x5C7C, 0x07C42783, "c.lw a5, 124(s0)"},
+    {0xC124, 0x04952023, "c.sw s1, 64(a0)"},
+    {0xDFE0, 0x0687AE23, "c.sw s0, 124(a5)"},
+    {0x0001, 0x00000013, "c.nop"},
+    {0x1281, 0xFE028293, "c.addi t0, -32"},
+    {0x0FFD, 0x01FF8F93, "c.addi t6, 31"},
+    {0x2FFD, 0x001000EF, "c.jal 2046"},
+    {0x3001, 0x803FF0EF, "c.jal -2048"},
+    {0xA9C9, 0x4D40006F, "c.j 1234"},
+    {0xBFFD, 0x0000006F, "c.j -2"},
+    {0x557D, 0xFFF00513, "c.li a0, -1"},
+    {0x40FD, 0x01F00093, "c.li ra, 31"},
+    {0x7101, 0xE0010113, "c.addi16sp sp, -512"},
+    {0x617D, 0x1F010113, "c.addi16sp sp, 496"},
+    {0x6285, 0x000012B7, "c.lui t0, 1"},
+    {0x7301, 0xFFFE0337, "c.lui t1, 0xfffe0"},
+    {0x63FD, 0x0001F3B7, "c.lui t2, 31"},
+    {0x807D, 0x01F45413, "c.srli s0, 31"},
+    {0x8785, 0x4017D793, "c.srai a5, 1"},
+    {0x9881, 0xFE04F493, "c.andi s1, -32"},
+    {0x88FD, 0x01F4F493, "c.andi s1, 31"},
+    {0x8C1D, 0x40F40433, "c.sub s0, a5"},
+    {0x8D2D, 0x00B54533, "c.xor a0, a1"},
+    {0x8E55, 0x00D66633, "c.or a2, a3"},
+    {0x8F65, 0x00977733, "c.and a4, s1"},
+    {0xD001, 0xF00401E3, "c.beqz s0, -256"},
+    {0xEFFD, 0x10079063, "c.bnez a5, 254"},
+    {0x00FE, 0x01F09093, "c.slli ra, 31"},
+    {0x50FE, 0x0FC12083, "c.lwsp ra, 252(sp)"},
+    {0x4F82, 0x00012F83, "c.lwsp t6, 0(sp)"},
+    {0x8082, 0x00008067, "c.jr ra"},
+    {0x829A, 0x006002B3, "c.mv t0, t1"},
+    {0x929A, 0x006282B3, "c.add t0, t1"},
+    {0x9382, 0x000380E7, "c.jalr t2"},
+    {0x9002, 0x00100073, "c.ebreak"},
+    {0xDFFE, 0x0FF12E23, "c.swsp t6, 252(sp)"},
+    {0xC002, 0x00012023, "c.swsp zero, 0(sp)"},
+    {0x0000, ILLEGAL_INSTRUCTION, "c.addi4spn with a zero immediate"},
+    {0x6101, ILLEGAL_INSTRUCTION, "c.addi16sp with a zero immediate"},
+    {0x6281, ILLEGAL_INSTRUCTION, "c.lui with a zero immediate"},
+    {0x4002, ILLEGAL_INSTRUCTION, "c.lwsp to zero"},
+    {0x8002, ILLEGAL_INSTRUCTION, "c.jr to zero"},
+    {0x9005, ILLEGAL_INSTRUCTION, "c.srli with shamt[5] set"},
+    {0x9405, ILLEGAL_INSTRUCTION, "c.srai with shamt[5] set"},
+    {0x1086, ILLEGAL_INSTRUCTION, "c.slli with shamt[5] set"},
+    {0x9C01, ILLEGAL_INSTRUCTION, "c.subw, which is RV64 only"},
+    {0x2000, ILLEGAL_INSTRUCTION, "c.fld, which needs the D extension"},
+    {0x8000, ILLEGAL_INSTRUCTION, "reserved quadrant 0 encoding"},
+};
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+/**
+ * @brief Each compressed instruction expands to the same 32-bit instruction an assembler gives for it
+ */
+static void testExpandCompressed(void)
+{
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(rvcCases) / sizeof(rvcCases[0]); i++)
+    {
+        uint32_t got = expandCompressed(rvcCases[i].ci);
+        if (got != rvcCases[i].expanded)
+        {
+            printf("%s (0x%04X) expanded to 0x%08" PRIX32 ", expected 0x%08" PRIX32 "\n", rvcCases[i].text,
+                   rvcCases[i].ci, got, rvcCases[i].expanded);
+            failures++;
+        }
+    }
+    fflush(stdout);
+    assert(0 == failures);
+}
+
+/**
+ * @brief A fetch decodes the rest of its basic block, mixing compressed and 32-bit instructions, and stops after a
+ * jump
+ */
+static void testDecodeBlock(void)
+{
+    // c.addi t0, -32; addi t0, t0, 1; c.j -2; c.nop
+    const uint8_t image[] = {0x81, 0x12, 0x93, 0x82, 0x12, 0x00, 0xFD, 0xBF, 0x01, 0x00};
+    assert(0 == ch32v003WriteFlash(image, sizeof(image)));
+    memset(decodedIr, 0, sizeof(decodedIr));
+
+    uint32_t trap = 0;
+    assert((0xFE028293 & ~1) == fetchDecoded(0, &trap));
+    assert(0 == trap);
+
+    // Compressed instructions are stored with bit 0 cleared, 32-bit ones as they are
+    assert(0x00128293 == decodedIr[1]);
+    assert((0x0000006F & ~1) == decodedIr[3]);
+
+    // The block ended at the jump, and the halfword inside the 32-bit instruction has no slot of its own
+    assert(0 == decodedIr[4]);
+    assert(0 == decodedIr[2]);
+}
+
+/**
+ * @brief Stores at the start of flash drop only the slots they overlap, and never the one before flash
+ */
+static void testStoreAtFlashStart(void)
+{
+    for (uint32_t ofs = 0; ofs < 2; ofs++)
+    {
+        decodedIr[0] = 1;
+        decodedIr[1] = 1;
+        noteStore(ofs, 1);
+        assert(0 == decodedIr[0]);
+        assert(1 == decodedIr[1]);
+    }
+
+    // A store after the first halfword also drops an instruction which started in the halfword before it
+    decodedIr[0] = 1;
+    decodedIr[1] = 1;
+    decodedIr[2] = 1;
+    noteStore(2, 2);
+    assert(0 == decodedIr[0]);
+    assert(0 == decodedIr[1]);
+    assert(1 == decodedIr[2]);
+}
+
+/**
+ * @brief Writing an image at address 0 goes through the same stores, like initOptionalPeripherals() does at startup
+ */
+static void testWriteFlashAtZero(void)
+{
+    const uint8_t image[] = {0x01, 0x00, 0x01, 0x00};
+    decodedIr[0]          = 1;
+    assert(0 == ch32v003WriteFlash(image, sizeof(image)));
+    assert(0 == decodedIr[0]);
+}
+
+int main(void)
+{
+    testStoreAtFlashStart();
+    testWriteFlashAtZero();
+    testExpandCompressed();
+    testDecodeBlock();
+    printf("test_ch32v003: passed\n");
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_shapes.c
+ * @brief Pixel tests for drawing circles. The source is included directly and draws into a framebuffer here. Run with
+ * `make test`, which builds this with the sanitizers
+ */
+
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <assert.h>
+
+#include "shapes.c"
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief A circle outline to draw
+ */
+typedef struct
+{
+    int r;      ///< The radius
+    int stroke; ///< The stroke width
+} outlineCase_t;
+
+//==============================================================================
+// Variables
+//==============================================================================
+
+static paletteColor_t framebuffer[TFT_WIDTH * TFT_HEIGHT];
+static paletteColor_t expected[TFT_WIDTH * TFT_HEIGHT];
+
+/**
+ * @brief Outlines with thin and thick strokes, holes one pixel across, and strokes which leave no hole at all
+ */
+static const outlineCase_t outlineCases[] = {
+    {10, 1},  // Thin stroke
+    {10, 3},  // Thick stroke
+    {25, 7},  // Large circle
+    {30, 29}, // stroke == r - 1, so the hole is a single row three pixels wide
+    {12, 11}, // stroke == r - 1
+    {2, 1},   // stroke == r - 1 on the smallest circle with a hole
+    {10, 10}, // stroke == r, no hole
+    {8, 12},  // stroke > r, no hole
+};
+
+//==============================================================================
+// Stubs
+//==============================================================================
+
+/**
+ * @brief UBSan only reports errors by default. An overflow while drawing should fail the test
+ */
+const char* __ubsan_default_options(void)
+{
+    return "halt_on_error=1";
+}
+
+paletteColor_t* getPxTftFramebuffer(void)
+{
+    return framebuffer;
+}
+
+void setPxTft(int16_t x, int16_t y, paletteColor_t px)
+{
+    if (0 <= x && x < TFT_WIDTH && 0 <= y && y < TFT_HEIGHT)
+    {
+        framebuffer[y * TFT_WIDTH + x] = px;
+    }
+}
+
+void fillDisplayArea(int16_t x1, int16_t y1, int16_t x2, int16_t y2, paletteColor_t c)
+{
+}
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+/**
+ * @brief Check that drawCircleOutline() draws the pixels of a filled circle which aren't in a filled circle as wide as
+ * the hole, and a filled circle if the stroke leaves no hole
+ */
+static void testCircleOutline(void)
+{
+    int xm = TFT_WIDTH / 2;
+    int ym = TFT_HEIGHT / 2;
+
+    for (int i = 0; i < ARRAY_SIZE(outlineCases); i++)
+    {
+        const outlineCase_t* oc = &outlineCases[i];
+
+        memset(framebuffer, cTransparent, sizeof(framebuffer));
+        drawCircleFilled(xm, ym, oc->r, c555);
+        if (oc->stroke < oc->r)
+        {
+            drawCircleFilled(xm, ym, oc->r - oc->stroke, cTransparent);
+        }
+        memcpy(expected, framebuffer, sizeof(expected));
+
+        memset(framebuffer, cTransparent, sizeof(framebuffer));
+        drawCircleOutline(xm, ym, oc->r, oc->stroke, c555);
+
+        int wrong = 0;
+        for (int px = 0; px < TFT_WIDTH * TFT_HEIGHT; px++)
+        {
+            if (framebuffer[px] != expected[px])
+            {
+                if (0 == wrong++)
+                {
+                    printf("r=%d stroke=%d: pixel (%d, %d) is %d, expected %d\n", oc->r, oc->stroke,
+                           px % TFT_WIDTH - xm, px / TFT_WIDTH - ym, framebuffer[px], expected[px]);
+                }
+            }
+        }
+        if (wrong)
+        {
+            printf("r=%d stroke=%d: %d pixels wrong\n", oc->r, oc->stroke, wrong);
+        }
+        fflush(stdout);
+        assert(0 == wrong);
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main(void)
+{
+    testCircleOutline();
+    printf("test_shapes: passed\n");
+    return 0;
+}
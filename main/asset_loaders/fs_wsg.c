@@ -14,10 +14,84 @@
 #include "fs_wsg.h"
 #include "macros.h"
 
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static bool decodeWsg(const uint8_t* buf, size_t sz, wsg_t* wsg, bool spiRam, heatshrink_decoder* hsd,
+                      const char* tag);
+
 //==============================================================================
 // Functions
 //==============================================================================
 
+/**
+ * @brief Decode a heatshrink compressed WSG straight into its pixel buffer. The four byte dimension header is decoded
+ * first so the pixels can be allocated once at their final size, and no intermediate copy of the image is made.
+ *
+ * @param buf The compressed WSG, starting with the four byte decompressed size
+ * @param sz The size of buf
+ * @param wsg A handle to load the WSG to
+ * @param spiRam true to load to SPI RAM, false to load to normal RAM
+ * @param hsd A heatshrink decoder to decode with. It is reset before use
+ * @param tag A tag for the pixel allocation
+ * @return true if the WSG was loaded successfully, false if not
+ */
+static bool decodeWsg(const uint8_t* buf, size_t sz, wsg_t* wsg, bool spiRam, heatshrink_decoder* hsd,
+                      const char* tag)
+{
+    if (sz < 4)
+    {
+        return false;
+    }
+
+    // Pick out the decompressed size, which includes the dimensions
+    uint32_t decompressedSize = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | (buf[3]);
+
+    heatshrink_decoder_reset(hsd);
+
+    // The decompressed filesize is four bytes, so start after that
+    uint32_t inputIdx = 4;
+
+    // Decode just the dimensions first
+    uint8_t header[4];
+    if (sizeof(header) != heatshrinkDecodeSome(hsd, buf, sz, &inputIdx, header, sizeof(header)))
+    {
+        ESP_LOGE("WSG", "Failed to decode header");
+        return false;
+    }
+
+    uint16_t w         = (header[0] << 8) | header[1];
+    uint16_t h         = (header[2] << 8) | header[3];
+    uint32_t pixelSize = sizeof(paletteColor_t) * w * h;
+    if (decompressedSize != sizeof(header) + pixelSize)
+    {
+        ESP_LOGE("WSG", "Dimensions %" PRIu16 " x %" PRIu16 " don't match size %" PRIu32, w, h, decompressedSize);
+        return false;
+    }
+
+    // The rest of the bytes are pixels, decode them in place
+    paletteColor_t* px
+        = (paletteColor_t*)heap_caps_malloc_tag(pixelSize, spiRam ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT, tag);
+    if (NULL == px)
+    {
+        ESP_LOGE("WSG", "Allocating pixels failed");
+        return false;
+    }
+
+    if (pixelSize != heatshrinkDecodeSome(hsd, buf, sz, &inputIdx, (uint8_t*)px, pixelSize))
+    {
+        ESP_LOGE("WSG", "Failed to decode pixels");
+        heap_caps_free(px);
+        return false;
+    }
+
+    wsg->w  = w;
+    wsg->h  = h;
+    wsg->px = px;
+    return true;
+}
+
 /**
  * @brief Load a WSG from ROM to RAM. WSGs placed in the assets_image folder
  * before compilation will be automatically flashed to ROM
@@ -31,113 +105,79 @@
  */
 bool loadWsg(cnfsFileIdx_t fIdx, wsg_t* wsg, bool spiRam)
 {
-    // Read and decompress file
-    uint32_t decompressedSize = 0;
-    uint8_t* decompressedBuf  = readHeatshrinkFile(fIdx, &decompressedSize, spiRam);
-
-    if (NULL == decompressedBuf)
+    // Allocate a decoder just for this load
+    heatshrink_decoder* hsd = heatshrink_decoder_alloc(256, 8, 4);
+    if (NULL == hsd)
     {
         return false;
     }
 
-    // Save the decompressed info to the wsg. The first four bytes are dimension
-    wsg->w = (decompressedBuf[0] << 8) | decompressedBuf[1];
-    wsg->h = (decompressedBuf[2] << 8) | decompressedBuf[3];
-    // The rest of the bytes are pixels
-    wsg->px = (paletteColor_t*)heap_caps_malloc_tag(sizeof(paletteColor_t) * wsg->w * wsg->h,
-                                                    spiRam ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT, "wsg");
-
-    if (NULL != wsg->px)
-    {
-        memcpy(wsg->px, &decompressedBuf[4], decompressedSize - 4);
-        heap_caps_free(decompressedBuf);
-        return true;
-    }
+    bool loaded = loadWsgInplace(fIdx, wsg, spiRam, hsd);
 
-    // all done
-    heap_caps_free(decompressedBuf);
-    return false;
+    heatshrink_decoder_free(hsd);
+    return loaded;
 }
 
 /**
  * @brief Load a WSG from ROM to RAM. WSGs placed in the assets_image folder
  * before compilation will be automatically flashed to ROM.
- * You must provide a decoder and decode space to this function. It's useful
- * when creating one decoder & space to decode many consecutive WSGs
+ * You must provide a decoder to this function. It's useful when creating one
+ * decoder to decode many consecutive WSGs
  *
  * @param fIdx The cnfsFileIdx_t the WSG to load
  * @param wsg  A handle to load the WSG to
  * @param spiRam true to load to SPI RAM, false to load to normal RAM. SPI RAM is more plentiful but slower to access
  * than normal RAM
- * @param decompressedBuf Memory to store decoded data. This must be as large as the decoded data
- * @param hsd A heatshrink decoder
+ * @param hsd A heatshrink decoder, created with `heatshrink_decoder_alloc(256, 8, 4)`
  * @return true if the WSG was loaded successfully,
  *         false if the WSG load failed and should not be used
  */
-bool loadWsgInplace(cnfsFileIdx_t fIdx, wsg_t* wsg, bool spiRam, uint8_t* decompressedBuf, heatshrink_decoder* hsd)
+bool loadWsgInplace(cnfsFileIdx_t fIdx, wsg_t* wsg, bool spiRam, heatshrink_decoder* hsd)
 {
-    // Read and decompress file
-    uint32_t decompressedSize = 0;
-    decompressedBuf           = readHeatshrinkFileInplace(fIdx, &decompressedSize, decompressedBuf, hsd);
-
-    if (NULL == decompressedBuf)
+    // Read WSG from file
+    size_t sz;
+    const uint8_t* buf = cnfsGetFile(fIdx, &sz);
+    if (NULL == buf)
     {
+        ESP_LOGE("WSG", "Failed to read %d", fIdx);
         return false;
     }
 
-    // Save the decompressed info to the wsg. The first four bytes are dimension
-    wsg->w = (decompressedBuf[0] << 8) | decompressedBuf[1];
-    wsg->h = (decompressedBuf[2] << 8) | decompressedBuf[3];
-    // The rest of the bytes are pixels
-    wsg->px = (paletteColor_t*)heap_caps_malloc_tag(sizeof(paletteColor_t) * wsg->w * wsg->h,
-                                                    spiRam ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT, "wsg_inplace");
-
-    if (NULL != wsg->px)
-    {
-        memcpy(wsg->px, &decompressedBuf[4], decompressedSize - 4);
-        return true;
-    }
-
-    // all done
-    return false;
+    return decodeWsg(buf, sz, wsg, spiRam, hsd, "wsg");
 }
 
 bool loadWsgNvs(const char* namespace, const char* key, wsg_t* wsg, bool spiRam)
 {
-    // Read and decompress file
-    uint32_t decompressedSize = 0;
-    uint8_t* decompressedBuf  = readHeatshrinkNvs(namespace, key, &decompressedSize, spiRam);
-
-    if (NULL == decompressedBuf)
+    // Get full size
+    size_t sz;
+    if (!readNamespaceNvsBlob(namespace, key, NULL, &sz))
     {
         return false;
     }
 
-    ESP_LOGD("WSG", "decompressedBuf size is %" PRIu32, decompressedSize);
+    ESP_LOGD("WSG", "Compressed size is %" PRIu64, (uint64_t)sz);
 
-    // Save the decompressed info to the wsg. The first four bytes are dimension
-    wsg->w = (decompressedBuf[0] << 8) | decompressedBuf[1];
-    wsg->h = (decompressedBuf[2] << 8) | decompressedBuf[3];
-
-    ESP_LOGD("WSG", "full WSG is %" PRIu16 " x %" PRIu16 ", or %d pixels", wsg->w, wsg->h, wsg->w * wsg->h);
-
-    // The rest of the bytes are pixels
-    wsg->px = (paletteColor_t*)heap_caps_malloc_tag(sizeof(paletteColor_t) * wsg->w * wsg->h,
-                                                    spiRam ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT, key);
-
-    if (NULL != wsg->px)
+    // Read compressed WSG from NVS
+    uint8_t* buf = (uint8_t*)heap_caps_malloc(sz, spiRam ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT);
+    if (NULL == buf)
     {
-        ESP_LOGD("WSG", "Copying %" PRIu32 " pixels into WSG now", decompressedSize - 4);
-        memcpy(wsg->px, &decompressedBuf[4], decompressedSize - 4);
-        heap_caps_free(decompressedBuf);
-        return true;
+        return false;
     }
 
-    ESP_LOGE("WSG", "Allocating pixels failed");
+    bool loaded = false;
+    if (readNamespaceNvsBlob(namespace, key, buf, &sz))
+    {
+        heatshrink_decoder* hsd = heatshrink_decoder_alloc(256, 8, 4);
+        if (NULL != hsd)
+        {
+            loaded = decodeWsg(buf, sz, wsg, spiRam, hsd, key);
+            heatshrink_decoder_free(hsd);
+        }
+    }
 
-    // all done
-    heap_caps_free(decompressedBuf);
-    return false;
+    // Free the bytes read from NVS
+    heap_caps_free(buf);
+    return loaded;
 }
 
 bool saveWsgNvs(const char* namespace, const char* key, const wsg_t* wsg)
@@ -15,6 +15,9 @@
  * Load WSGs from the filesystem to RAM using loadWsg(). WSGs may be loaded to normal RAM, which is smaller and faster,
  * or SPI RAM, which is larger and slower.
  *
+ * Pixels are decoded straight into their final buffer, so loading a WSG only needs as much memory as the image. When
+ * loading many WSGs in a row, allocate one heatshrink decoder and pass it to loadWsgInplace() for each of them.
+ *
  * Free when done using freeWsg(). If a wsg is not freed, the memory will leak.
  *
  * \section fs_wsg_example Example
@@ -44,7 +47,7 @@
 #include "heatshrink_encoder.h"
 
 bool loadWsg(cnfsFileIdx_t fIdx, wsg_t* wsg, bool spiRam);
-bool loadWsgInplace(cnfsFileIdx_t fIdx, wsg_t* wsg, bool spiRam, uint8_t* decompressedBuf, heatshrink_decoder* hsd);
+bool loadWsgInplace(cnfsFileIdx_t fIdx, wsg_t* wsg, bool spiRam, heatshrink_decoder* hsd);
 bool loadWsgNvs(const char* namespace, const char* key, wsg_t* wsg, bool spiRam);
 bool saveWsgNvs(const char* namespace, const char* key, const wsg_t* wsg);
 void freeWsg(wsg_t* wsg);
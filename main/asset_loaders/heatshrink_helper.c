@@ -84,6 +84,68 @@ uint8_t* readHeatshrinkFileInplace(cnfsFileIdx_t fIdx, uint32_t* outsize, uint8_
     return decompressedBuf;
 }
 
+/**
+ * @brief Decode heatshrink data until an output buffer is full or the input runs out. This may be called repeatedly
+ * with the same decoder to decode a stream into several buffers, e.g. a small header and then a payload whose size
+ * depends on that header. Call heatshrink_decoder_reset() on the decoder before decoding a new stream.
+ *
+ * @param hsd A heatshrink decoder, which carries the stream state between calls
+ * @param src The compressed data, not including the four byte decompressed size header
+ * @param srcSize The number of bytes in src
+ * @param srcIdx The index of the next byte of src to decode. This is updated as data is consumed
+ * @param dest The buffer to decode into
+ * @param destSize The number of bytes to decode into dest
+ * @return The number of bytes written to dest. This is less than destSize if the input ran out or there was an error
+ */
+uint32_t heatshrinkDecodeSome(heatshrink_decoder* hsd, const uint8_t* src, uint32_t srcSize, uint32_t* srcIdx,
+                              uint8_t* dest, uint32_t destSize)
+{
+    uint32_t outputIdx = 0;
+    bool finished      = false;
+
+    while (outputIdx < destSize)
+    {
+        // Drain any decoded data first
+        size_t copied       = 0;
+        HSD_poll_res polled = heatshrink_decoder_poll(hsd, &dest[outputIdx], destSize - outputIdx, &copied);
+        outputIdx += copied;
+
+        if (polled < 0)
+        {
+            ESP_LOGE("Heatshrink", "Fault on decode");
+            break;
+        }
+        else if (HSDR_POLL_MORE == polled)
+        {
+            // dest is full, the rest stays in the decoder for the next call
+            continue;
+        }
+        else if (*srcIdx < srcSize)
+        {
+            // The decoder is empty, give it more input
+            copied = 0;
+            if (heatshrink_decoder_sink(hsd, &src[*srcIdx], srcSize - *srcIdx, &copied) < 0 || 0 == copied)
+            {
+                ESP_LOGE("Heatshrink", "Fault on decode");
+                break;
+            }
+            (*srcIdx) += copied;
+        }
+        else if (!finished)
+        {
+            // Out of input, flush whatever is left in the window
+            finished = (HSDR_FINISH_DONE == heatshrink_decoder_finish(hsd));
+        }
+        else
+        {
+            // Out of input and output
+            break;
+        }
+    }
+
+    return outputIdx;
+}
+
 /**
  * @brief Read a heatshrink compressed file from the filesystem into an output array.
  * Files that are in the assets_image folder before compilation and flashing
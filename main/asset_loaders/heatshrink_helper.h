@@ -10,6 +10,8 @@
 
 uint8_t* readHeatshrinkFileInplace(cnfsFileIdx_t fIdx, uint32_t* outsize, uint8_t* decompressedBuf,
                                    heatshrink_decoder* hsd);
+uint32_t heatshrinkDecodeSome(heatshrink_decoder* hsd, const uint8_t* src, uint32_t srcSize, uint32_t* srcIdx,
+                              uint8_t* dest, uint32_t destSize);
 uint8_t* readHeatshrinkFile(cnfsFileIdx_t fIdx, uint32_t* outsize, bool readToSpiRam);
 uint8_t* readHeatshrinkNvs(const char* namespace, const char* key, uint32_t* outsize, bool spiRam);
 uint32_t heatshrinkCompress(uint8_t* dest, const uint8_t* src, uint32_t size);
@@ -1341,6 +1341,13 @@ static void drawCircleFilledInner(int xm, int ym, int r, paletteColor_t col, int
  */
 void drawCircleOutline(int xm, int ym, int r, int stroke, paletteColor_t col)
 {
+    // A stroke as wide as the radius leaves no hole
+    if (stroke >= r)
+    {
+        drawCircleFilled(xm, ym, r, col);
+        return;
+    }
+
     SETUP_FOR_TURBO();
 
     // Outer circle
@@ -1356,8 +1363,9 @@ void drawCircleOutline(int xm, int ym, int r, int stroke, paletteColor_t col)
         // Iterates over X
         for (int lineX = xm + x; lineX <= xm - x; lineX++)
         {
-            // Only draw the outline
-            if (lineX < (xm + x_inner) || lineX > (xm - x_inner))
+            // Only draw the outline. Rows past the top and bottom of the inner circle, which has ended once x_inner
+            // reaches 0, are drawn all the way across
+            if (x_inner >= 0 || y_inner != y || lineX < (xm + x_inner) || lineX > (xm - x_inner))
             {
                 TURBO_SET_PIXEL_BOUNDS(lineX, (ym - y), col);
                 TURBO_SET_PIXEL_BOUNDS(lineX, (ym + y), col);
@@ -1375,8 +1383,9 @@ void drawCircleOutline(int xm, int ym, int r, int stroke, paletteColor_t col)
             err += ++x * 2 + 1; /* -> x-step now */
         }
 
-        // Iterate the inner circle to match
-        while (y_inner != y)
+        // Iterate the inner circle to match, until it ends. Iterating past its end would never reach the outer circle's
+        // remaining rows, and would overflow err_inner
+        while (y_inner != y && x_inner < 0)
         {
             r_inner = err_inner;
             if (r_inner <= y_inner)
@@ -17,6 +17,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// @brief Precedes an event in a merged stream when it isn't from the predicted track
+#define MERGED_TRACK_MARKER 0x80
+
 //==============================================================================
 // Structs
 //==============================================================================
@@ -44,6 +51,12 @@ struct midiTrackState
 
     /// @brief Whether or not the END OF TRACK event has been read
     bool done;
+
+    /// @brief For a merged stream, the original track of the last event on each channel
+    uint8_t channelTracks[16];
+
+    /// @brief For a merged stream, the original track of the last meta or SysEx event
+    uint8_t systemTrack;
 };
 
 typedef struct
@@ -61,7 +74,10 @@ typedef struct
 static int readVariableLength(const uint8_t* data, uint32_t length, uint32_t* out);
 static int writeVariableLength(uint8_t* out, int max, uint32_t length);
 static bool trackParseNext(midiFileReader_t* reader, midiTrackState_t* track);
+static bool mergedParseNext(midiFileReader_t* reader, midiTrackState_t* track);
+static bool readNextEvent(midiFileReader_t* reader, midiTrackState_t* track);
 static bool parseMidiHeader(midiFile_t* file);
+static bool parseMergedHeader(midiFile_t* file);
 static void readFirstEvents(midiFileReader_t* reader);
 
 //==============================================================================
@@ -70,6 +86,8 @@ static void readFirstEvents(midiFileReader_t* reader);
 
 static const uint8_t midiHeader[]  = {'M', 'T', 'h', 'd'};
 static const uint8_t trackHeader[] = {'M', 'T', 'r', 'k'};
+/// @brief Header for a MIDI file whose tracks were merged into one stream by the asset preprocessor
+static const uint8_t mergedHeader[] = {'M', 'T', 'm', 'g'};
 
 //==============================================================================
 // Functions
@@ -592,6 +610,77 @@ static bool trackParseNext(midiFileReader_t* reader, midiTrackState_t* track)
     return true;
 }
 
+/**
+ * @brief Parse the next event from a merged MIDI stream and store its data in ::nextEvent
+ *
+ * A merged stream is laid out like a single MIDI track containing the events from every track, already sorted by
+ * time. So, there is never any need to search the other tracks for the next event. Each event is assumed to come
+ * from the same track as the previous event on its channel, or the previous non-channel event. When it doesn't, it
+ * is prefixed with ::MERGED_TRACK_MARKER and the index of the track it came from.
+ *
+ * @param reader The reader to read file data from
+ * @param track The parse state of the merged stream
+ * @return true If an event was successfully parsed
+ * @return false If there are no more events in the stream, or a fatal error was encountered while parsing
+ */
+static bool mergedParseNext(midiFileReader_t* reader, midiTrackState_t* track)
+{
+    if (track->done || !TRK_REMAIN())
+    {
+        return false;
+    }
+
+    bool marked      = false;
+    uint8_t trackIdx = 0;
+
+    if (MERGED_TRACK_MARKER == *track->cur)
+    {
+        if (TRK_REMAIN() < 2)
+        {
+            return false;
+        }
+
+        marked   = true;
+        trackIdx = track->cur[1];
+        track->cur += 2;
+    }
+
+    if (!trackParseNext(reader, track))
+    {
+        return false;
+    }
+
+    // Put back the original track index, instead of the index of the merged track
+    uint8_t* predicted = (MIDI_EVENT == track->nextEvent.type)
+                             ? &track->channelTracks[track->nextEvent.midi.status & 0x0F]
+                             : &track->systemTrack;
+    if (marked)
+    {
+        *predicted = trackIdx;
+    }
+
+    track->nextEvent.track = *predicted & 0x0F;
+    return true;
+}
+
+/**
+ * @brief Parse the next event for a track, using the appropriate parser for the file
+ *
+ * @param reader The reader to read file data from
+ * @param track The track parse state where the event will be stored
+ * @return true If an event was successfully parsed
+ * @return false If there are no more events in the track, or a fatal error was encountered while parsing
+ */
+static bool readNextEvent(midiFileReader_t* reader, midiTrackState_t* track)
+{
+    if (reader->file->merged)
+    {
+        return mergedParseNext(reader, track);
+    }
+
+    return trackParseNext(reader, track);
+}
+
 /**
  * @brief Parse the information contained in the MIDI header and write it to the file struct
  *
@@ -774,6 +863,59 @@ static bool parseMidiHeader(midiFile_t* file)
     return true;
 }
 
+/**
+ * @brief Parse the header of a merged MIDI stream and set up its single track
+ *
+ * @param file The MIDI file struct to write header data into
+ * @return true if the file contains a valid merged stream header
+ * @return false if the merged stream header could not be parsed
+ */
+static bool parseMergedHeader(midiFile_t* file)
+{
+    // Magic, format, track count, time division, event count
+    const uint32_t headerLen = sizeof(mergedHeader) + 1 + 1 + 2 + 4;
+
+    if (file->length < headerLen)
+    {
+        ESP_LOGE("MIDIParser", "Not a merged MIDI file! Length insufficient for header");
+        return false;
+    }
+
+    uint32_t offset = sizeof(mergedHeader);
+
+    uint8_t format = file->data[offset++];
+    if (format > MIDI_FORMAT_1)
+    {
+        ESP_LOGE("MIDIParser", "Unsupported merged MIDI file format: %" PRIu8, format);
+        return false;
+    }
+    file->format = (midiFileFormat_t)format;
+
+    // The original track count isn't needed for playback
+    offset++;
+
+    file->timeDivision = (file->data[offset] << 8) | file->data[offset + 1];
+    offset += 2;
+
+    // Skip the event count
+    offset += 4;
+
+    // All the events are stored in one stream, which is read just like one track
+    file->trackCount = 1;
+    file->tracks     = heap_caps_calloc_tag(1, sizeof(midiTrack_t), MALLOC_CAP_SPIRAM, "tracks");
+    if (NULL == file->tracks)
+    {
+        ESP_LOGE("MIDIParser", "Could not allocate data for merged MIDI file");
+        return false;
+    }
+
+    file->tracks[0].data   = file->data + offset;
+    file->tracks[0].length = file->length - offset;
+    file->merged           = true;
+
+    return true;
+}
+
 /**
  * @brief Attempt to read the first event from each track in the MIDI file
  *
@@ -784,7 +926,7 @@ static void readFirstEvents(midiFileReader_t* reader)
     for (int i = 0; i < reader->file->trackCount; i++)
     {
         // Parse the first event from each track?
-        reader->states[i].eventParsed = trackParseNext(reader, &reader->states[i]);
+        reader->states[i].eventParsed = readNextEvent(reader, &reader->states[i]);
 
         // Handle empty/invalid tracks
         if (!reader->states[i].eventParsed)
@@ -801,7 +943,10 @@ bool loadMidiData(uint8_t* data, size_t size, midiFile_t* file)
     {
         file->data   = data;
         file->length = (uint32_t)size;
-        if (parseMidiHeader(file))
+        file->merged = false;
+
+        bool isMerged = (size >= sizeof(mergedHeader) && !memcmp(data, mergedHeader, sizeof(mergedHeader)));
+        if (isMerged ? parseMergedHeader(file) : parseMidiHeader(file))
         {
             return true;
         }
@@ -829,7 +974,8 @@ bool loadMidiFile(cnfsFileIdx_t fIdx, midiFile_t* file, bool spiRam)
 
     if (NULL != data)
     {
-        if (raw_size < sizeof(midiHeader) || memcmp(data, midiHeader, sizeof(midiHeader)))
+        if (raw_size < sizeof(midiHeader)
+            || (memcmp(data, midiHeader, sizeof(midiHeader)) && memcmp(data, mergedHeader, sizeof(mergedHeader))))
         {
             // This is not a MIDI file! Try to decompress
             if (heatshrinkDecompress(NULL, &size, data, (uint32_t)raw_size))
@@ -947,7 +1093,9 @@ void resetMidiParser(midiFileReader_t* reader)
             reader->states[i].done = true;
         }
         memset(&reader->states[i].nextEvent, 0, sizeof(midiEvent_t));
-        reader->states[i].time = 0;
+        memset(reader->states[i].channelTracks, 0, sizeof(reader->states[i].channelTracks));
+        reader->states[i].systemTrack = 0;
+        reader->states[i].time        = 0;
     }
 
     if (reader->file != NULL)
@@ -1014,7 +1162,7 @@ bool midiNextEvent(midiFileReader_t* reader, midiEvent_t* event)
             info->time += info->nextEvent.deltaTime;
 
             // Consume the event!
-            info->eventParsed = trackParseNext(reader, info);
+            info->eventParsed = readNextEvent(reader, info);
             return true;
         }
         else if (info->time + info->nextEvent.deltaTime < minTime)
@@ -1033,7 +1181,7 @@ bool midiNextEvent(midiFileReader_t* reader, midiEvent_t* event)
 
     *event = nextTrack->nextEvent;
     nextTrack->time += event->deltaTime;
-    nextTrack->eventParsed = trackParseNext(reader, nextTrack);
+    nextTrack->eventParsed = readNextEvent(reader, nextTrack);
     return true;
 }
 
@@ -102,6 +102,10 @@ typedef struct
 
     /// @brief An array of MIDI tracks
     midiTrack_t* tracks;
+
+    /// @brief True if all tracks were merged into a single time-sorted stream by the asset preprocessor.
+    /// When set, \c tracks contains exactly one track holding the whole stream.
+    bool merged;
 } midiFile_t;
 
 typedef struct midiTrackState midiTrackState_t;
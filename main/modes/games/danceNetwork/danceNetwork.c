@@ -197,8 +197,6 @@ static const paletteColor_t starterAlbums[16][4] = {
 /// This helps to prevent memory fragmentation in SPIRAM.
 /// Note, this is outside the dn_t struct for easy access to loading fuctions without dn_t references
 heatshrink_decoder* dn_hsd;
-/// @brief A temporary decode space to use for all WSG loads
-uint8_t* dn_decodeSpace;
 
 // This is in order such that index is the assetIdx.
 static const cnfsFileIdx_t dn_assetToWsgLookup[]
@@ -309,12 +307,8 @@ static void dn_EnterMode(void)
     gameData->assets[DN_MMM_UP_ASSET].originX = 17 / 2;
     gameData->assets[DN_MMM_UP_ASSET].originY = 12 / 2;
 
-    // Allocate WSG loading helpers
+    // Allocate WSG loading helper. WSGs decode straight into their pixels, so no decode space is needed
     dn_hsd = heatshrink_decoder_alloc(256, 8, 4);
-    // The largest image is bb_menu2.png, decodes to 99124 bytes
-    // 99328 is 1024 * 97
-    dn_decodeSpace
-        = heap_caps_malloc_tag(99328, MALLOC_CAP_SPIRAM, "decodeSpace"); // TODO change the size to the largest sprite
 
     // Load some fonts
     loadFont(IBM_VGA_8_FONT, &gameData->font_ibm, true);
@@ -369,6 +363,8 @@ static void dn_ExitMode(void)
     freeFont(&gameData->font_ibm);
     freeFont(&gameData->font_righteous);
     freeFont(&gameData->outline_righteous);
+    heatshrink_decoder_free(dn_hsd);
+    dn_hsd = NULL;
     heap_caps_free(gameData);
 }
 
@@ -110,6 +110,5 @@ extern const char dnP2TroupeKey[];
 // extern const char tttUnlockKey[];
 extern swadgeMode_t danceNetworkMode;
 extern heatshrink_decoder* dn_hsd;
-extern uint8_t* dn_decodeSpace;
 // extern const int16_t markersUnlockedAtWins[NUM_UNLOCKABLE_MARKERS];
 extern const trophyData_t danceNetworkTrophies[];
\ No newline at end of file
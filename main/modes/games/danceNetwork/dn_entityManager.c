@@ -106,7 +106,7 @@ void dn_loadAsset(cnfsFileIdx_t spriteCnfsIdx, uint8_t num_frames, dn_asset_t* a
         wsg_t* wsg = &asset->frames[frameIdx];
         if (0 == wsg->h && 0 == wsg->w)
         {
-            loadWsgInplace(spriteCnfsIdx + frameIdx, wsg, true, dn_decodeSpace, dn_hsd);
+            loadWsgInplace(spriteCnfsIdx + frameIdx, wsg, true, dn_hsd);
         }
     }
 }
@@ -40,6 +40,9 @@ bool toggleTentativeMark(uint8_t x, uint8_t y);
 bool setTentativeMark(uint8_t x, uint8_t y, bool mark);
 void picrossVictoryLEDs(uint32_t tElapsedUs, uint32_t arg, bool reset);
 int8_t lerp(int8_t a, int8_t b, uint16_t amount);
+void picrossRequestHint(void);
+void picrossHintStep(void);
+bool picrossRevealKnownCell(void);
 //==============================================================================
 // Variables
 //==============================================================================
@@ -465,6 +468,12 @@ void picrossGameLoop(int64_t elapsedUs)
         return;
     }
 
+    // Spread the hint search over a few frames, so asking for a hint never causes a hitch.
+    if (p->hintPending)
+    {
+        picrossHintStep();
+    }
+
     if (p->input->showGuides)
     {
         picrossCalculateHoverHint();
@@ -776,6 +785,13 @@ void picrossUserInput(int64_t elapsedUs)
         p->input->prevBtnState = p->input->btnState;
         return;
     }
+
+    // Ask for a hint. The solver runs in picrossGameLoop, and moves the cursor when it finds a cell.
+    if (input->btnState & PB_SELECT && !(input->prevBtnState & PB_SELECT))
+    {
+        picrossRequestHint();
+    }
+
     // Input checks
 
     // DAS
@@ -1115,6 +1131,130 @@ void enterSpace(uint8_t x, uint8_t y, picrossSpaceType_t newSpace)
     }
 }
 
+/**
+ * @brief Start looking for a hint. The solver is set up from the clues the first time, and after that only learns
+ * about cells the player has filled or marked correctly, so only lines touched since the last hint are solved again.
+ */
+void picrossRequestHint(void)
+{
+    if (p->hintPending)
+    {
+        return;
+    }
+
+    if (NULL == p->hintSolver)
+    {
+        p->hintSolver = heap_caps_calloc(1, sizeof(picrossSolver_t), MALLOC_CAP_8BIT);
+        if (NULL == p->hintSolver)
+        {
+            // No hint this time, the next request will try again
+            return;
+        }
+        picrossSolverInit(p->hintSolver, p->puzzle->width, p->puzzle->height);
+        for (int i = 0; i < p->puzzle->height; i++)
+        {
+            picrossSolverSetClues(p->hintSolver, true, i, p->puzzle->rowHints[i].hints, PICROSS_MAX_HINTCOUNT);
+        }
+        for (int i = 0; i < p->puzzle->width; i++)
+        {
+            picrossSolverSetClues(p->hintSolver, false, i, p->puzzle->colHints[i].hints, PICROSS_MAX_HINTCOUNT);
+        }
+    }
+
+    // Wrong cells are left out, the hint will point at them once the solver works out what they should be.
+    for (int x = 0; x < p->puzzle->width; x++)
+    {
+        for (int y = 0; y < p->puzzle->height; y++)
+        {
+            picrossSpaceType_t space = p->puzzle->level[x][y];
+            picrossSpaceType_t goal  = p->puzzle->completeLevel[x][y];
+            if (space == SPACE_FILLED && goal == SPACE_FILLED)
+            {
+                picrossSolverSetCell(p->hintSolver, x, y, true);
+            }
+            else if (space == SPACE_MARKEMPTY && goal != SPACE_FILLED)
+            {
+                picrossSolverSetCell(p->hintSolver, x, y, false);
+            }
+        }
+    }
+
+    // Cells worked out for an earlier hint may not have been entered yet
+    p->hintPending = !picrossRevealKnownCell();
+}
+
+/**
+ * @brief Solve a few lines for a pending hint, and reveal a cell if any were found
+ */
+void picrossHintStep(void)
+{
+    switch (picrossSolverStep(p->hintSolver, PICROSS_HINT_LINES))
+    {
+        case PICROSS_SOLVER_WORKING:
+        {
+            break;
+        }
+        case PICROSS_SOLVER_PROGRESS:
+        {
+            // The new cells may only be empty ones the player has left blank, so keep going until one is worth showing
+            p->hintPending = !picrossRevealKnownCell();
+            break;
+        }
+        case PICROSS_SOLVER_STUCK:
+        case PICROSS_SOLVER_SOLVED:
+        case PICROSS_SOLVER_CONTRADICTION:
+        default:
+        {
+            // Nothing left to show. The player's filled cells already match the solution.
+            p->hintPending = false;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Move the cursor to a cell the hint solver knows but the player doesn't, and enter it.
+ * Missing filled cells are shown first, then wrongly filled cells. Blank cells which should be empty aren't shown.
+ *
+ * @return true if a cell was revealed, false if the player already has every cell the solver knows
+ */
+bool picrossRevealKnownCell(void)
+{
+    const picrossSolver_t* s = p->hintSolver;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int y = 0; y < p->puzzle->height; y++)
+        {
+            uint16_t known = pass ? s->rowEmpty[y] : s->rowFilled[y];
+            for (int x = 0; x < p->puzzle->width; x++)
+            {
+                if (!(known & (1 << x)))
+                {
+                    continue;
+                }
+
+                bool isFilled = (p->puzzle->level[x][y] == SPACE_FILLED);
+                if (pass == 0 && !isFilled)
+                {
+                    p->input->x = x;
+                    p->input->y = y;
+                    enterSpace(x, y, SPACE_FILLED);
+                    return true;
+                }
+                else if (pass == 1 && isFilled)
+                {
+                    p->input->x = x;
+                    p->input->y = y;
+                    enterSpace(x, y, SPACE_MARKEMPTY);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
 void countInput(picrossDir_t input)
 {
     // I need to work out how this should properly behave.
@@ -1774,6 +1914,7 @@ void picrossExitGame(void)
 
         freeFont(&(p->hintFont));
         freeFont(&(p->UIFont));
+        heap_caps_free(p->hintSolver);
         heap_caps_free(p->input);
         heap_caps_free(p->puzzle);
         heap_caps_free(p);
@@ -3,6 +3,7 @@
 
 #include "swadge2024.h"
 #include "picross_select.h"
+#include "picross_solver.h"
 
 typedef struct
 {
@@ -148,6 +149,8 @@ typedef struct
     int32_t marqueeScrollX;       // for the marquee text
     menu_t* menu;                 // for the background drawing effect
     menuMegaRenderer_t* renderer; // for the background drawing effect
+    picrossSolver_t* hintSolver;  // for the select button hint. Allocated on first use, and kept so work isn't redone.
+    bool hintPending;             // true while the hint solver is working through lines, a few per frame.
 } picrossGame_t;
 
 void picrossStartGame(font_t* mmFont, picrossLevelDef_t* selectedLevel, bool cont, menuMegaRenderer_t* renderer,
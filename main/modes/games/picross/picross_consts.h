@@ -9,6 +9,7 @@
 #define PICROSS_BORDER_COLOR  c333
 #define PICROSS_MOD5_COLOR    c541 // c441 is yellow. c541 is dark orange.
 #define PICROSS_LERP_AMOUNT   6000
+#define PICROSS_HINT_LINES    4 // how many rows or columns the hint solver may solve per frame.
 // If you add files, but haven't changed level select or this file, it might not recompile.
 // go to terminal and run: make -f emu.mk clean all
 // which will force everything to refresh
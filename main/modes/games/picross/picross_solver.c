@@ -0,0 +1,452 @@
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include "picross_solver.h"
+
+#include <string.h>
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// @brief A mask of len bits starting at bit start
+#define RANGE_MASK(start, len) ((uint32_t)((1u << (len)) - 1u) << (start))
+
+/// @brief The total number of lines the solver can track
+#define MAX_LINES (PICROSS_SOLVER_MAX_SIZE * 2)
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static void solverApplyCell(picrossSolver_t* solver, uint8_t x, uint8_t y, bool filled);
+static bool solverIsSolved(const picrossSolver_t* solver);
+
+//==============================================================================
+// Static Functions
+//==============================================================================
+
+/**
+ * @brief Mark a cell as known in both the row and column caches, and mark its row and column dirty if it changed
+ *
+ * @param solver The solver
+ * @param x The cell's column
+ * @param y The cell's row
+ * @param filled true if the cell is filled, false if it is empty
+ */
+static void solverApplyCell(picrossSolver_t* solver, uint8_t x, uint8_t y, bool filled)
+{
+    uint16_t xBit = 1 << x;
+    uint16_t yBit = 1 << y;
+
+    if (filled && !(solver->rowFilled[y] & xBit))
+    {
+        solver->rowFilled[y] |= xBit;
+        solver->colFilled[x] |= yBit;
+    }
+    else if (!filled && !(solver->rowEmpty[y] & xBit))
+    {
+        solver->rowEmpty[y] |= xBit;
+        solver->colEmpty[x] |= yBit;
+    }
+    else
+    {
+        return;
+    }
+
+    solver->dirty |= (1u << y) | (1u << (PICROSS_SOLVER_MAX_SIZE + x));
+}
+
+static bool solverIsSolved(const picrossSolver_t* solver)
+{
+    uint16_t rowMask = (1u << solver->width) - 1;
+    for (int y = 0; y < solver->height; y++)
+    {
+        if ((solver->rowFilled[y] | solver->rowEmpty[y]) != rowMask)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+/**
+ * @brief Find every cell in a line which is forced to be filled or empty by its clues and the cells already known.
+ *
+ * This is a complete line solver: a cell is forced only if it has the same value in every arrangement of the clues
+ * which fits the known cells. Arrangements are counted with bitsets of where each prefix and suffix of the clues can
+ * fit, so a 15-cell line is solved in a few hundred simple operations.
+ *
+ * @param clues The clue lengths for the line, in order
+ * @param count The number of clues. 0 means the line is empty
+ * @param len The number of cells in the line
+ * @param[in,out] filled Bitmask of the cells known to be filled, which forced cells are added to
+ * @param[in,out] empty Bitmask of the cells known to be empty, which forced cells are added to
+ * @return true if the line was solved, false if no arrangement of the clues fits the known cells
+ */
+bool picrossSolveLine(const uint8_t* clues, int count, int len, uint16_t* filled, uint16_t* empty)
+{
+    const uint32_t knownFilled = *filled;
+    const uint32_t knownEmpty  = *empty;
+    const uint32_t lineMask    = RANGE_MASK(0, len);
+
+    // fwd[j] bit i: clues [0, j) fit in cells [0, i), with no known filled cells left uncovered
+    // bwd[j] bit i: clues [j, count) fit in cells [i, len), likewise
+    uint32_t fwd[PICROSS_SOLVER_MAX_CLUES + 1] = {0};
+    uint32_t bwd[PICROSS_SOLVER_MAX_CLUES + 1] = {0};
+
+    if (count > PICROSS_SOLVER_MAX_CLUES)
+    {
+        return false;
+    }
+
+    for (int j = 0; j <= count; j++)
+    {
+        // Prefix [0, 0) fits no clues
+        fwd[j] = (0 == j) ? 1 : 0;
+        for (int i = 1; i <= len; i++)
+        {
+            // Cell i-1 is empty, and the prefix before it fits
+            bool fits = (fwd[j] & (1u << (i - 1))) && !(knownFilled & (1u << (i - 1)));
+
+            // Or clue j-1 ends at cell i-1
+            if (!fits && j > 0 && i >= clues[j - 1])
+            {
+                int start = i - clues[j - 1];
+                if (knownEmpty & RANGE_MASK(start, clues[j - 1]))
+                {
+                    fits = false;
+                }
+                else if (0 == start)
+                {
+                    fits = (1 == j);
+                }
+                else
+                {
+                    fits = !(knownFilled & (1u << (start - 1))) && (fwd[j - 1] & (1u << (start - 1)));
+                }
+            }
+
+            if (fits)
+            {
+                fwd[j] |= 1u << i;
+            }
+        }
+    }
+
+    for (int j = count; j >= 0; j--)
+    {
+        // Suffix [len, len) fits no clues
+        bwd[j] = (count == j) ? (1u << len) : 0;
+        for (int i = len - 1; i >= 0; i--)
+        {
+            // Cell i is empty, and the suffix after it fits
+            bool fits = (bwd[j] & (1u << (i + 1))) && !(knownFilled & (1u << i));
+
+            // Or clue j starts at cell i
+            if (!fits && j < count && i + clues[j] <= len)
+            {
+                int end = i + clues[j];
+                if (knownEmpty & RANGE_MASK(i, clues[j]))
+                {
+                    fits = false;
+                }
+                else if (len == end)
+                {
+                    fits = (count - 1 == j);
+                }
+                else
+                {
+                    fits = !(knownFilled & (1u << end)) && (bwd[j + 1] & (1u << (end + 1)));
+                }
+            }
+
+            if (fits)
+            {
+                bwd[j] |= 1u << i;
+            }
+        }
+    }
+
+    if (!(fwd[count] & (1u << len)))
+    {
+        // The clues can't be arranged at all
+        return false;
+    }
+
+    uint32_t canEmpty = 0;
+    uint32_t canFill  = 0;
+
+    for (int x = 0; x < len; x++)
+    {
+        if (knownFilled & (1u << x))
+        {
+            continue;
+        }
+
+        // Cell x can be empty if some prefix of the clues fits before it and the rest fit after it
+        for (int j = 0; j <= count; j++)
+        {
+            if ((fwd[j] & (1u << x)) && (bwd[j] & (1u << (x + 1))))
+            {
+                canEmpty |= 1u << x;
+                break;
+            }
+        }
+    }
+
+    // A clue can be placed at a start if the cells under it can be filled, the cells around it can be empty, and the
+    // other clues fit on either side
+    for (int j = 0; j < count; j++)
+    {
+        for (int start = 0; start + clues[j] <= len; start++)
+        {
+            int end = start + clues[j];
+            if (knownEmpty & RANGE_MASK(start, clues[j]))
+            {
+                continue;
+            }
+
+            bool leftFits = (0 == j);
+            if (start > 0)
+            {
+                leftFits = !(knownFilled & (1u << (start - 1))) && (fwd[j] & (1u << (start - 1)));
+            }
+
+            bool rightFits = (count - 1 == j);
+            if (end < len)
+            {
+                rightFits = !(knownFilled & (1u << end)) && (bwd[j + 1] & (1u << (end + 1)));
+            }
+
+            if (leftFits && rightFits)
+            {
+                canFill |= RANGE_MASK(start, clues[j]);
+            }
+        }
+    }
+
+    // Known cells can always be what they are
+    canFill |= knownFilled;
+    canEmpty |= knownEmpty;
+
+    if ((canFill | canEmpty) != lineMask)
+    {
+        return false;
+    }
+
+    *filled = (uint16_t)(lineMask & ~canEmpty);
+    *empty  = (uint16_t)(lineMask & ~canFill);
+    return true;
+}
+
+/**
+ * @brief Compute the clues for a line from its filled cells
+ *
+ * @param filled Bitmask of the filled cells in the line
+ * @param len The number of cells in the line
+ * @param[out] clues At least PICROSS_SOLVER_MAX_CLUES entries to write the clues to
+ * @return The number of clues, or -1 if there are too many for one line
+ */
+int picrossCluesFromLine(uint16_t filled, int len, uint8_t* clues)
+{
+    int count = 0;
+    int run   = 0;
+    for (int x = 0; x <= len; x++)
+    {
+        if (x < len && (filled & (1u << x)))
+        {
+            run++;
+        }
+        else if (run)
+        {
+            if (count >= PICROSS_SOLVER_MAX_CLUES)
+            {
+                return -1;
+            }
+            clues[count++] = run;
+            run            = 0;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Set up a solver for an empty puzzle. Clues must be set for every row and column before solving
+ *
+ * @param solver The solver to initialize
+ * @param width The width of the puzzle, up to PICROSS_SOLVER_MAX_SIZE
+ * @param height The height of the puzzle, up to PICROSS_SOLVER_MAX_SIZE
+ */
+void picrossSolverInit(picrossSolver_t* solver, uint8_t width, uint8_t height)
+{
+    memset(solver, 0, sizeof(picrossSolver_t));
+    solver->width    = width;
+    solver->height   = height;
+    solver->lastLine = -1;
+
+    // Every line starts dirty
+    solver->dirty = RANGE_MASK(0, height) | RANGE_MASK(PICROSS_SOLVER_MAX_SIZE, width);
+}
+
+/**
+ * @brief Set the clues for a row or column. Zero-length clues are skipped
+ *
+ * @param solver The solver
+ * @param isRow true to set a row's clues, false to set a column's
+ * @param index The row or column
+ * @param clues The clue lengths, in order
+ * @param count The number of entries in clues
+ * @return true if the clues were set, false if there are too many
+ */
+bool picrossSolverSetClues(picrossSolver_t* solver, bool isRow, uint8_t index, const uint8_t* clues, uint8_t count)
+{
+    int line = isRow ? index : PICROSS_SOLVER_MAX_SIZE + index;
+
+    solver->clueCounts[line] = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (clues[i])
+        {
+            if (solver->clueCounts[line] >= PICROSS_SOLVER_MAX_CLUES)
+            {
+                return false;
+            }
+            solver->clues[line][solver->clueCounts[line]++] = clues[i];
+        }
+    }
+
+    solver->dirty |= 1u << line;
+    return true;
+}
+
+/**
+ * @brief Tell the solver a cell is known, such as one the player has already entered correctly
+ *
+ * @param solver The solver
+ * @param x The cell's column
+ * @param y The cell's row
+ * @param filled true if the cell is filled, false if it is empty
+ */
+void picrossSolverSetCell(picrossSolver_t* solver, uint8_t x, uint8_t y, bool filled)
+{
+    solverApplyCell(solver, x, y, filled);
+}
+
+/**
+ * @brief Solve up to maxLines dirty lines, stopping early as soon as a line forces new cells.
+ *
+ * This is meant to be called once per frame with a small maxLines to spread the work out. Each line is only solved
+ * again after a cell in it changes.
+ *
+ * @param solver The solver
+ * @param maxLines The most lines to solve in this call
+ * @return The state of the solver after this step
+ */
+picrossSolverResult_t picrossSolverStep(picrossSolver_t* solver, int maxLines)
+{
+    solver->lastLine = -1;
+
+    for (int n = 0; n < maxLines && solver->dirty; n++)
+    {
+        while (!(solver->dirty & (1u << solver->nextLine)))
+        {
+            solver->nextLine = (solver->nextLine + 1) % MAX_LINES;
+        }
+
+        int line = solver->nextLine;
+        solver->dirty &= ~(1u << line);
+
+        bool isRow = line < PICROSS_SOLVER_MAX_SIZE;
+        int index  = isRow ? line : line - PICROSS_SOLVER_MAX_SIZE;
+        int len    = isRow ? solver->width : solver->height;
+
+        uint16_t oldFilled = isRow ? solver->rowFilled[index] : solver->colFilled[index];
+        uint16_t oldEmpty  = isRow ? solver->rowEmpty[index] : solver->colEmpty[index];
+        uint16_t filled    = oldFilled;
+        uint16_t empty     = oldEmpty;
+
+        if (!picrossSolveLine(solver->clues[line], solver->clueCounts[line], len, &filled, &empty))
+        {
+            return PICROSS_SOLVER_CONTRADICTION;
+        }
+
+        uint16_t newFilled = filled & ~oldFilled;
+        uint16_t newEmpty  = empty & ~oldEmpty;
+        if (newFilled | newEmpty)
+        {
+            for (int i = 0; i < len; i++)
+            {
+                if ((newFilled | newEmpty) & (1u << i))
+                {
+                    solverApplyCell(solver, isRow ? i : index, isRow ? index : i, (newFilled >> i) & 1);
+                }
+            }
+
+            // This line is already consistent with what it just found
+            solver->dirty &= ~(1u << line);
+
+            solver->lastLine   = line;
+            solver->lastFilled = newFilled;
+            solver->lastEmpty  = newEmpty;
+            return PICROSS_SOLVER_PROGRESS;
+        }
+    }
+
+    if (solver->dirty)
+    {
+        return PICROSS_SOLVER_WORKING;
+    }
+
+    return solverIsSolved(solver) ? PICROSS_SOLVER_SOLVED : PICROSS_SOLVER_STUCK;
+}
+
+/**
+ * @brief Solve lines until the puzzle is solved or no more progress can be made
+ *
+ * @param solver The solver
+ * @return PICROSS_SOLVER_SOLVED if the puzzle has a unique solution which can be found one line at a time,
+ * PICROSS_SOLVER_STUCK if it needs more than that, or PICROSS_SOLVER_CONTRADICTION if it has no solution
+ */
+picrossSolverResult_t picrossSolverRun(picrossSolver_t* solver)
+{
+    picrossSolverResult_t result;
+    do
+    {
+        result = picrossSolverStep(solver, MAX_LINES);
+    } while (PICROSS_SOLVER_WORKING == result || PICROSS_SOLVER_PROGRESS == result);
+    return result;
+}
+
+/**
+ * @brief Get the first cell forced by the last step, if it made progress
+ *
+ * @param solver The solver
+ * @param[out] x The cell's column
+ * @param[out] y The cell's row
+ * @param[out] filled true if the cell must be filled, false if it must be empty
+ * @return true if a cell was written, false if the last step didn't make progress
+ */
+bool picrossSolverLastCell(const picrossSolver_t* solver, uint8_t* x, uint8_t* y, bool* filled)
+{
+    if (solver->lastLine < 0)
+    {
+        return false;
+    }
+
+    // Prefer filled cells, since those are the ones the player has to enter
+    uint16_t cells = solver->lastFilled ? solver->lastFilled : solver->lastEmpty;
+    int i          = __builtin_ctz(cells);
+    bool isRow     = solver->lastLine < PICROSS_SOLVER_MAX_SIZE;
+    int index      = isRow ? solver->lastLine : solver->lastLine - PICROSS_SOLVER_MAX_SIZE;
+
+    *x      = isRow ? i : index;
+    *y      = isRow ? index : i;
+    *filled = 0 != solver->lastFilled;
+    return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// This file is shared with tools/assets_preprocessor, so it must not depend on anything from the rest of the firmware
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// @brief The largest puzzle dimension supported by the solver, so a line fits in a uint16_t
+#define PICROSS_SOLVER_MAX_SIZE 16
+
+/// @brief The most clues a single line can have
+#define PICROSS_SOLVER_MAX_CLUES 8
+
+//==============================================================================
+// Enums
+//==============================================================================
+
+typedef enum
+{
+    /// @brief There are still lines to solve, call picrossSolverStep() again
+    PICROSS_SOLVER_WORKING,
+    /// @brief The last line solved forced new cells, which can be read with picrossSolverLastCell()
+    PICROSS_SOLVER_PROGRESS,
+    /// @brief No more cells can be forced by solving single lines
+    PICROSS_SOLVER_STUCK,
+    /// @brief Every cell is known
+    PICROSS_SOLVER_SOLVED,
+    /// @brief The known cells don't match the clues
+    PICROSS_SOLVER_CONTRADICTION,
+} picrossSolverResult_t;
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief State for an incremental line solver.
+ *
+ * Known cells are cached both by row and by column as bitsets, so any line can be read without walking the grid.
+ * Only lines with a cell which changed since they were last solved are solved again.
+ */
+typedef struct
+{
+    /// @brief The width of the puzzle
+    uint8_t width;
+
+    /// @brief The height of the puzzle
+    uint8_t height;
+
+    /// @brief Clues for each line. Rows are lines 0 to PICROSS_SOLVER_MAX_SIZE - 1, columns are the rest
+    uint8_t clues[PICROSS_SOLVER_MAX_SIZE * 2][PICROSS_SOLVER_MAX_CLUES];
+
+    /// @brief The number of clues for each line
+    uint8_t clueCounts[PICROSS_SOLVER_MAX_SIZE * 2];
+
+    /// @brief Cells known to be filled in each row, bit x
+    uint16_t rowFilled[PICROSS_SOLVER_MAX_SIZE];
+
+    /// @brief Cells known to be empty in each row, bit x
+    uint16_t rowEmpty[PICROSS_SOLVER_MAX_SIZE];
+
+    /// @brief Cells known to be filled in each column, bit y
+    uint16_t colFilled[PICROSS_SOLVER_MAX_SIZE];
+
+    /// @brief Cells known to be empty in each column, bit y
+    uint16_t colEmpty[PICROSS_SOLVER_MAX_SIZE];
+
+    /// @brief Bitmask of lines which need to be solved again
+    uint32_t dirty;
+
+    /// @brief The next line to check for being dirty, so rows and columns take turns
+    uint8_t nextLine;
+
+    /// @brief The line which made progress in the last step, or -1
+    int8_t lastLine;
+
+    /// @brief Cells in lastLine which the last step found to be filled
+    uint16_t lastFilled;
+
+    /// @brief Cells in lastLine which the last step found to be empty
+    uint16_t lastEmpty;
+} picrossSolver_t;
+
+//==============================================================================
+// Function Declarations
+//==============================================================================
+
+bool picrossSolveLine(const uint8_t* clues, int count, int len, uint16_t* filled, uint16_t* empty);
+int picrossCluesFromLine(uint16_t filled, int len, uint8_t* clues);
+
+void picrossSolverInit(picrossSolver_t* solver, uint8_t width, uint8_t height);
+bool picrossSolverSetClues(picrossSolver_t* solver, bool isRow, uint8_t index, const uint8_t* clues, uint8_t count);
+void picrossSolverSetCell(picrossSolver_t* solver, uint8_t x, uint8_t y, bool filled);
+picrossSolverResult_t picrossSolverStep(picrossSolver_t* solver, int maxLines);
+picrossSolverResult_t picrossSolverRun(picrossSolver_t* solver);
+bool picrossSolverLastCell(const picrossSolver_t* solver, uint8_t* x, uint8_t* y, bool* filled);
@@ -410,6 +410,121 @@ bool setupSudokuGame(sudokuGrid_t* game, sudokuMode_t mode, int base, int size)
     }
 }
 
+/**
+ * @brief Start filling an empty game from setupSudokuGame() with a newly generated puzzle, using its box layout. The
+ * work is done by calling stepSudokuGenerator() once per frame until it finishes.
+ *
+ * @param[out] gen The generator to start
+ * @param game The game to fill, which must have the same size and base
+ * @param rating The difficulty rating to aim for
+ * @param attempts The number of puzzles to generate while looking for one with exactly the given rating
+ * @return true if generation started, false if the game can't be generated or memory ran out
+ */
+bool startSudokuGenerator(sudokuGenerator_t* gen, const sudokuGrid_t* game, sudokuRating_t rating, int attempts)
+{
+    memset(gen, 0, sizeof(sudokuGenerator_t));
+
+    if (game->size != game->base || game->base > SUDOKU_SOLVER_MAX_BASE)
+    {
+        ESP_LOGE("Swadgedoku", "Can't generate puzzle for %dx%d grid with base %d", game->size, game->size,
+                 game->base);
+        return false;
+    }
+
+    // The solver's working memory is several kilobytes, which is too much for the main task's stack
+    int totalSquares = game->size * game->size;
+    gen->work        = heap_caps_malloc(sudokuSolverWorkSize(), MALLOC_CAP_8BIT);
+    gen->puzzle      = heap_caps_malloc(2 * totalSquares, MALLOC_CAP_8BIT);
+    if (NULL == gen->work || NULL == gen->puzzle)
+    {
+        ESP_LOGE("Swadgedoku", "Couldn't allocate memory to generate a puzzle");
+        stopSudokuGenerator(gen);
+        return false;
+    }
+
+    gen->best         = gen->puzzle + totalSquares;
+    gen->rating       = rating;
+    gen->bestRating   = SUDOKU_RATING_INVALID;
+    gen->attemptsLeft = attempts;
+    gen->seed         = esp_random();
+    return true;
+}
+
+/**
+ * @brief Do one frame's worth of generating a puzzle. Starting an attempt fills in a random solution, and each call
+ * after that tries removing up to the given number of givens. Once every attempt is done, or one got the rating aimed
+ * for, the best puzzle is written to the game and the generator is stopped.
+ *
+ * @param gen The generator started with startSudokuGenerator()
+ * @param game The game passed to startSudokuGenerator()
+ * @param givens The most givens to try removing in this call
+ * @return SUDOKU_GENERATE_RUNNING if there's more to do, SUDOKU_GENERATE_DONE if the game was filled, or
+ * SUDOKU_GENERATE_FAILED if the game's box layout could not be solved
+ */
+sudokuGenerateState_t stepSudokuGenerator(sudokuGenerator_t* gen, sudokuGrid_t* game, int givens)
+{
+    if (gen->attemptRunning)
+    {
+        if (sudokuGenerateStep(gen->work, givens))
+        {
+            gen->attemptRunning = false;
+
+            sudokuRating_t got = sudokuGenerateEnd(gen->work);
+            if (got > gen->bestRating)
+            {
+                gen->bestRating = got;
+                memcpy(gen->best, gen->puzzle, game->size * game->size);
+            }
+        }
+        return SUDOKU_GENERATE_RUNNING;
+    }
+
+    if (gen->attemptsLeft > 0 && gen->bestRating != gen->rating)
+    {
+        // Filling in the solution is the most expensive part of an attempt, so it gets a frame of its own
+        // Void squares are marked in the box map, so the solver skips them
+        gen->attemptsLeft--;
+        gen->attemptRunning = sudokuGenerateBegin(gen->puzzle, NULL, game->boxMap, game->base, gen->rating, &gen->seed,
+                                                  gen->work);
+        return SUDOKU_GENERATE_RUNNING;
+    }
+
+    sudokuRating_t bestRating = gen->bestRating;
+    if (SUDOKU_RATING_INVALID == bestRating)
+    {
+        ESP_LOGE("Swadgedoku", "Couldn't generate a puzzle for this box layout");
+        stopSudokuGenerator(gen);
+        return SUDOKU_GENERATE_FAILED;
+    }
+
+    ESP_LOGI("Swadgedoku", "Generated %s puzzle, wanted %s", sudokuRatingName(bestRating),
+             sudokuRatingName(gen->rating));
+
+    for (int i = 0; i < game->size * game->size; i++)
+    {
+        game->grid[i] = gen->best[i];
+        if (gen->best[i])
+        {
+            game->flags[i] |= SF_LOCKED;
+        }
+    }
+
+    stopSudokuGenerator(gen);
+    return SUDOKU_GENERATE_DONE;
+}
+
+/**
+ * @brief Free a generator's memory, whether or not it finished. Does nothing if it isn't running.
+ *
+ * @param gen The generator to stop
+ */
+void stopSudokuGenerator(sudokuGenerator_t* gen)
+{
+    heap_caps_free(gen->work);
+    heap_caps_free(gen->puzzle);
+    memset(gen, 0, sizeof(sudokuGenerator_t));
+}
+
 void setupSudokuPlayer(sudokuPlayer_t* player, const sudokuGrid_t* game)
 {
     if (player->notes != NULL)
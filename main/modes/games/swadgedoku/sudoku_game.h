@@ -5,6 +5,7 @@
 //==============================================================================
 
 #include "sudoku_data.h"
+#include "sudoku_solver.h"
 
 //==============================================================================
 // Enums
@@ -17,6 +18,45 @@ typedef enum
     SUDOKU_COMPLETE   = 1,
 } sudokuWinState_t;
 
+typedef enum
+{
+    SUDOKU_GENERATE_FAILED  = -1,
+    SUDOKU_GENERATE_RUNNING = 0,
+    SUDOKU_GENERATE_DONE    = 1,
+} sudokuGenerateState_t;
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/// @brief State for generating a puzzle a little at a time, so a large grid doesn't stall the main loop
+typedef struct
+{
+    /// @brief The solver's working memory, or NULL if not generating
+    sudokuSolverWork_t* work;
+
+    /// @brief The puzzle for the current attempt
+    uint8_t* puzzle;
+
+    /// @brief The best puzzle from the finished attempts, in the same allocation as puzzle
+    uint8_t* best;
+
+    /// @brief The difficulty rating to aim for
+    sudokuRating_t rating;
+
+    /// @brief The rating of best, or SUDOKU_RATING_INVALID if no attempt has finished
+    sudokuRating_t bestRating;
+
+    /// @brief The number of attempts left to start
+    int attemptsLeft;
+
+    /// @brief Whether an attempt has been started and still has givens to try removing
+    bool attemptRunning;
+
+    /// @brief The random seed shared by all attempts
+    uint32_t seed;
+} sudokuGenerator_t;
+
 //==============================================================================
 // Function Declarations
 //==============================================================================
@@ -24,6 +64,9 @@ typedef enum
 bool initSudokuGame(sudokuGrid_t* game, int size, int base, sudokuMode_t mode);
 void deinitSudokuGame(sudokuGrid_t* game);
 bool setupSudokuGame(sudokuGrid_t* game, sudokuMode_t mode, int base, int size);
+bool startSudokuGenerator(sudokuGenerator_t* gen, const sudokuGrid_t* game, sudokuRating_t rating, int attempts);
+sudokuGenerateState_t stepSudokuGenerator(sudokuGenerator_t* gen, sudokuGrid_t* game, int givens);
+void stopSudokuGenerator(sudokuGenerator_t* gen);
 void setupSudokuPlayer(sudokuPlayer_t* player, const sudokuGrid_t* game);
 void sudokuReevaluatePeers(uint16_t* notes, const sudokuGrid_t* game, int row, int col, int flags);
 void sudokuGetNotes(uint16_t* notes, const sudokuGrid_t* game, int flags);
@@ -0,0 +1,943 @@
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include "sudoku_solver.h"
+
+#include <stddef.h>
+#include <string.h>
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// @brief Every square is in one row, one column, and at most one box
+#define UNITS_PER_SQUARE 3
+
+/// @brief The largest number of rows, columns, and boxes in a grid
+#define MAX_UNITS (SUDOKU_SOLVER_MAX_BASE * UNITS_PER_SQUARE)
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/// @brief Working state for the solver, tracking which digits are used in every row, column, and box
+typedef struct
+{
+    /// @brief The number of digits, rows, columns, and boxes
+    int base;
+
+    /// @brief The total number of squares in the grid
+    int squares;
+
+    /// @brief The number of non-void squares which don't have a digit yet
+    int emptyCount;
+
+    /// @brief A mask with one bit set for every digit
+    uint16_t allDigits;
+
+    /// @brief The digit in each square, or 0 if empty
+    uint8_t cells[SUDOKU_SOLVER_MAX_SQUARES];
+
+    /// @brief The box each square belongs to, or SUDOKU_SOLVER_VOID
+    uint8_t boxes[SUDOKU_SOLVER_MAX_SQUARES];
+
+    /// @brief Bitmask of the digits already placed in each row
+    uint16_t rowUsed[SUDOKU_SOLVER_MAX_BASE];
+
+    /// @brief Bitmask of the digits already placed in each column
+    uint16_t colUsed[SUDOKU_SOLVER_MAX_BASE];
+
+    /// @brief Bitmask of the digits already placed in each box
+    uint16_t boxUsed[SUDOKU_SOLVER_MAX_BASE];
+} solverState_t;
+
+/// @brief Extra state used when rating a puzzle by solving it like a human would
+typedef struct
+{
+    /// @brief Digits ruled out of each square by techniques other than direct conflicts
+    uint16_t eliminated[SUDOKU_SOLVER_MAX_SQUARES];
+
+    /// @brief The squares in each row, column, and box, not including void squares
+    uint8_t unitSquares[MAX_UNITS][SUDOKU_SOLVER_MAX_BASE];
+
+    /// @brief The number of squares in each unit
+    uint8_t unitLens[MAX_UNITS];
+
+    /// @brief The row, column, and box unit indices for each square
+    uint8_t squareUnits[SUDOKU_SOLVER_MAX_SQUARES][UNITS_PER_SQUARE];
+
+    /// @brief The total number of units
+    int unitCount;
+} solverLogic_t;
+
+/// @brief Working memory for generating puzzles. It's several kilobytes, so the caller allocates it on the heap
+struct sudokuSolverWork
+{
+    /// @brief The state of the puzzle being generated
+    solverState_t st;
+
+    /// @brief The state used to check that the puzzle is still unique after removing a given
+    solverState_t check;
+
+    /// @brief The state used to rate the puzzle after removing a given
+    solverLogic_t logic;
+
+    /// @brief The random solution the puzzle is made from
+    uint8_t full[SUDOKU_SOLVER_MAX_SQUARES];
+
+    /// @brief The order to try removing givens in
+    uint8_t order[SUDOKU_SOLVER_MAX_SQUARES];
+
+    /// @brief The puzzle being generated, owned by the caller of sudokuGenerateBegin()
+    uint8_t* puzzle;
+
+    /// @brief The box map of the puzzle being generated
+    const uint8_t* boxMap;
+
+    /// @brief The base of the puzzle being generated
+    int base;
+
+    /// @brief The hardest rating to allow
+    sudokuRating_t maxRating;
+
+    /// @brief The number of squares in order
+    int orderLen;
+
+    /// @brief The index in order of the next given to try removing
+    int next;
+};
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static uint32_t solverRand(uint32_t* seed);
+static int countBits(uint16_t mask);
+static bool solverInit(solverState_t* st, const uint8_t* grid, const uint8_t* boxMap, int base);
+static void solverPlace(solverState_t* st, int square, int digit);
+static void solverUnplace(solverState_t* st, int square);
+static uint16_t solverCandidates(const solverState_t* st, int square);
+static int solverPickDigit(uint16_t* tries, uint32_t* seed);
+static int solverSearch(solverState_t* st, int limit, uint32_t* seed, uint8_t* solution, int32_t budget);
+static void logicInit(solverLogic_t* logic, const solverState_t* st);
+static bool logicNakedSingles(solverState_t* st, const solverLogic_t* logic);
+static bool logicHiddenSingles(solverState_t* st, const solverLogic_t* logic);
+static bool logicLockedCandidates(const solverState_t* st, solverLogic_t* logic);
+static bool logicNakedPairs(const solverState_t* st, solverLogic_t* logic);
+static sudokuRating_t logicRate(solverState_t* st, solverLogic_t* logic);
+
+//==============================================================================
+// Static Functions
+//==============================================================================
+
+/**
+ * @brief Same LCG as swadgedokuRand(), so that puzzles from a given seed match between the tools and the Swadge
+ *
+ * @param seed The seed to advance
+ * @return A random number from 0 to 0x7FFF
+ */
+static uint32_t solverRand(uint32_t* seed)
+{
+    *seed = *seed * 0x343FD + 0x269EC3;
+    return (*seed >> 16) & 0x7FFF;
+}
+
+static int countBits(uint16_t mask)
+{
+    return __builtin_popcount(mask);
+}
+
+/**
+ * @brief Set up the solver state for a grid, checking that the givens don't already conflict
+ *
+ * @param st The state to initialize
+ * @param grid The size*size grid of digits, 0 for empty squares
+ * @param boxMap The size*size map of boxes, or NULL to use square boxes
+ * @param base The number of digits, which must also be the size of the grid
+ * @return true if the state was set up, false if the grid is invalid
+ */
+static bool solverInit(solverState_t* st, const uint8_t* grid, const uint8_t* boxMap, int base)
+{
+    if (base < 1 || base > SUDOKU_SOLVER_MAX_BASE)
+    {
+        return false;
+    }
+
+    memset(st, 0, sizeof(solverState_t));
+    st->base      = base;
+    st->squares   = base * base;
+    st->allDigits = (uint16_t)((1 << base) - 1);
+
+    if (NULL == boxMap)
+    {
+        if (!sudokuSolverSquareBoxes(st->boxes, base))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < st->squares; i++)
+        {
+            if (boxMap[i] != SUDOKU_SOLVER_VOID && boxMap[i] >= base)
+            {
+                return false;
+            }
+            st->boxes[i] = boxMap[i];
+        }
+    }
+
+    for (int i = 0; i < st->squares; i++)
+    {
+        if (SUDOKU_SOLVER_VOID == st->boxes[i])
+        {
+            continue;
+        }
+
+        int digit = grid[i];
+        if (0 == digit)
+        {
+            st->emptyCount++;
+        }
+        else if (digit > base || 0 == (solverCandidates(st, i) & (1 << (digit - 1))))
+        {
+            // Out of range, or the digit is already in this row, column, or box
+            return false;
+        }
+        else
+        {
+            // solverPlace() counts the square as filled, so count it as empty first
+            st->emptyCount++;
+            solverPlace(st, i, digit);
+        }
+    }
+
+    return true;
+}
+
+static void solverPlace(solverState_t* st, int square, int digit)
+{
+    uint16_t bit = 1 << (digit - 1);
+    uint8_t box  = st->boxes[square];
+
+    st->cells[square] = digit;
+    st->rowUsed[square / st->base] |= bit;
+    st->colUsed[square % st->base] |= bit;
+    if (SUDOKU_SOLVER_VOID != box)
+    {
+        st->boxUsed[box] |= bit;
+    }
+    st->emptyCount--;
+}
+
+static void solverUnplace(solverState_t* st, int square)
+{
+    uint16_t bit = ~(1 << (st->cells[square] - 1));
+    uint8_t box  = st->boxes[square];
+
+    st->cells[square] = 0;
+    st->rowUsed[square / st->base] &= bit;
+    st->colUsed[square % st->base] &= bit;
+    if (SUDOKU_SOLVER_VOID != box)
+    {
+        st->boxUsed[box] &= bit;
+    }
+    st->emptyCount++;
+}
+
+static uint16_t solverCandidates(const solverState_t* st, int square)
+{
+    uint16_t used = st->rowUsed[square / st->base] | st->colUsed[square % st->base];
+    uint8_t box   = st->boxes[square];
+    if (SUDOKU_SOLVER_VOID != box)
+    {
+        used |= st->boxUsed[box];
+    }
+    return st->allDigits & ~used;
+}
+
+/**
+ * @brief Remove one digit from a mask of digits left to try, either the lowest or a random one
+ *
+ * @param tries The mask of digits to pick from, which will have the picked digit removed
+ * @param seed The random seed to use, or NULL to pick the lowest digit
+ * @return The digit picked, from 1 to base
+ */
+static int solverPickDigit(uint16_t* tries, uint32_t* seed)
+{
+    int skip      = seed ? (int)(solverRand(seed) % countBits(*tries)) : 0;
+    uint16_t mask = *tries;
+    while (skip-- > 0)
+    {
+        // Clear the lowest set bit
+        mask &= mask - 1;
+    }
+
+    int bit = __builtin_ctz(mask);
+    *tries &= ~(1 << bit);
+    return bit + 1;
+}
+
+/**
+ * @brief Depth-first search for solutions, always branching on the square with the fewest candidates.
+ *
+ * This uses an explicit stack rather than recursion so a 16x16 grid doesn't need a deep call stack on the Swadge.
+ * The state is left in an unspecified condition afterwards.
+ *
+ * @param st The state to search from
+ * @param limit Stop searching after this many solutions are found
+ * @param seed A random seed to try digits in random order, or NULL to try them in order
+ * @param[out] solution If not NULL, the first solution found is written here
+ * @param budget The maximum number of branches to take before giving up
+ * @return The number of solutions found, up to limit, or -1 if the budget ran out first
+ */
+static int solverSearch(solverState_t* st, int limit, uint32_t* seed, uint8_t* solution, int32_t budget)
+{
+    uint8_t stackSquares[SUDOKU_SOLVER_MAX_SQUARES];
+    uint16_t stackTries[SUDOKU_SOLVER_MAX_SQUARES];
+    int depth = 0;
+    int count = 0;
+
+    while (true)
+    {
+        // Find the empty square with the fewest candidates
+        int best            = -1;
+        int bestCount       = st->base + 1;
+        uint16_t bestDigits = 0;
+        for (int i = 0; i < st->squares && bestCount > 1; i++)
+        {
+            if (0 == st->cells[i] && SUDOKU_SOLVER_VOID != st->boxes[i])
+            {
+                uint16_t digits = solverCandidates(st, i);
+                int n           = countBits(digits);
+                if (n < bestCount)
+                {
+                    best       = i;
+                    bestCount  = n;
+                    bestDigits = digits;
+                }
+            }
+        }
+
+        bool backtrack = false;
+        if (best < 0)
+        {
+            // Every square is filled, so this is a solution
+            if (0 == count++ && NULL != solution)
+            {
+                memcpy(solution, st->cells, st->squares);
+            }
+
+            if (count >= limit)
+            {
+                return count;
+            }
+            backtrack = true;
+        }
+        else if (0 == bestCount)
+        {
+            // Dead end
+            backtrack = true;
+        }
+        else
+        {
+            if (--budget < 0)
+            {
+                return -1;
+            }
+
+            stackSquares[depth] = best;
+            stackTries[depth]   = bestDigits;
+            depth++;
+        }
+
+        if (backtrack)
+        {
+            // Undo squares until one is found with more digits left to try
+            while (depth > 0)
+            {
+                solverUnplace(st, stackSquares[depth - 1]);
+                if (stackTries[depth - 1])
+                {
+                    break;
+                }
+                depth--;
+            }
+
+            if (0 == depth)
+            {
+                // The whole tree was searched
+                return count;
+            }
+        }
+
+        solverPlace(st, stackSquares[depth - 1], solverPickDigit(&stackTries[depth - 1], seed));
+    }
+}
+
+/**
+ * @brief Build the list of rows, columns, and boxes for the logical solver
+ *
+ * @param logic The logic state to initialize
+ * @param st The solver state to read the grid shape from
+ */
+static void logicInit(solverLogic_t* logic, const solverState_t* st)
+{
+    memset(logic, 0, sizeof(solverLogic_t));
+    logic->unitCount = st->base * UNITS_PER_SQUARE;
+
+    for (int i = 0; i < st->squares; i++)
+    {
+        uint8_t box = st->boxes[i];
+        if (SUDOKU_SOLVER_VOID == box)
+        {
+            continue;
+        }
+
+        uint8_t units[UNITS_PER_SQUARE] = {
+            i / st->base,
+            st->base + i % st->base,
+            st->base * 2 + box,
+        };
+
+        for (int u = 0; u < UNITS_PER_SQUARE; u++)
+        {
+            uint8_t unit             = units[u];
+            logic->squareUnits[i][u] = unit;
+
+            logic->unitSquares[unit][logic->unitLens[unit]++] = i;
+        }
+    }
+}
+
+/**
+ * @brief Fill in every square which only has one candidate left
+ *
+ * @return true if any digits were placed
+ */
+static bool logicNakedSingles(solverState_t* st, const solverLogic_t* logic)
+{
+    bool progress = false;
+    for (int i = 0; i < st->squares; i++)
+    {
+        if (0 == st->cells[i] && SUDOKU_SOLVER_VOID != st->boxes[i])
+        {
+            uint16_t digits = solverCandidates(st, i) & ~logic->eliminated[i];
+            if (1 == countBits(digits))
+            {
+                solverPlace(st, i, __builtin_ctz(digits) + 1);
+                progress = true;
+            }
+        }
+    }
+    return progress;
+}
+
+/**
+ * @brief Fill in every digit which only has one possible square left in a row, column, or box
+ *
+ * @return true if any digits were placed
+ */
+static bool logicHiddenSingles(solverState_t* st, const solverLogic_t* logic)
+{
+    bool progress = false;
+    for (int u = 0; u < logic->unitCount; u++)
+    {
+        // Units with void squares don't need to contain every digit
+        if (logic->unitLens[u] != st->base)
+        {
+            continue;
+        }
+
+        uint16_t placed = 0;
+        for (int n = 0; n < logic->unitLens[u]; n++)
+        {
+            uint8_t digit = st->cells[logic->unitSquares[u][n]];
+            if (digit)
+            {
+                placed |= 1 << (digit - 1);
+            }
+        }
+
+        for (int digit = 1; digit <= st->base; digit++)
+        {
+            uint16_t bit = 1 << (digit - 1);
+            if (placed & bit)
+            {
+                continue;
+            }
+
+            int count  = 0;
+            int square = -1;
+            for (int n = 0; n < logic->unitLens[u] && count < 2; n++)
+            {
+                int i = logic->unitSquares[u][n];
+                if (0 == st->cells[i] && (solverCandidates(st, i) & ~logic->eliminated[i] & bit))
+                {
+                    count++;
+                    square = i;
+                }
+            }
+
+            if (1 == count)
+            {
+                solverPlace(st, square, digit);
+                placed |= bit;
+                progress = true;
+            }
+        }
+    }
+    return progress;
+}
+
+/**
+ * @brief If every candidate square for a digit in one unit is also in a second unit, the digit can be eliminated
+ * from the rest of the second unit. This covers pointing pairs and box/line reduction, and works for jigsaw boxes.
+ *
+ * @return true if any candidates were eliminated
+ */
+static bool logicLockedCandidates(const solverState_t* st, solverLogic_t* logic)
+{
+    bool progress = false;
+    for (int u = 0; u < logic->unitCount; u++)
+    {
+        if (logic->unitLens[u] != st->base)
+        {
+            continue;
+        }
+
+        for (int digit = 1; digit <= st->base; digit++)
+        {
+            uint16_t bit = 1 << (digit - 1);
+
+            // Collect the squares in this unit where the digit could go
+            uint8_t squares[SUDOKU_SOLVER_MAX_BASE];
+            int count = 0;
+            for (int n = 0; n < logic->unitLens[u]; n++)
+            {
+                int i = logic->unitSquares[u][n];
+                if (st->cells[i] == digit)
+                {
+                    // Already placed
+                    count = 0;
+                    break;
+                }
+                else if (0 == st->cells[i] && (solverCandidates(st, i) & ~logic->eliminated[i] & bit))
+                {
+                    squares[count++] = i;
+                }
+            }
+
+            if (count < 2)
+            {
+                // Singles are handled elsewhere
+                continue;
+            }
+
+            // Check each other unit of the first square to see if it holds all the others
+            for (int k = 0; k < UNITS_PER_SQUARE; k++)
+            {
+                uint8_t other = logic->squareUnits[squares[0]][k];
+                if (other == u)
+                {
+                    continue;
+                }
+
+                bool allInOther = true;
+                for (int n = 1; n < count && allInOther; n++)
+                {
+                    allInOther = false;
+                    for (int m = 0; m < UNITS_PER_SQUARE; m++)
+                    {
+                        if (logic->squareUnits[squares[n]][m] == other)
+                        {
+                            allInOther = true;
+                        }
+                    }
+                }
+
+                if (!allInOther)
+                {
+                    continue;
+                }
+
+                // Eliminate the digit from the squares in the other unit which aren't in this one
+                for (int n = 0; n < logic->unitLens[other]; n++)
+                {
+                    int i = logic->unitSquares[other][n];
+                    if (0 != st->cells[i] || 0 == (solverCandidates(st, i) & ~logic->eliminated[i] & bit))
+                    {
+                        continue;
+                    }
+
+                    bool inThisUnit = false;
+                    for (int m = 0; m < UNITS_PER_SQUARE; m++)
+                    {
+                        if (logic->squareUnits[i][m] == u)
+                        {
+                            inThisUnit = true;
+                        }
+                    }
+
+                    if (!inThisUnit)
+                    {
+                        logic->eliminated[i] |= bit;
+                        progress = true;
+                    }
+                }
+            }
+        }
+    }
+    return progress;
+}
+
+/**
+ * @brief If two squares in a unit have the same two candidates, those digits can be eliminated from the rest of it
+ *
+ * @return true if any candidates were eliminated
+ */
+static bool logicNakedPairs(const solverState_t* st, solverLogic_t* logic)
+{
+    bool progress = false;
+    for (int u = 0; u < logic->unitCount; u++)
+    {
+        for (int a = 0; a < logic->unitLens[u]; a++)
+        {
+            int sqA = logic->unitSquares[u][a];
+            if (st->cells[sqA])
+            {
+                continue;
+            }
+
+            uint16_t pair = solverCandidates(st, sqA) & ~logic->eliminated[sqA];
+            if (2 != countBits(pair))
+            {
+                continue;
+            }
+
+            for (int b = a + 1; b < logic->unitLens[u]; b++)
+            {
+                int sqB = logic->unitSquares[u][b];
+                if (st->cells[sqB] || pair != (solverCandidates(st, sqB) & ~logic->eliminated[sqB]))
+                {
+                    continue;
+                }
+
+                for (int n = 0; n < logic->unitLens[u]; n++)
+                {
+                    int i = logic->unitSquares[u][n];
+                    if (i != sqA && i != sqB && 0 == st->cells[i]
+                        && (solverCandidates(st, i) & ~logic->eliminated[i] & pair))
+                    {
+                        logic->eliminated[i] |= pair;
+                        progress = true;
+                    }
+                }
+            }
+        }
+    }
+    return progress;
+}
+
+/**
+ * @brief Solve a puzzle one technique at a time, always using the easiest one which makes progress
+ *
+ * @param st The solver state for a puzzle already known to have a unique solution
+ * @param logic Space for the extra state used while rating
+ * @return The rating of the hardest technique needed
+ */
+static sudokuRating_t logicRate(solverState_t* st, solverLogic_t* logic)
+{
+    logicInit(logic, st);
+
+    sudokuRating_t rating = SUDOKU_RATING_SIMPLE;
+    while (st->emptyCount > 0)
+    {
+        if (logicNakedSingles(st, logic))
+        {
+            continue;
+        }
+
+        if (logicHiddenSingles(st, logic))
+        {
+            if (rating < SUDOKU_RATING_EASY)
+            {
+                rating = SUDOKU_RATING_EASY;
+            }
+            continue;
+        }
+
+        if (logicLockedCandidates(st, logic) || logicNakedPairs(st, logic))
+        {
+            if (rating < SUDOKU_RATING_INTERMEDIATE)
+            {
+                rating = SUDOKU_RATING_INTERMEDIATE;
+            }
+            continue;
+        }
+
+        return SUDOKU_RATING_EXPERT;
+    }
+
+    return rating;
+}
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+/**
+ * @brief Fill out a box map with standard square boxes, the same way setupSudokuGame() does
+ *
+ * @param[out] boxMap A base*base array to write box indices to
+ * @param base The number of digits, which must be a square number
+ * @return true if the boxes were written, false if base is not square
+ */
+bool sudokuSolverSquareBoxes(uint8_t* boxMap, int base)
+{
+    int baseRoot = 1;
+    while (baseRoot * baseRoot < base)
+    {
+        baseRoot++;
+    }
+
+    if (baseRoot * baseRoot != base)
+    {
+        return false;
+    }
+
+    for (int box = 0; box < base; box++)
+    {
+        for (int n = 0; n < base; n++)
+        {
+            int x                = (box % baseRoot) * baseRoot + (n % baseRoot);
+            int y                = (box / baseRoot) * baseRoot + (n / baseRoot);
+            boxMap[y * base + x] = box;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Count the solutions to a puzzle
+ *
+ * @param grid The base*base grid of digits, 0 for empty squares
+ * @param boxMap The base*base map of box indices, SUDOKU_SOLVER_VOID for void squares, or NULL for square boxes
+ * @param base The number of digits, which must also be the size of the grid
+ * @param limit Stop counting after this many solutions. Use 2 to check that a puzzle has a unique solution
+ * @param[out] solution If not NULL, the first solution found is written here
+ * @param budget The maximum number of branches to search, to bound the time spent on very open grids
+ * @return The number of solutions found, up to limit, or -1 if the budget ran out first
+ */
+int sudokuCountSolutions(const uint8_t* grid, const uint8_t* boxMap, int base, int limit, uint8_t* solution,
+                         int32_t budget)
+{
+    solverState_t st;
+    if (!solverInit(&st, grid, boxMap, base))
+    {
+        return 0;
+    }
+
+    return solverSearch(&st, limit, NULL, solution, budget);
+}
+
+/**
+ * @brief Rate a puzzle's difficulty by solving it one technique at a time, always using the easiest one which makes
+ * progress. Puzzles which can't be solved without guessing are rated SUDOKU_RATING_EXPERT.
+ *
+ * @param grid The base*base grid of digits, 0 for empty squares
+ * @param boxMap The base*base map of box indices, SUDOKU_SOLVER_VOID for void squares, or NULL for square boxes
+ * @param base The number of digits, which must also be the size of the grid
+ * @return The rating, or SUDOKU_RATING_INVALID if the puzzle does not have exactly one solution
+ */
+sudokuRating_t sudokuRatePuzzle(const uint8_t* grid, const uint8_t* boxMap, int base)
+{
+    if (1 != sudokuCountSolutions(grid, boxMap, base, 2, NULL, SUDOKU_SOLVER_DEFAULT_BUDGET))
+    {
+        return SUDOKU_RATING_INVALID;
+    }
+
+    solverState_t st;
+    solverLogic_t logic;
+    solverInit(&st, grid, boxMap, base);
+    return logicRate(&st, &logic);
+}
+
+/**
+ * @brief Generate a new puzzle with a unique solution.
+ *
+ * A random solution is filled in first, then givens are removed in random order as long as the puzzle stays unique
+ * and no harder than maxRating. The result is minimal, but may be easier than maxRating, so callers looking for a
+ * particular rating should retry with the same seed pointer until they get it.
+ *
+ * This runs sudokuGenerateBegin(), sudokuGenerateStep() and sudokuGenerateEnd() all at once. Callers which can't
+ * block for long should call those directly and spread the steps out.
+ *
+ * @param[out] puzzle A base*base array to write the puzzle to, 0 for empty squares
+ * @param[out] solution If not NULL, a base*base array to write the solution to
+ * @param boxMap The base*base map of box indices, SUDOKU_SOLVER_VOID for void squares, or NULL for square boxes
+ * @param base The number of digits, which must also be the size of the grid
+ * @param maxRating The hardest rating to allow
+ * @param seed The random seed, which is advanced as it is used
+ * @param work Working memory of at least sudokuSolverWorkSize() bytes, which is too big to keep on a task's stack
+ * @return The rating of the generated puzzle, or SUDOKU_RATING_INVALID if the box map has no solutions
+ */
+sudokuRating_t sudokuGeneratePuzzle(uint8_t* puzzle, uint8_t* solution, const uint8_t* boxMap, int base,
+                                    sudokuRating_t maxRating, uint32_t* seed, sudokuSolverWork_t* work)
+{
+    if (!sudokuGenerateBegin(puzzle, solution, boxMap, base, maxRating, seed, work))
+    {
+        return SUDOKU_RATING_INVALID;
+    }
+
+    while (!sudokuGenerateStep(work, SUDOKU_SOLVER_MAX_SQUARES))
+    {
+    }
+
+    return sudokuGenerateEnd(work);
+}
+
+/**
+ * @brief Start generating a puzzle by filling in a random solution and picking the order to remove givens in. The
+ * puzzle is finished by calling sudokuGenerateStep() until it returns true, then sudokuGenerateEnd().
+ *
+ * @param[out] puzzle A base*base array to write the puzzle to, which must stay valid until sudokuGenerateEnd()
+ * @param[out] solution If not NULL, a base*base array to write the solution to
+ * @param boxMap The base*base map of box indices, SUDOKU_SOLVER_VOID for void squares, or NULL for square boxes. It
+ * must stay valid until sudokuGenerateEnd()
+ * @param base The number of digits, which must also be the size of the grid
+ * @param maxRating The hardest rating to allow
+ * @param seed The random seed, which is advanced as it is used
+ * @param work Working memory of at least sudokuSolverWorkSize() bytes, which is too big to keep on a task's stack
+ * @return true if generation started, false if the box map has no solutions
+ */
+bool sudokuGenerateBegin(uint8_t* puzzle, uint8_t* solution, const uint8_t* boxMap, int base, sudokuRating_t maxRating,
+                         uint32_t* seed, sudokuSolverWork_t* work)
+{
+    solverState_t* st = &work->st;
+    uint8_t* full     = work->full;
+    uint8_t* order    = work->order;
+
+    memset(puzzle, 0, base * base);
+    if (!solverInit(st, puzzle, boxMap, base) || 1 != solverSearch(st, 1, seed, full, SUDOKU_SOLVER_DEFAULT_BUDGET))
+    {
+        return false;
+    }
+
+    memcpy(puzzle, full, st->squares);
+    if (NULL != solution)
+    {
+        memcpy(solution, full, st->squares);
+    }
+
+    // Shuffle the order to try removing givens in
+    int orderLen = 0;
+    for (int i = 0; i < st->squares; i++)
+    {
+        if (SUDOKU_SOLVER_VOID != st->boxes[i])
+        {
+            order[orderLen++] = i;
+        }
+    }
+
+    for (int i = orderLen - 1; i > 0; i--)
+    {
+        int j    = solverRand(seed) % (i + 1);
+        int tmp  = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    work->puzzle    = puzzle;
+    work->boxMap    = boxMap;
+    work->base      = base;
+    work->maxRating = maxRating;
+    work->orderLen  = orderLen;
+    work->next      = 0;
+    return true;
+}
+
+/**
+ * @brief Try removing some of the givens from a puzzle started with sudokuGenerateBegin()
+ *
+ * @param work The working memory passed to sudokuGenerateBegin()
+ * @param givens The most givens to try removing in this call, which bounds the time it takes
+ * @return true if every given has been tried and the puzzle is done, false if there are more to try
+ */
+bool sudokuGenerateStep(sudokuSolverWork_t* work, int givens)
+{
+    uint8_t* puzzle       = work->puzzle;
+    const uint8_t* boxMap = work->boxMap;
+    int base              = work->base;
+
+    for (; givens > 0 && work->next < work->orderLen; givens--, work->next++)
+    {
+        int square     = work->order[work->next];
+        uint8_t digit  = puzzle[square];
+        puzzle[square] = 0;
+
+        // Givens which take too long to prove unnecessary are kept, which bounds the time spent on large grids
+        bool keep = !solverInit(&work->check, puzzle, boxMap, base)
+                    || 1 != solverSearch(&work->check, 2, NULL, NULL, SUDOKU_SOLVER_GENERATE_BUDGET);
+        if (!keep && work->maxRating < SUDOKU_RATING_EXPERT)
+        {
+            solverInit(&work->st, puzzle, boxMap, base);
+            keep = (logicRate(&work->st, &work->logic) > work->maxRating);
+        }
+
+        if (keep)
+        {
+            puzzle[square] = digit;
+        }
+    }
+
+    return work->next >= work->orderLen;
+}
+
+/**
+ * @brief Rate a puzzle once sudokuGenerateStep() has finished it
+ *
+ * @param work The working memory passed to sudokuGenerateBegin()
+ * @return The rating of the generated puzzle
+ */
+sudokuRating_t sudokuGenerateEnd(sudokuSolverWork_t* work)
+{
+    solverInit(&work->st, work->puzzle, work->boxMap, work->base);
+    return logicRate(&work->st, &work->logic);
+}
+
+/**
+ * @brief Get how much working memory sudokuGeneratePuzzle() needs
+ *
+ * @return The size of a ::sudokuSolverWork_t, in bytes
+ */
+size_t sudokuSolverWorkSize(void)
+{
+    return sizeof(sudokuSolverWork_t);
+}
+
+/**
+ * @brief Get the name of a rating, matching the qqwing difficulty names
+ *
+ * @param rating The rating to name
+ * @return The name of the rating
+ */
+const char* sudokuRatingName(sudokuRating_t rating)
+{
+    switch (rating)
+    {
+        case SUDOKU_RATING_SIMPLE:
+            return "simple";
+        case SUDOKU_RATING_EASY:
+            return "easy";
+        case SUDOKU_RATING_INTERMEDIATE:
+            return "intermediate";
+        case SUDOKU_RATING_EXPERT:
+            return "expert";
+        case SUDOKU_RATING_INVALID:
+        default:
+            return "invalid";
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// This file is shared with tools/assets_preprocessor and tools/sudoku_gen, so it must not depend on anything from the
+// rest of the firmware
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// @brief The largest base supported by the solver, so candidates fit in a uint16_t
+#define SUDOKU_SOLVER_MAX_BASE 16
+
+/// @brief The largest number of squares in a grid supported by the solver
+#define SUDOKU_SOLVER_MAX_SQUARES (SUDOKU_SOLVER_MAX_BASE * SUDOKU_SOLVER_MAX_BASE)
+
+/// @brief Box map value for squares which are not part of the puzzle. Matches BOX_NONE in sudoku_data.h
+#define SUDOKU_SOLVER_VOID UINT8_MAX
+
+/// @brief Default number of search nodes to try before giving up on a puzzle
+#define SUDOKU_SOLVER_DEFAULT_BUDGET 200000
+
+/// @brief Number of search nodes to try when checking if a given can be removed while generating a puzzle
+#define SUDOKU_SOLVER_GENERATE_BUDGET 2000
+
+//==============================================================================
+// Enums
+//==============================================================================
+
+/**
+ * @brief Difficulty ratings, based on the hardest technique needed to solve a puzzle without guessing.
+ * These line up with the qqwing difficulty names used by the puzzles in assets/sudoku.
+ */
+typedef enum
+{
+    /// @brief The puzzle has no solution, more than one solution, or was too expensive to check
+    SUDOKU_RATING_INVALID = -1,
+    /// @brief Only naked singles are needed
+    SUDOKU_RATING_SIMPLE = 0,
+    /// @brief Hidden singles are needed
+    SUDOKU_RATING_EASY = 1,
+    /// @brief Pointing pairs, box/line reduction, or naked pairs are needed
+    SUDOKU_RATING_INTERMEDIATE = 2,
+    /// @brief The puzzle can't be solved with the above techniques and requires guessing
+    SUDOKU_RATING_EXPERT = 3,
+} sudokuRating_t;
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/// @brief Working memory for generating puzzles, allocated by the caller with sudokuSolverWorkSize() bytes
+typedef struct sudokuSolverWork sudokuSolverWork_t;
+
+//==============================================================================
+// Function Declarations
+//==============================================================================
+
+bool sudokuSolverSquareBoxes(uint8_t* boxMap, int base);
+int sudokuCountSolutions(const uint8_t* grid, const uint8_t* boxMap, int base, int limit, uint8_t* solution,
+                         int32_t budget);
+sudokuRating_t sudokuRatePuzzle(const uint8_t* grid, const uint8_t* boxMap, int base);
+sudokuRating_t sudokuGeneratePuzzle(uint8_t* puzzle, uint8_t* solution, const uint8_t* boxMap, int base,
+                                    sudokuRating_t maxRating, uint32_t* seed, sudokuSolverWork_t* work);
+bool sudokuGenerateBegin(uint8_t* puzzle, uint8_t* solution, const uint8_t* boxMap, int base, sudokuRating_t maxRating,
+                         uint32_t* seed, sudokuSolverWork_t* work);
+bool sudokuGenerateStep(sudokuSolverWork_t* work, int givens);
+sudokuRating_t sudokuGenerateEnd(sudokuSolverWork_t* work);
+size_t sudokuSolverWorkSize(void);
+const char* sudokuRatingName(sudokuRating_t rating);
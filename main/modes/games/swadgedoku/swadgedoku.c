@@ -24,16 +24,23 @@
 
 #define ONE_SECOND_IN_US (1000000)
 
+/// @brief How many puzzles to generate while looking for one of the selected difficulty
+#define GENERATE_ATTEMPTS 8
+
+/// @brief How many givens to try removing from a generated puzzle each frame, so large grids don't stall the main loop
+#define GENERATE_GIVENS_PER_FRAME 8
+
 //==============================================================================
 // Enums
 //==============================================================================
 
 typedef enum
 {
-    SWADGEDOKU_MAIN_MENU = 0,
-    SWADGEDOKU_GAME      = 1,
-    SWADGEDOKU_WIN       = 2,
-    SWADGEDOKU_PAUSE     = 3,
+    SWADGEDOKU_MAIN_MENU  = 0,
+    SWADGEDOKU_GAME       = 1,
+    SWADGEDOKU_WIN        = 2,
+    SWADGEDOKU_PAUSE      = 3,
+    SWADGEDOKU_GENERATING = 4,
 } sudokuScreen_t;
 
 typedef enum
@@ -59,6 +66,10 @@ typedef struct
 
     sudokuScreen_t screen;
     sudokuGrid_t game;
+
+    /// @brief Fills in game a little each frame while on the SWADGEDOKU_GENERATING screen
+    sudokuGenerator_t generator;
+
     int64_t playTimer;
 
     /// @brief The last (or next) level to play, the default to select
@@ -128,8 +139,11 @@ static bool numberWheelCb(const char* label, bool selected, uint32_t value);
 static void swadgedokuCheckTrophyTriggers(void);
 static void swadgedokuPlayerSetDigit(uint8_t digit);
 static void swadgedokuGameButton(buttonEvt_t evt);
+static bool swadgedokuStartGenerating(void);
+static void swadgedokuStartGeneratedGame(void);
 
 static sudokuDifficulty_t getLevelDifficulty(int level);
+static sudokuRating_t getDifficultyRating(sudokuDifficulty_t difficulty);
 
 //==============================================================================
 // Const data
@@ -166,6 +180,7 @@ static const char menuItemAbandonPuzzle[] = "Abandon Puzzle";
 // Number wheel title
 static const char strSelectDigit[] = "Select Digit";
 static const char strYouWin[]      = "You Win!";
+static const char strGenerating[]  = "Generating...";
 
 static const int32_t menuOptValsCustomSize[] = {
     2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
@@ -454,6 +469,7 @@ static void swadgedokuEnterMode(void)
 
 static void swadgedokuExitMode(void)
 {
+    stopSudokuGenerator(&sd->generator);
     deinitSudokuGame(&sd->game);
 
     void* val = NULL;
@@ -631,6 +647,38 @@ static void swadgedokuMainLoop(int64_t elapsedUs)
             drawMenuMega(sd->pauseMenu, sd->menuRenderer, elapsedUs);
             break;
         }
+
+        case SWADGEDOKU_GENERATING:
+        {
+            // Buttons pressed while waiting would otherwise land in the game once it starts
+            buttonEvt_t evt = {0};
+            while (checkButtonQueueWrapper(&evt))
+            {
+            }
+
+            switch (stepSudokuGenerator(&sd->generator, &sd->game, GENERATE_GIVENS_PER_FRAME))
+            {
+                case SUDOKU_GENERATE_RUNNING:
+                {
+                    break;
+                }
+                case SUDOKU_GENERATE_DONE:
+                {
+                    swadgedokuStartGeneratedGame();
+                    break;
+                }
+                case SUDOKU_GENERATE_FAILED:
+                {
+                    deinitSudokuGame(&sd->game);
+                    sd->screen = SWADGEDOKU_MAIN_MENU;
+                    break;
+                }
+            }
+
+            strncpy(sd->emptyMenuTitle, strGenerating, sizeof(sd->emptyMenuTitle));
+            drawMenuMega(sd->emptyMenu, sd->menuRenderer, elapsedUs);
+            break;
+        }
     }
 }
 
@@ -852,14 +900,10 @@ static bool swadgedokuMainMenuCb(const char* label, bool selected, uint32_t valu
             sd->currentMode       = sd->customModeMenuItem->currentSetting;
             sd->currentDifficulty = sd->customDifficultyMenuItem->currentSetting;
 
-            sd->playTimer           = 0;
-            sd->playingContinuation = false;
-            sd->currentLevelNumber  = -1;
-            setupSudokuPlayer(&sd->player, &sd->game);
-            sudokuGetNotes(sd->game.notes, &sd->game, 0);
-            sudokuAnnotate(&sd->player.overlay, &sd->player, &sd->game, &sd->settings);
-            swadgedokuSetupNumberWheel(sd->game.base, 0);
-            sd->screen = SWADGEDOKU_GAME;
+            if (!swadgedokuStartGenerating())
+            {
+                return false;
+            }
         }
         else if (menuItemPlayJigsaw == label)
         {
@@ -868,14 +912,11 @@ static bool swadgedokuMainMenuCb(const char* label, bool selected, uint32_t valu
                 return false;
             }
 
-            sd->playTimer           = 0;
-            sd->playingContinuation = false;
-            sd->currentLevelNumber  = -1;
-            setupSudokuPlayer(&sd->player, &sd->game);
-            sudokuGetNotes(sd->game.notes, &sd->game, 0);
-            sudokuAnnotate(&sd->player.overlay, &sd->player, &sd->game, &sd->settings);
-            swadgedokuSetupNumberWheel(sd->game.base, 0);
-            sd->screen = SWADGEDOKU_GAME;
+            sd->currentDifficulty = sd->customDifficultyMenuItem->currentSetting;
+            if (!swadgedokuStartGenerating())
+            {
+                return false;
+            }
         }
     }
     else
@@ -987,6 +1028,39 @@ static bool swadgedokuMainMenuCb(const char* label, bool selected, uint32_t valu
     return false;
 }
 
+/**
+ * @brief Start generating a puzzle for the game set up by setupSudokuGame(), at the current difficulty. The game is
+ * freed if generation can't start.
+ *
+ * @return true if the generating screen was shown, false if not
+ */
+static bool swadgedokuStartGenerating(void)
+{
+    if (!startSudokuGenerator(&sd->generator, &sd->game, getDifficultyRating(sd->currentDifficulty), GENERATE_ATTEMPTS))
+    {
+        deinitSudokuGame(&sd->game);
+        return false;
+    }
+
+    sd->screen = SWADGEDOKU_GENERATING;
+    return true;
+}
+
+/**
+ * @brief Start playing once the generator has filled in the game
+ */
+static void swadgedokuStartGeneratedGame(void)
+{
+    sd->playTimer           = 0;
+    sd->playingContinuation = false;
+    sd->currentLevelNumber  = -1;
+    setupSudokuPlayer(&sd->player, &sd->game);
+    sudokuGetNotes(sd->game.notes, &sd->game, 0);
+    sudokuAnnotate(&sd->player.overlay, &sd->player, &sd->game, &sd->settings);
+    swadgedokuSetupNumberWheel(sd->game.base, 0);
+    sd->screen = SWADGEDOKU_GAME;
+}
+
 static bool swadgedokuPauseMenuCb(const char* label, bool selected, uint32_t value)
 {
     if (selected)
@@ -1386,3 +1460,27 @@ static sudokuDifficulty_t getLevelDifficulty(int level)
         return SD_HARD;
     }
 }
+
+/**
+ * @brief Map a difficulty menu setting to the rating used by the puzzle generator
+ *
+ * @param difficulty The difficulty selected in the menu
+ * @return The closest generator rating
+ */
+static sudokuRating_t getDifficultyRating(sudokuDifficulty_t difficulty)
+{
+    switch (difficulty)
+    {
+        case SD_BEGINNER:
+            return SUDOKU_RATING_SIMPLE;
+        case SD_EASY:
+            return SUDOKU_RATING_EASY;
+        case SD_MEDIUM:
+            return SUDOKU_RATING_INTERMEDIATE;
+        case SD_HARD:
+        case SD_EXPERT:
+        case SD_HARDEST:
+        default:
+            return SUDOKU_RATING_EXPERT;
+    }
+}
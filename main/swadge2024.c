@@ -158,6 +158,7 @@
  * - hashMap.h: A data structure for storing data in key-value pairs
  * - macros.h: Convenient macros like MIN() and MAX()
  * - coreutil.h: General utilities for system profiling
+ * - profiler.h: Measure how long named zones of code take each frame, and export them from the emulator
  * - hdw-usb.h: Learn how to be a USB HID Gamepad
  *     - advanced_usb_control.h: Use USB for application development
  *
@@ -447,7 +448,9 @@ void app_main(void)
         {
             trophySystemInit(cSwadgeMode->trophyData, cSwadgeMode->modeName);
         }
+        PROFILE_ZONE_BEGIN("fnEnterMode");
         cSwadgeMode->fnEnterMode();
+        PROFILE_ZONE_END("fnEnterMode");
     }
     cSwadgeModeInit = true;
 
@@ -482,7 +485,9 @@ void app_main(void)
                     newSamp         = CLAMP(newSamp, -32768, 32767);
                     adcSamples[i]   = newSamp;
                 }
+                PROFILE_ZONE_BEGIN("fnAudioCallback");
                 cSwadgeMode->fnAudioCallback(adcSamples, sampleCnt);
+                PROFILE_ZONE_END("fnAudioCallback");
             }
         }
 
@@ -521,7 +526,9 @@ void app_main(void)
                 }
                 mainLoopCallDelay = tNowUs - tLastMainLoopCall;
 
+                PROFILE_ZONE_BEGIN("fnMainLoop");
                 cSwadgeMode->fnMainLoop(mainLoopCallDelay);
+                PROFILE_ZONE_END("fnMainLoop");
                 tLastMainLoopCall = tNowUs;
             }
 
@@ -577,7 +584,9 @@ void app_main(void)
             }
 
             // Draw to the TFT
+            PROFILE_ZONE_BEGIN("drawDisplayTft");
             drawDisplayTft(cSwadgeMode->fnBackgroundDrawCallback);
+            PROFILE_ZONE_END("drawDisplayTft");
         }
 
         // If the mode should be switched, do it now
@@ -602,6 +611,9 @@ void app_main(void)
         // If you want to allow printf() from the ch32v003, you can call this. Note that it takes about 40us every time
         // it's called. ch32v003CheckTerminal();
 
+        // Add this loop's profiling zones to their statistics
+        PROFILE_FRAME_END();
+
         // Yield to let the rest of the RTOS run
         taskYIELD();
     }
@@ -789,6 +801,16 @@ void switchToSwadgeMode(const swadgeMode_t* mode)
     pendingSwadgeMode = mode;
 }
 
+/**
+ * @brief Get the Swadge mode which is currently running
+ *
+ * @return The current Swadge mode
+ */
+const swadgeMode_t* getSwadgeMode(void)
+{
+    return cSwadgeMode;
+}
+
 /**
  * @brief Switch to the pending Swadge mode without restarting the system
  */
@@ -820,7 +842,9 @@ void softSwitchToPendingSwadge(void)
             {
                 trophySystemInit(cSwadgeMode->trophyData, cSwadgeMode->modeName);
             }
+            PROFILE_ZONE_BEGIN("fnEnterMode");
             cSwadgeMode->fnEnterMode();
+            PROFILE_ZONE_END("fnEnterMode");
         }
         cSwadgeModeInit = true;
 
@@ -914,6 +938,7 @@ uint32_t getFrameRateUs(void)
  */
 void dacCallback(uint8_t* samples, int16_t len)
 {
+    PROFILE_ZONE_BEGIN("fnDacCb");
     // If there is a DAC callback for the current mode
     if (cSwadgeModeInit && cSwadgeMode->fnDacCb)
     {
@@ -925,6 +950,7 @@ void dacCallback(uint8_t* samples, int16_t len)
         // Otherwise use the song player
         globalMidiPlayerFillBuffer(samples, len);
     }
+    PROFILE_ZONE_END("fnDacCb");
 }
 
 /**
@@ -225,6 +225,7 @@
 #include "swadgePass.h"
 #include "trophy.h"
 #include "helpPages.h"
+#include "profiler.h"
 
 // Sound utilities
 #include "soundFuncs.h"
@@ -378,6 +379,7 @@ typedef struct swadgeMode
 bool checkButtonQueueWrapper(buttonEvt_t* evt);
 
 void switchToSwadgeMode(const swadgeMode_t* mode);
+const swadgeMode_t* getSwadgeMode(void);
 void softSwitchToPendingSwadge(void);
 
 void deinitSystem(void);
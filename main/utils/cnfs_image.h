@@ -0,0 +1,1363 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t len;    ///< The length of the file
+    uint32_t offset; ///< The offset of the file in cnfs_data[]
+} cnfsFileEntry;
+
+typedef enum
+{
+    _6F_MAG_1_PZL_WSG = 0, ///< 6F-mag1_PZL.wsg
+    _6F_MAG_1_SLV_WSG = 1, ///< 6F-mag1_SLV.wsg
+    _6F_MAG_2_PZL_WSG = 2, ///< 6F-mag2_PZL.wsg
+    _6F_MAG_2_SLV_WSG = 3, ///< 6F-mag2_SLV.wsg
+    _6F_MAG_3_PZL_WSG = 4, ///< 6F-mag3_PZL.wsg
+    _6F_MAG_3_SLV_WSG = 5, ///< 6F-mag3_SLV.wsg
+    _6F_MAGLOGO_PZL_WSG = 6, ///< 6F-maglogo_PZL.wsg
+    _6F_MAGLOGO_SLV_WSG = 7, ///< 6F-maglogo_SLV.wsg
+    _6F_MUSIC_PZL_WSG = 8, ///< 6F-music_PZL.wsg
+    _6F_MUSIC_SLV_WSG = 9, ///< 6F-music_SLV.wsg
+    _8F_FLYINDONUT_PZL_WSG = 10, ///< 8F-flyindonut_PZL.wsg
+    _8F_FLYINDONUT_SLV_WSG = 11, ///< 8F-flyindonut_SLV.wsg
+    _8F_MTYPE_PZL_WSG = 12, ///< 8F-mtype_PZL.wsg
+    _8F_MTYPE_SLV_WSG = 13, ///< 8F-mtype_SLV.wsg
+    _8F_PERSONALDEMON_PZL_WSG = 14, ///< 8F-personaldemon_PZL.wsg
+    _8F_PERSONALDEMON_SLV_WSG = 15, ///< 8F-personaldemon_SLV.wsg
+    _8F_SHREDDER_PZL_WSG = 16, ///< 8F-shredder_PZL.wsg
+    _8F_SHREDDER_SLV_WSG = 17, ///< 8F-shredder_SLV.wsg
+    _8F_STOMP_PZL_WSG = 18, ///< 8F-stomp_PZL.wsg
+    _8F_STOMP_SLV_WSG = 19, ///< 8F-stomp_SLV.wsg
+    _55_ARROW_PZL_WSG = 20, ///< 55-arrow_PZL.wsg
+    _55_ARROW_SLV_WSG = 21, ///< 55-arrow_SLV.wsg
+    _55_CHECK_PZL_WSG = 22, ///< 55-check_PZL.wsg
+    _55_CHECK_SLV_WSG = 23, ///< 55-check_SLV.wsg
+    _55_CROWN_PZL_WSG = 24, ///< 55-crown_PZL.wsg
+    _55_CROWN_SLV_WSG = 25, ///< 55-crown_SLV.wsg
+    _55_FLOWER_PZL_WSG = 26, ///< 55-flower_PZL.wsg
+    _55_FLOWER_SLV_WSG = 27, ///< 55-flower_SLV.wsg
+    _55_GHOST_PZL_WSG = 28, ///< 55-ghost_PZL.wsg
+    _55_GHOST_SLV_WSG = 29, ///< 55-ghost_SLV.wsg
+    _55_HEART_PZL_WSG = 30, ///< 55-heart_PZL.wsg
+    _55_HEART_SLV_WSG = 31, ///< 55-heart_SLV.wsg
+    _55_KITTY_PZL_WSG = 32, ///< 55-kitty_PZL.wsg
+    _55_KITTY_SLV_WSG = 33, ///< 55-kitty_SLV.wsg
+    _55_PACMAN_PZL_WSG = 34, ///< 55-pacman_PZL.wsg
+    _55_PACMAN_SLV_WSG = 35, ///< 55-pacman_SLV.wsg
+    _55_RAINBOW_PZL_WSG = 36, ///< 55-rainbow_PZL.wsg
+    _55_RAINBOW_SLV_WSG = 37, ///< 55-rainbow_SLV.wsg
+    _55_TRIANGLE_PZL_WSG = 38, ///< 55-triangle_PZL.wsg
+    _55_TRIANGLE_SLV_WSG = 39, ///< 55-triangle_SLV.wsg
+    AA_APPLE_PZL_WSG = 40, ///< AA-apple_PZL.wsg
+    AA_APPLE_SLV_WSG = 41, ///< AA-apple_SLV.wsg
+    AA_BABA_PZL_WSG = 42, ///< AA-baba_PZL.wsg
+    AA_BABA_SLV_WSG = 43, ///< AA-baba_SLV.wsg
+    AA_DRAGONBALL_PZL_WSG = 44, ///< AA-dragonball_PZL.wsg
+    AA_DRAGONBALL_SLV_WSG = 45, ///< AA-dragonball_SLV.wsg
+    AA_HEARTPIECE_PZL_WSG = 46, ///< AA-heartpiece_PZL.wsg
+    AA_HEARTPIECE_SLV_WSG = 47, ///< AA-heartpiece_SLV.wsg
+    AA_METROID_PZL_WSG = 48, ///< AA-metroid_PZL.wsg
+    AA_METROID_SLV_WSG = 49, ///< AA-metroid_SLV.wsg
+    AA_MOONSTICK_PZL_WSG = 50, ///< AA-moonstick_PZL.wsg
+    AA_MOONSTICK_SLV_WSG = 51, ///< AA-moonstick_SLV.wsg
+    AA_PEACH_PZL_WSG = 52, ///< AA-peach_PZL.wsg
+    AA_PEACH_SLV_WSG = 53, ///< AA-peach_SLV.wsg
+    AA_POKEBALL_PZL_WSG = 54, ///< AA-pokeball_PZL.wsg
+    AA_POKEBALL_SLV_WSG = 55, ///< AA-pokeball_SLV.wsg
+    AA_SWORD_PZL_WSG = 56, ///< AA-sword_PZL.wsg
+    AA_SWORD_SLV_WSG = 57, ///< AA-sword_SLV.wsg
+    AA_TOADSTOOL_PZL_WSG = 58, ///< AA-toadstool_PZL.wsg
+    AA_TOADSTOOL_SLV_WSG = 59, ///< AA-toadstool_SLV.wsg
+    AF_DONUTJUMP_PZL_WSG = 60, ///< AF-donutjump_PZL.wsg
+    AF_DONUTJUMP_SLV_WSG = 61, ///< AF-donutjump_SLV.wsg
+    AF_PICROSS_PZL_WSG = 62, ///< AF-picross_PZL.wsg
+    AF_PICROSS_SLV_WSG = 63, ///< AF-picross_SLV.wsg
+    AF_SUPERSWADGELAND_PZL_WSG = 64, ///< AF-superswadgeland_PZL.wsg
+    AF_SUPERSWADGELAND_SLV_WSG = 65, ///< AF-superswadgeland_SLV.wsg
+    AF_SWADGEBROS_PZL_WSG = 66, ///< AF-swadgebros_PZL.wsg
+    AF_SWADGEBROS_SLV_WSG = 67, ///< AF-swadgebros_SLV.wsg
+    AF_TILTRADS_PZL_WSG = 68, ///< AF-tiltrads_PZL.wsg
+    AF_TILTRADS_SLV_WSG = 69, ///< AF-tiltrads_SLV.wsg
+    BARREL_1_WSG = 70, ///< Barrel-1.wsg
+    BARREL_2_WSG = 71, ///< Barrel-2.wsg
+    BARREL_3_WSG = 72, ///< Barrel-3.wsg
+    CF_GALACTICBRICKDOWN_PZL_WSG = 73, ///< CF-galacticbrickdown_PZL.wsg
+    CF_GALACTICBRICKDOWN_SLV_WSG = 74, ///< CF-galacticbrickdown_SLV.wsg
+    CF_LUMBERJACKS_PZL_WSG = 75, ///< CF-lumberjacks_PZL.wsg
+    CF_LUMBERJACKS_SLV_WSG = 76, ///< CF-lumberjacks_SLV.wsg
+    CF_MAGTROIDPOCKET_PZL_WSG = 77, ///< CF-magtroidpocket_PZL.wsg
+    CF_MAGTROIDPOCKET_SLV_WSG = 78, ///< CF-magtroidpocket_SLV.wsg
+    CF_PUSHYKAWAIIGO_PZL_WSG = 79, ///< CF-pushykawaiigo_PZL.wsg
+    CF_PUSHYKAWAIIGO_SLV_WSG = 80, ///< CF-pushykawaiigo_SLV.wsg
+    CHARGIN_SCHMUCK_3_WSG = 81, ///< CharginSchmuck3.wsg
+    CHARGIN_SCHMUCK_4_WSG = 82, ///< CharginSchmuck4.wsg
+    CHOWA_RACE_MID = 83, ///< Chowa_Race.mid
+    CRUMBLE_BLOCK_4_WSG = 84, ///< CrumbleBlock4.wsg
+    DEADEYE_BIN = 85, ///< Deadeye.bin
+    DONUT_BIN = 86, ///< Donut.bin
+    DRAIN_BIN = 87, ///< Drain.bin
+    EF_2048_PZL_WSG = 88, ///< EF-2048_PZL.wsg
+    EF_2048_SLV_WSG = 89, ///< EF-2048_SLV.wsg
+    EF_BIGBUG_PZL_WSG = 90, ///< EF-bigbug_PZL.wsg
+    EF_BIGBUG_SLV_WSG = 91, ///< EF-bigbug_SLV.wsg
+    EF_CHOWAGROVE_PZL_WSG = 92, ///< EF-chowagrove_PZL.wsg
+    EF_CHOWAGROVE_SLV_WSG = 93, ///< EF-chowagrove_SLV.wsg
+    EF_HUNTERSPUZZLES_PZL_WSG = 94, ///< EF-hunterspuzzles_PZL.wsg
+    EF_HUNTERSPUZZLES_SLV_WSG = 95, ///< EF-hunterspuzzles_SLV.wsg
+    EF_PANGO_PZL_WSG = 96, ///< EF-pango_PZL.wsg
+    EF_PANGO_SLV_WSG = 97, ///< EF-pango_SLV.wsg
+    EF_SWADGEHERO_PZL_WSG = 98, ///< EF-swadgehero_PZL.wsg
+    EF_SWADGEHERO_SLV_WSG = 99, ///< EF-swadgehero_SLV.wsg
+    EF_ULTIMATETTT_PZL_WSG = 100, ///< EF-ultimatettt_PZL.wsg
+    EF_ULTIMATETTT_SLV_WSG = 101, ///< EF-ultimatettt_SLV.wsg
+    FF_ACLEAF_PZL_WSG = 102, ///< FF-acleaf_PZL.wsg
+    FF_ACLEAF_SLV_WSG = 103, ///< FF-acleaf_SLV.wsg
+    FF_DOUBLEBASS_PZL_WSG = 104, ///< FF-doublebass_PZL.wsg
+    FF_DOUBLEBASS_SLV_WSG = 105, ///< FF-doublebass_SLV.wsg
+    FF_DRUM_PZL_WSG = 106, ///< FF-drum_PZL.wsg
+    FF_DRUM_SLV_WSG = 107, ///< FF-drum_SLV.wsg
+    FF_METEOR_PZL_WSG = 108, ///< FF-meteor_PZL.wsg
+    FF_METEOR_SLV_WSG = 109, ///< FF-meteor_SLV.wsg
+    FF_PSLOGO_PZL_WSG = 110, ///< FF-pslogo_PZL.wsg
+    FF_PSLOGO_SLV_WSG = 111, ///< FF-pslogo_SLV.wsg
+    FF_SAX_PZL_WSG = 112, ///< FF-sax_PZL.wsg
+    FF_SAX_SLV_WSG = 113, ///< FF-sax_SLV.wsg
+    FF_SFCLOGO_PZL_WSG = 114, ///< FF-sfclogo_PZL.wsg
+    FF_SFCLOGO_SLV_WSG = 115, ///< FF-sfclogo_SLV.wsg
+    FF_TANK_PZL_WSG = 116, ///< FF-tank_PZL.wsg
+    FF_TANK_SLV_WSG = 117, ///< FF-tank_SLV.wsg
+    FF_TRUMPET_PZL_WSG = 118, ///< FF-trumpet_PZL.wsg
+    FF_TRUMPET_SLV_WSG = 119, ///< FF-trumpet_SLV.wsg
+    FF_WING_PZL_WSG = 120, ///< FF-wing_PZL.wsg
+    FF_WING_SLV_WSG = 121, ///< FF-wing_SLV.wsg
+    FAIRY_FOUNTAIN_MID = 122, ///< Fairy_Fountain.mid
+    FAUXRIO_KART_MID = 123, ///< Fauxrio_Kart.mid
+    FOLLINESQUE_MID = 124, ///< Follinesque.mid
+    GRIND_BIN = 125, ///< Grind.bin
+    GRYFFYN_BIN = 126, ///< Gryffyn.bin
+    HP_BOSS_MIDDLE_0_WSG = 127, ///< HP_boss_middle_0.wsg
+    HP_BOSS_MIDDLE_1_WSG = 128, ///< HP_boss_middle_1.wsg
+    HP_BOSS_MIDDLE_2_WSG = 129, ///< HP_boss_middle_2.wsg
+    HP_BOSS_MIDDLE_3_WSG = 130, ///< HP_boss_middle_3.wsg
+    HP_BOSS_MIDDLE_4_WSG = 131, ///< HP_boss_middle_4.wsg
+    HP_BOSS_MIDDLE_5_WSG = 132, ///< HP_boss_middle_5.wsg
+    HP_BOSS_MIDDLE_6_WSG = 133, ///< HP_boss_middle_6.wsg
+    HP_BOSS_TOP_0_WSG = 134, ///< HP_boss_top_0.wsg
+    HP_BOSS_TOP_1_WSG = 135, ///< HP_boss_top_1.wsg
+    HP_BOSS_TOP_2_WSG = 136, ///< HP_boss_top_2.wsg
+    HP_BOSS_TOP_3_WSG = 137, ///< HP_boss_top_3.wsg
+    HP_BOSS_TOP_4_WSG = 138, ///< HP_boss_top_4.wsg
+    HP_BOSS_TOP_5_WSG = 139, ///< HP_boss_top_5.wsg
+    HP_BOSS_TOP_6_WSG = 140, ///< HP_boss_top_6.wsg
+    HP_BOTTOM_ALPHA_WSG = 141, ///< HP_bottom_alpha.wsg
+    HP_BOTTOM_BIGMA_WSG = 142, ///< HP_bottom_bigma.wsg
+    HP_MIDDLE_0_WSG = 143, ///< HP_middle_0.wsg
+    HP_MIDDLE_1_WSG = 144, ///< HP_middle_1.wsg
+    HP_MIDDLE_2_WSG = 145, ///< HP_middle_2.wsg
+    HP_MIDDLE_3_WSG = 146, ///< HP_middle_3.wsg
+    HP_MIDDLE_4_WSG = 147, ///< HP_middle_4.wsg
+    HP_MIDDLE_5_WSG = 148, ///< HP_middle_5.wsg
+    HP_MIDDLE_6_WSG = 149, ///< HP_middle_6.wsg
+    HP_TOP_0_WSG = 150, ///< HP_top_0.wsg
+    HP_TOP_1_WSG = 151, ///< HP_top_1.wsg
+    HP_TOP_2_WSG = 152, ///< HP_top_2.wsg
+    HP_TOP_3_WSG = 153, ///< HP_top_3.wsg
+    HP_TOP_4_WSG = 154, ///< HP_top_4.wsg
+    HP_TOP_5_WSG = 155, ///< HP_top_5.wsg
+    HP_TOP_6_WSG = 156, ///< HP_top_6.wsg
+    HOOK_WSG = 157, ///< Hook.wsg
+    KD_BURGER_BOUNCE_DIAGONAL_WSG = 158, ///< KD_burger_bounce_diagonal.wsg
+    KD_BURGER_BOUNCE_UPRIGHT_WSG = 159, ///< KD_burger_bounce_upright.wsg
+    LAMP_WSG = 160, ///< Lamp.wsg
+    MAG_FEST_BOUNCER_WSG = 161, ///< MagFestBouncer.wsg
+    MEGAMAX_JONES_FONT = 162, ///< MegamaxJones.font
+    OPEN_TAB_LEFT_WSG = 163, ///< OpenTabLeft.wsg
+    OPEN_TAB_RIGHT_WSG = 164, ///< OpenTabRight.wsg
+    PULSE_000_WSG = 165, ///< Pulse_000.wsg
+    PULSE_001_WSG = 166, ///< Pulse_001.wsg
+    PULSE_002_WSG = 167, ///< Pulse_002.wsg
+    PULSE_003_WSG = 168, ///< Pulse_003.wsg
+    PULSE_004_WSG = 169, ///< Pulse_004.wsg
+    PULSE_005_WSG = 170, ///< Pulse_005.wsg
+    PULSE_006_WSG = 171, ///< Pulse_006.wsg
+    PULSE_007_WSG = 172, ///< Pulse_007.wsg
+    PULSE_008_WSG = 173, ///< Pulse_008.wsg
+    PULSE_009_WSG = 174, ///< Pulse_009.wsg
+    PULSE_012_WSG = 175, ///< Pulse_012.wsg
+    PULSE_013_WSG = 176, ///< Pulse_013.wsg
+    PULSE_014_WSG = 177, ///< Pulse_014.wsg
+    PULSE_015_WSG = 178, ///< Pulse_015.wsg
+    PULSE_016_WSG = 179, ///< Pulse_016.wsg
+    PULSE_017_WSG = 180, ///< Pulse_017.wsg
+    PULSE_018_WSG = 181, ///< Pulse_018.wsg
+    PULSE_019_WSG = 182, ///< Pulse_019.wsg
+    PULSE_020_WSG = 183, ///< Pulse_020.wsg
+    PULSE_021_WSG = 184, ///< Pulse_021.wsg
+    PULSE_024_WSG = 185, ///< Pulse_024.wsg
+    PULSE_025_WSG = 186, ///< Pulse_025.wsg
+    PULSE_036_WSG = 187, ///< Pulse_036.wsg
+    PULSE_037_WSG = 188, ///< Pulse_037.wsg
+    PULSE_038_WSG = 189, ///< Pulse_038.wsg
+    PULSE_041_WSG = 190, ///< Pulse_041.wsg
+    PULSE_043_WSG = 191, ///< Pulse_043.wsg
+    PULSE_046_WSG = 192, ///< Pulse_046.wsg
+    PULSE_MIC_DROP_00_WSG = 193, ///< Pulse_Mic_Drop_00.wsg
+    PULSE_MIC_DROP_01_WSG = 194, ///< Pulse_Mic_Drop_01.wsg
+    PULSE_SHIELD_000_WSG = 195, ///< Pulse_Shield_000.wsg
+    PULSE_SHIELD_001_WSG = 196, ///< Pulse_Shield_001.wsg
+    PULSE_SHIELD_002_WSG = 197, ///< Pulse_Shield_002.wsg
+    PULSE_SHIELD_003_WSG = 198, ///< Pulse_Shield_003.wsg
+    PULSE_DMG_000_WSG = 199, ///< Pulse_dmg_000.wsg
+    PULSE_DMG_001_WSG = 200, ///< Pulse_dmg_001.wsg
+    PULSE_DMG_002_WSG = 201, ///< Pulse_dmg_002.wsg
+    PULSE_SLIDE_WSG = 202, ///< Pulse_slide.wsg
+    PULSE_SURE_YOU_CAN_000_WSG = 203, ///< Pulse_sure_you_can_000.wsg
+    PULSE_SURE_YOU_CAN_001_WSG = 204, ///< Pulse_sure_you_can_001.wsg
+    PULSE_WIN_WSG = 205, ///< Pulse_win.wsg
+    QRTUTORIAL_WSG = 206, ///< QRTutorial.wsg
+    QRTUTORIAL_OLD_WSG = 207, ///< QRTutorial_old.wsg
+    ROBO_CRAWL_1_WSG = 208, ///< RoboCrawl1.wsg
+    ROBO_CRAWL_2_WSG = 209, ///< RoboCrawl2.wsg
+    ROBO_DEAD_WSG = 210, ///< RoboDead.wsg
+    ROBO_LEFT_WSG = 211, ///< RoboLeft.wsg
+    ROBO_RIGHT_WSG = 212, ///< RoboRight.wsg
+    ROBO_STANDING_WSG = 213, ///< RoboStanding.wsg
+    SWSN_ARROW_L_WSG = 214, ///< SWSN_Arrow_L.wsg
+    SWSN_ARROW_R_WSG = 215, ///< SWSN_Arrow_R.wsg
+    SWSN_CHAOS_GOBLIN_WSG = 216, ///< SWSN_Chaos_Goblin.wsg
+    SWSN_EAR_WSG = 217, ///< SWSN_Ear.wsg
+    SWSN_EYE_WSG = 218, ///< SWSN_Eye.wsg
+    SWSN_EYEBROW_WSG = 219, ///< SWSN_Eyebrow.wsg
+    SWSN_FACIAL_HAIR_WSG = 220, ///< SWSN_FacialHair.wsg
+    SWSN_GLASSES_WSG = 221, ///< SWSN_Glasses.wsg
+    SWSN_HAIR_WSG = 222, ///< SWSN_Hair.wsg
+    SWSN_HATS_WSG = 223, ///< SWSN_Hats.wsg
+    SWSN_MIRROR_WSG = 224, ///< SWSN_Mirror.wsg
+    SWSN_MOUTH_WSG = 225, ///< SWSN_Mouth.wsg
+    SWSN_NEW_FACE_WSG = 226, ///< SWSN_NewFace.wsg
+    SWSN_NO_GO_WSG = 227, ///< SWSN_NoGo.wsg
+    SWSN_POINTER_ARROW_WSG = 228, ///< SWSN_Pointer_Arrow.wsg
+    SWSN_POINTER_BALL_WSG = 229, ///< SWSN_Pointer_Ball.wsg
+    SWSN_POINTER_BEAKER_WSG = 230, ///< SWSN_Pointer_Beaker.wsg
+    SWSN_POINTER_BOW_WSG = 231, ///< SWSN_Pointer_Bow.wsg
+    SWSN_POINTER_CANDY_CANE_WSG = 232, ///< SWSN_Pointer_Candy_Cane.wsg
+    SWSN_POINTER_CARROT_WSG = 233, ///< SWSN_Pointer_Carrot.wsg
+    SWSN_POINTER_CAT_PAW_WSG = 234, ///< SWSN_Pointer_Cat_Paw.wsg
+    SWSN_POINTER_CAT_PAW_B_WSG = 235, ///< SWSN_Pointer_Cat_PawB.wsg
+    SWSN_POINTER_COMPUTER_POINTER_WSG = 236, ///< SWSN_Pointer_ComputerPointer.wsg
+    SWSN_POINTER_DONUT_WSG = 237, ///< SWSN_Pointer_Donut.wsg
+    SWSN_POINTER_DRESSED_WEINER_WSG = 238, ///< SWSN_Pointer_DressedWeiner.wsg
+    SWSN_POINTER_ENDER_WSG = 239, ///< SWSN_Pointer_Ender.wsg
+    SWSN_POINTER_GEM_WSG = 240, ///< SWSN_Pointer_Gem.wsg
+    SWSN_POINTER_GHOST_WSG = 241, ///< SWSN_Pointer_Ghost.wsg
+    SWSN_POINTER_HAMMER_WSG = 242, ///< SWSN_Pointer_Hammer.wsg
+    SWSN_POINTER_HEART_WSG = 243, ///< SWSN_Pointer_Heart.wsg
+    SWSN_POINTER_LEAF_WSG = 244, ///< SWSN_Pointer_Leaf.wsg
+    SWSN_POINTER_MAGIC_WAND_WSG = 245, ///< SWSN_Pointer_Magic_Wand.wsg
+    SWSN_POINTER_NO_GLOVE_NO_LOVE_WSG = 246, ///< SWSN_Pointer_NoGloveNoLove.wsg
+    SWSN_POINTER_NO_STEM_WSG = 247, ///< SWSN_Pointer_NoStem.wsg
+    SWSN_POINTER_PENCIL_WSG = 248, ///< SWSN_Pointer_Pencil.wsg
+    SWSN_POINTER_PIZZA_WSG = 249, ///< SWSN_Pointer_Pizza.wsg
+    SWSN_POINTER_RAINBOW_WSG = 250, ///< SWSN_Pointer_Rainbow.wsg
+    SWSN_POINTER_RULER_WSG = 251, ///< SWSN_Pointer_Ruler.wsg
+    SWSN_POINTER_SWORD_WSG = 252, ///< SWSN_Pointer_Sword.wsg
+    SWSN_POINTER_WATERMELON_WSG = 253, ///< SWSN_Pointer_Watermelon.wsg
+    SWSN_POINTER_WEINER_WSG = 254, ///< SWSN_Pointer_Weiner.wsg
+    SWSN_SHIRT_WSG = 255, ///< SWSN_Shirt.wsg
+    SWSN_SKIN_WSG = 256, ///< SWSN_Skin.wsg
+    SEVER_BIN = 257, ///< Sever.bin
+    SHOT_BASIC_000_WSG = 258, ///< Shot_Basic_000.wsg
+    SHOT_BASIC_001_WSG = 259, ///< Shot_Basic_001.wsg
+    SHOT_BASIC_002_WSG = 260, ///< Shot_Basic_002.wsg
+    SMASH_BIN = 261, ///< Smash.bin
+    SPIKE_TILE_BOTTOM_00_WSG = 262, ///< SpikeTile_bottom_00.wsg
+    SPIKE_TILE_LEFT_00_WSG = 263, ///< SpikeTile_left_00.wsg
+    SPIKE_TILE_RIGHT_00_WSG = 264, ///< SpikeTile_right_00.wsg
+    SPIKE_TILE_TOP_00_WSG = 265, ///< SpikeTile_top_00.wsg
+    SPIKY_MC_GEE_1_WSG = 266, ///< SpikyMcGee1.wsg
+    SPIKY_MC_GEE_2_WSG = 267, ///< SpikyMcGee2.wsg
+    SWSN_CHOOSE_SFX_MID = 268, ///< SwsnChooseSFX.mid
+    SWSN_CREATOR_BGM1_MID = 269, ///< SwsnCreatorBGM1.mid
+    SWSN_CREATOR_BGM2_MID = 270, ///< SwsnCreatorBGM2.mid
+    SWSN_MOVE_SFX_MID = 271, ///< SwsnMoveSFX.mid
+    TURRET_3_WSG = 272, ///< Turret3.wsg
+    TURRET_4_WSG = 273, ///< Turret4.wsg
+    TURRET_5_WSG = 274, ///< Turret5.wsg
+    WARNING_WSG = 275, ///< Warning.wsg
+    ARROW_5_WSG = 276, ///< arrow5.wsg
+    ARROW_8_WSG = 277, ///< arrow8.wsg
+    ARROW_9_WSG = 278, ///< arrow9.wsg
+    ARROW_10_WSG = 279, ///< arrow10.wsg
+    ARROW_12_WSG = 280, ///< arrow12.wsg
+    ARROW_18_WSG = 281, ///< arrow18.wsg
+    ARROW_19_WSG = 282, ///< arrow19.wsg
+    ARROW_21_WSG = 283, ///< arrow21.wsg
+    BACKLIGHT_DISABLED_WSG = 284, ///< backlightDisabled.wsg
+    BACKLIGHT_ENABLED_WSG = 285, ///< backlightEnabled.wsg
+    BANANA_MID = 286, ///< banana.mid
+    BASS_WSG = 287, ///< bass.wsg
+    BATT_1_WSG = 288, ///< batt1.wsg
+    BATT_2_WSG = 289, ///< batt2.wsg
+    BATT_3_WSG = 290, ///< batt3.wsg
+    BATT_4_WSG = 291, ///< batt4.wsg
+    BGM_CASTLE_MID = 292, ///< bgmCastle.mid
+    BGM_DE_MAGIO_MID = 293, ///< bgmDeMAGio.mid
+    BGM_GAME_OVER_MID = 294, ///< bgmGameOver.mid
+    BGM_GAME_START_MID = 295, ///< bgmGameStart.mid
+    BGM_INTRO_MID = 296, ///< bgmIntro.mid
+    BGM_NAME_ENTRY_MID = 297, ///< bgmNameEntry.mid
+    BGM_SMOOTH_MID = 298, ///< bgmSmooth.mid
+    BGM_UNDERGROUND_MID = 299, ///< bgmUnderground.mid
+    BGM_DEADEYE_CHIRPZI_MID = 300, ///< bgm_Deadeye_Chirpzi.mid
+    BGM_DRAIN_BAT_MID = 301, ///< bgm_Drain_Bat.mid
+    BGM_FLARE_GRYFFYN_MID = 302, ///< bgm_Flare_Gryffyn.mid
+    BGM_GRIND_PANGOLIN_MID = 303, ///< bgm_Grind_Pangolin.mid
+    BGM_KINETIC_DONUT_MID = 304, ///< bgm_Kinetic_Donut.mid
+    BGM_RIP_BARONESS_MID = 305, ///< bgm_Rip_Baroness.mid
+    BGM_SEVER_YAGATA_MID = 306, ///< bgm_Sever_Yagata.mid
+    BGM_SMASH_GORILLA_MID = 307, ///< bgm_Smash_Gorilla.mid
+    BGM_STAGE_SELECT_MID = 308, ///< bgm_Stage_Select.mid
+    BGM_BOSS_BIGMA_MID = 309, ///< bgm_boss_Bigma.mid
+    BGM_BOSS_DEADEYE_CHIRPZI_MID = 310, ///< bgm_boss_Deadeye_Chirpzi.mid
+    BGM_BOSS_DRAIN_BAT_MID = 311, ///< bgm_boss_Drain_Bat.mid
+    BGM_BOSS_FLARE_GRIFFIN_MID = 312, ///< bgm_boss_Flare_Griffin.mid
+    BGM_BOSS_GRIND_PANGOLIN_MID = 313, ///< bgm_boss_Grind_Pangolin.mid
+    BGM_BOSS_HANK_WADDLE_MID = 314, ///< bgm_boss_Hank_Waddle.mid
+    BGM_BOSS_KINETIC_DONUT_MID = 315, ///< bgm_boss_Kinetic_Donut.mid
+    BGM_BOSS_SEVER_YAGATA_MID = 316, ///< bgm_boss_Sever_Yagata.mid
+    BGM_BOSS_SMASH_GORILLA_MID = 317, ///< bgm_boss_Smash_Gorilla.mid
+    BGM_BOSS_TRASH_MAN_MID = 318, ///< bgm_boss_TRASH_MAN.mid
+    BLOCK_1_MID = 319, ///< block1.mid
+    BLOCK_2_MID = 320, ///< block2.mid
+    BLOW_IT_RAW = 321, ///< blow_it.raw
+    BM_AVATAR_WSG = 322, ///< bm_Avatar.wsg
+    BM_BEARD_WSG = 323, ///< bm_Beard.wsg
+    BM_BLUSH_WSG = 324, ///< bm_Blush.wsg
+    BM_BOTTOM_WSG = 325, ///< bm_Bottom.wsg
+    BM_BOTTOM_MOLE_WSG = 326, ///< bm_BottomMole.wsg
+    BM_CHIN_WSG = 327, ///< bm_Chin.wsg
+    BM_CHIN_PATCH_WSG = 328, ///< bm_ChinPatch.wsg
+    BM_CHIN_STRAP_WSG = 329, ///< bm_ChinStrap.wsg
+    BM_CHOKER_WSG = 330, ///< bm_Choker.wsg
+    BM_COP_WSG = 331, ///< bm_Cop.wsg
+    BM_COWBOY_WSG = 332, ///< bm_Cowboy.wsg
+    BM_EYE_MOLE_WSG = 333, ///< bm_EyeMole.wsg
+    BM_FRECKLES_WSG = 334, ///< bm_Freckles.wsg
+    BM_FULL_SCRAGGLY_WSG = 335, ///< bm_FullScraggly.wsg
+    BM_HALF_STACHE_WSG = 336, ///< bm_HalfStache.wsg
+    BM_HEART_STACHE_WSG = 337, ///< bm_HeartStache.wsg
+    BM_LESS_WISE_WSG = 338, ///< bm_LessWise.wsg
+    BM_MAGICIAN_WSG = 339, ///< bm_Magician.wsg
+    BM_MARILYN_WSG = 340, ///< bm_Marilyn.wsg
+    BM_NECK_BLOOD_WSG = 341, ///< bm_Neck_Blood.wsg
+    BM_OLD_WSG = 342, ///< bm_Old.wsg
+    BM_PILLOW_WSG = 343, ///< bm_Pillow.wsg
+    BM_SAND_P_WSG = 344, ///< bm_SAndP.wsg
+    BM_SCRAGGLY_WSG = 345, ///< bm_Scraggly.wsg
+    BM_SMALL_CURL_WSG = 346, ///< bm_SmallCurl.wsg
+    BM_SMALL_STACHE_WSG = 347, ///< bm_SmallStache.wsg
+    BM_SOUL_PATCH_WSG = 348, ///< bm_SoulPatch.wsg
+    BM_SPIKED_NECKLACE_WSG = 349, ///< bm_SpikedNecklace.wsg
+    BM_STACHE_AND_STRAP_WSG = 350, ///< bm_StacheAndStrap.wsg
+    BM_STRONGMAN_WSG = 351, ///< bm_Strongman.wsg
+    BM_THIN_CHIN_WSG = 352, ///< bm_ThinChin.wsg
+    BM_THIS_WSG = 353, ///< bm_This.wsg
+    BM_TIRED_WSG = 354, ///< bm_Tired.wsg
+    BM_VITILIGO_WSG = 355, ///< bm_Vitiligo.wsg
+    BM_WISEMAN_WSG = 356, ///< bm_Wiseman.wsg
+    BRASS_WSG = 357, ///< brass.wsg
+    BRONZE_TROPHY_WSG = 358, ///< bronzeTrophy.wsg
+    BU_0_WSG = 359, ///< bu0.wsg
+    BU_1_WSG = 360, ///< bu1.wsg
+    BU_2_WSG = 361, ///< bu2.wsg
+    BU_3_WSG = 362, ///< bu3.wsg
+    BU_4_WSG = 363, ///< bu4.wsg
+    BU_5_WSG = 364, ///< bu5.wsg
+    BU_6_WSG = 365, ///< bu6.wsg
+    BU_7_WSG = 366, ///< bu7.wsg
+    BU_8_WSG = 367, ///< bu8.wsg
+    BU_9_WSG = 368, ///< bu9.wsg
+    BU_10_WSG = 369, ///< bu10.wsg
+    BU_11_WSG = 370, ///< bu11.wsg
+    BU_12_WSG = 371, ///< bu12.wsg
+    BU_13_WSG = 372, ///< bu13.wsg
+    BU_14_WSG = 373, ///< bu14.wsg
+    BU_15_WSG = 374, ///< bu15.wsg
+    BU_16_WSG = 375, ///< bu16.wsg
+    BU_17_WSG = 376, ///< bu17.wsg
+    BU_18_WSG = 377, ///< bu18.wsg
+    BU_19_WSG = 378, ///< bu19.wsg
+    BU_20_WSG = 379, ///< bu20.wsg
+    BU_21_WSG = 380, ///< bu21.wsg
+    BU_22_WSG = 381, ///< bu22.wsg
+    BU_23_WSG = 382, ///< bu23.wsg
+    BUG_0_WSG = 383, ///< bug0.wsg
+    BUG_1_WSG = 384, ///< bug1.wsg
+    BUG_2_WSG = 385, ///< bug2.wsg
+    BUG_3_WSG = 386, ///< bug3.wsg
+    BUG_4_WSG = 387, ///< bug4.wsg
+    BUG_5_WSG = 388, ///< bug5.wsg
+    BUG_6_WSG = 389, ///< bug6.wsg
+    BUG_7_WSG = 390, ///< bug7.wsg
+    BUG_8_WSG = 391, ///< bug8.wsg
+    BUG_9_WSG = 392, ///< bug9.wsg
+    BUG_10_WSG = 393, ///< bug10.wsg
+    BUG_11_WSG = 394, ///< bug11.wsg
+    BUG_12_WSG = 395, ///< bug12.wsg
+    BUG_13_WSG = 396, ///< bug13.wsg
+    BUG_14_WSG = 397, ///< bug14.wsg
+    BUG_15_WSG = 398, ///< bug15.wsg
+    BUG_16_WSG = 399, ///< bug16.wsg
+    BUG_17_WSG = 400, ///< bug17.wsg
+    BUG_18_WSG = 401, ///< bug18.wsg
+    BUG_19_WSG = 402, ///< bug19.wsg
+    BUG_20_WSG = 403, ///< bug20.wsg
+    BUG_21_WSG = 404, ///< bug21.wsg
+    BUG_22_WSG = 405, ///< bug22.wsg
+    BUG_23_WSG = 406, ///< bug23.wsg
+    BUGG_0_WSG = 407, ///< bugg0.wsg
+    BUGG_1_WSG = 408, ///< bugg1.wsg
+    BUGG_2_WSG = 409, ///< bugg2.wsg
+    BUGG_3_WSG = 410, ///< bugg3.wsg
+    BUGG_4_WSG = 411, ///< bugg4.wsg
+    BUGG_5_WSG = 412, ///< bugg5.wsg
+    BUGG_6_WSG = 413, ///< bugg6.wsg
+    BUGG_7_WSG = 414, ///< bugg7.wsg
+    BUGG_8_WSG = 415, ///< bugg8.wsg
+    BUGG_9_WSG = 416, ///< bugg9.wsg
+    BUGG_10_WSG = 417, ///< bugg10.wsg
+    BUGG_11_WSG = 418, ///< bugg11.wsg
+    BUGG_12_WSG = 419, ///< bugg12.wsg
+    BUGG_13_WSG = 420, ///< bugg13.wsg
+    BUGG_14_WSG = 421, ///< bugg14.wsg
+    BUGG_15_WSG = 422, ///< bugg15.wsg
+    BUGG_16_WSG = 423, ///< bugg16.wsg
+    BUGG_17_WSG = 424, ///< bugg17.wsg
+    BUGG_18_WSG = 425, ///< bugg18.wsg
+    BUGG_19_WSG = 426, ///< bugg19.wsg
+    BUGG_20_WSG = 427, ///< bugg20.wsg
+    BUGG_21_WSG = 428, ///< bugg21.wsg
+    BUGG_22_WSG = 429, ///< bugg22.wsg
+    BUGG_23_WSG = 430, ///< bugg23.wsg
+    BUGGO_0_WSG = 431, ///< buggo0.wsg
+    BUGGO_1_WSG = 432, ///< buggo1.wsg
+    BUGGO_2_WSG = 433, ///< buggo2.wsg
+    BUGGO_3_WSG = 434, ///< buggo3.wsg
+    BUGGO_4_WSG = 435, ///< buggo4.wsg
+    BUGGO_5_WSG = 436, ///< buggo5.wsg
+    BUGGO_6_WSG = 437, ///< buggo6.wsg
+    BUGGO_7_WSG = 438, ///< buggo7.wsg
+    BUGGO_8_WSG = 439, ///< buggo8.wsg
+    BUGGO_9_WSG = 440, ///< buggo9.wsg
+    BUGGO_10_WSG = 441, ///< buggo10.wsg
+    BUGGO_11_WSG = 442, ///< buggo11.wsg
+    BUGGO_12_WSG = 443, ///< buggo12.wsg
+    BUGGO_13_WSG = 444, ///< buggo13.wsg
+    BUGGO_14_WSG = 445, ///< buggo14.wsg
+    BUGGO_15_WSG = 446, ///< buggo15.wsg
+    BUGGO_16_WSG = 447, ///< buggo16.wsg
+    BUGGO_17_WSG = 448, ///< buggo17.wsg
+    BUGGO_18_WSG = 449, ///< buggo18.wsg
+    BUGGO_19_WSG = 450, ///< buggo19.wsg
+    BUGGO_20_WSG = 451, ///< buggo20.wsg
+    BUGGO_21_WSG = 452, ///< buggo21.wsg
+    BUGGO_22_WSG = 453, ///< buggo22.wsg
+    BUGGO_23_WSG = 454, ///< buggo23.wsg
+    BUGGY_0_WSG = 455, ///< buggy0.wsg
+    BUGGY_1_WSG = 456, ///< buggy1.wsg
+    BUGGY_2_WSG = 457, ///< buggy2.wsg
+    BUGGY_3_WSG = 458, ///< buggy3.wsg
+    BUGGY_4_WSG = 459, ///< buggy4.wsg
+    BUGGY_5_WSG = 460, ///< buggy5.wsg
+    BUGGY_6_WSG = 461, ///< buggy6.wsg
+    BUGGY_7_WSG = 462, ///< buggy7.wsg
+    BUGGY_8_WSG = 463, ///< buggy8.wsg
+    BUGGY_9_WSG = 464, ///< buggy9.wsg
+    BUGGY_10_WSG = 465, ///< buggy10.wsg
+    BUGGY_11_WSG = 466, ///< buggy11.wsg
+    BUGGY_12_WSG = 467, ///< buggy12.wsg
+    BUGGY_13_WSG = 468, ///< buggy13.wsg
+    BUGGY_14_WSG = 469, ///< buggy14.wsg
+    BUGGY_15_WSG = 470, ///< buggy15.wsg
+    BUGGY_16_WSG = 471, ///< buggy16.wsg
+    BUGGY_17_WSG = 472, ///< buggy17.wsg
+    BUGGY_18_WSG = 473, ///< buggy18.wsg
+    BUGGY_19_WSG = 474, ///< buggy19.wsg
+    BUGGY_20_WSG = 475, ///< buggy20.wsg
+    BUGGY_21_WSG = 476, ///< buggy21.wsg
+    BUGGY_22_WSG = 477, ///< buggy22.wsg
+    BUGGY_23_WSG = 478, ///< buggy23.wsg
+    BUTT_0_WSG = 479, ///< butt0.wsg
+    BUTT_1_WSG = 480, ///< butt1.wsg
+    BUTT_2_WSG = 481, ///< butt2.wsg
+    BUTT_3_WSG = 482, ///< butt3.wsg
+    BUTT_4_WSG = 483, ///< butt4.wsg
+    BUTT_5_WSG = 484, ///< butt5.wsg
+    BUTT_6_WSG = 485, ///< butt6.wsg
+    BUTT_7_WSG = 486, ///< butt7.wsg
+    BUTT_8_WSG = 487, ///< butt8.wsg
+    BUTT_9_WSG = 488, ///< butt9.wsg
+    BUTT_10_WSG = 489, ///< butt10.wsg
+    BUTT_11_WSG = 490, ///< butt11.wsg
+    BUTT_12_WSG = 491, ///< butt12.wsg
+    BUTT_13_WSG = 492, ///< butt13.wsg
+    BUTT_14_WSG = 493, ///< butt14.wsg
+    BUTT_15_WSG = 494, ///< butt15.wsg
+    BUTT_16_WSG = 495, ///< butt16.wsg
+    BUTT_17_WSG = 496, ///< butt17.wsg
+    BUTT_18_WSG = 497, ///< butt18.wsg
+    BUTT_19_WSG = 498, ///< butt19.wsg
+    BUTT_20_WSG = 499, ///< butt20.wsg
+    BUTT_21_WSG = 500, ///< butt21.wsg
+    BUTT_22_WSG = 501, ///< butt22.wsg
+    BUTT_23_WSG = 502, ///< butt23.wsg
+    BUTTON_A_WSG = 503, ///< button_a.wsg
+    BUTTON_B_WSG = 504, ///< button_b.wsg
+    BUTTON_MENU_WSG = 505, ///< button_menu.wsg
+    BUTTON_PAUSE_WSG = 506, ///< button_pause.wsg
+    BUTTON_SYSTEM_WSG = 507, ///< button_system.wsg
+    BUTTON_UP_WSG = 508, ///< button_up.wsg
+    CC_BACKGROUND_DESK_WSG = 509, ///< ccBackgroundDesk.wsg
+    CC_BACKGROUND_MAT_WSG = 510, ///< ccBackgroundMat.wsg
+    CC_BIG_NEEDLE_LEFT_WSG = 511, ///< ccBigNeedleLeft.wsg
+    CC_BIG_NEEDLE_RIGHT_WSG = 512, ///< ccBigNeedleRight.wsg
+    CC_CALENDAR_WSG = 513, ///< ccCalendar.wsg
+    CC_FABRIC_WSG = 514, ///< ccFabric.wsg
+    CC_FABRIC_BUNDLE_WSG = 515, ///< ccFabricBundle.wsg
+    CC_FABRIC_CLOSED_SIGN_WSG = 516, ///< ccFabricClosedSign.wsg
+    CC_FABRIC_EDGE_WSG = 517, ///< ccFabricEdge.wsg
+    CC_FABRIC_SHOPPER_WSG = 518, ///< ccFabricShopper.wsg
+    CC_FABRIC_SHOPPER_FOOT_WSG = 519, ///< ccFabricShopperFoot.wsg
+    CC_FABRIC_STORE_BACKGROUND_WSG = 520, ///< ccFabricStoreBackground.wsg
+    CC_FINGERS_WSG = 521, ///< ccFingers.wsg
+    CC_GRASS_WSG = 522, ///< ccGrass.wsg
+    CC_KNIFE_BOTTOM_WSG = 523, ///< ccKnifeBottom.wsg
+    CC_KNIFE_TOP_WSG = 524, ///< ccKnifeTop.wsg
+    CC_MENU_ARROW_LEFT_WSG = 525, ///< ccMenuArrowLeft.wsg
+    CC_MENU_ARROW_RIGHT_WSG = 526, ///< ccMenuArrowRight.wsg
+    CC_MENU_FOLD_WSG = 527, ///< ccMenuFold.wsg
+    CC_MENU_PIN_WSG = 528, ///< ccMenuPin.wsg
+    CC_MUG_WSG = 529, ///< ccMug.wsg
+    CC_MUG_LIQUID_WSG = 530, ///< ccMugLiquid.wsg
+    CC_MUG_SPILLED_WSG = 531, ///< ccMugSpilled.wsg
+    CC_MUG_SPILLED_LIQUID_WSG = 532, ///< ccMugSpilledLiquid.wsg
+    CC_PACKAGE_WSG = 533, ///< ccPackage.wsg
+    CC_PACKAGE_GET_MID = 534, ///< ccPackageGet.mid
+    CC_PACKAGE_STARBURST_WSG = 535, ///< ccPackageStarburst.wsg
+    CC_PAINT_LABEL_WSG = 536, ///< ccPaintLabel.wsg
+    CC_PAINT_TUBE_WSG = 537, ///< ccPaintTube.wsg
+    CC_SEWING_NEEDLE_EYE_WSG = 538, ///< ccSewingNeedleEye.wsg
+    CC_SEWING_NEEDLE_POINT_WSG = 539, ///< ccSewingNeedlePoint.wsg
+    CC_SLASH_WSG = 540, ///< ccSlash.wsg
+    CC_SLASH_OVERLAY_WSG = 541, ///< ccSlashOverlay.wsg
+    CC_SLASH_UNDERLAY_WSG = 542, ///< ccSlashUnderlay.wsg
+    CC_SPILL_WSG = 543, ///< ccSpill.wsg
+    CC_SPRAY_WSG = 544, ///< ccSpray.wsg
+    CC_SPRAY_CAN_WSG = 545, ///< ccSprayCan.wsg
+    CC_SPRAY_CAN_GRAPHICS_WSG = 546, ///< ccSprayCanGraphics.wsg
+    CC_SPRAY_NOZZLE_WSG = 547, ///< ccSprayNozzle.wsg
+    CC_THREAD_WSG = 548, ///< ccThread.wsg
+    CC_THREAD_KNOT_WSG = 549, ///< ccThreadKnot.wsg
+    CC_TIMER_LEFT_WSG = 550, ///< ccTimerLeft.wsg
+    CC_TIMER_RIGHT_WSG = 551, ///< ccTimerRight.wsg
+    CC_TUMBLEWEED_WSG = 552, ///< ccTumbleweed.wsg
+    CHANNELS_WSG = 553, ///< channels.wsg
+    CHARGE_SHOT_LV_1_000_WSG = 554, ///< charge-shot-lv1-000.wsg
+    CHARGE_SHOT_LV_1_001_WSG = 555, ///< charge-shot-lv1-001.wsg
+    CHARGE_SHOT_LV_1_003_WSG = 556, ///< charge-shot-lv1-003.wsg
+    CHARGE_SHOT_MAX_000_WSG = 557, ///< charge-shot-max-000.wsg
+    CHARGE_SHOT_MAX_001_WSG = 558, ///< charge-shot-max-001.wsg
+    CHARGE_SHOT_MAX_002_WSG = 559, ///< charge-shot-max-002.wsg
+    CHROMATIC_PERCUSSION_WSG = 560, ///< chromatic_percussion.wsg
+    COLOSSUS_BIN = 561, ///< colossus.bin
+    CRASHCYMBAL_BIN = 562, ///< crashcymbal.bin
+    DAC_01_BIN = 563, ///< dac01.bin
+    DAC_02_BIN = 564, ///< dac02.bin
+    DAC_03_BIN = 565, ///< dac03.bin
+    DAC_SCREAM_RAW = 566, ///< dac_scream.raw
+    DEBUG_BIN = 567, ///< debug.bin
+    DEFAULT_SETTING_WSG = 568, ///< defaultSetting.wsg
+    DICE_0_GS = 569, ///< dice0.gs
+    DICE_1_GS = 570, ///< dice1.gs
+    DICE_2_GS = 571, ///< dice2.gs
+    DICE_3_GS = 572, ///< dice3.gs
+    DICE_4_GS = 573, ///< dice4.gs
+    DICE_5_GS = 574, ///< dice5.gs
+    DICE_6_GS = 575, ///< dice6.gs
+    DICE_7_GS = 576, ///< dice7.gs
+    DICE_8_GS = 577, ///< dice8.gs
+    DICE_9_GS = 578, ///< dice9.gs
+    DN_KING_WSG = 579, ///< dn_King.wsg
+    DN_KING_SMALL_0_WSG = 580, ///< dn_KingSmall0.wsg
+    DN_PAWN_WSG = 581, ///< dn_Pawn.wsg
+    DN_PAWN_SMALL_0_WSG = 582, ///< dn_PawnSmall0.wsg
+    DN_ALBUM_WSG = 583, ///< dn_album.wsg
+    DN_ALBUM_EXPLOSION_0_WSG = 584, ///< dn_albumExplosion0.wsg
+    DN_ALBUM_EXPLOSION_1_WSG = 585, ///< dn_albumExplosion1.wsg
+    DN_ALBUM_EXPLOSION_2_WSG = 586, ///< dn_albumExplosion2.wsg
+    DN_ALBUM_EXPLOSION_3_WSG = 587, ///< dn_albumExplosion3.wsg
+    DN_ALBUM_EXPLOSION_4_WSG = 588, ///< dn_albumExplosion4.wsg
+    DN_ALBUM_EXPLOSION_5_WSG = 589, ///< dn_albumExplosion5.wsg
+    DN_ALBUM_EXPLOSION_6_WSG = 590, ///< dn_albumExplosion6.wsg
+    DN_ALPHA_DOWN_WSG = 591, ///< dn_alpha_down.wsg
+    DN_ALPHA_ORTHO_WSG = 592, ///< dn_alpha_ortho.wsg
+    DN_ALPHA_UP_WSG = 593, ///< dn_alpha_up.wsg
+    DN_BUCKET_HAT_DOWN_WSG = 594, ///< dn_bucketHat_down.wsg
+    DN_BUCKET_HAT_UP_WSG = 595, ///< dn_bucketHat_up.wsg
+    DN_CHESS_ORTHO_WSG = 596, ///< dn_chess_ortho.wsg
+    DN_CURTAIN_WSG = 597, ///< dn_curtain.wsg
+    DN_DANCENONYDA_WSG = 598, ///< dn_dancenonyda.wsg
+    DN_GLITCH_0_WSG = 599, ///< dn_glitch0.wsg
+    DN_GLITCH_1_WSG = 600, ///< dn_glitch1.wsg
+    DN_GLITCH_2_WSG = 601, ///< dn_glitch2.wsg
+    DN_GLITCH_3_WSG = 602, ///< dn_glitch3.wsg
+    DN_GLITCH_4_WSG = 603, ///< dn_glitch4.wsg
+    DN_GLITCH_5_WSG = 604, ///< dn_glitch5.wsg
+    DN_GROUND_TILE_0_WSG = 605, ///< dn_groundTile0.wsg
+    DN_GROUND_TILE_1_WSG = 606, ///< dn_groundTile1.wsg
+    DN_GROUND_TILE_2_WSG = 607, ///< dn_groundTile2.wsg
+    DN_MINI_TILE_WSG = 608, ///< dn_miniTile.wsg
+    DN_NUMBER_0_WSG = 609, ///< dn_number0.wsg
+    DN_NUMBER_1_WSG = 610, ///< dn_number1.wsg
+    DN_NUMBER_2_WSG = 611, ///< dn_number2.wsg
+    DN_NUMBER_3_WSG = 612, ///< dn_number3.wsg
+    DN_NUMBER_4_WSG = 613, ///< dn_number4.wsg
+    DN_NUMBER_5_WSG = 614, ///< dn_number5.wsg
+    DN_NUMBER_6_WSG = 615, ///< dn_number6.wsg
+    DN_NUMBER_7_WSG = 616, ///< dn_number7.wsg
+    DN_NUMBER_8_WSG = 617, ///< dn_number8.wsg
+    DN_NUMBER_9_WSG = 618, ///< dn_number9.wsg
+    DN_PIT_WSG = 619, ///< dn_pit.wsg
+    DN_QR_0_WSG = 620, ///< dn_qr0.wsg
+    DN_REROLL_WSG = 621, ///< dn_reroll.wsg
+    DN_SKIP_0_WSG = 622, ///< dn_skip0.wsg
+    DN_SKIP_1_WSG = 623, ///< dn_skip1.wsg
+    DN_SKIP_2_WSG = 624, ///< dn_skip2.wsg
+    DN_SKIP_3_WSG = 625, ///< dn_skip3.wsg
+    DN_SKIP_4_WSG = 626, ///< dn_skip4.wsg
+    DN_SKIP_5_WSG = 627, ///< dn_skip5.wsg
+    DN_SKIP_6_WSG = 628, ///< dn_skip6.wsg
+    DN_SKIP_7_WSG = 629, ///< dn_skip7.wsg
+    DN_SKIP_8_WSG = 630, ///< dn_skip8.wsg
+    DN_SPEAKER_0_WSG = 631, ///< dn_speaker0.wsg
+    DN_SPEAKER_1_WSG = 632, ///< dn_speaker1.wsg
+    DN_SPEAKER_2_WSG = 633, ///< dn_speaker2.wsg
+    DN_SPEAKER_3_WSG = 634, ///< dn_speaker3.wsg
+    DN_SPEAKER_4_WSG = 635, ///< dn_speaker4.wsg
+    DN_SPEAKER_5_WSG = 636, ///< dn_speaker5.wsg
+    DN_SPEAKER_STAND_WSG = 637, ///< dn_speakerStand.wsg
+    DN_STATUS_LIGHT_WSG = 638, ///< dn_statusLight.wsg
+    DN_SWAP_0_WSG = 639, ///< dn_swap0.wsg
+    DN_SWAP_1_WSG = 640, ///< dn_swap1.wsg
+    DN_SWAP_2_WSG = 641, ///< dn_swap2.wsg
+    DN_SWAP_3_WSG = 642, ///< dn_swap3.wsg
+    DN_SWAP_4_WSG = 643, ///< dn_swap4.wsg
+    DN_SWAP_5_WSG = 644, ///< dn_swap5.wsg
+    DN_SWAP_6_WSG = 645, ///< dn_swap6.wsg
+    DN_SWAP_7_WSG = 646, ///< dn_swap7.wsg
+    DN_SWAP_8_WSG = 647, ///< dn_swap8.wsg
+    DN_SWAP_9_WSG = 648, ///< dn_swap9.wsg
+    DN_SWAP_10_WSG = 649, ///< dn_swap10.wsg
+    DN_SWAP_11_WSG = 650, ///< dn_swap11.wsg
+    DN_SWAP_12_WSG = 651, ///< dn_swap12.wsg
+    DN_SWAP_13_WSG = 652, ///< dn_swap13.wsg
+    DN_SWAP_14_WSG = 653, ///< dn_swap14.wsg
+    DN_SWAP_15_WSG = 654, ///< dn_swap15.wsg
+    DN_TEXT_BOX_WSG = 655, ///< dn_textBox.wsg
+    DN_TFT_WSG = 656, ///< dn_tft.wsg
+    DONUT_FEST_BIN = 657, ///< donut_fest.bin
+    DONUT_MAG_BIN = 658, ///< donut_mag.bin
+    DOUBLE_QUAVER_WSG = 659, ///< doubleQuaver.wsg
+    DUMP_BIN = 660, ///< dump.bin
+    E_ANGRY_WSG = 661, ///< e_Angry.wsg
+    E_ANGY_WSG = 662, ///< e_Angy.wsg
+    E_BABY_WSG = 663, ///< e_Baby.wsg
+    E_BIG_WSG = 664, ///< e_Big.wsg
+    E_BIG_LINER_WSG = 665, ///< e_BigLiner.wsg
+    E_BLOOD_WSG = 666, ///< e_Blood.wsg
+    E_BOOPED_WSG = 667, ///< e_Booped.wsg
+    E_CAT_WSG = 668, ///< e_Cat.wsg
+    E_CLOSED_WSG = 669, ///< e_Closed.wsg
+    E_CLOSED_LASHES_WSG = 670, ///< e_ClosedLashes.wsg
+    E_CLOSED_LINER_WSG = 671, ///< e_ClosedLiner.wsg
+    E_CRAZY_WSG = 672, ///< e_Crazy.wsg
+    E_CROSSES_WSG = 673, ///< e_Crosses.wsg
+    E_CRYING_WSG = 674, ///< e_Crying.wsg
+    E_CUTE_WSG = 675, ///< e_Cute.wsg
+    E_DOOFY_WSG = 676, ///< e_Doofy.wsg
+    E_EXASPERATED_WSG = 677, ///< e_Exasperated.wsg
+    E_HEARTS_WSG = 678, ///< e_Hearts.wsg
+    E_LINER_WSG = 679, ///< e_Liner.wsg
+    E_MAKEUP_WSG = 680, ///< e_Makeup.wsg
+    E_MY_EYES_WSG = 681, ///< e_My_Eyes.wsg
+    E_RANDOMIZER_WSG = 682, ///< e_Randomizer.wsg
+    E_SEXY_WSG = 683, ///< e_Sexy.wsg
+    E_SEXY_LASHES_WSG = 684, ///< e_SexyLashes.wsg
+    E_SLEEPING_WSG = 685, ///< e_Sleeping.wsg
+    E_SMALL_WLASHES_WSG = 686, ///< e_SmallWLashes.wsg
+    E_SQUINTING_WSG = 687, ///< e_Squinting.wsg
+    E_SQUINTING_LASHES_WSG = 688, ///< e_SquintingLashes.wsg
+    E_STARE_WSG = 689, ///< e_Stare.wsg
+    E_STARING_WSG = 690, ///< e_Staring.wsg
+    E_SWIRLS_WSG = 691, ///< e_Swirls.wsg
+    E_THIN_WSG = 692, ///< e_Thin.wsg
+    E_WIDE_WSG = 693, ///< e_Wide.wsg
+    EA_BIG_HOOP_WSG = 694, ///< ea_BigHoop.wsg
+    EA_BUNNY_WSG = 695, ///< ea_Bunny.wsg
+    EA_CAT_WSG = 696, ///< ea_Cat.wsg
+    EA_DOG_WSG = 697, ///< ea_Dog.wsg
+    EA_DOWN_COW_WSG = 698, ///< ea_DownCow.wsg
+    EA_DWARF_WSG = 699, ///< ea_Dwarf.wsg
+    EA_EARRINGS_WSG = 700, ///< ea_Earrings.wsg
+    EA_ELF_WSG = 701, ///< ea_Elf.wsg
+    EA_LEFT_WSG = 702, ///< ea_Left.wsg
+    EA_MEDIUM_HOOP_WSG = 703, ///< ea_MediumHoop.wsg
+    EA_OPEN_COW_WSG = 704, ///< ea_OpenCow.wsg
+    EA_RIGHT_WSG = 705, ///< ea_Right.wsg
+    EA_SMALL_HOOP_WSG = 706, ///< ea_SmallHoop.wsg
+    EARLY_GAMEBOY_FONT = 707, ///< early_gameboy.font
+    EB_ARCHED_WSG = 708, ///< eb_Arched.wsg
+    EB_BUSHY_WSG = 709, ///< eb_Bushy.wsg
+    EB_CONCERN_WSG = 710, ///< eb_Concern.wsg
+    EB_CUT_LEFT_WSG = 711, ///< eb_CutLeft.wsg
+    EB_CUT_LEFT_PIERCING_WSG = 712, ///< eb_CutLeftPiercing.wsg
+    EB_CUT_RIGHT_WSG = 713, ///< eb_CutRight.wsg
+    EB_CUT_RIGHT_PIERCING_WSG = 714, ///< eb_CutRightPiercing.wsg
+    EB_DOT_WSG = 715, ///< eb_Dot.wsg
+    EB_DOWNTURNED_WSG = 716, ///< eb_Downturned.wsg
+    EB_HMM_WSG = 717, ///< eb_Hmm.wsg
+    EB_MISCHIEVOUS_WSG = 718, ///< eb_Mischievous.wsg
+    EB_ODD_WSG = 719, ///< eb_Odd.wsg
+    EB_PUFFY_WSG = 720, ///< eb_Puffy.wsg
+    EB_SLIGHT_CONCERN_WSG = 721, ///< eb_SlightConcern.wsg
+    EB_THICC_WSG = 722, ///< eb_Thicc.wsg
+    EB_THIN_WSG = 723, ///< eb_Thin.wsg
+    EB_TINY_WSG = 724, ///< eb_Tiny.wsg
+    EIGHTBIT_ATARI_GRUBE_2_FONT = 725, ///< eightbit_atari_grube2.font
+    ENABLE_WSG = 726, ///< enable.wsg
+    ENSEMBLE_WSG = 727, ///< ensemble.wsg
+    ETHNIC_WSG = 728, ///< ethnic.wsg
+    EXAMPLE_BG_WSG = 729, ///< exampleBG.wsg
+    EYES_CL_GS = 730, ///< eyes_cl.gs
+    EYES_CR_GS = 731, ///< eyes_cr.gs
+    EYES_DC_GS = 732, ///< eyes_dc.gs
+    EYES_DEAD_GS = 733, ///< eyes_dead.gs
+    EYES_DEFAULT_GS = 734, ///< eyes_default.gs
+    EYES_DL_GS = 735, ///< eyes_dl.gs
+    EYES_DR_GS = 736, ///< eyes_dr.gs
+    EYES_HAPPY_GS = 737, ///< eyes_happy.gs
+    EYES_SAD_GS = 738, ///< eyes_sad.gs
+    EYES_SWIRL_0_GS = 739, ///< eyes_swirl0.gs
+    EYES_SWIRL_1_GS = 740, ///< eyes_swirl1.gs
+    EYES_SWIRL_2_GS = 741, ///< eyes_swirl2.gs
+    EYES_SWIRL_3_GS = 742, ///< eyes_swirl3.gs
+    EYES_UC_GS = 743, ///< eyes_uc.gs
+    EYES_UL_GS = 744, ///< eyes_ul.gs
+    EYES_UR_GS = 745, ///< eyes_ur.gs
+    F_CLEF_WSG = 746, ///< fClef.wsg
+    FAST_FORWARD_WSG = 747, ///< fast_forward.wsg
+    FLAT_IBM_VGA_8_WSG = 748, ///< flat_ibm_vga8.wsg
+    FLAT_LOGBOOK_WSG = 749, ///< flat_logbook.wsg
+    G_3D_WSG = 750, ///< g_3D.wsg
+    G_ANIME_WSG = 751, ///< g_Anime.wsg
+    G_BANDAGE_WSG = 752, ///< g_Bandage.wsg
+    G_BIG_WSG = 753, ///< g_Big.wsg
+    G_BIG_ANGLE_WSG = 754, ///< g_BigAngle.wsg
+    G_BIG_ANGLE_SUN_WSG = 755, ///< g_BigAngleSun.wsg
+    G_BIG_SQUARE_WSG = 756, ///< g_BigSquare.wsg
+    G_BIG_SQUARE_SUN_WSG = 757, ///< g_BigSquareSun.wsg
+    G_BLACK_SUN_WSG = 758, ///< g_BlackSun.wsg
+    G_CUTE_PATCH_WSG = 759, ///< g_CutePatch.wsg
+    G_EGGMAN_WSG = 760, ///< g_Eggman.wsg
+    G_GOEORDI_WSG = 761, ///< g_Goeordi.wsg
+    G_LINDA_WSG = 762, ///< g_Linda.wsg
+    G_LINDA_SUN_WSG = 763, ///< g_LindaSun.wsg
+    G_LOW_WSG = 764, ///< g_Low.wsg
+    G_LOW_SUN_WSG = 765, ///< g_LowSun.wsg
+    G_PATCH_WSG = 766, ///< g_Patch.wsg
+    G_RAY_BAN_WSG = 767, ///< g_RayBan.wsg
+    G_RAY_BAN_SUN_WSG = 768, ///< g_RayBanSun.wsg
+    G_READING_WSG = 769, ///< g_Reading.wsg
+    G_SCOUTER_WSG = 770, ///< g_Scouter.wsg
+    G_SMALL_WSG = 771, ///< g_Small.wsg
+    G_SQUARE_WSG = 772, ///< g_Square.wsg
+    G_SQUARE_SUN_WSG = 773, ///< g_SquareSun.wsg
+    G_SQUIRTLE_SQUAD_WSG = 774, ///< g_SquirtleSquad.wsg
+    G_THIN_ANGLE_WSG = 775, ///< g_ThinAngle.wsg
+    G_THIN_ANGLE_SUN_WSG = 776, ///< g_ThinAngleSun.wsg
+    G_UPTURNED_WSG = 777, ///< g_Upturned.wsg
+    G_UPTURNED_SUN_WSG = 778, ///< g_UpturnedSun.wsg
+    G_WIDE_NOSE_WSG = 779, ///< g_WideNose.wsg
+    G_WIDE_NOSE_SUN_WSG = 780, ///< g_WideNoseSun.wsg
+    GAMECUBE_MID = 781, ///< gamecube.mid
+    GMCC_MID = 782, ///< gmcc.mid
+    GOLD_CORNER_TR_WSG = 783, ///< goldCornerTR.wsg
+    GOLD_TROPHY_WSG = 784, ///< goldTrophy.wsg
+    GUITAR_WSG = 785, ///< guitar.wsg
+    H_BALLET_BUN_WSG = 786, ///< h_BalletBun.wsg
+    H_BOWL_CUT_WSG = 787, ///< h_BowlCut.wsg
+    H_CHIBIUSA_WSG = 788, ///< h_Chibiusa.wsg
+    H_CURLY_WSG = 789, ///< h_Curly.wsg
+    H_CUTE_WSG = 790, ///< h_Cute.wsg
+    H_CUTE_BANGS_WSG = 791, ///< h_CuteBangs.wsg
+    H_DOLLY_WSG = 792, ///< h_Dolly.wsg
+    H_DOWN_DREADS_WSG = 793, ///< h_DownDreads.wsg
+    H_DOWN_DREADS_R_WSG = 794, ///< h_DownDreadsR.wsg
+    H_FRANKEY_STEIN_WSG = 795, ///< h_FrankeyStein.wsg
+    H_FRO_WSG = 796, ///< h_Fro.wsg
+    H_HINATA_WSG = 797, ///< h_Hinata.wsg
+    H_JINX_WSG = 798, ///< h_Jinx.wsg
+    H_JINX_HALF_WSG = 799, ///< h_Jinx_half.wsg
+    H_LONG_WSG = 800, ///< h_Long.wsg
+    H_LONG_PIGS_WSG = 801, ///< h_LongPigs.wsg
+    H_MCR_WSG = 802, ///< h_MCR.wsg
+    H_MAIN_CHARACTER_WSG = 803, ///< h_MainCharacter.wsg
+    H_MAIN_CHARACTER_R_WSG = 804, ///< h_MainCharacterR.wsg
+    H_MAIN_VILLAIN_WSG = 805, ///< h_MainVillain.wsg
+    H_MAIN_VILLAIN_R_WSG = 806, ///< h_MainVillainR.wsg
+    H_MALE_PATTERN_WSG = 807, ///< h_MalePattern.wsg
+    H_MINAKO_WSG = 808, ///< h_Minako.wsg
+    H_MOHAWK_WSG = 809, ///< h_Mohawk.wsg
+    H_POMPADOUR_WSG = 810, ///< h_Pompadour.wsg
+    H_PONYTAIL_WSG = 811, ///< h_Ponytail.wsg
+    H_PONYTAIL_NO_BANGS_WSG = 812, ///< h_PonytailNoBangs.wsg
+    H_RAVEN_WSG = 813, ///< h_Raven.wsg
+    H_SHORT_WSG = 814, ///< h_Short.wsg
+    H_SHORT_PIGS_WSG = 815, ///< h_ShortPigs.wsg
+    H_SIDE_PUFFS_WSG = 816, ///< h_SidePuffs.wsg
+    H_SIDE_PUFFS_R_WSG = 817, ///< h_SidePuffsR.wsg
+    H_SKULL_WSG = 818, ///< h_Skull.wsg
+    H_SKULL_R_WSG = 819, ///< h_SkullR.wsg
+    H_SMALL_BUNS_WSG = 820, ///< h_SmallBuns.wsg
+    H_SPOCK_WSG = 821, ///< h_Spock.wsg
+    H_STAR_PUFF_NB_WSG = 822, ///< h_StarPuffNB.wsg
+    H_STAR_PUFFS_WSG = 823, ///< h_StarPuffs.wsg
+    H_STAR_PUFFS_R_WSG = 824, ///< h_StarPuffsR.wsg
+    H_TATTOO_WSG = 825, ///< h_Tattoo.wsg
+    H_THING_WSG = 826, ///< h_Thing.wsg
+    H_USAGI_WSG = 827, ///< h_Usagi.wsg
+    H_VBANG_WSG = 828, ///< h_VBang.wsg
+    H_WAVY_HAWK_WSG = 829, ///< h_WavyHawk.wsg
+    H_WAVY_HAWK_R_WSG = 830, ///< h_WavyHawkR.wsg
+    H_WAVY_LONG_WSG = 831, ///< h_WavyLong.wsg
+    H_WAVY_SHORT_WSG = 832, ///< h_WavyShort.wsg
+    H_WEDNESDAY_WSG = 833, ///< h_Wednesday.wsg
+    H_WEDNESDAY_R_WSG = 834, ///< h_WednesdayR.wsg
+    H_WET_CURLY_WSG = 835, ///< h_WetCurly.wsg
+    H_WET_SHORT_WSG = 836, ///< h_WetShort.wsg
+    HA_ANGEL_WSG = 837, ///< ha_Angel.wsg
+    HA_BATTRICE_WSG = 838, ///< ha_Battrice.wsg
+    HA_BEANIE_WSG = 839, ///< ha_Beanie.wsg
+    HA_BIGMA_WSG = 840, ///< ha_Bigma.wsg
+    HA_BLITZO_WSG = 841, ///< ha_Blitzo.wsg
+    HA_CHAOS_GOBLIN_WSG = 842, ///< ha_Chaos_Goblin.wsg
+    HA_CHEF_WSG = 843, ///< ha_Chef.wsg
+    HA_COOL_HAT_WSG = 844, ///< ha_CoolHat.wsg
+    HA_COWBOY_WSG = 845, ///< ha_Cowboy.wsg
+    HA_DEVIL_WSG = 846, ///< ha_Devil.wsg
+    HA_GARBOTNIK_WSG = 847, ///< ha_Garbotnik.wsg
+    HA_GRAD_CAP_WSG = 848, ///< ha_GradCap.wsg
+    HA_HEART_WSG = 849, ///< ha_Heart.wsg
+    HA_HOMESTUCK_WSG = 850, ///< ha_Homestuck.wsg
+    HA_KINETIC_DONUT_WSG = 851, ///< ha_KineticDonut.wsg
+    HA_MET_HELMET_WSG = 852, ///< ha_MetHelmet.wsg
+    HA_MILLIE_WSG = 853, ///< ha_Millie.wsg
+    HA_MINI_HOMESTUCK_WSG = 854, ///< ha_Mini_Homestuck.wsg
+    HA_MOXXIE_WSG = 855, ///< ha_Moxxie.wsg
+    HA_PUFFBALL_BEANIE_WSG = 856, ///< ha_PuffballBeanie.wsg
+    HA_PULSE_WSG = 857, ///< ha_Pulse.wsg
+    HA_SANS_WSG = 858, ///< ha_Sans.wsg
+    HA_SAWTOOTH_WSG = 859, ///< ha_Sawtooth.wsg
+    HA_TV_HEAD_WSG = 860, ///< ha_TV_Head.wsg
+    HA_TALL_HOMESTUCK_WSG = 861, ///< ha_Tall_Homestuck.wsg
+    HA_TENNA_WSG = 862, ///< ha_Tenna.wsg
+    HA_TINY_HOMESTUCK_WSG = 863, ///< ha_Tiny_Homestuck.wsg
+    HA_TRON_WSG = 864, ///< ha_Tron.wsg
+    HA_VEROSIKA_WSG = 865, ///< ha_Verosika.wsg
+    HA_WIDE_HOMESTUCK_WSG = 866, ///< ha_Wide_Homestuck.wsg
+    HALF_NOTE_WSG = 867, ///< halfNote.wsg
+    HAMBURGER_WSG = 868, ///< hamburger.wsg
+    HD_CREDITS_MID = 869, ///< hd_credits.mid
+    HIGHQ_BIN = 870, ///< highq.bin
+    HOTROD_MID = 871, ///< hotrod.mid
+    IBM_VGA_8_FONT = 872, ///< ibm_vga8.font
+    IGNORE_WSG = 873, ///< ignore.wsg
+    INTERFACE_WSG = 874, ///< interface.wsg
+    INTRO_SWADGE_CHOPPED_WSG = 875, ///< intro_swadge_chopped.wsg
+    INTROJINGLE_MID = 876, ///< introjingle.mid
+    JUKEBOX_WSG = 877, ///< jukebox.wsg
+    KD_TILE_032_WSG = 878, ///< kd_tile032.wsg
+    KD_TILE_033_WSG = 879, ///< kd_tile033.wsg
+    KD_TILE_034_WSG = 880, ///< kd_tile034.wsg
+    KD_TILE_035_WSG = 881, ///< kd_tile035.wsg
+    KD_TILE_036_WSG = 882, ///< kd_tile036.wsg
+    KD_TILE_037_WSG = 883, ///< kd_tile037.wsg
+    KD_TILE_038_WSG = 884, ///< kd_tile038.wsg
+    KD_TILE_039_WSG = 885, ///< kd_tile039.wsg
+    KD_TILE_040_WSG = 886, ///< kd_tile040.wsg
+    KD_TILE_041_WSG = 887, ///< kd_tile041.wsg
+    KD_TILE_042_WSG = 888, ///< kd_tile042.wsg
+    KD_TILE_043_WSG = 889, ///< kd_tile043.wsg
+    KD_TILE_044_WSG = 890, ///< kd_tile044.wsg
+    KD_TILE_045_WSG = 891, ///< kd_tile045.wsg
+    KD_TILE_046_WSG = 892, ///< kd_tile046.wsg
+    KD_TILE_047_WSG = 893, ///< kd_tile047.wsg
+    KD_TILE_048_WSG = 894, ///< kd_tile048.wsg
+    KD_TILE_049_WSG = 895, ///< kd_tile049.wsg
+    KD_TILE_050_WSG = 896, ///< kd_tile050.wsg
+    KD_TILE_051_WSG = 897, ///< kd_tile051.wsg
+    KD_TILE_052_WSG = 898, ///< kd_tile052.wsg
+    KD_TILE_053_WSG = 899, ///< kd_tile053.wsg
+    KD_TILE_054_WSG = 900, ///< kd_tile054.wsg
+    KD_TILE_055_WSG = 901, ///< kd_tile055.wsg
+    KD_TILE_056_WSG = 902, ///< kd_tile056.wsg
+    KD_TILE_057_WSG = 903, ///< kd_tile057.wsg
+    KD_TILE_058_WSG = 904, ///< kd_tile058.wsg
+    KD_TILE_059_WSG = 905, ///< kd_tile059.wsg
+    KD_TILE_060_WSG = 906, ///< kd_tile060.wsg
+    KD_TILE_061_WSG = 907, ///< kd_tile061.wsg
+    KD_TILE_062_WSG = 908, ///< kd_tile062.wsg
+    KD_TILE_063_WSG = 909, ///< kd_tile063.wsg
+    KD_TILE_064_WSG = 910, ///< kd_tile064.wsg
+    KD_TILE_065_WSG = 911, ///< kd_tile065.wsg
+    KD_TILE_066_WSG = 912, ///< kd_tile066.wsg
+    KD_TILE_067_WSG = 913, ///< kd_tile067.wsg
+    KD_TILE_068_WSG = 914, ///< kd_tile068.wsg
+    KD_TILE_069_WSG = 915, ///< kd_tile069.wsg
+    KD_TILE_070_WSG = 916, ///< kd_tile070.wsg
+    KD_TILE_071_WSG = 917, ///< kd_tile071.wsg
+    KD_TILE_072_WSG = 918, ///< kd_tile072.wsg
+    KD_TILE_073_WSG = 919, ///< kd_tile073.wsg
+    KD_TILE_074_WSG = 920, ///< kd_tile074.wsg
+    KD_TILE_075_WSG = 921, ///< kd_tile075.wsg
+    KD_TILE_076_WSG = 922, ///< kd_tile076.wsg
+    KD_TILE_077_WSG = 923, ///< kd_tile077.wsg
+    KD_TILE_078_WSG = 924, ///< kd_tile078.wsg
+    KD_TILE_079_WSG = 925, ///< kd_tile079.wsg
+    KD_TILE_080_WSG = 926, ///< kd_tile080.wsg
+    KD_TILE_081_WSG = 927, ///< kd_tile081.wsg
+    KD_TILE_082_WSG = 928, ///< kd_tile082.wsg
+    KD_TILE_083_WSG = 929, ///< kd_tile083.wsg
+    KD_TILE_084_WSG = 930, ///< kd_tile084.wsg
+    KD_TILE_085_WSG = 931, ///< kd_tile085.wsg
+    KD_TILE_086_WSG = 932, ///< kd_tile086.wsg
+    KD_TILE_087_WSG = 933, ///< kd_tile087.wsg
+    KD_TILE_088_WSG = 934, ///< kd_tile088.wsg
+    KD_TILE_089_WSG = 935, ///< kd_tile089.wsg
+    KD_TILE_090_WSG = 936, ///< kd_tile090.wsg
+    KD_TILE_091_WSG = 937, ///< kd_tile091.wsg
+    KD_TILE_092_WSG = 938, ///< kd_tile092.wsg
+    KD_TILE_093_WSG = 939, ///< kd_tile093.wsg
+    KD_TILE_094_WSG = 940, ///< kd_tile094.wsg
+    KD_TILE_095_WSG = 941, ///< kd_tile095.wsg
+    KD_TILE_096_WSG = 942, ///< kd_tile096.wsg
+    KD_TILE_097_WSG = 943, ///< kd_tile097.wsg
+    KD_TILE_098_WSG = 944, ///< kd_tile098.wsg
+    KD_TILE_099_WSG = 945, ///< kd_tile099.wsg
+    KD_TILE_100_WSG = 946, ///< kd_tile100.wsg
+    KD_TILE_101_WSG = 947, ///< kd_tile101.wsg
+    KD_TILE_102_WSG = 948, ///< kd_tile102.wsg
+    KD_TILE_103_WSG = 949, ///< kd_tile103.wsg
+    KD_TILE_104_WSG = 950, ///< kd_tile104.wsg
+    KD_TILE_105_WSG = 951, ///< kd_tile105.wsg
+    KD_TILE_106_WSG = 952, ///< kd_tile106.wsg
+    KD_TILE_107_WSG = 953, ///< kd_tile107.wsg
+    KD_TILE_108_WSG = 954, ///< kd_tile108.wsg
+    KD_TILE_109_WSG = 955, ///< kd_tile109.wsg
+    KD_TILE_110_WSG = 956, ///< kd_tile110.wsg
+    KD_TILE_160_WSG = 957, ///< kd_tile160.wsg
+    KD_TILE_192_WSG = 958, ///< kd_tile192.wsg
+    KD_TILE_193_WSG = 959, ///< kd_tile193.wsg
+    KD_TILE_194_WSG = 960, ///< kd_tile194.wsg
+    KD_TILE_195_WSG = 961, ///< kd_tile195.wsg
+    KD_TILE_196_WSG = 962, ///< kd_tile196.wsg
+    KD_TILE_197_WSG = 963, ///< kd_tile197.wsg
+    KICK_BIN = 964, ///< kick.bin
+    KID_0_WSG = 965, ///< kid0.wsg
+    KID_1_WSG = 966, ///< kid1.wsg
+    KINETIC_DONUT_BIN = 967, ///< kinetic-donut.bin
+    LEDS_DISABLED_WSG = 968, ///< ledsDisabled.wsg
+    LEDS_ENABLED_WSG = 969, ///< ledsEnabled.wsg
+    LEVEL_SELECT_BIN = 970, ///< level-select.bin
+    LEVEL_1_1_OLD_BIN = 971, ///< level1-1-old.bin
+    LEVEL_1_3_BIN = 972, ///< level1-3.bin
+    LEVEL_1_4_BIN = 973, ///< level1-4.bin
+    LEVEL_2_1_BIN = 974, ///< level2-1.bin
+    LEVEL_2_3_BIN = 975, ///< level2-3.bin
+    LEVEL_2_4_BIN = 976, ///< level2-4.bin
+    LEVEL_3_1_BIN = 977, ///< level3-1.bin
+    LEVEL_3_2_BIN = 978, ///< level3-2.bin
+    LEVEL_3_3_BIN = 979, ///< level3-3.bin
+    LEVEL_3_4_BIN = 980, ///< level3-4.bin
+    LEVEL_4_1_BIN = 981, ///< level4-1.bin
+    LEVEL_4_2_BIN = 982, ///< level4-2.bin
+    LEVEL_4_3_BIN = 983, ///< level4-3.bin
+    LEVEL_4_4_BIN = 984, ///< level4-4.bin
+    LEVEL_02_BIN = 985, ///< level02.bin
+    LOGBOOK_FONT = 986, ///< logbook.font
+    LOOP_WSG = 987, ///< loop.wsg
+    LULLABY_IN_NUMBERS_MID = 988, ///< lullaby_in_numbers.mid
+    M_AH_WSG = 989, ///< m_Ah.wsg
+    M_ANGEL_BITE_WSG = 990, ///< m_AngelBite.wsg
+    M_BAR_PIERCING_WSG = 991, ///< m_BarPiercing.wsg
+    M_BITE_WSG = 992, ///< m_Bite.wsg
+    M_BITE_PIERCING_WSG = 993, ///< m_BitePiercing.wsg
+    M_CENSOR_WSG = 994, ///< m_Censor.wsg
+    M_CONCERN_WSG = 995, ///< m_Concern.wsg
+    M_CONTENT_WSG = 996, ///< m_Content.wsg
+    M_DROOL_WSG = 997, ///< m_Drool.wsg
+    M_HALF_SMILE_WSG = 998, ///< m_HalfSmile.wsg
+    M_KET_WSG = 999, ///< m_Ket.wsg
+    M_KISSES_WSG = 1000, ///< m_Kisses.wsg
+    M_LIP_WSG = 1001, ///< m_Lip.wsg
+    M_LITTLE_DROOL_WSG = 1002, ///< m_LittleDrool.wsg
+    M_MISCHIEF_WSG = 1003, ///< m_Mischief.wsg
+    M_MLEM_WSG = 1004, ///< m_Mlem.wsg
+    M_NO_CUPID_BOW_WSG = 1005, ///< m_NoCupidBow.wsg
+    M_OH_WSG = 1006, ///< m_Oh.wsg
+    M_OH_PIERCING_WSG = 1007, ///< m_OhPiercing.wsg
+    M_OPEN_SMILE_WSG = 1008, ///< m_OpenSmile.wsg
+    M_PIERCING_WSG = 1009, ///< m_Piercing.wsg
+    M_POUTY_WSG = 1010, ///< m_Pouty.wsg
+    M_SAD_WSG = 1011, ///< m_Sad.wsg
+    M_SAD_PIERCING_WSG = 1012, ///< m_SadPiercing.wsg
+    M_SATISFIED_WSG = 1013, ///< m_Satisfied.wsg
+    M_SMILE_WSG = 1014, ///< m_Smile.wsg
+    M_STOIC_WSG = 1015, ///< m_Stoic.wsg
+    M_TONGUE_WSG = 1016, ///< m_Tongue.wsg
+    M_TONGUE_PIERCING_WSG = 1017, ///< m_TonguePiercing.wsg
+    M_UHM_WSG = 1018, ///< m_Uhm.wsg
+    M_VAMPIRE_WSG = 1019, ///< m_Vampire.wsg
+    M_YELLING_WSG = 1020, ///< m_Yelling.wsg
+    MAGCOM_2_WSG = 1021, ///< magcom2.wsg
+    MAGCOM_3_WSG = 1022, ///< magcom3.wsg
+    MAGCOM_4_WSG = 1023, ///< magcom4.wsg
+    MAGCOM_5_WSG = 1024, ///< magcom5.wsg
+    MAGFEST_BANK_WSG = 1025, ///< magfest_bank.wsg
+    MATRIX_BLINKS_CFUN_BIN = 1026, ///< matrix_blinks.cfun.bin
+    MATRIX_DROPS_CFUN_BIN = 1027, ///< matrix_drops.cfun.bin
+    MATRIX_FACTORY_CFUN_BIN = 1028, ///< matrix_factory.cfun.bin
+    MATRIX_GRADIENT_CFUN_BIN = 1029, ///< matrix_gradient.cfun.bin
+    MEGAMAX_JONES_SMALL_FONT = 1030, ///< megamaxJones.small.font
+    METRONOME_BOTTOM_WSG = 1031, ///< metronomeBottom.wsg
+    METRONOME_TOP_WSG = 1032, ///< metronomeTop.wsg
+    MG_LEVEL_SELECT_TILE_001_WSG = 1033, ///< mgLevelSelectTile001.wsg
+    MG_LEVEL_SELECT_TILE_002_WSG = 1034, ///< mgLevelSelectTile002.wsg
+    MG_LEVEL_SELECT_TILE_003_WSG = 1035, ///< mgLevelSelectTile003.wsg
+    MG_LEVEL_SELECT_TILE_004_WSG = 1036, ///< mgLevelSelectTile004.wsg
+    MG_LEVEL_SELECT_TILE_005_WSG = 1037, ///< mgLevelSelectTile005.wsg
+    MG_LEVEL_SELECT_TILE_006_WSG = 1038, ///< mgLevelSelectTile006.wsg
+    MG_LEVEL_SELECT_TILE_007_WSG = 1039, ///< mgLevelSelectTile007.wsg
+    MG_LEVEL_SELECT_TILE_008_WSG = 1040, ///< mgLevelSelectTile008.wsg
+    MG_LEVEL_SELECT_TILE_009_WSG = 1041, ///< mgLevelSelectTile009.wsg
+    MG_LEVEL_SELECT_TILE_010_WSG = 1042, ///< mgLevelSelectTile010.wsg
+    MIDI_VOLUME_WSG = 1043, ///< midi_volume.wsg
+    MM_FONT = 1044, ///< mm.font
+    MMM_BACK_WSG = 1045, ///< mmm_back.wsg
+    MMM_BG_WSG = 1046, ///< mmm_bg.wsg
+    MMM_BODY_BOTTOM_WSG = 1047, ///< mmm_body_bottom.wsg
+    MMM_BODY_TOP_WSG = 1048, ///< mmm_body_top.wsg
+    MMM_DOWN_WSG = 1049, ///< mmm_down.wsg
+    MMM_ITEM_WSG = 1050, ///< mmm_item.wsg
+    MMM_ITEM_SEL_WSG = 1051, ///< mmm_item_sel.wsg
+    MMM_NEXT_WSG = 1052, ///< mmm_next.wsg
+    MMM_PREV_WSG = 1053, ///< mmm_prev.wsg
+    MMM_SUBMENU_WSG = 1054, ///< mmm_submenu.wsg
+    MMM_UP_WSG = 1055, ///< mmm_up.wsg
+    MMX_TROPHY_WSG = 1056, ///< mmxTrophy.wsg
+    MUSIC_DISABLED_WSG = 1057, ///< musicDisabled.wsg
+    MUSIC_ENABLED_WSG = 1058, ///< musicEnabled.wsg
+    NORI_2_BIN = 1059, ///< nori2.bin
+    ODE_MID = 1060, ///< ode.mid
+    OPEN_SONG_WSG = 1061, ///< open_song.wsg
+    OPENHIHAT_BIN = 1062, ///< openhihat.bin
+    ORGAN_WSG = 1063, ///< organ.wsg
+    OXANIUM_FONT = 1064, ///< oxanium.font
+    PANGO_FW_FONT = 1065, ///< pango-fw.font
+    PAUSE_WSG = 1066, ///< pause.wsg
+    PERCUSSION_WSG = 1067, ///< percussion.wsg
+    PERCUSSIVE_WSG = 1068, ///< percussive.wsg
+    PIANO_WSG = 1069, ///< piano.wsg
+    PINKIE_WSG = 1070, ///< pinkie.wsg
+    PIPE_WSG = 1071, ///< pipe.wsg
+    PITCH_WHEEL_WSG = 1072, ///< pitch_wheel.wsg
+    PLACEHOLDER_24X_24_WSG = 1073, ///< placeholder_24x24.wsg
+    PLACEHOLDER_30X_30_WSG = 1074, ///< placeholder_30x30.wsg
+    PLAY_WSG = 1075, ///< play.wsg
+    PLAYER_WSG = 1076, ///< player.wsg
+    PLAYPAUSE_WSG = 1077, ///< playpause.wsg
+    POWERSNARE_BIN = 1078, ///< powersnare.bin
+    PRESS_IT_RAW = 1079, ///< press_it.raw
+    PULSE_AUX_FONT = 1080, ///< pulseAux.font
+    QUAVER_WSG = 1081, ///< quaver.wsg
+    RADIOSTARS_FONT = 1082, ///< radiostars.font
+    REED_WSG = 1083, ///< reed.wsg
+    RESET_WSG = 1084, ///< reset.wsg
+    RETRO_LOGO_FONT = 1085, ///< retro_logo.font
+    RIGHTEOUS_150_FONT = 1086, ///< righteous_150.font
+    ROBO_RUNNER_BGM_MID = 1087, ///< roboRunnerBGM.mid
+    RODIN_EB_FONT = 1088, ///< rodin_eb.font
+    SALSA_WSG = 1089, ///< salsa.wsg
+    SECRET_MID = 1090, ///< secret.mid
+    SEQ_DRUMS_WSG = 1091, ///< seq_drums.wsg
+    SEQ_EIGHTH_NOTE_WSG = 1092, ///< seq_eighth_note.wsg
+    SEQ_GUITAR_WSG = 1093, ///< seq_guitar.wsg
+    SEQ_HALF_NOTE_WSG = 1094, ///< seq_half_note.wsg
+    SEQ_PIANO_WSG = 1095, ///< seq_piano.wsg
+    SEQ_QUARTER_NOTE_WSG = 1096, ///< seq_quarter_note.wsg
+    SEQ_SAX_WSG = 1097, ///< seq_sax.wsg
+    SEQ_SIXTEENTH_NOTE_WSG = 1098, ///< seq_sixteenth_note.wsg
+    SEQ_SYNTH_WSG = 1099, ///< seq_synth.wsg
+    SEQ_TRUMPET_WSG = 1100, ///< seq_trumpet.wsg
+    SEQ_WHOLE_NOTE_WSG = 1101, ///< seq_whole_note.wsg
+    SEVEN_SEGMENT_FONT = 1102, ///< seven_segment.font
+    SF_MMX_011_VIBRAPHONE_BIN = 1103, ///< sf_mmx_011_vibraphone.bin
+    SF_MMX_017_ORGAN_BIN = 1104, ///< sf_mmx_017_organ.bin
+    SF_MMX_024_ACOUSTIC_GUITAR_BIN = 1105, ///< sf_mmx_024_acoustic_guitar.bin
+    SF_MMX_029_OVERDRIVEN_GUITAR_BIN = 1106, ///< sf_mmx_029_overdriven_guitar.bin
+    SF_MMX_030_DISTORTION_GUITAR_BIN = 1107, ///< sf_mmx_030_distortion_guitar.bin
+    SF_MMX_036_SLAP_BASS_BIN = 1108, ///< sf_mmx_036_slap_bass.bin
+    SF_MMX_038_SYNTH_BASS_BIN = 1109, ///< sf_mmx_038_synth_bass.bin
+    SF_MMX_048_STRINGS_BIN = 1110, ///< sf_mmx_048_strings.bin
+    SF_MMX_055_ORCHESTRA_HIT_BIN = 1111, ///< sf_mmx_055_orchestra_hit.bin
+    SF_MMX_062_SYNTH_BRASS_BIN = 1112, ///< sf_mmx_062_synth_brass.bin
+    SF_MMX_080_SQUARE_WAVE_BIN = 1113, ///< sf_mmx_080_square_wave.bin
+    SF_MMX_081_SAWTOOTH_WAVE_BIN = 1114, ///< sf_mmx_081_sawtooth_wave.bin
+    SF_MMX_082_SYNTH_LEAD_BIN = 1115, ///< sf_mmx_082_synth_lead.bin
+    SF_MMX_083_SYNTH_LEAD_2_BIN = 1116, ///< sf_mmx_083_synth_lead_2.bin
+    SFX_DISABLED_WSG = 1117, ///< sfxDisabled.wsg
+    SFX_ENABLED_WSG = 1118, ///< sfxEnabled.wsg
+    SHAKE_IT_RAW = 1119, ///< shake_it.raw
+    SHUFFLE_WSG = 1120, ///< shuffle.wsg
+    SI_BAT_WSG = 1121, ///< si_bat.wsg
+    SI_PANGO_WSG = 1122, ///< si_pango.wsg
+    SI_PULSE_WSG = 1123, ///< si_pulse.wsg
+    SI_SAWTOOTH_WSG = 1124, ///< si_sawtooth.wsg
+    SILVER_TROPHY_WSG = 1125, ///< silverTrophy.wsg
+    SKIP_WSG = 1126, ///< skip.wsg
+    SNARE_BIN = 1127, ///< snare.bin
+    SND_1UP_MID = 1128, ///< snd1up.mid
+    SND_BREAK_MID = 1129, ///< sndBreak.mid
+    SND_CHECKPOINT_MID = 1130, ///< sndCheckpoint.mid
+    SND_COIN_MID = 1131, ///< sndCoin.mid
+    SND_DIE_MID = 1132, ///< sndDie.mid
+    SND_HIT_MID = 1133, ///< sndHit.mid
+    SND_HURT_MID = 1134, ///< sndHurt.mid
+    SND_JUMP_1_MID = 1135, ///< sndJump1.mid
+    SND_JUMP_2_MID = 1136, ///< sndJump2.mid
+    SND_JUMP_3_MID = 1137, ///< sndJump3.mid
+    SND_LEVEL_CLEAR_A_MID = 1138, ///< sndLevelClearA.mid
+    SND_LEVEL_CLEAR_B_MID = 1139, ///< sndLevelClearB.mid
+    SND_LEVEL_CLEAR_C_MID = 1140, ///< sndLevelClearC.mid
+    SND_LEVEL_CLEAR_D_MID = 1141, ///< sndLevelClearD.mid
+    SND_LEVEL_CLEAR_S_MID = 1142, ///< sndLevelClearS.mid
+    SND_MENU_CONFIRM_MID = 1143, ///< sndMenuConfirm.mid
+    SND_MENU_DENY_MID = 1144, ///< sndMenuDeny.mid
+    SND_MENU_SELECT_MID = 1145, ///< sndMenuSelect.mid
+    SND_OUT_OF_TIME_MID = 1146, ///< sndOutOfTime.mid
+    SND_PAUSE_MID = 1147, ///< sndPause.mid
+    SND_POWER_UP_MID = 1148, ///< sndPowerUp.mid
+    SND_SQUISH_MID = 1149, ///< sndSquish.mid
+    SND_TALLY_MID = 1150, ///< sndTally.mid
+    SND_WARP_MID = 1151, ///< sndWarp.mid
+    SND_WAVE_BALL_MID = 1152, ///< sndWaveBall.mid
+    SOLO_STRINGS_WSG = 1153, ///< solo_strings.wsg
+    SONIC_FONT = 1154, ///< sonic.font
+    SOUND_EFFECTS_WSG = 1155, ///< sound_effects.wsg
+    SPK_WSG = 1156, ///< spk.wsg
+    SPRITE_000_WSG = 1157, ///< sprite000.wsg
+    SPRITE_001_WSG = 1158, ///< sprite001.wsg
+    SPRITE_002_WSG = 1159, ///< sprite002.wsg
+    SPRITE_003_WSG = 1160, ///< sprite003.wsg
+    SPRITE_004_WSG = 1161, ///< sprite004.wsg
+    SPRITE_005_WSG = 1162, ///< sprite005.wsg
+    SPRITE_006_WSG = 1163, ///< sprite006.wsg
+    SPRITE_007_WSG = 1164, ///< sprite007.wsg
+    SPRITE_008_WSG = 1165, ///< sprite008.wsg
+    SPRITE_009_WSG = 1166, ///< sprite009.wsg
+    SPRITE_012_WSG = 1167, ///< sprite012.wsg
+    SPRITE_013_WSG = 1168, ///< sprite013.wsg
+    SPRITE_014_WSG = 1169, ///< sprite014.wsg
+    SPRITE_015_WSG = 1170, ///< sprite015.wsg
+    SPRITE_016_WSG = 1171, ///< sprite016.wsg
+    SPRITE_017_WSG = 1172, ///< sprite017.wsg
+    SPRITE_018_WSG = 1173, ///< sprite018.wsg
+    SPRITE_019_WSG = 1174, ///< sprite019.wsg
+    SPRITE_020_WSG = 1175, ///< sprite020.wsg
+    SPRITE_021_WSG = 1176, ///< sprite021.wsg
+    SPRITE_022_WSG = 1177, ///< sprite022.wsg
+    SPRITE_023_WSG = 1178, ///< sprite023.wsg
+    SPRITE_024_WSG = 1179, ///< sprite024.wsg
+    SPRITE_025_WSG = 1180, ///< sprite025.wsg
+    SPRITE_026_WSG = 1181, ///< sprite026.wsg
+    SPRITE_027_WSG = 1182, ///< sprite027.wsg
+    SPRITE_028_WSG = 1183, ///< sprite028.wsg
+    SPRITE_029_WSG = 1184, ///< sprite029.wsg
+    SPRITE_033_WSG = 1185, ///< sprite033.wsg
+    SPRITE_034_WSG = 1186, ///< sprite034.wsg
+    SPRITE_035_WSG = 1187, ///< sprite035.wsg
+    SPRITE_036_WSG = 1188, ///< sprite036.wsg
+    SPRITE_037_WSG = 1189, ///< sprite037.wsg
+    SPRITE_038_WSG = 1190, ///< sprite038.wsg
+    SPRITE_039_WSG = 1191, ///< sprite039.wsg
+    SPRITE_040_WSG = 1192, ///< sprite040.wsg
+    SPRITE_041_WSG = 1193, ///< sprite041.wsg
+    SPRITE_042_WSG = 1194, ///< sprite042.wsg
+    SPRITE_043_WSG = 1195, ///< sprite043.wsg
+    SPRITE_044_WSG = 1196, ///< sprite044.wsg
+    SPRITE_045_WSG = 1197, ///< sprite045.wsg
+    SPRITE_046_WSG = 1198, ///< sprite046.wsg
+    SPRITE_047_WSG = 1199, ///< sprite047.wsg
+    SPRITE_048_WSG = 1200, ///< sprite048.wsg
+    SPRITE_049_WSG = 1201, ///< sprite049.wsg
+    STEREO_MID = 1202, ///< stereo.mid
+    STEREO_TEST_MID = 1203, ///< stereo_test.mid
+    STOP_WSG = 1204, ///< stop.wsg
+    STT_BACKGROUND_WSG = 1205, ///< sttBackground.wsg
+    STT_EYES_BLINK_GS = 1206, ///< sttEyesBlink.gs
+    STT_EYES_DEFAULT_GS = 1207, ///< sttEyesDefault.gs
+    STT_EYES_PLAYING_1_GS = 1208, ///< sttEyesPlaying1.gs
+    STT_EYES_PLAYING_2_GS = 1209, ///< sttEyesPlaying2.gs
+    STT_EYES_PLAYING_3_GS = 1210, ///< sttEyesPlaying3.gs
+    STT_EYES_PLAYING_4_GS = 1211, ///< sttEyesPlaying4.gs
+    SUDOKU_NOTES_WSG = 1212, ///< sudoku_notes.wsg
+    SUDOKU_PUZ_000_BSP = 1213, ///< sudoku_puz_000.bsp
+    SUDOKU_PUZ_001_BSP = 1214, ///< sudoku_puz_001.bsp
+    SUDOKU_PUZ_002_BSP = 1215, ///< sudoku_puz_002.bsp
+    SUDOKU_PUZ_003_BSP = 1216, ///< sudoku_puz_003.bsp
+    SUDOKU_PUZ_004_BSP = 1217, ///< sudoku_puz_004.bsp
+    SUDOKU_PUZ_005_BSP = 1218, ///< sudoku_puz_005.bsp
+    SUDOKU_PUZ_006_BSP = 1219, ///< sudoku_puz_006.bsp
+    SUDOKU_PUZ_007_BSP = 1220, ///< sudoku_puz_007.bsp
+    SUDOKU_PUZ_008_BSP = 1221, ///< sudoku_puz_008.bsp
+    SUDOKU_PUZ_009_BSP = 1222, ///< sudoku_puz_009.bsp
+    SUDOKU_PUZ_010_BSP = 1223, ///< sudoku_puz_010.bsp
+    SUDOKU_PUZ_011_BSP = 1224, ///< sudoku_puz_011.bsp
+    SUDOKU_PUZ_012_BSP = 1225, ///< sudoku_puz_012.bsp
+    SUDOKU_PUZ_013_BSP = 1226, ///< sudoku_puz_013.bsp
+    SUDOKU_PUZ_014_BSP = 1227, ///< sudoku_puz_014.bsp
+    SUDOKU_PUZ_015_BSP = 1228, ///< sudoku_puz_015.bsp
+    SUDOKU_PUZ_016_BSP = 1229, ///< sudoku_puz_016.bsp
+    SUDOKU_PUZ_017_BSP = 1230, ///< sudoku_puz_017.bsp
+    SUDOKU_PUZ_018_BSP = 1231, ///< sudoku_puz_018.bsp
+    SUDOKU_PUZ_019_BSP = 1232, ///< sudoku_puz_019.bsp
+    SUDOKU_PUZ_020_BSP = 1233, ///< sudoku_puz_020.bsp
+    SUDOKU_PUZ_021_BSP = 1234, ///< sudoku_puz_021.bsp
+    SUDOKU_PUZ_022_BSP = 1235, ///< sudoku_puz_022.bsp
+    SUDOKU_PUZ_023_BSP = 1236, ///< sudoku_puz_023.bsp
+    SUDOKU_PUZ_024_BSP = 1237, ///< sudoku_puz_024.bsp
+    SUDOKU_PUZ_025_BSP = 1238, ///< sudoku_puz_025.bsp
+    SUDOKU_PUZ_026_BSP = 1239, ///< sudoku_puz_026.bsp
+    SUDOKU_PUZ_027_BSP = 1240, ///< sudoku_puz_027.bsp
+    SUDOKU_PUZ_028_BSP = 1241, ///< sudoku_puz_028.bsp
+    SUDOKU_PUZ_029_BSP = 1242, ///< sudoku_puz_029.bsp
+    SUDOKU_PUZ_030_BSP = 1243, ///< sudoku_puz_030.bsp
+    SUDOKU_PUZ_031_BSP = 1244, ///< sudoku_puz_031.bsp
+    SUDOKU_PUZ_032_BSP = 1245, ///< sudoku_puz_032.bsp
+    SUDOKU_PUZ_033_BSP = 1246, ///< sudoku_puz_033.bsp
+    SUDOKU_PUZ_034_BSP = 1247, ///< sudoku_puz_034.bsp
+    SUDOKU_PUZ_035_BSP = 1248, ///< sudoku_puz_035.bsp
+    SUDOKU_PUZ_036_BSP = 1249, ///< sudoku_puz_036.bsp
+    SUDOKU_PUZ_037_BSP = 1250, ///< sudoku_puz_037.bsp
+    SUDOKU_PUZ_038_BSP = 1251, ///< sudoku_puz_038.bsp
+    SUDOKU_PUZ_039_BSP = 1252, ///< sudoku_puz_039.bsp
+    SUDOKU_PUZ_040_BSP = 1253, ///< sudoku_puz_040.bsp
+    SUDOKU_PUZ_041_BSP = 1254, ///< sudoku_puz_041.bsp
+    SUDOKU_PUZ_042_BSP = 1255, ///< sudoku_puz_042.bsp
+    SUDOKU_PUZ_043_BSP = 1256, ///< sudoku_puz_043.bsp
+    SUDOKU_PUZ_044_BSP = 1257, ///< sudoku_puz_044.bsp
+    SUDOKU_PUZ_045_BSP = 1258, ///< sudoku_puz_045.bsp
+    SUDOKU_PUZ_046_BSP = 1259, ///< sudoku_puz_046.bsp
+    SUDOKU_PUZ_047_BSP = 1260, ///< sudoku_puz_047.bsp
+    SUDOKU_PUZ_048_BSP = 1261, ///< sudoku_puz_048.bsp
+    SUDOKU_PUZ_049_BSP = 1262, ///< sudoku_puz_049.bsp
+    SWIRL_IT_RAW = 1263, ///< swirl_it.raw
+    SWSN_BODY_WSG = 1264, ///< swsnBody.wsg
+    SWSN_HEAD_WSG = 1265, ///< swsnHead.wsg
+    SYNTH_EFFECTS_WSG = 1266, ///< synth_effects.wsg
+    SYNTH_LEAD_WSG = 1267, ///< synth_lead.wsg
+    SYNTH_PAD_WSG = 1268, ///< synth_pad.wsg
+    SYNTHTOM_BIN = 1269, ///< synthtom.bin
+    TAILLESS_QUAVER_WSG = 1270, ///< taillessQuaver.wsg
+    TEST_ROOM_BIN = 1271, ///< test_room.bin
+    TILE_032_WSG = 1272, ///< tile032.wsg
+    TILE_033_WSG = 1273, ///< tile033.wsg
+    TILE_034_WSG = 1274, ///< tile034.wsg
+    TILE_035_WSG = 1275, ///< tile035.wsg
+    TILE_036_WSG = 1276, ///< tile036.wsg
+    TILE_037_WSG = 1277, ///< tile037.wsg
+    TILE_038_WSG = 1278, ///< tile038.wsg
+    TILE_039_WSG = 1279, ///< tile039.wsg
+    TILE_040_WSG = 1280, ///< tile040.wsg
+    TILE_041_WSG = 1281, ///< tile041.wsg
+    TILE_059_WSG = 1282, ///< tile059.wsg
+    TILE_060_WSG = 1283, ///< tile060.wsg
+    TILE_061_WSG = 1284, ///< tile061.wsg
+    TILE_062_WSG = 1285, ///< tile062.wsg
+    TILE_063_WSG = 1286, ///< tile063.wsg
+    TILE_064_WSG = 1287, ///< tile064.wsg
+    TILE_065_WSG = 1288, ///< tile065.wsg
+    TILE_066_WSG = 1289, ///< tile066.wsg
+    TILE_067_WSG = 1290, ///< tile067.wsg
+    TILE_068_WSG = 1291, ///< tile068.wsg
+    TILE_069_WSG = 1292, ///< tile069.wsg
+    TILE_070_WSG = 1293, ///< tile070.wsg
+    TILE_080_WSG = 1294, ///< tile080.wsg
+    TILE_081_WSG = 1295, ///< tile081.wsg
+    TILE_082_WSG = 1296, ///< tile082.wsg
+    TILE_083_WSG = 1297, ///< tile083.wsg
+    TILE_084_WSG = 1298, ///< tile084.wsg
+    TILE_085_WSG = 1299, ///< tile085.wsg
+    TILE_086_WSG = 1300, ///< tile086.wsg
+    TILE_087_WSG = 1301, ///< tile087.wsg
+    TILE_088_WSG = 1302, ///< tile088.wsg
+    TILE_089_WSG = 1303, ///< tile089.wsg
+    TILE_090_WSG = 1304, ///< tile090.wsg
+    TILE_091_WSG = 1305, ///< tile091.wsg
+    TILE_092_WSG = 1306, ///< tile092.wsg
+    TILE_093_WSG = 1307, ///< tile093.wsg
+    TILE_094_WSG = 1308, ///< tile094.wsg
+    TILE_095_WSG = 1309, ///< tile095.wsg
+    TILE_096_WSG = 1310, ///< tile096.wsg
+    TILE_097_WSG = 1311, ///< tile097.wsg
+    TILE_098_WSG = 1312, ///< tile098.wsg
+    TILE_099_WSG = 1313, ///< tile099.wsg
+    TILE_100_WSG = 1314, ///< tile100.wsg
+    TILE_101_WSG = 1315, ///< tile101.wsg
+    TILE_102_WSG = 1316, ///< tile102.wsg
+    TILE_103_WSG = 1317, ///< tile103.wsg
+    TILE_TBD_WSG = 1318, ///< tileTBD.wsg
+    TINY_NUMBERS_FONT = 1319, ///< tiny_numbers.font
+    TOM_BIN = 1320, ///< tom.bin
+    TOM_THUMB_FONT = 1321, ///< tom_thumb.font
+    TOUCH_GEM_WSG = 1322, ///< touch-gem.wsg
+    TOUCHPAD_WSG = 1323, ///< touchpad.wsg
+    TOUCHPAD_JOYSTICK_WSG = 1324, ///< touchpad_joystick.wsg
+    TOUCHPAD_SPIN_WSG = 1325, ///< touchpad_spin.wsg
+    TREBLE_CLEF_WSG = 1326, ///< trebleClef.wsg
+    TUT_WSG = 1327, ///< tut.wsg
+    TWO_TAIL_QUAVER_WSG = 1328, ///< twoTailQuaver.wsg
+    UNKNOWN_PUZZLE_WSG = 1329, ///< unknownPuzzle.wsg
+    UP_CURSOR_8_WSG = 1330, ///< upCursor8.wsg
+    USB_WSG = 1331, ///< usb.wsg
+    USB_MODE_WSG = 1332, ///< usb_mode.wsg
+    VIEW_MODE_WSG = 1333, ///< view_mode.wsg
+    VT_FIGHT_ON_MID = 1334, ///< vt_fight_on.mid
+    VT_FUNK_MID = 1335, ///< vt_funk.mid
+    VT_POP_MID = 1336, ///< vt_pop.mid
+    VT_RISK_MID = 1337, ///< vt_risk.mid
+    WARP_WALL_WSG = 1338, ///< warp_wall.wsg
+    WHOLE_NOTE_WSG = 1339, ///< wholeNote.wsg
+    WILHELM_BIN = 1340, ///< wilhelm.bin
+    WINGED_TROPHY_WSG = 1341, ///< wingedTrophy.wsg
+    WOOD_BACKGROUND_WSG = 1342, ///< woodBackground.wsg
+    WOOD_TEXTURE_64_WSG = 1343, ///< woodTexture64.wsg
+    YALIKEJAZZ_MID = 1344, ///< yalikejazz.mid
+    CNFS_NUM_FILES = 1345,
+} cnfsFileIdx_t;
+
+const uint8_t* getCnfsImage(void);
+int32_t getCnfsSize(void);
+const cnfsFileEntry* getCnfsFiles(void);
@@ -0,0 +1,401 @@
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include <esp_log.h>
+
+#include "coreutil.h"
+#include "profiler.h"
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief A zone which has started but not ended
+ */
+typedef struct
+{
+    /// @brief The zone's name
+    const char* name;
+
+    /// @brief The zone's statistics, or NULL if there are too many zones
+    profileZoneStats_t* stats;
+
+    /// @brief When the zone started, in ticks
+    uint64_t start;
+} openZone_t;
+
+//==============================================================================
+// Variables
+//==============================================================================
+
+static const char PROF_TAG[] = "PROF";
+
+/// Statistics for each distinct zone name, in the order they were first seen
+static profileZoneStats_t zones[PROFILE_MAX_ZONES];
+static uint32_t numZones = 0;
+
+/// Zones which have started but not ended, innermost last. This may count past PROFILE_MAX_DEPTH, but they aren't
+/// stored
+static openZone_t openZones[PROFILE_MAX_DEPTH];
+static uint32_t depth = 0;
+
+/// Zones which ended during the frame. After the frame ends they're kept until the next zone starts
+static profileEvent_t events[PROFILE_MAX_EVENTS];
+static uint32_t numEvents      = 0;
+static bool eventsFinished     = false;
+static uint32_t droppedEvents  = 0;
+static uint32_t unmatchedZones = 0;
+
+/// Frame timing, in ticks
+static uint64_t frameStart     = 0;
+static uint64_t lastFrameStart = 0;
+static uint64_t lastFrameEnd   = 0;
+static uint64_t allFrameTicks  = 0;
+static uint32_t numFrames      = 0;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+static profileZoneStats_t* findZone(const char* name);
+static void startEvents(uint64_t now);
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+/**
+ * @brief Get the current time for profiling. On real hardware this is the processor's cycle count, extended to 64
+ * bits. In the emulator it is the host's monotonic clock in nanoseconds.
+ *
+ * @return The current time, in ticks. Convert to microseconds with profileGetTicksPerUs()
+ */
+uint64_t profileGetTicks(void)
+{
+#if defined(__XTENSA__)
+    // The cycle counter wraps about every 18 seconds at 240MHz. This is only called from the main loop, and at least
+    // once per frame, so a wrap is never missed
+    static uint32_t lastCount = 0;
+    static uint64_t wraps     = 0;
+
+    uint32_t count = getCycleCount();
+    if (count < lastCount)
+    {
+        wraps += (1ULL << 32);
+    }
+    lastCount = count;
+    return wraps | count;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Get the number of ticks in one microsecond
+ *
+ * @return The number of ticks in one microsecond
+ */
+uint32_t profileGetTicksPerUs(void)
+{
+#if defined(__XTENSA__)
+    return CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+#else
+    return 1000;
+#endif
+}
+
+/**
+ * @brief Start a zone. Use PROFILE_ZONE_BEGIN() instead of calling this directly, so it compiles to nothing when
+ * profiling is disabled
+ *
+ * @param name The zone's name, which should be a string literal
+ */
+void profileZoneBegin(const char* name)
+{
+    uint64_t now = profileGetTicks();
+    startEvents(now);
+
+    if (depth < PROFILE_MAX_DEPTH)
+    {
+        openZones[depth].name  = name;
+        openZones[depth].stats = findZone(name);
+        openZones[depth].start = now;
+    }
+    depth++;
+}
+
+/**
+ * @brief End the most recently started zone. Use PROFILE_ZONE_END() instead of calling this directly, so it compiles to
+ * nothing when profiling is disabled
+ *
+ * @param name The zone's name, which must match the name it was started with
+ */
+void profileZoneEnd(const char* name)
+{
+    uint64_t now = profileGetTicks();
+    startEvents(now);
+
+    if (0 == depth)
+    {
+        unmatchedZones++;
+        return;
+    }
+
+    depth--;
+    if (depth >= PROFILE_MAX_DEPTH)
+    {
+        // Too deep to have been recorded
+        return;
+    }
+
+    openZone_t* zone = &openZones[depth];
+    if (zone->name != name && strcmp(zone->name, name))
+    {
+        // Zones were ended out of order. Count it, but still end the innermost zone so the stack doesn't grow forever
+        unmatchedZones++;
+    }
+
+    uint64_t duration = now - zone->start;
+    if (zone->stats)
+    {
+        zone->stats->frameTicks += duration;
+        zone->stats->frameCalls++;
+    }
+
+    if (numEvents < PROFILE_MAX_EVENTS)
+    {
+        events[numEvents].name     = zone->name;
+        events[numEvents].start    = zone->start;
+        events[numEvents].duration = (uint32_t)duration;
+        events[numEvents].depth    = depth;
+        numEvents++;
+    }
+    else
+    {
+        droppedEvents++;
+    }
+}
+
+/**
+ * @brief End the current frame, adding the time spent in each zone to its statistics. Use PROFILE_FRAME_END() instead
+ * of calling this directly, so it compiles to nothing when profiling is disabled
+ */
+void profileFrameEnd(void)
+{
+    uint64_t now = profileGetTicks();
+    if (eventsFinished)
+    {
+        // No zones ran this frame, so don't report the last frame's events again
+        numEvents = 0;
+    }
+    if (0 == frameStart)
+    {
+        frameStart = now;
+    }
+
+    for (uint32_t i = 0; i < numZones; i++)
+    {
+        profileZoneStats_t* zone = &zones[i];
+        zone->lastCalls          = zone->frameCalls;
+        zone->lastTicks          = zone->frameTicks;
+        if (zone->frameCalls)
+        {
+            if (zone->frameTicks > zone->maxTicks)
+            {
+                zone->maxTicks = zone->frameTicks;
+            }
+            zone->totalTicks += zone->frameTicks;
+            zone->frames++;
+        }
+        zone->frameCalls = 0;
+        zone->frameTicks = 0;
+    }
+
+    lastFrameStart = frameStart;
+    lastFrameEnd   = now;
+    frameStart     = now;
+    allFrameTicks += lastFrameEnd - lastFrameStart;
+    numFrames++;
+    eventsFinished = true;
+
+#if defined(__XTENSA__)
+    if (0 == numFrames % PROFILE_SUMMARY_FRAMES)
+    {
+        profilePrintSummary();
+    }
+#endif
+}
+
+/**
+ * @brief Get the zones which ended during the last frame. These are only valid after PROFILE_FRAME_END() and until the
+ * next zone starts, so this should be called right after the frame ends, like from an emulator post-frame callback
+ *
+ * @param[out] count The number of events is written here
+ * @param[out] start When the frame started, in ticks, is written here. May be NULL
+ * @param[out] end When the frame ended, in ticks, is written here. May be NULL
+ * @return The events in the order they ended
+ */
+const profileEvent_t* profileGetFrameEvents(uint32_t* count, uint64_t* start, uint64_t* end)
+{
+    *count = eventsFinished ? numEvents : 0;
+    if (start)
+    {
+        *start = lastFrameStart;
+    }
+    if (end)
+    {
+        *end = lastFrameEnd;
+    }
+    return events;
+}
+
+/**
+ * @brief Get the statistics of all zones which have run
+ *
+ * @param[out] count The number of zones is written here
+ * @param[out] frames The number of frames which have ended is written here. May be NULL
+ * @return The statistics of each zone, in the order they first ran
+ */
+const profileZoneStats_t* profileGetZones(uint32_t* count, uint32_t* frames)
+{
+    *count = numZones;
+    if (frames)
+    {
+        *frames = numFrames;
+    }
+    return zones;
+}
+
+/**
+ * @brief Find the statistics of a zone by name
+ *
+ * @param name The zone's name
+ * @return The zone's statistics, or NULL if it hasn't run yet
+ */
+const profileZoneStats_t* profileFindZone(const char* name)
+{
+    // Names are usually string literals, so compare the pointers before the strings
+    for (uint32_t i = 0; i < numZones; i++)
+    {
+        if (zones[i].name == name)
+        {
+            return &zones[i];
+        }
+    }
+    for (uint32_t i = 0; i < numZones; i++)
+    {
+        if (!strcmp(zones[i].name, name))
+        {
+            return &zones[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get how long a zone took in total during the last frame
+ *
+ * @param name The zone's name
+ * @return The zone's total time in the last frame, in ticks, or 0 if it hasn't run yet
+ */
+uint64_t profileGetZoneLastTicks(const char* name)
+{
+    const profileZoneStats_t* zone = profileFindZone(name);
+    return zone ? zone->lastTicks : 0;
+}
+
+/**
+ * @brief Get the number of zones which ended after a frame's event buffer was full, over all frames
+ *
+ * @return The number of events which weren't recorded
+ */
+uint32_t profileGetDroppedEvents(void)
+{
+    return droppedEvents;
+}
+
+/**
+ * @brief Print the average and worst time per frame of every zone
+ */
+void profilePrintSummary(void)
+{
+    if (0 == numFrames)
+    {
+        return;
+    }
+
+    uint32_t ticksPerUs = profileGetTicksPerUs();
+    uint64_t avgFrameUs = allFrameTicks / numFrames / ticksPerUs;
+    ESP_LOGI(PROF_TAG, "%" PRIu32 " frames, %" PRIu64 " us per frame", numFrames, avgFrameUs);
+    ESP_LOGI(PROF_TAG, "%-24s %10s %10s %8s %6s", "Zone", "Avg us", "Max us", "Frames", "Frame%");
+    for (uint32_t i = 0; i < numZones; i++)
+    {
+        const profileZoneStats_t* zone = &zones[i];
+
+        // Averages are over all frames, not just frames the zone ran in, so they add up to the frame time
+        uint64_t avgUs   = zone->totalTicks / numFrames / ticksPerUs;
+        uint64_t maxUs   = zone->maxTicks / ticksPerUs;
+        uint32_t permill = allFrameTicks ? (uint32_t)((zone->totalTicks * 1000) / allFrameTicks) : 0;
+        ESP_LOGI(PROF_TAG, "%-24s %10" PRIu64 " %10" PRIu64 " %8" PRIu32 " %4" PRIu32 ".%" PRIu32, zone->name, avgUs,
+                 maxUs, zone->frames, permill / 10, permill % 10);
+    }
+
+    if (droppedEvents || unmatchedZones)
+    {
+        ESP_LOGW(PROF_TAG, "%" PRIu32 " events dropped, %" PRIu32 " zones ended out of order", droppedEvents,
+                 unmatchedZones);
+    }
+}
+
+/**
+ * @brief Find the statistics for a zone name, adding them if this is the first time the name was seen
+ *
+ * @param name The zone's name
+ * @return The zone's statistics, or NULL if there are already ::PROFILE_MAX_ZONES zones
+ */
+static profileZoneStats_t* findZone(const char* name)
+{
+    const profileZoneStats_t* found = profileFindZone(name);
+    if (found)
+    {
+        return &zones[found - zones];
+    }
+
+    if (numZones >= PROFILE_MAX_ZONES)
+    {
+        return NULL;
+    }
+
+    profileZoneStats_t* zone = &zones[numZones++];
+    memset(zone, 0, sizeof(*zone));
+    zone->name = name;
+    return zone;
+}
+
+/**
+ * @brief Clear the last frame's events when the first zone of a new frame starts or ends
+ *
+ * @param now The current time, in ticks
+ */
+static void startEvents(uint64_t now)
+{
+    if (eventsFinished)
+    {
+        eventsFinished = false;
+        numEvents      = 0;
+    }
+
+    if (0 == frameStart)
+    {
+        frameStart = now;
+    }
+}
@@ -0,0 +1,159 @@
+/*! \file profiler.h
+ *
+ * \section profiler_design Design Philosophy
+ *
+ * Profiling zones measure how long named sections of code take, and how that time adds up over each frame. They are
+ * meant to be left in hot code, so when profiling is disabled the zone macros compile to nothing.
+ *
+ * Profiling is enabled by \c CONFIG_PROFILE_ZONES, which is set in \c menuconfig for the firmware and always set for
+ * the emulator. Timestamps come from the processor's cycle counter on real hardware and from \c clock_gettime() in the
+ * emulator, so they measure real time spent, even when the emulator is faking time.
+ *
+ * The system already has zones around each mode's \c fnEnterMode, \c fnMainLoop, \c fnAudioCallback, and \c fnDacCb,
+ * and around drawDisplayTft(). Zones may be nested, up to ::PROFILE_MAX_DEPTH deep, and every zone must be ended in
+ * the reverse order it was started. Zones must only be used from the Swadge main loop's thread, not from interrupts or
+ * other tasks.
+ *
+ * At the end of each frame, the time spent in each zone is added to that zone's statistics, which can be read with
+ * profileGetZones(). Each finished zone is also recorded as a ::profileEvent_t, which can be read with
+ * profileGetFrameEvents() until the next zone starts. The emulator's profiler extension writes these to a Chrome trace
+ * JSON file when run with \c --trace, which can be opened with \c chrome://tracing or https://ui.perfetto.dev. On real
+ * hardware, a summary of the zones is printed every ::PROFILE_SUMMARY_FRAMES frames.
+ *
+ * \section profiler_usage Usage
+ *
+ * Wrap code to measure with PROFILE_ZONE_BEGIN() and PROFILE_ZONE_END(), using the same string literal for both.
+ *
+ * PROFILE_FRAME_END() is called by the system once per main loop and doesn't need to be called by modes.
+ *
+ * \section profiler_example Example
+ *
+ * \code{.c}
+ * static void exampleMainLoop(int64_t elapsedUs)
+ * {
+ *     PROFILE_ZONE_BEGIN("examplePhysics");
+ *     exampleUpdatePhysics(elapsedUs);
+ *     PROFILE_ZONE_END("examplePhysics");
+ *
+ *     PROFILE_ZONE_BEGIN("exampleDraw");
+ *     exampleDrawField();
+ *     PROFILE_ZONE_END("exampleDraw");
+ * }
+ * \endcode
+ */
+
+#pragma once
+
+//==============================================================================
+// Includes
+//==============================================================================
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//==============================================================================
+// Defines
+//==============================================================================
+
+/// @brief The most distinct zone names which are tracked. Zones with more names than this are ignored
+#define PROFILE_MAX_ZONES 32
+
+/// @brief How deeply zones may be nested
+#define PROFILE_MAX_DEPTH 16
+
+/// @brief The most zone events recorded in a single frame. Events after this are counted but not recorded
+#define PROFILE_MAX_EVENTS 256
+
+/// @brief How often a summary of all zones is printed on real hardware, in frames
+#define PROFILE_SUMMARY_FRAMES 600
+
+#if defined(CONFIG_PROFILE_ZONES)
+    /// @brief Start a zone named \c name, which must be a string literal
+    #define PROFILE_ZONE_BEGIN(name) profileZoneBegin(name)
+    /// @brief End the zone named \c name, which must be the most recently started zone
+    #define PROFILE_ZONE_END(name) profileZoneEnd(name)
+    /// @brief Add the zones in this frame to their statistics and start a new frame
+    #define PROFILE_FRAME_END() profileFrameEnd()
+#else
+    #define PROFILE_ZONE_BEGIN(name) \
+        do                           \
+        {                            \
+        } while (0)
+    #define PROFILE_ZONE_END(name) \
+        do                         \
+        {                          \
+        } while (0)
+    #define PROFILE_FRAME_END() \
+        do                      \
+        {                       \
+        } while (0)
+#endif
+
+//==============================================================================
+// Structs
+//==============================================================================
+
+/**
+ * @brief A zone which finished during the last frame
+ */
+typedef struct
+{
+    /// @brief The zone's name
+    const char* name;
+
+    /// @brief When the zone started, in ticks
+    uint64_t start;
+
+    /// @brief How long the zone took, in ticks
+    uint32_t duration;
+
+    /// @brief How many zones this one was nested in
+    uint8_t depth;
+} profileEvent_t;
+
+/**
+ * @brief Statistics for all zones with the same name
+ */
+typedef struct
+{
+    /// @brief The zone's name
+    const char* name;
+
+    /// @brief How many times the zone ran during the last frame
+    uint32_t lastCalls;
+
+    /// @brief How long the zone took in total during the last frame, in ticks
+    uint64_t lastTicks;
+
+    /// @brief The most ticks the zone took in total during a single frame
+    uint64_t maxTicks;
+
+    /// @brief The total ticks the zone has taken over all frames
+    uint64_t totalTicks;
+
+    /// @brief How many frames the zone ran in
+    uint32_t frames;
+
+    /// @brief Ticks accumulated during the frame in progress
+    uint64_t frameTicks;
+
+    /// @brief Calls made during the frame in progress
+    uint32_t frameCalls;
+} profileZoneStats_t;
+
+//==============================================================================
+// Function Prototypes
+//==============================================================================
+
+void profileZoneBegin(const char* name);
+void profileZoneEnd(const char* name);
+void profileFrameEnd(void);
+
+uint64_t profileGetTicks(void);
+uint32_t profileGetTicksPerUs(void);
+const profileEvent_t* profileGetFrameEvents(uint32_t* count, uint64_t* start, uint64_t* end);
+const profileZoneStats_t* profileGetZones(uint32_t* count, uint32_t* frames);
+const profileZoneStats_t* profileFindZone(const char* name);
+uint64_t profileGetZoneLastTicks(const char* name);
+uint32_t profileGetDroppedEvents(void);
+void profilePrintSummary(void);
@@ -32,6 +32,7 @@
 #include "greyscale_processor.h"
 #include "image_processor.h"
 #include "json_processor.h"
+#include "midi_processor.h"
 #include "raw_processor.h"
 #include "sudoku_processor.h"
 #include "txt_processor.h"
@@ -45,9 +46,9 @@
 // EDIT HERE to register a new asset processor
 //==============================================================================
 static const assetProcessor_t* allAssetProcessors[] = {
-    &binProcessor,   &chartProcessor, &fontProcessor, &heatshrinkProcessor,
-    &imageProcessor, &jsonProcessor,  &sudokuProcessor, &textProcessor,
-    &cfunProcessor,  &greyscaleProcessor,
+    &binProcessor,   &chartProcessor, &fontProcessor,   &heatshrinkProcessor,
+    &imageProcessor, &jsonProcessor,  &midiProcessor,   &sudokuProcessor,
+    &textProcessor,  &cfunProcessor,  &greyscaleProcessor,
 };
 //==============================================================================
 // END Asset Processor List
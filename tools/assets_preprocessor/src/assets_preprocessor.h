@@ -168,6 +168,14 @@
  * the file will not be compressed, and can be loaded with \ref cnfsReadFile()
  * instead.
  *
+ * \paragraph assetProc_midi midi
+ * Merges all the tracks of a format 0 or 1 MIDI file into a single time-sorted event
+ * stream and compresses it with heatshrink. Format 2 files are only compressed. The
+ * file can be loaded with \ref loadMidiFile().
+ *
+ * Supports the option `merge`, which is true by default. If set to false, the MIDI
+ * file will only be compressed.
+ *
  * \paragraph assetProc_text text
  * Removes any non-ASCII and unsupported characters in the input
  * file and writes it to the output.
@@ -178,6 +186,11 @@
  * will be reduced to fit the web-safe color palette, along with one fully
  * transparent color, \ref paletteColor_t::cTransparent.
  *
+ * Supports the option `picross`, which is false by default. If set to true,
+ * images named like `*_PZL.png` are checked as picross puzzles, where white and
+ * transparent pixels are empty. A warning is printed for any puzzle which can't
+ * be solved one row or column at a time, because it may not have a unique solution.
+ *
  * \paragraph assetProc_gs gs
  * Process 12x6 pixel images as greyscale for the eyes.
  *
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -32,6 +33,8 @@
 
 #include "fileUtils.h"
 
+#include "picross_solver.h"
+
 #define CLAMP(x, l, u) ((x) < l ? l : ((x) > u ? u : (x)))
 
 typedef struct
@@ -49,6 +52,7 @@ typedef struct
 void shuffleArray(uint32_t* ar, uint32_t len);
 int isNeighborNotDrawn(pixel_t** img, int x, int y, int w, int h);
 void spreadError(pixel_t** img, int x, int y, int w, int h, int teR, int teG, int teB, float diagScalar);
+bool checkPicrossPuzzle(pixel_t** img, int w, int h, const char* name);
 bool process_image(processorInput_t* arg);
 
 const assetProcessor_t imageProcessor
@@ -100,6 +104,64 @@ void spreadError(pixel_t** img, int x, int y, int w, int h, int teR, int teG, in
     }
 }
 
+/**
+ * @brief Check that a picross puzzle image has a unique solution which can be found one line at a time. Pixels that
+ * are transparent or white are empty, the same as setCompleteLevelFromWSG()
+ *
+ * @param img The quantized image
+ * @param w The width of the image
+ * @param h The height of the image
+ * @param name The name of the image, for warnings
+ * @return false if the image can't be a picross puzzle at all, true otherwise
+ */
+bool checkPicrossPuzzle(pixel_t** img, int w, int h, const char* name)
+{
+    if (w > PICROSS_SOLVER_MAX_SIZE || h > PICROSS_SOLVER_MAX_SIZE)
+    {
+        fprintf(stderr, "[wsg] %s is too large to be a picross puzzle\n", name);
+        return false;
+    }
+
+    uint16_t rows[PICROSS_SOLVER_MAX_SIZE] = {0};
+    uint16_t cols[PICROSS_SOLVER_MAX_SIZE] = {0};
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            bool white = (5 == img[y][x].r && 5 == img[y][x].g && 5 == img[y][x].b);
+            if (img[y][x].a && !white)
+            {
+                rows[y] |= (1 << x);
+                cols[x] |= (1 << y);
+            }
+        }
+    }
+
+    picrossSolver_t solver;
+    picrossSolverInit(&solver, w, h);
+
+    uint8_t clues[PICROSS_SOLVER_MAX_CLUES];
+    for (int i = 0; i < w + h; i++)
+    {
+        bool isRow = i < h;
+        int index  = isRow ? i : i - h;
+        int count  = picrossCluesFromLine(isRow ? rows[index] : cols[index], isRow ? w : h, clues);
+        if (count < 0)
+        {
+            fprintf(stderr, "[wsg] %s has too many clues in %s %d\n", name, isRow ? "row" : "column", index);
+            return false;
+        }
+        picrossSolverSetClues(&solver, isRow, index, clues, count);
+    }
+
+    if (PICROSS_SOLVER_SOLVED != picrossSolverRun(&solver))
+    {
+        fprintf(stderr, "[wsg] Warning: picross puzzle %s can't be solved one line at a time, so may not be unique\n",
+                name);
+    }
+    return true;
+}
+
 bool process_image(processorInput_t* arg)
 {
     /* Load the source PNG */
@@ -191,6 +253,18 @@ bool process_image(processorInput_t* arg)
         /* Free stbi memory */
         stbi_image_free(data);
 
+        /* Picross puzzles are named *_PZL.png, and their solutions *_SLV.png */
+        if (getBoolOption(arg->options, "wsg.picross", false) && strstr(arg->inFilename, "_PZL.")
+            && !checkPicrossPuzzle(image8b, w, h, arg->inFilename))
+        {
+            for (int y = 0; y < h; y++)
+            {
+                free(image8b[y]);
+            }
+            free(image8b);
+            return false;
+        }
+
 // #define WRITE_DITHERED_PNG
 #ifdef WRITE_DITHERED_PNG
         /* Convert to a pixel buffer */
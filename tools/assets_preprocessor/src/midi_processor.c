@@ -0,0 +1,528 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "midi_processor.h"
+#include "assets_preprocessor.h"
+#include "fileUtils.h"
+#include "heatshrink_util.h"
+
+/*
+ * Merged MIDI stream format, before heatshrink compression. All multi-byte integers are big-endian.
+ *
+ * 'M' 'T' 'm' 'g'  Magic, distinguishes a merged stream from a standard MIDI file ("MThd")
+ * uint8_t          The original MIDI file format, 0 or 1
+ * uint8_t          The number of tracks in the original MIDI file, clamped to 255
+ * uint16_t         The time division, already resolved to ticks per quarter note or ticks per frame
+ * uint32_t         The number of events in the stream
+ *
+ * Then, for each event, sorted by absolute time:
+ *   [0x80 uint8_t] A track marker and the index of the track the event came from, only written when that isn't the
+ *                  predicted track. A delta-time never starts with 0x80, so this is unambiguous
+ *   varlen         Ticks since the previous event in the stream, so the absolute time is a running sum
+ *   ...            The event, exactly as it would be in a standard MIDI file. Running status applies across the
+ *                  whole stream, not per-track
+ *
+ * The predicted track for a channel event is the track of the previous event on the same channel, and for any other
+ * event it's the track of the previous non-channel event. All predictions start at track 0.
+ *
+ * Each track's END OF TRACK meta-event is dropped and a single END OF TRACK is written at the very end.
+ */
+
+#define MIDI_HEADER_LEN   14
+#define MERGED_HEADER_LEN 12
+#define TRACK_MARKER      0x80
+
+/// @brief A single event from any track, pointing to its data in the original file
+typedef struct
+{
+    /// @brief The absolute time of this event, in ticks
+    uint32_t absTime;
+
+    /// @brief The order this event was read in, used to keep the sort stable
+    uint32_t order;
+
+    /// @brief The index of the track this event came from
+    uint8_t track;
+
+    /// @brief The resolved status byte of this event
+    uint8_t status;
+
+    /// @brief A pointer to the event's data following the status byte, or NULL to use synthData
+    const uint8_t* data;
+
+    /// @brief The number of bytes of event data following the status byte
+    uint32_t length;
+
+    /// @brief Event data which doesn't exist in the original file, used when data is NULL
+    uint8_t synthData[4];
+} mergeEvent_t;
+
+/// @brief A growable list of events
+typedef struct
+{
+    mergeEvent_t* events;
+    uint32_t count;
+    uint32_t capacity;
+} mergeEventList_t;
+
+bool process_midi(processorInput_t* arg);
+static uint32_t readBe32(const uint8_t* data);
+static int readVarLen(const uint8_t* data, uint32_t length, uint32_t* out);
+static int writeVarLen(uint8_t* out, uint32_t value);
+static mergeEvent_t* appendEvent(mergeEventList_t* list);
+static bool readTrackEvents(const uint8_t* data, uint32_t length, uint8_t trackIdx, mergeEventList_t* list,
+                            uint32_t* endTime);
+static int compareEvents(const void* a, const void* b);
+static uint8_t* mergeMidiTracks(const uint8_t* data, uint32_t length, uint32_t* outLength, const char* filename);
+
+const assetProcessor_t midiProcessor = {
+    .name     = "midi",
+    .type     = FUNCTION,
+    .function = process_midi,
+    .inFmt    = FMT_DATA,
+    .outFmt   = FMT_FILE_BIN,
+};
+
+static const uint8_t midiHeader[]   = {'M', 'T', 'h', 'd'};
+static const uint8_t trackHeader[]  = {'M', 'T', 'r', 'k'};
+static const uint8_t mergedHeader[] = {'M', 'T', 'm', 'g'};
+
+static uint32_t readBe32(const uint8_t* data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+/**
+ * @brief Read a variable length quantity the same way the Swadge's MIDI parser does
+ *
+ * @param data The data to read from
+ * @param length The number of bytes remaining in data
+ * @param out A pointer to write the read quantity to
+ * @return int The number of bytes read, or 0 if none could be
+ */
+static int readVarLen(const uint8_t* data, uint32_t length, uint32_t* out)
+{
+    uint32_t read = 0;
+    uint32_t val  = 0;
+    uint8_t last  = 0;
+
+    while (((last & 0x80) || read == 0) && read < 4 && read < length)
+    {
+        last = data[read++];
+        val  = (val << 7) | (last & 0x7F);
+    }
+
+    *out = val;
+    return read;
+}
+
+/**
+ * @brief Write a variable length quantity
+ *
+ * @param out A buffer with at least 4 bytes of space
+ * @param value The value to write, which must fit in 28 bits
+ * @return int The number of bytes written
+ */
+static int writeVarLen(uint8_t* out, uint32_t value)
+{
+    uint8_t tmp[4];
+    int count = 0;
+
+    do
+    {
+        tmp[count++] = value & 0x7F;
+        value >>= 7;
+    } while (value && count < 4);
+
+    for (int i = 0; i < count; i++)
+    {
+        // Every byte but the last has the continuation bit set
+        out[i] = tmp[count - 1 - i] | ((i < count - 1) ? 0x80 : 0x00);
+    }
+
+    return count;
+}
+
+static mergeEvent_t* appendEvent(mergeEventList_t* list)
+{
+    if (list->count == list->capacity)
+    {
+        uint32_t newCap    = list->capacity ? list->capacity * 2 : 256;
+        mergeEvent_t* grow = realloc(list->events, newCap * sizeof(mergeEvent_t));
+        if (NULL == grow)
+        {
+            return NULL;
+        }
+        list->events   = grow;
+        list->capacity = newCap;
+    }
+
+    mergeEvent_t* evt = &list->events[list->count];
+    memset(evt, 0, sizeof(mergeEvent_t));
+    evt->order = list->count++;
+    return evt;
+}
+
+/**
+ * @brief Read all the events from a single track chunk into the list
+ *
+ * Parsing stops at the END OF TRACK event, which is not added to the list. Anything which the Swadge's
+ * MIDI parser would treat as a fatal error for the track also ends the track here, so playback is unchanged.
+ *
+ * @param data The track chunk data, after the chunk header
+ * @param length The length of the track chunk data
+ * @param trackIdx The index of this track
+ * @param list The list to append events to
+ * @param[out] endTime Written with the absolute time at which the track ends
+ * @return true if the track was read, even if it was cut short
+ * @return false if memory could not be allocated
+ */
+static bool readTrackEvents(const uint8_t* data, uint32_t length, uint8_t trackIdx, mergeEventList_t* list,
+                            uint32_t* endTime)
+{
+    const uint8_t* cur    = data;
+    const uint8_t* end    = data + length;
+    uint32_t time         = 0;
+    uint8_t runningStatus = 0;
+
+    while (cur < end)
+    {
+        uint32_t delta;
+        int read = readVarLen(cur, end - cur, &delta);
+        cur += read;
+        if (!read || cur >= end)
+        {
+            break;
+        }
+
+        uint8_t status = *cur;
+
+        if (0x80 <= status && status <= 0xEF)
+        {
+            // Voice messages set the running status
+            runningStatus = status;
+            cur++;
+        }
+        else if (0xF0 <= status)
+        {
+            // System messages clear the running status
+            runningStatus = 0;
+            cur++;
+        }
+        else if (runningStatus)
+        {
+            // This is data, use the running status and don't consume it
+            status = runningStatus;
+        }
+        else
+        {
+            fprintf(stderr, "[WRN] Track %d has data with no running status, ending it early\n", trackIdx);
+            break;
+        }
+
+        const uint8_t* evtData = cur;
+        uint32_t evtLen        = 0;
+
+        switch (status & 0xF0)
+        {
+            case 0x80: // Note OFF
+            case 0x90: // Note ON
+            case 0xA0: // AfterTouch
+            case 0xB0: // Control Change
+            case 0xE0: // Pitch bend
+            {
+                evtLen = 2;
+                break;
+            }
+
+            case 0xC0: // Program Select
+            case 0xD0: // Channel Pressure
+            {
+                evtLen = 1;
+                break;
+            }
+
+            default:
+            {
+                uint32_t dataLen;
+                if (status == 0xFF)
+                {
+                    // Meta event, skip over the type byte
+                    if (cur >= end)
+                    {
+                        evtLen = UINT32_MAX;
+                        break;
+                    }
+
+                    uint8_t metaType = *cur;
+                    read             = readVarLen(cur + 1, end - cur - 1, &dataLen);
+                    if (!read)
+                    {
+                        evtLen = UINT32_MAX;
+                        break;
+                    }
+
+                    evtLen = 1 + read + dataLen;
+
+                    if (metaType == 0x2F)
+                    {
+                        // END OF TRACK, this is the last event in the track
+                        *endTime = time + delta;
+                        return true;
+                    }
+                }
+                else if (status == 0xF0 || status == 0xF7)
+                {
+                    // SysEx event
+                    read = readVarLen(cur, end - cur, &dataLen);
+                    if (!read)
+                    {
+                        evtLen = UINT32_MAX;
+                        break;
+                    }
+
+                    evtLen = read + dataLen;
+                }
+                else
+                {
+                    // System realtime messages don't belong in a MIDI file, and the parser ignores them
+                    time += delta;
+                    continue;
+                }
+                break;
+            }
+        }
+
+        if (evtLen > (uint32_t)(end - cur))
+        {
+            fprintf(stderr, "[WRN] Track %d has a truncated event, ending it early\n", trackIdx);
+            break;
+        }
+
+        cur += evtLen;
+        time += delta;
+
+        mergeEvent_t* evt = appendEvent(list);
+        if (NULL == evt)
+        {
+            return false;
+        }
+
+        evt->absTime = time;
+        evt->track   = trackIdx;
+        evt->status  = status;
+        evt->data    = evtData;
+        evt->length  = evtLen;
+
+        if (status == 0xFF && evtData[0] == 0x00 && evtData[1] == 0)
+        {
+            // A SEQUENCE NUMBER with no data uses the track index, which is no longer implied by the stream
+            evt->data         = NULL;
+            evt->length       = 4;
+            evt->synthData[0] = 0x00;
+            evt->synthData[1] = 2;
+            evt->synthData[2] = 0;
+            evt->synthData[3] = trackIdx;
+        }
+    }
+
+    // The track ended without an END OF TRACK
+    *endTime = time;
+    return true;
+}
+
+static int compareEvents(const void* a, const void* b)
+{
+    const mergeEvent_t* evtA = (const mergeEvent_t*)a;
+    const mergeEvent_t* evtB = (const mergeEvent_t*)b;
+
+    if (evtA->absTime != evtB->absTime)
+    {
+        return (evtA->absTime < evtB->absTime) ? -1 : 1;
+    }
+
+    // Events at the same time keep track order, then file order
+    if (evtA->track != evtB->track)
+    {
+        return (int)evtA->track - (int)evtB->track;
+    }
+
+    return (evtA->order < evtB->order) ? -1 : 1;
+}
+
+/**
+ * @brief Merge all the tracks in a format 0 or 1 MIDI file into a single stream
+ *
+ * @param data The MIDI file data
+ * @param length The length of the MIDI file data
+ * @param[out] outLength Written with the length of the returned stream
+ * @param filename The name of the file being processed, for error messages
+ * @return uint8_t* A newly allocated buffer containing the merged stream, or NULL if the file can't be merged
+ */
+static uint8_t* mergeMidiTracks(const uint8_t* data, uint32_t length, uint32_t* outLength, const char* filename)
+{
+    if (length < MIDI_HEADER_LEN || memcmp(data, midiHeader, sizeof(midiHeader)))
+    {
+        fprintf(stderr, "[WRN] %s is not a MIDI file, it will only be compressed\n", filename);
+        return NULL;
+    }
+
+    uint32_t headerLen  = readBe32(data + 4);
+    uint16_t format     = (data[8] << 8) | data[9];
+    uint16_t trackCount = (data[10] << 8) | data[11];
+    uint16_t division   = (data[12] << 8) | data[13];
+
+    if (format > 1)
+    {
+        // Sequential tracks can't be merged by time
+        return NULL;
+    }
+
+    // Resolve the time division like the parser does
+    uint16_t timeDivision = (division & 0x8000) ? (division & 0xFF) : (division & 0x7FFF);
+
+    mergeEventList_t list = {0};
+    uint32_t songEnd      = 0;
+    uint8_t lastTrack     = 0;
+
+    const uint8_t* ptr = data + 8 + headerLen;
+    const uint8_t* end = data + length;
+    int trackIdx       = 0;
+
+    while (trackIdx < trackCount && ptr + 8 <= end)
+    {
+        uint32_t chunkLen = readBe32(ptr + 4);
+        bool isTrack      = !memcmp(ptr, trackHeader, sizeof(trackHeader));
+        ptr += 8;
+
+        if (chunkLen > (uint32_t)(end - ptr))
+        {
+            chunkLen = end - ptr;
+        }
+
+        if (isTrack)
+        {
+            uint32_t trackEnd = 0;
+            if (!readTrackEvents(ptr, chunkLen, trackIdx & 0xFF, &list, &trackEnd))
+            {
+                fprintf(stderr, "[ERR] Could not allocate memory to merge %s\n", filename);
+                free(list.events);
+                return NULL;
+            }
+
+            if (trackEnd >= songEnd)
+            {
+                songEnd   = trackEnd;
+                lastTrack = trackIdx & 0xFF;
+            }
+            trackIdx++;
+        }
+
+        ptr += chunkLen;
+    }
+
+    qsort(list.events, list.count, sizeof(mergeEvent_t), compareEvents);
+
+    // Add up the size of the output, with worst-case delta-times and track changes
+    uint32_t outSize = MERGED_HEADER_LEN + 2 + 4 + 3;
+    for (uint32_t i = 0; i < list.count; i++)
+    {
+        outSize += 2 + 4 + 1 + list.events[i].length;
+    }
+
+    uint8_t* out = malloc(outSize);
+    if (NULL == out)
+    {
+        fprintf(stderr, "[ERR] Could not allocate memory to merge %s\n", filename);
+        free(list.events);
+        return NULL;
+    }
+
+    uint32_t eventCount = list.count + 1;
+    uint32_t idx        = 0;
+
+    memcpy(out, mergedHeader, sizeof(mergedHeader));
+    idx += sizeof(mergedHeader);
+    out[idx++] = format;
+    out[idx++] = (trackCount > 0xFF) ? 0xFF : trackCount;
+    out[idx++] = HI_BYTE(timeDivision);
+    out[idx++] = LO_BYTE(timeDivision);
+    out[idx++] = HI_BYTE(HI_WORD(eventCount));
+    out[idx++] = LO_BYTE(HI_WORD(eventCount));
+    out[idx++] = HI_BYTE(LO_WORD(eventCount));
+    out[idx++] = LO_BYTE(LO_WORD(eventCount));
+
+    uint32_t lastTime         = 0;
+    uint8_t runningStatus     = 0;
+    uint8_t channelTracks[16] = {0};
+    uint8_t systemTrack       = 0;
+    for (uint32_t i = 0; i < list.count; i++)
+    {
+        const mergeEvent_t* evt = &list.events[i];
+
+        uint8_t* predicted = (evt->status < 0xF0) ? &channelTracks[evt->status & 0x0F] : &systemTrack;
+        if (evt->track != *predicted)
+        {
+            out[idx++] = TRACK_MARKER;
+            out[idx++] = evt->track;
+            *predicted = evt->track;
+        }
+
+        idx += writeVarLen(&out[idx], evt->absTime - lastTime);
+
+        if (evt->status >= 0xF0)
+        {
+            // System messages clear the running status
+            out[idx++]    = evt->status;
+            runningStatus = 0;
+        }
+        else if (evt->status != runningStatus)
+        {
+            out[idx++]    = evt->status;
+            runningStatus = evt->status;
+        }
+
+        memcpy(&out[idx], evt->data ? evt->data : evt->synthData, evt->length);
+        idx += evt->length;
+
+        lastTime = evt->absTime;
+    }
+
+    // Finish with a single END OF TRACK for the whole song
+    if (lastTrack != systemTrack)
+    {
+        out[idx++] = TRACK_MARKER;
+        out[idx++] = lastTrack;
+    }
+    idx += writeVarLen(&out[idx], songEnd - lastTime);
+    out[idx++] = 0xFF;
+    out[idx++] = 0x2F;
+    out[idx++] = 0x00;
+
+    free(list.events);
+
+    *outLength = idx;
+    return out;
+}
+
+bool process_midi(processorInput_t* arg)
+{
+    if (getBoolOption(arg->options, "midi.merge", true))
+    {
+        uint32_t mergedLen = 0;
+        uint8_t* merged    = mergeMidiTracks(arg->in.data, arg->in.length, &mergedLen, arg->inFilename);
+
+        if (NULL != merged)
+        {
+            bool ok = writeHeatshrinkFileHandle(merged, mergedLen, arg->out.file);
+            free(merged);
+            return ok;
+        }
+    }
+
+    // Fall back to compressing the MIDI file as-is
+    return writeHeatshrinkFileHandle(arg->in.data, arg->in.length, arg->out.file);
+}
@@ -0,0 +1,13 @@
+#ifndef _MIDI_PROCESSOR_H_
+#define _MIDI_PROCESSOR_H_
+
+#include "assets_preprocessor.h"
+
+/**
+ * @brief The MIDI processor merges all the tracks of a format 0 or 1 MIDI file into a single time-sorted event
+ * stream, then compresses it with heatshrink. Files which can't be merged are only compressed.
+ * The output file can be loaded with \ref loadMidiFile()
+ */
+extern const assetProcessor_t midiProcessor;
+
+#endif
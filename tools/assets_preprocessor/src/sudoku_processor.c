@@ -4,8 +4,10 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "assets_preprocessor.h"
+#include "sudoku_solver.h"
 
 
 bool process_sudoku(processorInput_t* arg);
@@ -28,8 +30,23 @@ bool process_sudoku(processorInput_t* arg)
     int cur;
     bool startOfLine = true;
     bool comment = false;
+
+    // The #L level comment, if any
+    char level[32] = {0};
+    int levelLen = 0;
+    bool readingLevel = false;
+
     while (-1 != (cur = getc(arg->in.file)))
     {
+        if (readingLevel && cur != '\r' && cur != '\n')
+        {
+            if (levelLen < (int)sizeof(level) - 1)
+            {
+                level[levelLen++] = cur;
+            }
+            continue;
+        }
+
         switch (cur)
         {
             case '.':
@@ -84,9 +101,9 @@ bool process_sudoku(processorInput_t* arg)
             case 'L': // Level
             case 'U': // Source URL
             {
-                if (comment && startOfLine)
+                if (comment && startOfLine && cur == 'L')
                 {
-                    // no comment handling th
+                    readingLevel = true;
                 }
                 startOfLine = false;
                 break;
@@ -94,12 +111,15 @@ bool process_sudoku(processorInput_t* arg)
 
             case '#':
             {
-                if (startOfLine)
+                if (startOfLine && !comment)
                 {
+                    // Leave startOfLine set so the comment type letter can be checked next
                     comment = true;
                 }
-
-                startOfLine = false;
+                else
+                {
+                    startOfLine = false;
+                }
                 break;
             }
 
@@ -107,6 +127,7 @@ bool process_sudoku(processorInput_t* arg)
             case '\n':
             {
                 comment = false;
+                readingLevel = false;
                 startOfLine = true;
                 break;
             }
@@ -124,6 +145,20 @@ bool process_sudoku(processorInput_t* arg)
         return false;
     }
 
+    // Make sure the puzzle can be solved, and only one way
+    sudokuRating_t rating = sudokuRatePuzzle(cells, NULL, 9);
+    if (SUDOKU_RATING_INVALID == rating)
+    {
+        fprintf(stderr, "[sudoku] %s does not have exactly one solution\n", arg->inFilename);
+        return false;
+    }
+
+    if (levelLen && strcmp(level, sudokuRatingName(rating)))
+    {
+        fprintf(stderr, "[sudoku] Warning: %s is marked %s but rates as %s\n", arg->inFilename, level,
+                sudokuRatingName(rating));
+    }
+
     FILE* outFile = arg->out.file;
 
     // version
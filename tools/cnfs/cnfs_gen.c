@@ -5,13 +5,61 @@
 #include <string.h>
 #include <dirent.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <sys/stat.h>
 
-int stringcmp(const void* a, const void* b);
-char* filenameToEnumName(const char* filename);
+#include "heatshrink_decoder.h"
 
 #define MAX_FILES     8192
 #define CNFS_PATH_MAX 4096
 
+/// The most source folders which may be scanned for asset references
+#define MAX_SRC_DIRS 16
+
+/// The most distinct modes which may reference assets
+#define MAX_OWNERS 512
+
+/// Rough cost of heatshrink decoding on the ESP32-S2, per decoded byte. Only meant for comparing assets to each other
+#define HEATSHRINK_NS_PER_BYTE 500
+
+/// A list of all the data required for an input file
+typedef struct
+{
+    char* filename;
+    uint8_t* data;
+    int offset;
+    int len;
+    int padLen;
+} fileEntry_t;
+
+/// An enum name and the index of the file it refers to, for looking up references in source files
+typedef struct
+{
+    char* name;
+    int fileIdx;
+} enumLookup_t;
+
+/// Which modes reference which files, for the asset report
+typedef struct
+{
+    enumLookup_t* enums;
+    int numEnums;
+    char* owners[MAX_OWNERS];
+    int numOwners;
+    uint8_t* refs; ///< numFiles rows of MAX_OWNERS bits
+    const char* skip[2];
+} refScan_t;
+
+int stringcmp(const void* a, const void* b);
+char* filenameToEnumName(const char* filename);
+bool heatshrinkDecodedSize(const uint8_t* data, int len, uint32_t* decodedSize);
+int enumLookupCmp(const void* a, const void* b);
+char* sourceOwner(const char* root, const char* path);
+void scanSourceFile(refScan_t* scan, const char* root, const char* path);
+void scanSourceDir(refScan_t* scan, const char* root, const char* path);
+bool writeReport(const char* reportFile, const fileEntry_t* entries, int nr_file, char** srcDirs, int numSrcDirs,
+                 const char* cFile, const char* hFile);
+
 /**
  * @brief alphanumeric ordering string comparison for qsort() that sorts nicely with and without leading zeros on digit sequences.
  *
@@ -130,19 +178,444 @@ char* filenameToEnumName(const char* filename)
     return enumName;
 }
 
+/**
+ * @brief Check if a file is heatshrink compressed by decoding it, and get its decoded size
+ *
+ * @param data The file data, which starts with a four byte decoded size if it's compressed
+ * @param len The length of the file data
+ * @param decodedSize Returns the decoded size if the file is compressed
+ * @return true if the whole file decodes to exactly the size in its header, false if it isn't compressed
+ */
+bool heatshrinkDecodedSize(const uint8_t* data, int len, uint32_t* decodedSize)
+{
+    if (len < 5)
+    {
+        return false;
+    }
+
+    uint32_t expected = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | (data[3]);
+
+    // Heatshrink can't compress by much more than 10x, so anything bigger isn't a size
+    if (0 == expected || expected / 16 > (uint32_t)len)
+    {
+        return false;
+    }
+
+    heatshrink_decoder* hsd = heatshrink_decoder_alloc(256, 8, 4);
+    heatshrink_decoder_reset(hsd);
+
+    uint8_t out[1024];
+    uint32_t decoded = 0;
+    int inputIdx     = 4;
+    bool ok          = true;
+    bool finished    = false;
+    while (ok)
+    {
+        size_t copied       = 0;
+        HSD_poll_res polled = heatshrink_decoder_poll(hsd, out, sizeof(out), &copied);
+        decoded += copied;
+
+        if (polled < 0 || decoded > expected)
+        {
+            ok = false;
+        }
+        else if (HSDR_POLL_MORE == polled)
+        {
+            continue;
+        }
+        else if (inputIdx < len)
+        {
+            copied = 0;
+            heatshrink_decoder_sink(hsd, &data[inputIdx], len - inputIdx, &copied);
+            inputIdx += copied;
+            ok = (0 != copied);
+        }
+        else if (!finished)
+        {
+            finished = (HSDR_FINISH_DONE == heatshrink_decoder_finish(hsd));
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    heatshrink_decoder_free(hsd);
+
+    if (ok && decoded == expected)
+    {
+        *decodedSize = decoded;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Compare two enumLookup_t by name for qsort() and bsearch()
+ *
+ * @param a An enumLookup_t to compare
+ * @param b Another enumLookup_t to compare
+ * @return <0 if a<b, 0 if equal, >0 if a>b
+ */
+int enumLookupCmp(const void* a, const void* b)
+{
+    return strcmp(((const enumLookup_t*)a)->name, ((const enumLookup_t*)b)->name);
+}
+
+/**
+ * @brief Get the name of the mode or component which owns a source file. Files in modes/category/name/ belong to
+ * "name", files directly in modes/category/ belong to their own name, and anything else belongs to the first folder
+ * under the root, like "utils" or "menu"
+ *
+ * @param root The folder being scanned
+ * @param path The path to a source file in that folder
+ * @return The owner name. This is allocated and must be free()'d
+ */
+char* sourceOwner(const char* root, const char* path)
+{
+    const char* rel = path + strlen(root);
+    while ('/' == *rel)
+    {
+        rel++;
+    }
+
+    // Split the relative path into at most four components
+    const char* parts[4] = {0};
+    int partLens[4]      = {0};
+    int numParts         = 0;
+    while (*rel && numParts < 4)
+    {
+        const char* end = strchr(rel, '/');
+        int partLen     = end ? (end - rel) : (int)strlen(rel);
+
+        parts[numParts]    = rel;
+        partLens[numParts] = partLen;
+        numParts++;
+
+        rel += partLen;
+        while ('/' == *rel)
+        {
+            rel++;
+        }
+    }
+
+    int ownerIdx = 0;
+    if (numParts >= 3 && 5 == partLens[0] && 0 == strncmp(parts[0], "modes", 5))
+    {
+        ownerIdx = 2;
+    }
+
+    // Drop the extension from file names
+    int ownerLen = partLens[ownerIdx];
+    if (ownerIdx == numParts - 1)
+    {
+        const char* dot = memchr(parts[ownerIdx], '.', ownerLen);
+        if (dot)
+        {
+            ownerLen = dot - parts[ownerIdx];
+        }
+    }
+
+    return strndup(parts[ownerIdx], ownerLen);
+}
+
+/**
+ * @brief Find every asset enum referenced in a source file, and note which owner references it
+ *
+ * @param scan The scan state
+ * @param root The folder being scanned
+ * @param path The path to the source file
+ */
+void scanSourceFile(refScan_t* scan, const char* root, const char* path)
+{
+    // Only C sources and headers, and not the generated CNFS files which list every enum
+    const char* ext = strrchr(path, '.');
+    if (NULL == ext || (strcmp(ext, ".c") && strcmp(ext, ".h")))
+    {
+        return;
+    }
+
+    const char* base = strrchr(path, '/');
+    base             = base ? base + 1 : path;
+    for (int i = 0; i < 2; i++)
+    {
+        if (scan->skip[i] && 0 == strcmp(base, scan->skip[i]))
+        {
+            return;
+        }
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        return;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = calloc(1, len + 1);
+    len        = fread(text, 1, len, f);
+    fclose(f);
+
+    int ownerIdx = -1;
+    char* tok    = text;
+    while (*tok)
+    {
+        if (!(isalpha((unsigned char)*tok) || '_' == *tok))
+        {
+            tok++;
+            continue;
+        }
+
+        // Find the end of the identifier
+        char* end = tok;
+        while (isalnum((unsigned char)*end) || '_' == *end)
+        {
+            end++;
+        }
+
+        char saved = *end;
+        *end       = 0;
+
+        enumLookup_t key    = {.name = tok};
+        enumLookup_t* found = bsearch(&key, scan->enums, scan->numEnums, sizeof(enumLookup_t), enumLookupCmp);
+        if (found)
+        {
+            // Find or add the owner the first time a reference is found in this file
+            if (ownerIdx < 0)
+            {
+                char* owner = sourceOwner(root, path);
+                for (ownerIdx = 0; ownerIdx < scan->numOwners; ownerIdx++)
+                {
+                    if (0 == strcmp(owner, scan->owners[ownerIdx]))
+                    {
+                        break;
+                    }
+                }
+
+                if (ownerIdx == scan->numOwners && scan->numOwners < MAX_OWNERS)
+                {
+                    scan->owners[scan->numOwners++] = owner;
+                }
+                else
+                {
+                    free(owner);
+                }
+            }
+
+            if (ownerIdx < MAX_OWNERS)
+            {
+                scan->refs[found->fileIdx * (MAX_OWNERS / 8) + ownerIdx / 8] |= (1 << (ownerIdx % 8));
+            }
+        }
+
+        *end = saved;
+        tok  = end;
+    }
+
+    free(text);
+}
+
+/**
+ * @brief Recursively scan a folder of source files for asset references
+ *
+ * @param scan The scan state
+ * @param root The top level folder being scanned
+ * @param path The folder to scan
+ */
+void scanSourceDir(refScan_t* scan, const char* root, const char* path)
+{
+    DIR* dir = opendir(path);
+    if (!dir)
+    {
+        fprintf(stderr, "Warning: Can't open %s\n", path);
+        return;
+    }
+
+    // Sort the names so owners are found in a repeatable order
+    char* names[MAX_FILES];
+    int numNames = 0;
+    struct dirent* dp;
+    while ((dp = readdir(dir)) && numNames < MAX_FILES)
+    {
+        if ('.' != dp->d_name[0])
+        {
+            names[numNames++] = strdup(dp->d_name);
+        }
+    }
+    closedir(dir);
+    qsort(names, numNames, sizeof(char*), stringcmp);
+
+    for (int i = 0; i < numNames; i++)
+    {
+        char child[CNFS_PATH_MAX];
+        snprintf(child, sizeof(child), "%s/%s", path, names[i]);
+
+        struct stat st;
+        if (0 == stat(child, &st))
+        {
+            if (S_ISDIR(st.st_mode))
+            {
+                scanSourceDir(scan, root, child);
+            }
+            else
+            {
+                scanSourceFile(scan, root, child);
+            }
+        }
+        free(names[i]);
+    }
+}
+
+/**
+ * @brief Write a CSV report with the flash size, decoded size, estimated decode time, and referencing modes of each
+ * file. Rows are in the same order as the files in the image, so reports from two builds can be diffed
+ *
+ * @param reportFile The CSV file to write
+ * @param entries The files in the image
+ * @param nr_file The number of files in the image
+ * @param srcDirs Folders of source code to scan for references to each file's enum
+ * @param numSrcDirs The number of folders in srcDirs
+ * @param cFile The generated C file, which is not scanned
+ * @param hFile The generated header file, which is not scanned
+ * @return true if the report was written, false if it wasn't
+ */
+bool writeReport(const char* reportFile, const fileEntry_t* entries, int nr_file, char** srcDirs, int numSrcDirs,
+                 const char* cFile, const char* hFile)
+{
+    refScan_t scan = {0};
+    scan.enums     = calloc(nr_file, sizeof(enumLookup_t));
+    scan.numEnums  = nr_file;
+    scan.refs      = calloc(nr_file, MAX_OWNERS / 8);
+    scan.skip[0]   = strrchr(cFile, '/') ? strrchr(cFile, '/') + 1 : cFile;
+    scan.skip[1]   = strrchr(hFile, '/') ? strrchr(hFile, '/') + 1 : hFile;
+
+    for (int i = 0; i < nr_file; i++)
+    {
+        scan.enums[i].name    = filenameToEnumName(entries[i].filename);
+        scan.enums[i].fileIdx = i;
+    }
+    qsort(scan.enums, nr_file, sizeof(enumLookup_t), enumLookupCmp);
+
+    for (int i = 0; i < numSrcDirs; i++)
+    {
+        // Trim trailing slashes so owner names are found correctly
+        char root[CNFS_PATH_MAX];
+        snprintf(root, sizeof(root), "%s", srcDirs[i]);
+        for (int end = strlen(root) - 1; end > 0 && '/' == root[end]; end--)
+        {
+            root[end] = 0;
+        }
+        scanSourceDir(&scan, root, root);
+    }
+
+    // Sort owner names, remembering where each one was so the reference bits can be read
+    int ownerOrder[MAX_OWNERS];
+    for (int i = 0; i < scan.numOwners; i++)
+    {
+        ownerOrder[i] = i;
+    }
+    for (int i = 1; i < scan.numOwners; i++)
+    {
+        for (int j = i; j > 0 && strcmp(scan.owners[ownerOrder[j - 1]], scan.owners[ownerOrder[j]]) > 0; j--)
+        {
+            int tmp           = ownerOrder[j];
+            ownerOrder[j]     = ownerOrder[j - 1];
+            ownerOrder[j - 1] = tmp;
+        }
+    }
+
+    bool ok = false;
+    FILE* f = fopen(reportFile, "w");
+    if (!f)
+    {
+        fprintf(stderr, "Error: cannot open %s\n", reportFile);
+    }
+    else
+    {
+        fprintf(f, "file,enum,flash_bytes,decoded_bytes,ratio,decode_us,modes\n");
+        for (int i = 0; i < nr_file; i++)
+        {
+            const fileEntry_t* fe = &entries[i];
+
+            // Files which aren't compressed are used straight from flash
+            uint32_t decodedSize = fe->len;
+            uint32_t decodeUs    = 0;
+            if (heatshrinkDecodedSize(fe->data, fe->len, &decodedSize))
+            {
+                decodeUs = (uint32_t)(((uint64_t)decodedSize * HEATSHRINK_NS_PER_BYTE + 500) / 1000);
+            }
+
+            char* enumName = filenameToEnumName(fe->filename);
+            fprintf(f, "%s,%s,%d,%u,%.2f,%u,", fe->filename, enumName, fe->len, decodedSize,
+                    fe->len ? (double)decodedSize / fe->len : 1.0, decodeUs);
+            free(enumName);
+
+            bool first = true;
+            for (int o = 0; o < scan.numOwners; o++)
+            {
+                int ownerIdx = ownerOrder[o];
+                if (scan.refs[i * (MAX_OWNERS / 8) + ownerIdx / 8] & (1 << (ownerIdx % 8)))
+                {
+                    fprintf(f, "%s%s", first ? "" : ";", scan.owners[ownerIdx]);
+                    first = false;
+                }
+            }
+            fprintf(f, "\n");
+        }
+        fclose(f);
+        ok = true;
+    }
+
+    for (int i = 0; i < nr_file; i++)
+    {
+        free(scan.enums[i].name);
+    }
+    for (int i = 0; i < scan.numOwners; i++)
+    {
+        free(scan.owners[i]);
+    }
+    free(scan.enums);
+    free(scan.refs);
+    return ok;
+}
+
 /**
  * @brief Main function for cnfs_gen. This converts a folder of files into a cnfs blob
  *
  * @param argc Argument count
- * @param argv Argument values: [program name, input folder, output C file, output H file]
+ * @param argv Argument values: [program name, input folder, output C file, output H file], then optionally
+ * [-r report.csv] to write an asset report and [-s sourceFolder/] any number of times to find which modes use each file
  * @return 0 for success, a negative number for error
  */
 int main(int argc, char** argv)
 {
+    // Parse optional report arguments
+    const char* reportFile = NULL;
+    char* srcDirs[MAX_SRC_DIRS];
+    int numSrcDirs = 0;
+    bool argsOk    = (argc >= 4);
+    for (int i = 4; argsOk && i < argc; i += 2)
+    {
+        if (i + 1 < argc && 0 == strcmp(argv[i], "-r"))
+        {
+            reportFile = argv[i + 1];
+        }
+        else if (i + 1 < argc && 0 == strcmp(argv[i], "-s") && numSrcDirs < MAX_SRC_DIRS)
+        {
+            srcDirs[numSrcDirs++] = argv[i + 1];
+        }
+        else
+        {
+            argsOk = false;
+        }
+    }
+
     // Make sure enough arguments are supplied
-    if (argc != 4)
+    if (!argsOk)
     {
-        fprintf(stderr, "Error: Usage: cnfs_gen folder/ image.c image.h\n");
+        fprintf(stderr, "Error: Usage: cnfs_gen folder/ image.c image.h [-r report.csv] [-s sourceFolder/]...\n");
         return -5;
     }
 
@@ -172,14 +645,7 @@ int main(int argc, char** argv)
     qsort(filelist, numfiles_in, sizeof(char*), stringcmp);
 
     // A list of all the data required for an input file
-    struct fileEntry
-    {
-        char* filename;
-        uint8_t* data;
-        int offset;
-        int len;
-        int padLen;
-    } entries[MAX_FILES];
+    static fileEntry_t entries[MAX_FILES];
 
     // A count of input files
     int nr_file = 0;
@@ -210,12 +676,12 @@ int main(int argc, char** argv)
         fseek(f, 0, SEEK_SET);
 
         // Save the input file into entries[]
-        struct fileEntry* fe = &entries[nr_file];
-        fe->data             = malloc(len);
-        fe->len              = len;
-        fe->padLen           = ((len + 3) / 4) * 4;
-        int readLen          = fread(fe->data, 1, len, f);
-        fe->filename         = fname_in;
+        fileEntry_t* fe = &entries[nr_file];
+        fe->data        = malloc(len);
+        fe->len         = len;
+        fe->padLen      = ((len + 3) / 4) * 4;
+        int readLen     = fread(fe->data, 1, len, f);
+        fe->filename    = fname_in;
         if (readLen != fe->len)
         {
             fprintf(stderr, "Error: File %s truncated (expected %d bytes, got %d)\n", fname, fe->len, readLen);
@@ -257,8 +723,8 @@ int main(int argc, char** argv)
     fprintf(f, "{\n");
     for (int i = 0; i < nr_file; i++)
     {
-        struct fileEntry* fe = &entries[i];
-        char* enumName       = filenameToEnumName(fe->filename);
+        fileEntry_t* fe = &entries[i];
+        char* enumName  = filenameToEnumName(fe->filename);
         fprintf(f, "    %s = %d, ///< %s\n", enumName, i, fe->filename);
         free(enumName);
     }
@@ -302,7 +768,7 @@ int main(int argc, char** argv)
     fprintf(f, "const cnfsFileEntry cnfs_files[CNFS_NUM_FILES] = {\n");
     for (int i = 0; i < nr_file; i++)
     {
-        struct fileEntry* fe = entries + i;
+        fileEntry_t* fe = entries + i;
         fprintf(f, "    { .len = %d, .offset = %d },\n", fe->len, fe->offset);
         directorySize += (((strlen(fe->filename) + 1) + 3) & (~3)) + 12;
     }
@@ -315,7 +781,7 @@ int main(int argc, char** argv)
     int ki = 0;
     for (int i = 0; i < nr_file; i++)
     {
-        struct fileEntry* fe = entries + i;
+        fileEntry_t* fe = entries + i;
         int k;
         for (k = 0; k < fe->padLen; k++)
         {
@@ -368,6 +834,12 @@ int main(int argc, char** argv)
     printf("Image size: %d bytes\n", offset);
     printf("Directory size: %d bytes\n", directorySize);
 
+    // Write the asset report, if asked for
+    if (NULL != reportFile && !writeReport(reportFile, entries, nr_file, srcDirs, numSrcDirs, argv[2], argv[3]))
+    {
+        return -21;
+    }
+
     // Free everything
     for (int idx = 0; idx < numfiles_in; idx++)
     {
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""
+Run many headless, fuzzing Swadge emulators in parallel and collect the crashes, hangs, and failed assertions they
+find. Each run gets its own seed, working folder, NVS file, and ESP-NOW port, and records its inputs so a finding can
+be replayed with --playback. Findings are deduplicated by the top frames of their backtrace.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import re
+import shutil
+import signal
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+# Frames from the crash handler, the C library, and sanitizers, which are the same for every finding
+IGNORED_FRAMES = {
+    "signalHandler_crash",
+    "__restore_rt",
+    "raise",
+    "abort",
+    "__assert_fail",
+    "__assert_fail_base",
+    "__GI_raise",
+    "__GI_abort",
+    "__pthread_kill_implementation",
+    "__pthread_kill_internal",
+    "pthread_kill",
+    "gsignal",
+    "backtrace",
+    "__libc_start_call_main",
+    "__libc_start_main",
+    "_start",
+    "??",
+}
+
+# How many frames make up a finding's signature
+SIGNATURE_FRAMES = 5
+
+# addr2line -fpriC output, e.g. "drawFoo at /path/foo.c:123" or " (inlined by) drawFoo at /path/foo.c:123"
+ADDR2LINE_FRAME = re.compile(r"^\s*(?:\(inlined by\)\s*)?(\S+) at (\S+)")
+
+# AddressSanitizer output, e.g. "    #3 0x55d1c2 in drawFoo /path/foo.c:123"
+ASAN_FRAME = re.compile(r"^\s*#\d+ 0x[0-9a-fA-F]+ in (\S+)")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Run fuzzing Swadge emulators in parallel and collect findings")
+    parser.add_argument("--emulator", default="./swadge_emulator", help="Path to the emulator binary")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="How many emulators to run at once")
+    parser.add_argument("--runs", type=int, default=100, help="How many emulators to run in total")
+    parser.add_argument("--mode", help="The mode to fuzz. Defaults to the main menu")
+    parser.add_argument("--duration", type=float, default=60, help="Simulated seconds to fuzz in each run")
+    parser.add_argument("--hang-timeout", type=float, default=10,
+                        help="Real seconds a single frame may take before the run is reported as a hang")
+    parser.add_argument("--timeout", type=float, default=0,
+                        help="Real seconds a whole run may take before it is killed. Defaults to no limit")
+    parser.add_argument("--seed", type=int, default=1, help="The seed of the first run. Each run adds one")
+    parser.add_argument("--port", type=int, default=40000, help="The ESP-NOW port of the first run. Each run adds one")
+    parser.add_argument("--out", default="fuzz_out", help="Folder to write runs and findings to")
+    parser.add_argument("--keep-runs", action="store_true", help="Keep the folders of runs which found nothing")
+    parser.add_argument("extra", nargs=argparse.REMAINDER, help="Extra arguments for the emulator, after --")
+    return parser.parse_args()
+
+
+def build_command(args, emulator, seed, port):
+    """Build the emulator command line for one run. Frame times aren't fuzzed, so a seed reproduces a run"""
+    cmd = [emulator, "--batch", "--fuzz",
+           "--seed", str(seed),
+           "--record", "fuzz.swrp",
+           "--nvs-file", "nvs.json",
+           "--espnow-port", str(port),
+           "--hang-timeout", str(args.hang_timeout),
+           "--duration", str(args.duration)]
+    if args.mode:
+        cmd += ["--mode", args.mode]
+    cmd += [a for a in args.extra if a != "--"]
+    return cmd
+
+
+def run_one(args, emulator, index):
+    """Run a single emulator in its own folder and return what happened"""
+    seed = args.seed + index
+    port = args.port + index
+    run_dir = os.path.join(args.out, "runs", "run-%d" % seed)
+    os.makedirs(run_dir, exist_ok=True)
+
+    cmd = build_command(args, emulator, seed, port)
+    timed_out = False
+    with open(os.path.join(run_dir, "output.log"), "w") as log:
+        proc = subprocess.Popen(cmd, cwd=run_dir, stdout=log, stderr=subprocess.STDOUT, stdin=subprocess.DEVNULL)
+        try:
+            proc.wait(timeout=args.timeout or None)
+        except subprocess.TimeoutExpired:
+            timed_out = True
+            proc.kill()
+            proc.wait()
+
+    with open(os.path.join(run_dir, "output.log"), errors="replace") as log:
+        output = log.read()
+
+    kind = classify(proc.returncode, output, timed_out)
+    return {
+        "seed": seed,
+        "port": port,
+        "dir": run_dir,
+        "cmd": cmd,
+        "returncode": proc.returncode,
+        "kind": kind,
+        "frames": parse_frames(output) if kind else [],
+    }
+
+
+def classify(returncode, output, timed_out):
+    """Return "hang", "assert", "crash", or None if the run finished cleanly"""
+    if timed_out or "HANG:" in output:
+        return "hang"
+    if "Assertion" in output or "assert failed" in output:
+        return "assert"
+    if returncode != 0 or "ERROR: AddressSanitizer" in output or "runtime error:" in output:
+        return "crash"
+    return None
+
+
+def parse_frames(output):
+    """Return the function names of a backtrace in the output, innermost first, without the crash handler's frames"""
+    frames = []
+    lines = output.splitlines()
+
+    # The emulator's crash handler prints addr2line output after this header
+    if "CRASH BACKTRACE" in lines:
+        start = lines.index("CRASH BACKTRACE") + 1
+        for line in lines[start:]:
+            if line.startswith("====="):
+                continue
+            match = ADDR2LINE_FRAME.match(line)
+            if not match:
+                break
+            frames.append(match.group(1))
+    else:
+        for line in lines:
+            match = ASAN_FRAME.match(line)
+            if match:
+                frames.append(match.group(1))
+            elif frames:
+                # Only the first sanitizer stack is the one that failed
+                break
+
+    return [f for f in frames if f not in IGNORED_FRAMES]
+
+
+def signature(kind, frames):
+    """A short, stable name for a finding, so every seed which hits the same bug lands in the same folder"""
+    top = frames[:SIGNATURE_FRAMES]
+    return hashlib.sha1("\n".join([kind] + top).encode()).hexdigest()[:12]
+
+
+def save_finding(args, result, sig):
+    """Copy the first reproducer of a finding into its own folder. Returns True if this was a new finding"""
+    finding_dir = os.path.join(args.out, "findings", "%s-%s" % (result["kind"], sig))
+    if os.path.exists(finding_dir):
+        return False
+
+    os.makedirs(finding_dir)
+    for name in os.listdir(result["dir"]):
+        # The run's nvs.json isn't copied, since it's the state at the end. Replays start from an empty one
+        if name in ("output.log", "fuzz.swrp") or (name.startswith("crash-") and name.endswith(".txt")):
+            shutil.copy(os.path.join(result["dir"], name), finding_dir)
+
+    with open(os.path.join(finding_dir, "repro.txt"), "w") as f:
+        f.write("seed: %d\n" % result["seed"])
+        f.write("command: %s\n" % " ".join(result["cmd"]))
+        f.write("replay: %s --playback fuzz.swrp --nvs-file nvs.json\n" % result["cmd"][0])
+        f.write("frames:\n")
+        for frame in result["frames"]:
+            f.write("    %s\n" % frame)
+    return True
+
+
+def main():
+    args = parse_args()
+
+    emulator = os.path.abspath(args.emulator)
+    if not os.path.isfile(emulator):
+        print("Error: Emulator not found at %s" % emulator, file=sys.stderr)
+        return 1
+
+    os.makedirs(args.out, exist_ok=True)
+
+    findings = {}
+    clean = 0
+    try:
+        with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+            futures = [pool.submit(run_one, args, emulator, i) for i in range(args.runs)]
+            for done, future in enumerate(as_completed(futures), 1):
+                result = future.result()
+                if not result["kind"]:
+                    clean += 1
+                    if not args.keep_runs:
+                        shutil.rmtree(result["dir"], ignore_errors=True)
+                    print("[%d/%d] seed %d: ok" % (done, args.runs, result["seed"]))
+                    continue
+
+                sig = signature(result["kind"], result["frames"])
+                key = "%s-%s" % (result["kind"], sig)
+                new = save_finding(args, result, sig)
+                entry = findings.setdefault(key, {
+                    "kind": result["kind"],
+                    "signature": sig,
+                    "frames": result["frames"][:SIGNATURE_FRAMES],
+                    "seeds": [],
+                })
+                entry["seeds"].append(result["seed"])
+                print("[%d/%d] seed %d: %s %s%s" % (done, args.runs, result["seed"], result["kind"], sig,
+                                                    " (new)" if new else ""))
+    except KeyboardInterrupt:
+        # The emulators are in our process group, so they got the interrupt too
+        print("Interrupted, writing the summary so far")
+        signal.signal(signal.SIGINT, signal.SIG_IGN)
+
+    # Write and print a summary, most frequent findings first
+    ordered = sorted(findings.values(), key=lambda e: len(e["seeds"]), reverse=True)
+    with open(os.path.join(args.out, "summary.json"), "w") as f:
+        json.dump({"clean": clean, "findings": ordered}, f, indent=4)
+
+    print()
+    print("%d clean runs, %d distinct findings" % (clean, len(ordered)))
+    if ordered:
+        print("%-7s %-12s %6s  %-10s %s" % ("Kind", "Signature", "Count", "First seed", "Top frame"))
+        for entry in ordered:
+            top = entry["frames"][0] if entry["frames"] else "(no backtrace)"
+            print("%-7s %-12s %6d  %-10d %s" % (entry["kind"], entry["signature"], len(entry["seeds"]),
+                                                min(entry["seeds"]), top))
+    return 1 if ordered else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
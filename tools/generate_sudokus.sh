@@ -16,12 +16,17 @@ EXPERT_THRESH=$(($INTERMEDIATE_THRESH+$INTERMEDIATE_COUNT))
 COUNT=$SIMPLE_COUNT
 DIFF="simple"
 
-qqwing --version >/dev/null
+SUDOKU_GEN=./tools/sudoku_gen/sudoku_gen
+
+make -C ./tools/sudoku_gen >/dev/null
 if [ "$?" -ne "0" ]; then
-	echo "qqwing is not installed! exiting" >2
+	echo "Couldn't build sudoku_gen! exiting" >&2
 	exit 1
 fi
 
+# Seed from the current time, so each run makes a new set of puzzles
+SEED=$(date +%s)
+
 
 I=0
 while [ "${I}" -lt "${PUZZLE_COUNT}" ]; do
@@ -38,8 +43,7 @@ while [ "${I}" -lt "${PUZZLE_COUNT}" ]; do
 
 
 
-	# APPARENTLY qqwing uses srand(time()), so if you generate two puzzles in the same second they're the same
-	# So we have to use the --generate <n> option to do multiple ones, with this monstrosity
+	# Generate all the puzzles of this difficulty at once and split them on blank lines
 	PUZZLE=
 	while REPLY=; read -r || [[ $REPLY ]]; do
 		if [[ $REPLY ]]; then
@@ -55,12 +59,12 @@ while [ "${I}" -lt "${PUZZLE_COUNT}" ]; do
 #DA randomly-generated ${DIFF} puzzle
 #B$(date -I)
 #L${DIFF}
-#Sqqwing
+#Ssudoku_gen
 ${PUZZLE}
 EOF
 
 			I=$(($I + 1))
 			PUZZLE=
 		fi
-	done < <(qqwing --generate $COUNT --difficulty $DIFF | tee qqqwing_$I)
+	done < <(${SUDOKU_GEN} --count $COUNT --difficulty $DIFF --seed $(($SEED + $I)))
 done
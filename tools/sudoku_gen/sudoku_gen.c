@@ -0,0 +1,132 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sudoku_solver.h"
+
+#define BASE      9
+#define BASE_ROOT 3
+
+/// @brief How many puzzles to generate while looking for one with the requested difficulty
+#define MAX_ATTEMPTS 10000
+
+static void printUsage(const char* prog);
+static bool parseDifficulty(const char* name, sudokuRating_t* rating);
+static void printPuzzle(const uint8_t* puzzle);
+
+static void printUsage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [--difficulty simple|easy|intermediate|expert] [--count N] [--seed N]\n", prog);
+}
+
+static bool parseDifficulty(const char* name, sudokuRating_t* rating)
+{
+    for (sudokuRating_t r = SUDOKU_RATING_SIMPLE; r <= SUDOKU_RATING_EXPERT; r++)
+    {
+        if (!strcmp(name, sudokuRatingName(r)))
+        {
+            *rating = r;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Print a puzzle in the same layout qqwing uses, which the sudoku asset processor can read
+ *
+ * @param puzzle The 9x9 puzzle to print
+ */
+static void printPuzzle(const uint8_t* puzzle)
+{
+    for (int r = 0; r < BASE; r++)
+    {
+        if (r && 0 == r % BASE_ROOT)
+        {
+            printf("-------|-------|-------\n");
+        }
+
+        for (int c = 0; c < BASE; c++)
+        {
+            if (c && 0 == c % BASE_ROOT)
+            {
+                printf(" |");
+            }
+
+            uint8_t digit = puzzle[r * BASE + c];
+            printf(" %c", digit ? '0' + digit : '.');
+        }
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Generate sudoku puzzles with a unique solution and a given difficulty, and print them separated by blank
+ * lines. This replaces calling qqwing from generate_sudokus.sh
+ *
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return 0 on success, 1 on failure
+ */
+int main(int argc, char** argv)
+{
+    sudokuRating_t rating = SUDOKU_RATING_SIMPLE;
+    int count             = 1;
+    uint32_t seed         = (uint32_t)time(NULL);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--difficulty") && i + 1 < argc)
+        {
+            if (!parseDifficulty(argv[++i], &rating))
+            {
+                fprintf(stderr, "Error: Unknown difficulty %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--count") && i + 1 < argc)
+        {
+            count = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    sudokuSolverWork_t* work = malloc(sudokuSolverWorkSize());
+    if (NULL == work)
+    {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+
+    uint8_t puzzle[BASE * BASE];
+    for (int n = 0; n < count; n++)
+    {
+        int attempt = 0;
+        while (rating != sudokuGeneratePuzzle(puzzle, NULL, NULL, BASE, rating, &seed, work))
+        {
+            if (++attempt >= MAX_ATTEMPTS)
+            {
+                fprintf(stderr, "Error: Couldn't generate a %s puzzle\n", sudokuRatingName(rating));
+                free(work);
+                return 1;
+            }
+        }
+
+        printPuzzle(puzzle);
+        printf("\n");
+    }
+
+    free(work);
+    return 0;
+}